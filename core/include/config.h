@@ -3,6 +3,6 @@
 #define CORE_CONFIG_H
 namespace Core::Config
 {
-    float random_seed = 0;
+    inline float random_seed = 0;
 };     // namespace Core
 #endif // CORE_CONFIG_H
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+#ifndef CORE_FIXED_MATRIX_H
+#define CORE_FIXED_MATRIX_H
+
+#include <iostream>
+#include <type_traits>
+#include "matrix.h"
+#include "fixed_vector.h"
+
+namespace Core
+{
+    // Fixed-size, stack allocated counterparts of Matrix3/Matrix4.
+    // The memory layout is identical to the dynamic types: (row, col) maps to
+    // values[row * N + col], so data() can be uploaded to OpenGL unchanged.
+
+    class Mat4;
+
+    class alignas(16) Mat3
+    {
+        // attributes
+    public:
+        float values[9];
+
+        // constructors and deconstructor
+    public:
+        constexpr Mat3() : values{} {}
+        constexpr Mat3(float m00, float m01, float m02,
+                       float m10, float m11, float m12,
+                       float m20, float m21, float m22)
+            : values{m00, m01, m02, m10, m11, m12, m20, m21, m22} {}
+        Mat3(const Matrix3 &other);
+        explicit Mat3(const Matrix &other);
+        // upper-left 3x3 block of a 4x4 matrix
+        explicit Mat3(const Mat4 &other);
+
+        operator Matrix3() const;
+
+        // methods
+    public:
+        float &operator()(size_t row, size_t col) { return values[row * 3 + col]; }
+        constexpr float operator()(size_t row, size_t col) const { return values[row * 3 + col]; }
+        constexpr size_t index(size_t row, size_t col) const { return row * 3 + col; }
+
+        float *data() { return values; }
+        const float *data() const { return values; }
+        constexpr size_t rows() const { return 3; }
+        constexpr size_t cols() const { return 3; }
+        constexpr size_t size() const { return 9; }
+        constexpr size_t bytes() const { return 9 * sizeof(float); }
+
+        Mat3 operator+(const Mat3 &other) const;
+        Mat3 operator-(const Mat3 &other) const;
+        Mat3 operator*(float scalar) const;
+        Mat3 operator*(const Mat3 &other) const;
+        Vec3 operator*(const Vec3 &vector) const;
+        Mat3 operator-() const { return *this * -1.f; }
+
+        Mat3 &operator+=(const Mat3 &other) { return *this = *this + other; }
+        Mat3 &operator-=(const Mat3 &other) { return *this = *this - other; }
+        Mat3 &operator*=(float scalar) { return *this = *this * scalar; }
+        Mat3 &operator*=(const Mat3 &other) { return *this = *this * other; }
+
+        bool operator==(const Mat3 &other) const;
+        bool operator!=(const Mat3 &other) const { return !(*this == other); }
+
+        void fill(float value);
+        Mat3 transpose() const;
+        float determinant() const;
+        Mat3 inverse() const;
+        float trace() const { return values[0] + values[4] + values[8]; }
+
+        void translate(const Vec2 &translation);
+        void rotate(float angle_rad, const Vec2 &center);
+        void scale(const Vec2 &scale);
+
+        Mat3 translate(const Vec2 &translation) const;
+        Mat3 rotate(float angle_rad, const Vec2 &center) const;
+        Mat3 scale(const Vec2 &scale) const;
+
+        // static methods
+    public:
+        static constexpr Mat3 identity() { return Mat3(1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f); }
+        static constexpr Mat3 zeros() { return Mat3(); }
+        static constexpr Mat3 ones() { return Mat3(1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f); }
+
+        // friend functions
+    public:
+        friend std::ostream &operator<<(std::ostream &os, const Mat3 &matrix);
+    };
+
+    class alignas(16) Mat4
+    {
+        // attributes
+    public:
+        float values[16];
+
+        // constructors and deconstructor
+    public:
+        constexpr Mat4() : values{} {}
+        constexpr Mat4(float m00, float m01, float m02, float m03,
+                       float m10, float m11, float m12, float m13,
+                       float m20, float m21, float m22, float m23,
+                       float m30, float m31, float m32, float m33)
+            : values{m00, m01, m02, m03, m10, m11, m12, m13, m20, m21, m22, m23, m30, m31, m32, m33} {}
+        Mat4(const Matrix4 &other);
+        explicit Mat4(const Matrix &other);
+
+        operator Matrix4() const;
+
+        // methods
+    public:
+        float &operator()(size_t row, size_t col) { return values[row * 4 + col]; }
+        constexpr float operator()(size_t row, size_t col) const { return values[row * 4 + col]; }
+        constexpr size_t index(size_t row, size_t col) const { return row * 4 + col; }
+
+        float *data() { return values; }
+        const float *data() const { return values; }
+        constexpr size_t rows() const { return 4; }
+        constexpr size_t cols() const { return 4; }
+        constexpr size_t size() const { return 16; }
+        constexpr size_t bytes() const { return 16 * sizeof(float); }
+
+        Mat4 operator+(const Mat4 &other) const;
+        Mat4 operator-(const Mat4 &other) const;
+        Mat4 operator*(float scalar) const;
+        Mat4 operator*(const Mat4 &other) const;
+        Vec4 operator*(const Vec4 &vector) const;
+        Mat4 operator-() const { return *this * -1.f; }
+
+        Mat4 &operator+=(const Mat4 &other) { return *this = *this + other; }
+        Mat4 &operator-=(const Mat4 &other) { return *this = *this - other; }
+        Mat4 &operator*=(float scalar) { return *this = *this * scalar; }
+        Mat4 &operator*=(const Mat4 &other) { return *this = *this * other; }
+
+        bool operator==(const Mat4 &other) const;
+        bool operator!=(const Mat4 &other) const { return !(*this == other); }
+
+        void fill(float value);
+        Mat4 transpose() const;
+        float determinant() const;
+        Mat4 inverse() const;
+        // inverse of an affine transform (rotation/scale/shear + translation), the
+        // translation in row 3 (Geometry::translate) or in column 3 (translate())
+        Mat4 inverse_affine() const;
+        float trace() const { return values[0] + values[5] + values[10] + values[15]; }
+
+        void translate(const Vec3 &translation);
+        void rotate(float angle_rad, const Vec3 &axis);
+        void scale(const Vec3 &scale);
+
+        Mat4 translate(const Vec3 &translation) const;
+        Mat4 rotate(float angle_rad, const Vec3 &axis) const;
+        Mat4 scale(const Vec3 &scale) const;
+
+        // static methods
+    public:
+        static constexpr Mat4 identity()
+        {
+            return Mat4(1.f, 0.f, 0.f, 0.f,
+                        0.f, 1.f, 0.f, 0.f,
+                        0.f, 0.f, 1.f, 0.f,
+                        0.f, 0.f, 0.f, 1.f);
+        }
+        static constexpr Mat4 zeros() { return Mat4(); }
+        static constexpr Mat4 ones()
+        {
+            return Mat4(1.f, 1.f, 1.f, 1.f,
+                        1.f, 1.f, 1.f, 1.f,
+                        1.f, 1.f, 1.f, 1.f,
+                        1.f, 1.f, 1.f, 1.f);
+        }
+
+        // friend functions
+    public:
+        friend std::ostream &operator<<(std::ostream &os, const Mat4 &matrix);
+    };
+
+    static_assert(std::is_trivially_copyable_v<Mat3>, "Mat3 must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<Mat4>, "Mat4 must be trivially copyable");
+}; // namespace Core
+
+#endif // CORE_FIXED_MATRIX_H
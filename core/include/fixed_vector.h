@@ -0,0 +1,244 @@
+#pragma once
+#ifndef CORE_FIXED_VECTOR_H
+#define CORE_FIXED_VECTOR_H
+
+#include <cmath>
+#include <iostream>
+#include <type_traits>
+#include "vector.h"
+#include "math/base.h"
+
+namespace Core
+{
+    // Fixed-size, stack allocated counterparts of Vector2/3/4.
+    // They are trivially copyable and never touch the heap, which makes them
+    // suitable for the per-frame code paths (transforms, cameras, geometry).
+    // Implicit conversions from/to the dynamic types keep both worlds interoperable.
+
+    class alignas(8) Vec2
+    {
+        // attributes
+    public:
+        float values[2];
+
+        // constructors and deconstructor
+    public:
+        constexpr Vec2() : values{0.f, 0.f} {}
+        constexpr Vec2(float x, float y) : values{x, y} {}
+        Vec2(const Vector2 &other) : values{other.x(), other.y()} {}
+        explicit Vec2(const Vector &other) : values{other[0], other[1]} {}
+
+        operator Vector2() const { return Vector2(values[0], values[1]); }
+
+        // methods
+    public:
+        float &x() { return values[0]; }
+        float &y() { return values[1]; }
+        constexpr float x() const { return values[0]; }
+        constexpr float y() const { return values[1]; }
+
+        float &operator[](size_t index) { return values[index]; }
+        constexpr float operator[](size_t index) const { return values[index]; }
+        float *data() { return values; }
+        const float *data() const { return values; }
+        constexpr size_t size() const { return 2; }
+
+        Vec2 operator+(const Vec2 &other) const { return Vec2(values[0] + other.values[0], values[1] + other.values[1]); }
+        Vec2 operator-(const Vec2 &other) const { return Vec2(values[0] - other.values[0], values[1] - other.values[1]); }
+        Vec2 operator*(float scalar) const { return Vec2(values[0] * scalar, values[1] * scalar); }
+        Vec2 operator/(float scalar) const { return *this * (1.f / scalar); }
+        Vec2 operator-() const { return Vec2(-values[0], -values[1]); }
+
+        Vec2 &operator+=(const Vec2 &other) { return *this = *this + other; }
+        Vec2 &operator-=(const Vec2 &other) { return *this = *this - other; }
+        Vec2 &operator*=(float scalar) { return *this = *this * scalar; }
+        Vec2 &operator/=(float scalar) { return *this = *this / scalar; }
+
+        bool operator==(const Vec2 &other) const { return Math::equal(values[0], other.values[0]) && Math::equal(values[1], other.values[1]); }
+        bool operator!=(const Vec2 &other) const { return !(*this == other); }
+
+        float dot(const Vec2 &other) const { return values[0] * other.values[0] + values[1] * other.values[1]; }
+        float length2() const { return dot(*this); }
+        float norm() const { return std::sqrt(length2()); }
+        float length() const { return norm(); }
+        float magnitude() const { return norm(); }
+        Vec2 &normalize() { return *this *= 1.f / norm(); }
+        Vec2 normalized() const { return *this * (1.f / norm()); }
+
+        // static methods
+    public:
+        static constexpr Vec2 ones() { return Vec2(1.f, 1.f); }
+        static constexpr Vec2 zeros() { return Vec2(0.f, 0.f); }
+        static float dot(const Vec2 &a, const Vec2 &b) { return a.dot(b); }
+        static float cross(const Vec2 &a, const Vec2 &b) { return a.x() * b.y() - a.y() * b.x(); }
+
+        // friend functions
+    public:
+        friend Vec2 operator*(float scalar, const Vec2 &vector) { return vector * scalar; }
+        friend std::ostream &operator<<(std::ostream &os, const Vec2 &vector);
+    };
+
+    class alignas(16) Vec3
+    {
+        // attributes
+    public:
+        float values[3];
+
+        // constructors and deconstructor
+    public:
+        constexpr Vec3() : values{0.f, 0.f, 0.f} {}
+        constexpr Vec3(float x, float y, float z) : values{x, y, z} {}
+        constexpr Vec3(const Vec2 &other, float z) : values{other.x(), other.y(), z} {}
+        Vec3(const Vector3 &other) : values{other.x(), other.y(), other.z()} {}
+        explicit Vec3(const Vector &other) : values{other[0], other[1], other[2]} {}
+
+        operator Vector3() const { return Vector3(values[0], values[1], values[2]); }
+
+        // methods
+    public:
+        float &x() { return values[0]; }
+        float &y() { return values[1]; }
+        float &z() { return values[2]; }
+        constexpr float x() const { return values[0]; }
+        constexpr float y() const { return values[1]; }
+        constexpr float z() const { return values[2]; }
+
+        float &operator[](size_t index) { return values[index]; }
+        constexpr float operator[](size_t index) const { return values[index]; }
+        float *data() { return values; }
+        const float *data() const { return values; }
+        constexpr size_t size() const { return 3; }
+
+        Vec3 operator+(const Vec3 &other) const { return Vec3(values[0] + other.values[0], values[1] + other.values[1], values[2] + other.values[2]); }
+        Vec3 operator-(const Vec3 &other) const { return Vec3(values[0] - other.values[0], values[1] - other.values[1], values[2] - other.values[2]); }
+        Vec3 operator*(float scalar) const { return Vec3(values[0] * scalar, values[1] * scalar, values[2] * scalar); }
+        Vec3 operator/(float scalar) const { return *this * (1.f / scalar); }
+        Vec3 operator-() const { return Vec3(-values[0], -values[1], -values[2]); }
+
+        Vec3 &operator+=(const Vec3 &other) { return *this = *this + other; }
+        Vec3 &operator-=(const Vec3 &other) { return *this = *this - other; }
+        Vec3 &operator*=(float scalar) { return *this = *this * scalar; }
+        Vec3 &operator/=(float scalar) { return *this = *this / scalar; }
+
+        bool operator==(const Vec3 &other) const
+        {
+            return Math::equal(values[0], other.values[0]) && Math::equal(values[1], other.values[1]) && Math::equal(values[2], other.values[2]);
+        }
+        bool operator!=(const Vec3 &other) const { return !(*this == other); }
+
+        float dot(const Vec3 &other) const { return values[0] * other.values[0] + values[1] * other.values[1] + values[2] * other.values[2]; }
+        Vec3 cross(const Vec3 &other) const
+        {
+            return Vec3(y() * other.z() - z() * other.y(),
+                        z() * other.x() - x() * other.z(),
+                        x() * other.y() - y() * other.x());
+        }
+        float length2() const { return dot(*this); }
+        float norm() const { return std::sqrt(length2()); }
+        float length() const { return norm(); }
+        float magnitude() const { return norm(); }
+        Vec3 &normalize() { return *this *= 1.f / norm(); }
+        Vec3 normalized() const { return *this * (1.f / norm()); }
+
+        // static methods
+    public:
+        static constexpr Vec3 ones() { return Vec3(1.f, 1.f, 1.f); }
+        static constexpr Vec3 zeros() { return Vec3(0.f, 0.f, 0.f); }
+        static float dot(const Vec3 &a, const Vec3 &b) { return a.dot(b); }
+        static Vec3 cross(const Vec3 &a, const Vec3 &b) { return a.cross(b); }
+
+        // friend functions
+    public:
+        friend Vec3 operator*(float scalar, const Vec3 &vector) { return vector * scalar; }
+        friend std::ostream &operator<<(std::ostream &os, const Vec3 &vector);
+    };
+
+    class alignas(16) Vec4
+    {
+        // attributes
+    public:
+        float values[4];
+
+        // constructors and deconstructor
+    public:
+        constexpr Vec4() : values{0.f, 0.f, 0.f, 0.f} {}
+        constexpr Vec4(float x, float y, float z, float w) : values{x, y, z, w} {}
+        constexpr Vec4(const Vec3 &other, float w) : values{other.x(), other.y(), other.z(), w} {}
+        constexpr Vec4(const Vec2 &other, float z, float w) : values{other.x(), other.y(), z, w} {}
+        Vec4(const Vector4 &other) : values{other.x(), other.y(), other.z(), other.w()} {}
+        explicit Vec4(const Vector &other) : values{other[0], other[1], other[2], other[3]} {}
+
+        operator Vector4() const { return Vector4(values[0], values[1], values[2], values[3]); }
+
+        // methods
+    public:
+        float &x() { return values[0]; }
+        float &y() { return values[1]; }
+        float &z() { return values[2]; }
+        float &w() { return values[3]; }
+        constexpr float x() const { return values[0]; }
+        constexpr float y() const { return values[1]; }
+        constexpr float z() const { return values[2]; }
+        constexpr float w() const { return values[3]; }
+        constexpr Vec3 xyz() const { return Vec3(values[0], values[1], values[2]); }
+
+        float &operator[](size_t index) { return values[index]; }
+        constexpr float operator[](size_t index) const { return values[index]; }
+        float *data() { return values; }
+        const float *data() const { return values; }
+        constexpr size_t size() const { return 4; }
+
+        Vec4 operator+(const Vec4 &other) const
+        {
+            return Vec4(values[0] + other.values[0], values[1] + other.values[1], values[2] + other.values[2], values[3] + other.values[3]);
+        }
+        Vec4 operator-(const Vec4 &other) const
+        {
+            return Vec4(values[0] - other.values[0], values[1] - other.values[1], values[2] - other.values[2], values[3] - other.values[3]);
+        }
+        Vec4 operator*(float scalar) const { return Vec4(values[0] * scalar, values[1] * scalar, values[2] * scalar, values[3] * scalar); }
+        Vec4 operator/(float scalar) const { return *this * (1.f / scalar); }
+        Vec4 operator-() const { return Vec4(-values[0], -values[1], -values[2], -values[3]); }
+
+        Vec4 &operator+=(const Vec4 &other) { return *this = *this + other; }
+        Vec4 &operator-=(const Vec4 &other) { return *this = *this - other; }
+        Vec4 &operator*=(float scalar) { return *this = *this * scalar; }
+        Vec4 &operator/=(float scalar) { return *this = *this / scalar; }
+
+        bool operator==(const Vec4 &other) const
+        {
+            return Math::equal(values[0], other.values[0]) && Math::equal(values[1], other.values[1]) &&
+                   Math::equal(values[2], other.values[2]) && Math::equal(values[3], other.values[3]);
+        }
+        bool operator!=(const Vec4 &other) const { return !(*this == other); }
+
+        float dot(const Vec4 &other) const
+        {
+            return values[0] * other.values[0] + values[1] * other.values[1] + values[2] * other.values[2] + values[3] * other.values[3];
+        }
+        float length2() const { return dot(*this); }
+        float norm() const { return std::sqrt(length2()); }
+        float length() const { return norm(); }
+        float magnitude() const { return norm(); }
+        Vec4 &normalize() { return *this *= 1.f / norm(); }
+        Vec4 normalized() const { return *this * (1.f / norm()); }
+
+        // static methods
+    public:
+        static constexpr Vec4 ones() { return Vec4(1.f, 1.f, 1.f, 1.f); }
+        static constexpr Vec4 zeros() { return Vec4(0.f, 0.f, 0.f, 0.f); }
+        static float dot(const Vec4 &a, const Vec4 &b) { return a.dot(b); }
+
+        // friend functions
+    public:
+        friend Vec4 operator*(float scalar, const Vec4 &vector) { return vector * scalar; }
+        friend std::ostream &operator<<(std::ostream &os, const Vec4 &vector);
+    };
+
+    static_assert(std::is_trivially_copyable_v<Vec2>, "Vec2 must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<Vec3>, "Vec3 must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<Vec4>, "Vec4 must be trivially copyable");
+    static_assert(sizeof(Vec3) == 16 && sizeof(Vec4) == 16, "Vec3/Vec4 are expected to fill one SIMD register");
+}; // namespace Core
+
+#endif // CORE_FIXED_VECTOR_H
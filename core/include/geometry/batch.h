@@ -0,0 +1,75 @@
+#pragma once
+#ifndef CORE_GEOMETRY_BATCH_H
+#define CORE_GEOMETRY_BATCH_H
+
+#include <cstddef>
+#include "fixed_matrix.h"
+#include "quaternion.h"
+
+namespace Core
+{
+    // Bulk transforms of point sets (point clouds, particles, mesh vertices).
+    // Matrices are applied the way the shaders apply them, with the translation in
+    // row 3: p' = (x, y, z, 1) * m, i.e. p'(j) = sum_k p(k) * m(k, j). This is the
+    // transpose of what Mat4::operator*(Vec4) computes.
+    // Points come either interleaved (AoS, `stride` floats from one point to the
+    // next, 3 for packed xyz, 4 for xyzw or Vec3 arrays) or as three separate
+    // arrays (SoA). The SoA form feeds the AVX kernel directly, AoS is deinterleaved
+    // in small blocks on the stack. `out` may be `in` for an in-place transform but
+    // must not overlap it otherwise. Large inputs are split across threads.
+    // SCALAR/SSE2/AVX backends give bit-identical results, FMA rounds differently.
+    namespace Geometry
+    {
+        struct PointsSoA
+        {
+            float *x;
+            float *y;
+            float *z;
+        };
+
+        struct ConstPointsSoA
+        {
+            const float *x;
+            const float *y;
+            const float *z;
+
+            ConstPointsSoA(const float *x, const float *y, const float *z) : x(x), y(y), z(z) {}
+            ConstPointsSoA(const PointsSoA &points) : x(points.x), y(points.y), z(points.z) {}
+        };
+
+        // positions, w = 1
+        void transform_points(const Mat4 &matrix, const float *in, float *out, size_t count, size_t stride = 3);
+        void transform_points(const Mat4 &matrix, const Vec3 *in, Vec3 *out, size_t count);
+        void transform_points(const Mat4 &matrix, ConstPointsSoA in, PointsSoA out, size_t count);
+
+        // directions, w = 0, the translation is ignored
+        void transform_vectors(const Mat4 &matrix, const float *in, float *out, size_t count, size_t stride = 3);
+        void transform_vectors(const Mat4 &matrix, const Vec3 *in, Vec3 *out, size_t count);
+        void transform_vectors(const Mat4 &matrix, ConstPointsSoA in, PointsSoA out, size_t count);
+
+        // positions through a projection, divided by the resulting w
+        void project_points(const Mat4 &matrix, const float *in, float *out, size_t count, size_t stride = 3);
+        void project_points(const Mat4 &matrix, const Vec3 *in, Vec3 *out, size_t count);
+        void project_points(const Mat4 &matrix, ConstPointsSoA in, PointsSoA out, size_t count);
+
+        // full homogeneous transform of xyzw points, no divide
+        void transform_points(const Mat4 &matrix, const Vec4 *in, Vec4 *out, size_t count);
+
+        // normals by a normal matrix (see Transform::get_normal_matrix), renormalized;
+        // zero-length normals stay zero
+        void transform_normals(const Mat3 &normal_matrix, const float *in, float *out, size_t count, size_t stride = 3);
+        void transform_normals(const Mat3 &normal_matrix, const Vec3 *in, Vec3 *out, size_t count);
+        void transform_normals(const Mat3 &normal_matrix, ConstPointsSoA in, PointsSoA out, size_t count);
+
+        // q * p * conjugate(q), the same as Quaternion::operator*(Vec3) for any q
+        void rotate_points(const Quaternion &rotation, const float *in, float *out, size_t count, size_t stride = 3);
+        void rotate_points(const Quaternion &rotation, const Vec3 *in, Vec3 *out, size_t count);
+        void rotate_points(const Quaternion &rotation, ConstPointsSoA in, PointsSoA out, size_t count);
+
+        // threads used for large batches, 0 (default) means one per hardware thread
+        void set_batch_threads(size_t threads);
+        size_t get_batch_threads();
+    };
+};
+
+#endif // CORE_GEOMETRY_BATCH_H
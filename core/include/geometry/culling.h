@@ -0,0 +1,80 @@
+#pragma once
+#ifndef CORE_GEOMETRY_CULLING_H
+#define CORE_GEOMETRY_CULLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include "fixed_matrix.h"
+
+namespace Core
+{
+    // Bounding volumes and frustum tests for visibility culling.
+    // Matrices follow the convention of Geometry::look_at and perspective, with
+    // the translation in row 3, so a camera's frustum comes from
+    // look_at(...) * perspective(...) and an object's from model * view * projection.
+    // Planes are normalized and point inwards: dot(n, p) + d >= 0 inside.
+    // The tests are conservative, a volume that touches a plane or a NaN is kept.
+    // The batch tests read SoA arrays and run 4 (SSE2) or 8 (AVX, FMA) volumes per
+    // iteration, after Math::SIMD's backend; large batches are split across the
+    // threads of Geometry::set_batch_threads. All backends give the same answer.
+    namespace Geometry
+    {
+        struct AABB
+        {
+            Vec3 min;
+            Vec3 max;
+        };
+
+        struct BoundingSphere
+        {
+            Vec3 center;
+            float radius = 0.f;
+        };
+
+        struct Frustum
+        {
+            // (a, b, c, d): left, right, bottom, top, near, far
+            Vec4 planes[6];
+        };
+
+        struct SpheresSoA
+        {
+            const float *x;
+            const float *y;
+            const float *z;
+            const float *radius;
+        };
+
+        struct AABBsSoA
+        {
+            const float *min_x;
+            const float *min_y;
+            const float *min_z;
+            const float *max_x;
+            const float *max_y;
+            const float *max_z;
+        };
+
+        // GL clip space, -w <= z <= w
+        Frustum extract_frustum(const Mat4 &view_projection);
+
+        // of `count` points `stride` floats apart, zero for no points
+        AABB compute_aabb(const float *points, size_t count, size_t stride = 3);
+        // centered on the points' box, the radius reaches the farthest point
+        BoundingSphere compute_sphere(const float *points, size_t count, size_t stride = 3);
+
+        // the box around the transformed box
+        AABB transform_aabb(const Mat4 &matrix, const AABB &box);
+        // the radius grows with the largest axis scale
+        BoundingSphere transform_sphere(const Mat4 &matrix, const BoundingSphere &sphere);
+
+        bool intersects(const Frustum &frustum, const BoundingSphere &sphere);
+        bool intersects(const Frustum &frustum, const AABB &box);
+
+        // visible[i] = 1 if volume i is at least partly inside, 0 if not; returns the number visible
+        size_t cull_spheres(const Frustum &frustum, SpheresSoA spheres, uint8_t *visible, size_t count);
+        size_t cull_aabbs(const Frustum &frustum, AABBsSoA boxes, uint8_t *visible, size_t count);
+    };
+};
+
+#endif // CORE_GEOMETRY_CULLING_H
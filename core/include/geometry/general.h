@@ -2,6 +2,7 @@
 #ifndef CORE_GEOMETRY_GENERAL_H
 #define CORE_GEOMETRY_GENERAL_H
 #include "vector.h"
+#include "fixed_vector.h"
 
 namespace Core
 {
@@ -32,6 +33,11 @@ namespace Core
         Core::Vector radians(const Core::Vector &degrees);
         float distance(const Core::Vector &v1, const Core::Vector &v2);
         Core::Vector normalize(const Core::Vector &vector);
+        float distance(const Core::Vec2 &v1, const Core::Vec2 &v2);
+        float distance(const Core::Vec3 &v1, const Core::Vec3 &v2);
+        Core::Vec2 normalize(const Core::Vec2 &vector);
+        Core::Vec3 normalize(const Core::Vec3 &vector);
+        Core::Vec4 normalize(const Core::Vec4 &vector);
         float dist_point_line(const Core::Vector &p, const Line& line);
         float dist_point_line_segment(const Core::Vector &p, const LineSegment& line_segment);
     };
@@ -0,0 +1,140 @@
+#pragma once
+#ifndef CORE_JOBS_H
+#define CORE_JOBS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Core::Jobs
+{
+    // Work-stealing job system shared by the whole tree. A fixed pool of workers
+    // each owns a deque: a worker pushes and pops its own jobs at the back (newest
+    // first, still warm in cache) and steals from the front of the others when it
+    // runs dry. Jobs queued from threads outside the pool go to a shared queue.
+    // A thread that waits on a Counter keeps running queued jobs until the counter
+    // drops to zero, so waiting inside a job (nested parallel_for) never deadlocks
+    // and the main thread contributes instead of blocking.
+    // Jobs must not throw, parallel_for forwards the first exception to its caller.
+
+    using Job = std::function<void()>;
+
+    constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+    class Scheduler;
+
+    // The number of unfinished jobs attached to it. Jobs queued with run_after()
+    // start when it drops to zero. It must outlive every job it counts: destroy
+    // it after wait() returned, done() alone does not mean the last job let go.
+    class Counter
+    {
+        // attributes
+    private:
+        std::atomic<size_t> pending{0};
+        std::mutex mutex;
+        std::vector<std::pair<Job, Counter *>> continuations;
+
+        // constructors and deconstructor
+    public:
+        Counter() = default;
+        Counter(const Counter &) = delete;
+        Counter &operator=(const Counter &) = delete;
+
+        // methods
+    public:
+        size_t get() const { return pending.load(std::memory_order_acquire); }
+        bool done() const { return get() == 0; }
+
+    private:
+        void add(size_t count) { pending.fetch_add(count, std::memory_order_relaxed); }
+
+        friend class Scheduler;
+    };
+
+    // (re)starts the pool with `threads` threads running jobs, the calling thread
+    // included, i.e. threads - 1 workers; 0 means one per hardware thread. With a
+    // single thread queued jobs only run when someone waits or helps. Not to be
+    // called while jobs are in flight. The pool starts by itself on first use.
+    void init(size_t threads = 0);
+    // finishes the queued jobs and joins the workers
+    void shutdown();
+    // workers in the pool, the thread calling wait() comes on top
+    size_t get_worker_count();
+    // index of the calling worker, NONE outside the pool
+    size_t get_worker_index();
+
+    // queues `job`, `counter` (if any) is incremented now and decremented when it finished
+    void run(Job job, Counter *counter = nullptr);
+    // queues `job` once `dependency` reached zero
+    void run_after(Counter &dependency, Job job, Counter *counter = nullptr);
+    // runs queued jobs on the calling thread until `counter` reaches zero
+    void wait(Counter &counter);
+    // runs one queued job on the calling thread, false if there was none
+    bool help();
+
+    // calls f(chunk_begin, chunk_end) over [begin, end) in chunks of `grain`
+    // elements (0: a few chunks per thread) on the pool and the calling thread,
+    // returns when all of them finished. Chunk boundaries only depend on `grain`.
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F &&f);
+
+    /*---Implementation---*/
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F &&f)
+    {
+        if (end <= begin)
+            return;
+        const size_t count = end - begin;
+        const size_t workers = get_worker_count();
+        if (grain == 0)
+            grain = std::max<size_t>(1, count / (4 * (workers + 1)));
+        const size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1 || workers == 0)
+        {
+            for (size_t c = 0; c < chunks; ++c)
+                f(begin + c * grain, std::min(end, begin + (c + 1) * grain));
+            return;
+        }
+
+        // chunks are claimed through one shared index, the queued helpers only
+        // decide how many threads take part
+        std::atomic<size_t> next{0};
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto work = [&]
+        {
+            for (size_t c = next.fetch_add(1, std::memory_order_relaxed); c < chunks; c = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                const size_t b = begin + c * grain;
+                try
+                {
+                    f(b, std::min(end, b + grain));
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next = chunks;
+                }
+            }
+        };
+        Counter counter;
+        const size_t helpers = std::min(workers, chunks - 1);
+        for (size_t i = 0; i < helpers; ++i)
+            run(work, &counter);
+        work();
+        wait(counter);
+        if (error)
+            std::rethrow_exception(error);
+    }
+    /*====*/
+} // namespace Core::Jobs
+
+#endif // CORE_JOBS_H
@@ -0,0 +1,134 @@
+#pragma once
+#ifndef CORE_LOGGER_H
+#define CORE_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Core
+{
+    // Logging that any thread can do without taking a lock. log() copies the
+    // message into a fixed size entry and publishes it to a bounded MPSC ring
+    // buffer; a background thread formats and drains the ring into a history of
+    // lines for the UI and, optionally, into a rotating file. When the ring is
+    // full the message is dropped and counted, producers never wait.
+    class Logger
+    {
+    public:
+        enum Level : uint8_t
+        {
+            LEVEL_DEBUG = 0,
+            LEVEL_INFO,
+            LEVEL_WARN,
+            LEVEL_ERROR
+        };
+
+        // longer messages are truncated
+        static constexpr size_t TEXT_SIZE = 232;
+
+        struct Entry
+        {
+            uint64_t time;   // microseconds since the epoch
+            uint32_t thread; // small id, numbered in the order threads first log
+            Level level;
+            uint16_t length;
+            char text[TEXT_SIZE];
+        };
+
+        struct Line
+        {
+            Level level;
+            std::string text;
+        };
+
+        // attributes
+    private:
+        struct alignas(64) Cell
+        {
+            std::atomic<size_t> sequence;
+            Entry entry;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+        alignas(64) std::atomic<size_t> enqueue_pos{0};
+        alignas(64) size_t dequeue_pos = 0;    // only touched by the consumer
+        std::atomic<size_t> completed_pos{0}; // entries that reached the history and the file
+        std::atomic<size_t> dropped{0};
+        std::atomic<bool> waiting{false};
+
+        // consumer side
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable drained;
+        bool stopping = false;
+        size_t reported_drops = 0;
+        std::thread consumer;
+
+        // circular, head is the oldest line
+        mutable std::mutex history_mutex;
+        std::vector<Line> history;
+        size_t history_head = 0;
+        size_t history_capacity;
+
+        std::mutex file_mutex;
+        std::ofstream file;
+        std::string file_path;
+        size_t file_size = 0;
+        size_t file_max_bytes = 0;
+        size_t file_max_files = 0;
+
+        // constructors and deconstructor
+    public:
+        // capacity is rounded up to a power of two
+        Logger(size_t capacity = 4096, size_t history_capacity = 100000);
+        ~Logger();
+        Logger(const Logger &) = delete;
+        Logger &operator=(const Logger &) = delete;
+
+        // methods
+    public:
+        // false if the ring was full and the message was dropped
+        bool log(Level level, const char *msg, size_t length);
+        bool log(Level level, const std::string &msg) { return log(level, msg.data(), msg.size()); }
+        // blocks until everything logged before the call is in the history and the file
+        void flush();
+
+        // appends to `path`; once it exceeds max_bytes it is renamed to path.1, the
+        // older files shift up to path.<max_files - 1> and the oldest one is removed
+        void open_file(const std::string &path, size_t max_bytes = 8 << 20, size_t max_files = 3);
+        void close_file();
+        bool has_file();
+
+        size_t history_size() const;
+        // copies up to `count` lines starting at the `first` oldest one, returns the number copied
+        size_t read_history(size_t first, size_t count, std::vector<Line> &out) const;
+        void clear_history();
+        void set_history_capacity(size_t capacity);
+        size_t get_history_capacity() const;
+
+        size_t get_capacity() const { return mask + 1; }
+        size_t get_dropped() const { return dropped; }
+
+        // "HH:MM:SS.uuuuuu [LEVEL] [T<thread>] text"
+        static std::string format(const Entry &entry);
+        static const char *level_name(Level level);
+
+    private:
+        void fill(Entry &entry, Level level, const char *msg, size_t length);
+        bool pop(Entry &entry);
+        void run();
+        size_t drain();
+        void write_lines(const std::vector<Line> &lines);
+        void rotate();
+    };
+} // namespace Core
+
+#endif // CORE_LOGGER_H
@@ -0,0 +1,31 @@
+#pragma once
+#ifndef MATH_GEMM_H
+#define MATH_GEMM_H
+
+#include <cstddef>
+
+namespace Core
+{
+    namespace Math
+    {
+        // C = alpha * A * B + beta * C on row-major float arrays, A is m x k,
+        // B is k x n, C is m x n; lda/ldb/ldc are the row strides.
+        // A and B are packed into MR x KC / KC x NR panels that stay in L1/L2, a
+        // 6 x 16 register-tiled microkernel (AVX/FMA when the SIMD backend allows
+        // it) computes the tiles, and the rows of C are split across threads.
+        // C must not overlap A or B. With beta == 0, C is not read.
+        void gemm(size_t m, size_t n, size_t k,
+                  float alpha, const float *a, size_t lda,
+                  const float *b, size_t ldb,
+                  float beta, float *c, size_t ldc);
+
+        // worker threads used by gemm, 0 (default) means one per hardware thread
+        void set_gemm_threads(size_t threads);
+        size_t get_gemm_threads();
+
+        // Matrix::operator* switches to gemm once m * n * k reaches this
+        constexpr size_t GEMM_THRESHOLD = 64 * 64 * 64;
+    };
+};
+
+#endif // MATH_GEMM_H
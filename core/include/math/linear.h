@@ -2,11 +2,106 @@
 #ifndef MATH_LINEAR_H
 #define MATH_LINEAR_H
 #include <cmath>
+#include <vector>
+#include "matrix.h"
+
 namespace Core
 {
     namespace Math
     {
+        // Dense linear algebra on the row-major Matrix storage.
+        // The factorizations work on a private copy of the input, are blocked by
+        // BLOCK_SIZE columns and keep every inner loop on contiguous rows.
+        // Right hand sides are passed as n x k matrices (a Vector is n x 1).
+
+        constexpr size_t BLOCK_SIZE = 64;
+
+        // partial-pivot LU: P * A = L * U, L unit lower triangular
+        class LU
+        {
+            // attributes
+        private:
+            Matrix lu;
+            std::vector<size_t> pivots;
+            int parity;
+            bool singular;
+
+            // constructors and deconstructor
+        public:
+            explicit LU(const Matrix &matrix);
+
+            // methods
+        public:
+            size_t dim() const { return lu.rows(); }
+            bool is_singular() const { return singular; }
+            // L and U packed in one matrix, the unit diagonal of L is not stored
+            const Matrix &packed() const { return lu; }
+            // row i of P * A is row pivot_order()[i] of A
+            std::vector<size_t> pivot_order() const;
+            Matrix lower() const;
+            Matrix upper() const;
+
+            float determinant() const;
+            Matrix solve(const Matrix &b) const;
+            MatrixS inverse() const;
+        };
+
+        // Householder QR of an m x n matrix with m >= n: A = Q * R
+        class QR
+        {
+            // attributes
+        private:
+            // R in the upper triangle, the Householder vectors below the diagonal
+            Matrix qr;
+            std::vector<float> tau;
+            bool full_rank;
+
+            // constructors and deconstructor
+        public:
+            explicit QR(const Matrix &matrix);
+
+            // methods
+        public:
+            bool is_full_rank() const { return full_rank; }
+            // thin factors, Q is m x n and R is n x n
+            Matrix q() const;
+            Matrix r() const;
+
+            // least squares solution of A * x = b
+            Matrix solve(const Matrix &b) const;
+        };
+
+        // A = L * L^T for a symmetric positive definite A, only the lower triangle is read
+        class Cholesky
+        {
+            // attributes
+        private:
+            Matrix l;
+            bool positive_definite;
+
+            // constructors and deconstructor
+        public:
+            explicit Cholesky(const Matrix &matrix);
+
+            // methods
+        public:
+            bool is_positive_definite() const { return positive_definite; }
+            const Matrix &lower() const { return l; }
+
+            float determinant() const;
+            Matrix solve(const Matrix &b) const;
+            MatrixS inverse() const;
+        };
+
+        // triangular solves, only the referenced triangle of the matrix is read
+        Matrix solve_lower(const Matrix &l, const Matrix &b, bool unit_diagonal = false);
+        Matrix solve_upper(const Matrix &u, const Matrix &b, bool unit_diagonal = false);
+
+        // LU for square systems, least squares through QR for overdetermined ones
+        Matrix solve(const Matrix &a, const Matrix &b);
+        MatrixS inverse(const Matrix &matrix);
+        float determinant(const Matrix &matrix);
     };
 } // namespace math
 
-#endif // MATH_LINEAR_H
\ No newline at end of file
+#endif // MATH_LINEAR_H
@@ -2,33 +2,122 @@
 #ifndef CORE_RANDOM_H
 #define CORE_RANDOM_H
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <random>
+#include <type_traits>
 #include "config.h"
+#include "fixed_vector.h"
 
 namespace Core::Math
 {
+    // Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers:
+    // as easy as 1, 2, 3"). Word i of stream s under a seed is a pure function of
+    // (seed, s, i), so a generator can jump anywhere in O(1), distinct streams never
+    // overlap, and the bulk fills below give the same numbers no matter how many
+    // threads split the work. Satisfies UniformRandomBitGenerator.
+    class Philox
+    {
+        // attributes
+    public:
+        using result_type = uint32_t;
+
+    private:
+        uint64_t _seed;
+        uint64_t _stream;
+        uint64_t position;    // next word
+        uint64_t cached = ~uint64_t(0); // block held in cache
+        uint32_t cache[4];
+
+        // constructors and deconstructor
+    public:
+        explicit Philox(uint64_t seed = 0, uint64_t stream = 0) : _seed(seed), _stream(stream), position(0) {}
+
+        // methods
+    public:
+        result_type operator()();
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        uint64_t seed() const { return _seed; }
+        uint64_t stream() const { return _stream; }
+        // another independent stream under the same seed, e.g. one per thread or task
+        Philox split(uint64_t stream) const { return Philox(_seed, stream); }
+
+        // position in words, every call to operator() consumes one
+        uint64_t tell() const { return position; }
+        void seek(uint64_t word) { position = word; }
+        void discard(uint64_t words) { position += words; }
+
+        // [0, 1) with 24 random bits
+        float uniform() { return to_unit((*this)()); }
+        float uniform(float min, float max) { return min + (max - min) * uniform(); }
+        // [0, range) without modulo bias
+        uint32_t bounded(uint32_t range);
+        // standard normal, Box-Muller on two words
+        float normal();
+
+        // bulk fills. fill_uniform and the directions consume words exactly as the
+        // scalar calls would, one per uniform and two per direction. fill_normal
+        // keeps both values of each Box-Muller pair where normal() drops the
+        // second: it consumes one word per value (rounded up to a pair), and only
+        // its even elements match successive normal() calls
+        void fill_uniform(float *out, size_t count, float min = 0.f, float max = 1.f);
+        void fill_normal(float *out, size_t count, float mean = 0.f, float stddev = 1.f);
+        // uniformly distributed unit vectors
+        void fill_unit_sphere(Vec3 *out, size_t count);
+        // uniformly distributed unit vectors with a non-negative dot product with `normal`
+        void fill_hemisphere(Vec3 *out, size_t count, const Vec3 &normal);
+
+        // static methods
+    public:
+        // the four words of block `counter` in `stream` under `seed`
+        static void block(uint64_t seed, uint64_t stream, uint64_t counter, uint32_t out[4]);
+        static float to_unit(uint32_t word) { return static_cast<float>(word >> 8) * (1.f / 16777216.f); }
+    };
 
+    // threads used by the bulk fills, 0 (default) means one per hardware thread
+    void set_random_threads(size_t threads);
+    size_t get_random_threads();
+
+    // per-thread generators behind random() and random_s(): random() is seeded from
+    // std::random_device, random_s() from Config::random_seed, each thread on its own stream
+    Philox &thread_generator();
+    Philox &thread_generator_s();
+
+    // uniform in [min, max) for both real and integer types
     template <typename T>
-    T random_s(T min, T max)
+    T uniform(Philox &gen, T min, T max)
     {
-        static std::mt19937 gen(Config::random_seed);
-        // if is real value
-        if (std::is_floating_point_v<T>)
+        if constexpr (std::is_floating_point_v<T>)
         {
-            std::uniform_real_distribution<T> dis(min, max);
-            return dis(gen);
+            return min + (max - min) * static_cast<T>(gen.uniform());
+        }
+        else if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(uint32_t))
+        {
+            if (max <= min)
+                return min;
+            return static_cast<T>(static_cast<int64_t>(min) + gen.bounded(static_cast<uint32_t>(static_cast<int64_t>(max) - min)));
         }
-        // if is integer value
-        else if (std::is_integral_v<T>)
+        else if constexpr (std::is_integral_v<T>)
         {
-            std::uniform_int_distribution<T> dis(min, max);
+            if (max <= min)
+                return min;
+            std::uniform_int_distribution<T> dis(min, max - 1);
             return dis(gen);
         }
         else
         {
-            throw std::invalid_argument("random_s: invalid type");
+            static_assert(std::is_arithmetic_v<T>, "uniform: invalid type");
         }
     }
+
+    template <typename T>
+    T random_s(T min, T max)
+    {
+        return uniform<T>(thread_generator_s(), min, max);
+    }
     template <typename T>
     T random_s(T max)
     {
@@ -43,24 +132,7 @@ namespace Core::Math
     template <typename T>
     T random(T min, T max)
     {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        // if is real value
-        if constexpr (std::is_floating_point_v<T>)
-        {
-            std::uniform_real_distribution<T> dis(min, max);
-            return dis(gen);
-        }
-        // if is integer value
-        else if constexpr (std::is_integral_v<T>)
-        {
-            std::uniform_int_distribution<T> dis(min, max);
-            return dis(gen);
-        }
-        else
-        {
-            throw std::invalid_argument("random: invalid type");
-        }
+        return uniform<T>(thread_generator(), min, max);
     }
 
     template <typename T>
@@ -77,4 +149,4 @@ namespace Core::Math
 
 } // namespace  Core::Random
 
-#endif // CORE_RANDOM_H
\ No newline at end of file
+#endif // CORE_RANDOM_H
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef MATH_SIMD_H
+#define MATH_SIMD_H
+
+namespace Core
+{
+    namespace Math
+    {
+        // 4x4 kernels on flat float[16] arrays using the layout of Matrix4/Mat4,
+        // i.e. (row, col) is stored at [row * 4 + col].
+        // The backend is picked at runtime on first use. SCALAR, SSE2 and AVX produce
+        // bit-identical results; FMA differs by the rounding of the fused multiply-add,
+        // so it is never picked automatically and has to be requested with set_backend().
+        namespace SIMD
+        {
+            enum Backend
+            {
+                SCALAR = 0,
+                SSE2,
+                AVX,
+                FMA
+            };
+
+            bool is_supported(Backend backend);
+            Backend best_backend();
+            Backend get_backend();
+            // falls back to the best supported backend below the requested one.
+            // Safe while other threads run kernels: each call uses the old or the new
+            // backend as a whole, so results only change mid-flight when FMA is involved.
+            Backend set_backend(Backend backend);
+            const char *backend_name(Backend backend);
+
+            // rslt(i, j) = sum_k a(i, k) * b(k, j); rslt may alias a or b
+            void mat4_mul(const float *a, const float *b, float *rslt);
+            // rslt(i) = sum_k m(i, k) * v(k); rslt may alias v
+            void mat4_mul_vec4(const float *m, const float *v, float *rslt);
+            void mat4_transpose(const float *m, float *rslt);
+            // inverse of an affine matrix in the Geometry convention: (i, 3) = (0, 0, 0, 1)
+            // and the translation stored in row 3; returns false if the 3x3 block is singular
+            bool mat4_inverse_affine(const float *m, float *rslt);
+            // the same for either place of the translation: row 3 as above, or column 3
+            // with row 3 = (0, 0, 0, 1) as Mat4::translate writes it; false if m is
+            // neither or its 3x3 block is singular
+            bool mat4_inverse_affine_either(const float *m, float *rslt);
+        };
+    }; // namespace Math
+};
+
+#endif // MATH_SIMD_H
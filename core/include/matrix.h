@@ -9,6 +9,18 @@ namespace Core
     class Vector2;
     class Vector3;
     class Vector4;
+    class Vec4;
+
+    template <typename E>
+    class MatrixExpr;
+    namespace Expr
+    {
+        class Ref;
+        template <typename E>
+        class Transpose;
+    };
+    class MatrixView;
+    class ConstMatrixView;
 
     class Matrix
     {
@@ -31,8 +43,16 @@ namespace Core
         Matrix &operator=(Matrix &&other);
         virtual ~Matrix();
 
+        // duplicate == false wraps the buffer without owning it, the caller keeps it
+        // alive; copies are always owning. Prefer MatrixView for windows into storage
         Matrix(float *values, size_t rows, size_t cols, bool duplicate);
 
+        // evaluate a lazy expression, see matrix_expr.h
+        template <typename E>
+        Matrix(const MatrixExpr<E> &expr);
+        template <typename E>
+        Matrix &operator=(const MatrixExpr<E> &expr);
+
         // construct from vector
         Matrix(const Vector &other);
         Matrix &operator=(const Vector &other);
@@ -48,16 +68,17 @@ namespace Core
         float operator()(size_t row, size_t col) const;
         inline size_t index(size_t row, size_t col) const { return row * _cols + col;}
 
-        Matrix operator+(const Matrix &other) const;
-        Matrix operator-(const Matrix &other) const;
-        Matrix operator*(float scalar) const;
+        // +, - and scaling by a float are lazy, see matrix_expr.h
         Matrix operator*(const Matrix &other) const;
         // Vector operator*(const Vector &other) const;
-        Matrix operator-() const;
 
-        Matrix &operator+=(const Matrix &other) { return *this = *this + other; }
-        Matrix &operator-=(const Matrix &other) { return *this = *this - other; }
-        Matrix &operator*=(float scalar) { return *this = *this * scalar; }
+        Matrix &operator+=(const Matrix &other);
+        Matrix &operator-=(const Matrix &other);
+        Matrix &operator*=(float scalar);
+        template <typename E>
+        Matrix &operator+=(const MatrixExpr<E> &expr);
+        template <typename E>
+        Matrix &operator-=(const MatrixExpr<E> &expr);
 
 
         virtual bool operator==(const Matrix &other) const;
@@ -86,8 +107,18 @@ namespace Core
 
         bool is_square() const { return _rows == _cols; }
 
-        Matrix transpose() const;
+        Expr::Transpose<Expr::Ref> transpose() const;
         Matrix submatrix(size_t row, size_t col) const;
+
+        // non-owning windows into this matrix, see matrix_view.h
+        MatrixView view();
+        ConstMatrixView view() const;
+        MatrixView block(size_t row, size_t col, size_t rows, size_t cols);
+        ConstMatrixView block(size_t row, size_t col, size_t rows, size_t cols) const;
+        MatrixView row(size_t row);
+        ConstMatrixView row(size_t row) const;
+        MatrixView col(size_t col);
+        ConstMatrixView col(size_t col) const;
         // static methods
     public:
         static Matrix ones(size_t rows, size_t cols);
@@ -98,6 +129,11 @@ namespace Core
         // friend Matrix operator*(float scalar, const Matrix &other){ return other * scalar; }
         // format output
         friend std::ostream &operator<<(std::ostream &os, const Matrix &matrix);
+
+        // expression evaluation
+    protected:
+        template <typename E>
+        void evaluate(const E &expr);
     };
 
     class MatrixS : public Matrix
@@ -123,6 +159,15 @@ namespace Core
         MatrixS &operator=(const Matrix &other);
         MatrixS &operator=(Matrix &&other);
 
+        template <typename E>
+        MatrixS(const MatrixExpr<E> &expr) : Matrix(expr) {}
+        template <typename E>
+        MatrixS &operator=(const MatrixExpr<E> &expr)
+        {
+            Matrix::operator=(expr);
+            return *this;
+        }
+
         // methods
     public:
         size_t dim() const { return _rows; }
@@ -166,8 +211,21 @@ namespace Core
         Matrix4(Matrix &&other);
         Matrix4 &operator=(const Matrix &other);
         Matrix4 &operator=(Matrix &&other);
+        template <typename E>
+        Matrix4(const MatrixExpr<E> &expr) : MatrixS(4) { *this = expr; }
+        template <typename E>
+        Matrix4 &operator=(const MatrixExpr<E> &expr);
         // methods for 4x4 matrices
     public:
+        // 4x4 specialisations running on the SIMD kernels of math/simd.h
+        using Matrix::operator*;
+        Matrix4 operator*(const Matrix4 &other) const;
+        Vec4 operator*(const Vec4 &vector) const;
+        Matrix4 transpose() const;
+        // inverse of an affine transform (rotation/scale/shear + translation), the
+        // translation in row 3 (Geometry::translate) or in column 3 (translate())
+        Matrix4 inverse_affine() const;
+
         void translate(const Vector3 &translation);
         void rotate(float angle_rad, const Vector3 &axis);
         void scale(const Vector3 &scale);
@@ -208,6 +266,10 @@ namespace Core
         Matrix3(Matrix &&other);
         Matrix3 &operator=(const Matrix &other);
         Matrix3 &operator=(Matrix &&other);
+        template <typename E>
+        Matrix3(const MatrixExpr<E> &expr) : MatrixS(3) { *this = expr; }
+        template <typename E>
+        Matrix3 &operator=(const MatrixExpr<E> &expr);
         // methods for 3x3 matrices
 
         void translate(const Vector2 &translation);
@@ -223,4 +285,9 @@ namespace Core
         static Matrix3 identity() { return Matrix3(MatrixS::identity(3)); }
     };
 };     // namespace Core
+
+// the lazy operators and the template members above
+#include "matrix_expr.h"
+#include "matrix_view.h"
+
 #endif // !CORE_MATRIX_H
\ No newline at end of file
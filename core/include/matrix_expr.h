@@ -0,0 +1,364 @@
+#pragma once
+#ifndef CORE_MATRIX_EXPR_H
+#define CORE_MATRIX_EXPR_H
+
+#include <iostream>
+#include <type_traits>
+#include "matrix.h"
+
+namespace Core
+{
+    // Lazy element-wise expressions over Matrix and its subclasses.
+    // `a * 2.f + b - c` builds a small tree of nodes instead of three temporaries;
+    // the tree is evaluated in one pass straight into the destination buffer when
+    // it is assigned to, or used to construct, a Matrix/Vector.
+    // Leaves only point to their matrix, so an expression must not outlive its
+    // operands: evaluate it right away rather than keeping it in an `auto`.
+
+    template <typename E>
+    class MatrixExpr
+    {
+        // methods
+    public:
+        const E &self() const { return static_cast<const E &>(*this); }
+
+        size_t rows() const { return self().rows(); }
+        size_t cols() const { return self().cols(); }
+        size_t size() const { return rows() * cols(); }
+        float operator()(size_t row, size_t col) const { return self()(row, col); }
+
+        Matrix eval() const { return Matrix(*this); }
+    };
+
+    namespace Expr
+    {
+        // leaf wrapping an existing matrix
+        class Ref : public MatrixExpr<Ref>
+        {
+            // attributes
+        private:
+            const float *values;
+            size_t _rows;
+            size_t _cols;
+
+            // constructors and deconstructor
+        public:
+            Ref(const Matrix &matrix) : values(matrix.data()), _rows(matrix.rows()), _cols(matrix.cols()) {}
+
+            // methods
+        public:
+            size_t rows() const { return _rows; }
+            size_t cols() const { return _cols; }
+            float operator()(size_t row, size_t col) const { return values[row * _cols + col]; }
+
+            // whether the expression reads any element of [begin, end)
+            bool reads(const float *begin, const float *end) const { return values < end && begin < values + _rows * _cols; }
+            // whether evaluating in place into the matrix at [begin, end) would read an
+            // element that was already overwritten; same-index reads are safe
+            bool aliases(const float *, const float *) const { return false; }
+        };
+
+        struct Add
+        {
+            static float apply(float a, float b) { return a + b; }
+        };
+
+        struct Sub
+        {
+            static float apply(float a, float b) { return a - b; }
+        };
+
+        template <typename Op, typename L, typename R>
+        class Binary : public MatrixExpr<Binary<Op, L, R>>
+        {
+            // attributes
+        private:
+            L lhs;
+            R rhs;
+
+            // constructors and deconstructor
+        public:
+            Binary(const L &lhs, const R &rhs) : lhs(lhs), rhs(rhs) {}
+
+            // methods
+        public:
+            size_t rows() const { return lhs.rows(); }
+            size_t cols() const { return lhs.cols(); }
+            float operator()(size_t row, size_t col) const { return Op::apply(lhs(row, col), rhs(row, col)); }
+
+            bool reads(const float *begin, const float *end) const { return lhs.reads(begin, end) || rhs.reads(begin, end); }
+            bool aliases(const float *begin, const float *end) const { return lhs.aliases(begin, end) || rhs.aliases(begin, end); }
+        };
+
+        template <typename E>
+        class Scale : public MatrixExpr<Scale<E>>
+        {
+            // attributes
+        private:
+            E expr;
+            float scalar;
+
+            // constructors and deconstructor
+        public:
+            Scale(const E &expr, float scalar) : expr(expr), scalar(scalar) {}
+
+            // methods
+        public:
+            size_t rows() const { return expr.rows(); }
+            size_t cols() const { return expr.cols(); }
+            float operator()(size_t row, size_t col) const { return expr(row, col) * scalar; }
+
+            bool reads(const float *begin, const float *end) const { return expr.reads(begin, end); }
+            bool aliases(const float *begin, const float *end) const { return expr.aliases(begin, end); }
+        };
+
+        template <typename E>
+        class Negate : public MatrixExpr<Negate<E>>
+        {
+            // attributes
+        private:
+            E expr;
+
+            // constructors and deconstructor
+        public:
+            explicit Negate(const E &expr) : expr(expr) {}
+
+            // methods
+        public:
+            size_t rows() const { return expr.rows(); }
+            size_t cols() const { return expr.cols(); }
+            float operator()(size_t row, size_t col) const { return -expr(row, col); }
+
+            bool reads(const float *begin, const float *end) const { return expr.reads(begin, end); }
+            bool aliases(const float *begin, const float *end) const { return expr.aliases(begin, end); }
+        };
+
+        template <typename E>
+        class Transpose : public MatrixExpr<Transpose<E>>
+        {
+            // attributes
+        private:
+            E expr;
+
+            // constructors and deconstructor
+        public:
+            explicit Transpose(const E &expr) : expr(expr) {}
+
+            // methods
+        public:
+            size_t rows() const { return expr.cols(); }
+            size_t cols() const { return expr.rows(); }
+            float operator()(size_t row, size_t col) const { return expr(col, row); }
+
+            bool reads(const float *begin, const float *end) const { return expr.reads(begin, end); }
+            // reads (col, row) while (row, col) is written
+            bool aliases(const float *begin, const float *end) const { return expr.reads(begin, end); }
+        };
+
+        // Matrix (or a subclass) becomes a Ref leaf, expressions are stored by value
+        template <typename T, typename = void>
+        struct Operand
+        {
+        };
+
+        template <typename T>
+        struct Operand<T, std::enable_if_t<std::is_base_of_v<Matrix, T>>>
+        {
+            using type = Ref;
+        };
+
+        template <typename T>
+        struct Operand<T, std::enable_if_t<std::is_base_of_v<MatrixExpr<T>, T>>>
+        {
+            using type = T;
+        };
+
+        template <typename T>
+        using operand_t = typename Operand<T>::type;
+
+        template <typename T, typename = void>
+        struct IsOperand : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct IsOperand<T, std::void_t<operand_t<T>>> : std::true_type
+        {
+        };
+
+        template <typename T>
+        constexpr bool is_expr_v = std::is_base_of_v<MatrixExpr<T>, T>;
+
+        template <typename T>
+        constexpr bool is_operand_v = IsOperand<T>::value;
+
+        // strided leaves that products read in place, specialized in matrix_view.h
+        template <typename T>
+        struct IsView : std::false_type
+        {
+        };
+
+        template <typename T>
+        constexpr bool is_view_v = IsView<T>::value;
+
+        // views and matrices, at least one view: multiplied without evaluating either side
+        template <typename L, typename R>
+        constexpr bool is_view_product_v = (is_view_v<L> || is_view_v<R>) &&
+                                           (is_view_v<L> || std::is_base_of_v<Matrix, L>) &&
+                                           (is_view_v<R> || std::is_base_of_v<Matrix, R>);
+    };
+
+    /*------------------------------operators-----------------------------*/
+    /*====================================================================*/
+
+    template <typename L, typename R>
+    Expr::Binary<Expr::Add, Expr::operand_t<L>, Expr::operand_t<R>> operator+(const L &lhs, const R &rhs)
+    {
+        return {Expr::operand_t<L>(lhs), Expr::operand_t<R>(rhs)};
+    }
+
+    template <typename L, typename R>
+    Expr::Binary<Expr::Sub, Expr::operand_t<L>, Expr::operand_t<R>> operator-(const L &lhs, const R &rhs)
+    {
+        return {Expr::operand_t<L>(lhs), Expr::operand_t<R>(rhs)};
+    }
+
+    template <typename E>
+    Expr::Scale<Expr::operand_t<E>> operator*(const E &expr, float scalar)
+    {
+        return {Expr::operand_t<E>(expr), scalar};
+    }
+
+    template <typename E>
+    Expr::Scale<Expr::operand_t<E>> operator*(float scalar, const E &expr)
+    {
+        return {Expr::operand_t<E>(expr), scalar};
+    }
+
+    template <typename E>
+    Expr::Negate<Expr::operand_t<E>> operator-(const E &expr)
+    {
+        return Expr::Negate<Expr::operand_t<E>>(Expr::operand_t<E>(expr));
+    }
+
+    template <typename E>
+    Expr::Transpose<Expr::operand_t<E>> transpose(const E &expr)
+    {
+        return Expr::Transpose<Expr::operand_t<E>>(Expr::operand_t<E>(expr));
+    }
+
+    // matrix products are not element-wise, the expression side is evaluated first;
+    // products of views go through multiply() in matrix_view.h instead
+    template <typename E, typename M>
+    std::enable_if_t<Expr::is_expr_v<E> && std::is_base_of_v<Matrix, M> && !Expr::is_view_product_v<E, M>, Matrix> operator*(const E &lhs, const M &rhs)
+    {
+        return Matrix(lhs) * rhs;
+    }
+
+    template <typename M, typename E>
+    std::enable_if_t<std::is_base_of_v<Matrix, M> && Expr::is_expr_v<E> && !Expr::is_view_product_v<M, E>, Matrix> operator*(const M &lhs, const E &rhs)
+    {
+        return lhs.Matrix::operator*(Matrix(rhs));
+    }
+
+    template <typename L, typename R>
+    std::enable_if_t<Expr::is_expr_v<L> && Expr::is_expr_v<R> && !Expr::is_view_product_v<L, R>, Matrix> operator*(const L &lhs, const R &rhs)
+    {
+        return Matrix(lhs) * Matrix(rhs);
+    }
+
+    template <typename E, typename M>
+    std::enable_if_t<Expr::is_expr_v<E> && Expr::is_operand_v<M>, bool> operator==(const E &lhs, const M &rhs)
+    {
+        return Matrix(lhs) == Matrix(Expr::operand_t<M>(rhs));
+    }
+
+    template <typename M, typename E>
+    std::enable_if_t<std::is_base_of_v<Matrix, M> && Expr::is_expr_v<E>, bool> operator==(const M &lhs, const E &rhs)
+    {
+        return lhs == Matrix(rhs);
+    }
+
+    template <typename E>
+    std::ostream &operator<<(std::ostream &os, const MatrixExpr<E> &expr)
+    {
+        return os << Matrix(expr);
+    }
+
+    /*---------------------------Implementation---------------------------*/
+    /*====================================================================*/
+
+    inline Expr::Transpose<Expr::Ref> Matrix::transpose() const
+    {
+        return Expr::Transpose<Expr::Ref>(Expr::Ref(*this));
+    }
+
+    template <typename E>
+    Matrix::Matrix(const MatrixExpr<E> &expr)
+        : own_data(true), values(nullptr), _rows(expr.rows()), _cols(expr.cols())
+    {
+        if (size() > 0)
+            values = new float[size()];
+        evaluate(expr.self());
+    }
+
+    template <typename E>
+    Matrix &Matrix::operator=(const MatrixExpr<E> &expr)
+    {
+        const E &e = expr.self();
+        // a fresh buffer is needed if the shape changes, the data is borrowed,
+        // or a transposed read of the destination would see overwritten values
+        if (!own_data || size() != e.rows() * e.cols() || e.aliases(values, values + size()))
+            return *this = Matrix(e);
+        _rows = e.rows();
+        _cols = e.cols();
+        evaluate(e);
+        return *this;
+    }
+
+    template <typename E>
+    Matrix &Matrix::operator+=(const MatrixExpr<E> &expr)
+    {
+        return *this = *this + expr.self();
+    }
+
+    template <typename E>
+    Matrix &Matrix::operator-=(const MatrixExpr<E> &expr)
+    {
+        return *this = *this - expr.self();
+    }
+
+    template <typename E>
+    void Matrix::evaluate(const E &expr)
+    {
+        for (size_t row = 0; row < _rows; ++row)
+        {
+            float *dst = values + row * _cols;
+            for (size_t col = 0; col < _cols; ++col)
+                dst[col] = expr(row, col);
+        }
+    }
+
+    template <typename E>
+    Matrix4 &Matrix4::operator=(const MatrixExpr<E> &expr)
+    {
+        // like the Matrix conversion, other shapes are cropped or zero padded
+        if (expr.rows() == 4 && expr.cols() == 4)
+            Matrix::operator=(expr);
+        else
+            *this = Matrix(expr);
+        return *this;
+    }
+
+    template <typename E>
+    Matrix3 &Matrix3::operator=(const MatrixExpr<E> &expr)
+    {
+        if (expr.rows() == 3 && expr.cols() == 3)
+            Matrix::operator=(expr);
+        else
+            *this = Matrix(expr);
+        return *this;
+    }
+}; // namespace Core
+
+#endif // CORE_MATRIX_EXPR_H
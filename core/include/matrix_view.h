@@ -0,0 +1,207 @@
+#pragma once
+#ifndef CORE_MATRIX_VIEW_H
+#define CORE_MATRIX_VIEW_H
+
+#include <stdexcept>
+#include "matrix.h"
+#include "matrix_expr.h"
+
+namespace Core
+{
+    // Non-owning strided windows into matrix storage.
+    // Element (row, col) lives at data()[row * row_stride() + col * col_stride()],
+    // so blocks, single rows/columns and transposes are expressed without copying.
+    // A view never owns or frees memory: it stays valid as long as the storage it
+    // was taken from is alive and not reallocated (assigning a differently shaped
+    // value to a Matrix reallocates it). Copying a view copies the window, not the
+    // elements; assigning to a MatrixView writes through to the elements.
+    // Views are expressions, so they mix freely with Matrix in +, - and scaling,
+    // and a Matrix can be constructed from one to get an owning copy. Products of
+    // views and matrices read the views in place through their strides; other
+    // expressions are evaluated into a Matrix before they are multiplied.
+
+    class MatrixView;
+
+    class ConstMatrixView : public MatrixExpr<ConstMatrixView>
+    {
+        // attributes
+    protected:
+        const float *values;
+        size_t _rows;
+        size_t _cols;
+        size_t _row_stride;
+        size_t _col_stride;
+
+        // constructors and deconstructor
+    public:
+        ConstMatrixView(const float *values, size_t rows, size_t cols, size_t row_stride, size_t col_stride = 1)
+            : values(values), _rows(rows), _cols(cols), _row_stride(row_stride), _col_stride(col_stride) {}
+        ConstMatrixView(const Matrix &matrix)
+            : ConstMatrixView(matrix.data(), matrix.rows(), matrix.cols(), matrix.cols()) {}
+
+        // methods
+    public:
+        size_t rows() const { return _rows; }
+        size_t cols() const { return _cols; }
+        size_t size() const { return _rows * _cols; }
+        size_t row_stride() const { return _row_stride; }
+        size_t col_stride() const { return _col_stride; }
+        const float *data() const { return values; }
+        // whether the elements are one dense row-major block
+        bool is_contiguous() const { return _col_stride == 1 && (_rows <= 1 || _row_stride == _cols); }
+
+        float operator()(size_t row, size_t col) const { return values[row * _row_stride + col * _col_stride]; }
+
+        ConstMatrixView block(size_t row, size_t col, size_t rows, size_t cols) const;
+        ConstMatrixView row(size_t row) const { return block(row, 0, 1, _cols); }
+        ConstMatrixView col(size_t col) const { return block(0, col, _rows, 1); }
+        ConstMatrixView transpose() const { return ConstMatrixView(values, _cols, _rows, _col_stride, _row_stride); }
+
+        // expression interface, a view may overlap its destination in any layout
+        bool reads(const float *begin, const float *end) const { return _rows && _cols && values < end && begin < last() + 1; }
+        bool aliases(const float *begin, const float *end) const { return reads(begin, end); }
+
+    protected:
+        const float *last() const { return values + (_rows - 1) * _row_stride + (_cols - 1) * _col_stride; }
+    };
+
+    class MatrixView : public MatrixExpr<MatrixView>
+    {
+        // attributes
+    private:
+        float *values;
+        size_t _rows;
+        size_t _cols;
+        size_t _row_stride;
+        size_t _col_stride;
+
+        // constructors and deconstructor
+    public:
+        MatrixView(float *values, size_t rows, size_t cols, size_t row_stride, size_t col_stride = 1)
+            : values(values), _rows(rows), _cols(cols), _row_stride(row_stride), _col_stride(col_stride) {}
+        MatrixView(Matrix &matrix)
+            : MatrixView(matrix.data(), matrix.rows(), matrix.cols(), matrix.cols()) {}
+        MatrixView(const MatrixView &other) = default;
+
+        operator ConstMatrixView() const { return ConstMatrixView(values, _rows, _cols, _row_stride, _col_stride); }
+
+        // element-wise assignment, the shapes have to match
+        MatrixView &operator=(const MatrixView &other) { return assign(ConstMatrixView(other)); }
+        MatrixView &operator=(const Matrix &other) { return assign(Expr::Ref(other)); }
+        template <typename E>
+        MatrixView &operator=(const MatrixExpr<E> &expr) { return assign(expr.self()); }
+
+        // methods
+    public:
+        size_t rows() const { return _rows; }
+        size_t cols() const { return _cols; }
+        size_t size() const { return _rows * _cols; }
+        size_t row_stride() const { return _row_stride; }
+        size_t col_stride() const { return _col_stride; }
+        float *data() const { return values; }
+        bool is_contiguous() const { return _col_stride == 1 && (_rows <= 1 || _row_stride == _cols); }
+
+        float &operator()(size_t row, size_t col) { return values[row * _row_stride + col * _col_stride]; }
+        float operator()(size_t row, size_t col) const { return values[row * _row_stride + col * _col_stride]; }
+
+        MatrixView &operator+=(const Matrix &other) { return apply(Expr::Ref(other), Expr::Add()); }
+        MatrixView &operator-=(const Matrix &other) { return apply(Expr::Ref(other), Expr::Sub()); }
+        template <typename E>
+        MatrixView &operator+=(const MatrixExpr<E> &expr) { return apply(expr.self(), Expr::Add()); }
+        template <typename E>
+        MatrixView &operator-=(const MatrixExpr<E> &expr) { return apply(expr.self(), Expr::Sub()); }
+        MatrixView &operator*=(float scalar);
+
+        void fill(float value);
+        void swap_rows(size_t row1, size_t row2);
+        void scale_row(size_t row, float scalar);
+        void add_row(size_t target, size_t source, float scalar = 1.0f);
+
+        MatrixView block(size_t row, size_t col, size_t rows, size_t cols) const;
+        MatrixView row(size_t row) const { return block(row, 0, 1, _cols); }
+        MatrixView col(size_t col) const { return block(0, col, _rows, 1); }
+        MatrixView transpose() const { return MatrixView(values, _cols, _rows, _col_stride, _row_stride); }
+
+        bool reads(const float *begin, const float *end) const { return ConstMatrixView(*this).reads(begin, end); }
+        bool aliases(const float *begin, const float *end) const { return reads(begin, end); }
+
+    private:
+        template <typename E>
+        MatrixView &assign(const E &expr);
+        template <typename E, typename Op>
+        MatrixView &apply(const E &expr, Op op);
+        const float *last() const { return values + (_rows - 1) * _row_stride + (_cols - 1) * _col_stride; }
+    };
+
+    namespace Expr
+    {
+        template <>
+        struct IsView<ConstMatrixView> : std::true_type
+        {
+        };
+
+        template <>
+        struct IsView<MatrixView> : std::true_type
+        {
+        };
+    };
+
+    // lhs * rhs, reading both views through their strides. From
+    // Math::GEMM_THRESHOLD on it runs on gemm, which reads views with unit
+    // column stride in place; any other view, a transpose say, is copied first.
+    Matrix multiply(const ConstMatrixView &lhs, const ConstMatrixView &rhs);
+
+    template <typename L, typename R>
+    std::enable_if_t<Expr::is_view_product_v<L, R>, Matrix> operator*(const L &lhs, const R &rhs)
+    {
+        return multiply(ConstMatrixView(lhs), ConstMatrixView(rhs));
+    }
+
+    /*---------------------------Implementation---------------------------*/
+    /*====================================================================*/
+
+    inline MatrixView Matrix::view() { return MatrixView(*this); }
+    inline ConstMatrixView Matrix::view() const { return ConstMatrixView(*this); }
+    inline MatrixView Matrix::block(size_t row, size_t col, size_t rows, size_t cols) { return view().block(row, col, rows, cols); }
+    inline ConstMatrixView Matrix::block(size_t row, size_t col, size_t rows, size_t cols) const { return view().block(row, col, rows, cols); }
+    inline MatrixView Matrix::row(size_t row) { return view().row(row); }
+    inline ConstMatrixView Matrix::row(size_t row) const { return view().row(row); }
+    inline MatrixView Matrix::col(size_t col) { return view().col(col); }
+    inline ConstMatrixView Matrix::col(size_t col) const { return view().col(col); }
+
+    template <typename E>
+    MatrixView &MatrixView::assign(const E &expr)
+    {
+        if (expr.rows() != _rows || expr.cols() != _cols)
+            throw std::runtime_error("MatrixView::operator=: shape mismatch");
+        // the destination may be any strided window, so any overlap goes through a copy
+        if (size() > 0 && expr.reads(values, last() + 1))
+            return assign(Expr::Ref(Matrix(expr)));
+        for (size_t row = 0; row < _rows; ++row)
+        {
+            for (size_t col = 0; col < _cols; ++col)
+                (*this)(row, col) = expr(row, col);
+        }
+        return *this;
+    }
+
+    template <typename E, typename Op>
+    MatrixView &MatrixView::apply(const E &expr, Op op)
+    {
+        if (expr.rows() != _rows || expr.cols() != _cols)
+            throw std::runtime_error("MatrixView: shape mismatch");
+        if (size() > 0 && expr.reads(values, last() + 1))
+            return apply(Expr::Ref(Matrix(expr)), op);
+        for (size_t row = 0; row < _rows; ++row)
+        {
+            for (size_t col = 0; col < _cols; ++col)
+            {
+                float &dst = (*this)(row, col);
+                dst = op.apply(dst, expr(row, col));
+            }
+        }
+        return *this;
+    }
+}; // namespace Core
+
+#endif // CORE_MATRIX_VIEW_H
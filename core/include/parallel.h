@@ -0,0 +1,358 @@
+#pragma once
+#ifndef CORE_PARALLEL_H
+#define CORE_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "jobs.h"
+
+namespace Core::Parallel
+{
+    // Algorithms over contiguous arrays, in the pointer + size style of
+    // Tools::binary_search. The input is cut into chunks of GRAIN elements that run
+    // as Core::Jobs; with a single chunk everything stays on the calling thread.
+    // Chunk boundaries never depend on the thread count, so a reduce or scan with
+    // an op that is only nearly associative (float addition) gives the same result on
+    // any machine. Sorts and partition are stable and need a temporary copy of the
+    // data, so T must be default constructible and move assignable.
+
+    constexpr size_t GRAIN = size_t(1) << 15;
+
+    // init op data[0] op data[1] ..., `op` must be associative
+    template <typename T, typename Op = std::plus<T>>
+    T reduce(const T *data, size_t size, T init = T(), Op op = Op());
+
+    // out[i] = in[0] op ... op in[i]; `out` may be `in`
+    template <typename T, typename Op = std::plus<T>>
+    void inclusive_scan(const T *in, T *out, size_t size, Op op = Op());
+
+    // out[0] = init, out[i] = init op in[0] op ... op in[i - 1]; `out` may be `in`
+    template <typename T, typename Op = std::plus<T>>
+    void exclusive_scan(const T *in, T *out, size_t size, T init = T(), Op op = Op());
+
+    // moves the elements satisfying `pred` to the front keeping the relative order on
+    // both sides, returns how many there are
+    template <typename T, typename Predicate>
+    size_t partition(T *data, size_t size, Predicate pred);
+
+    // stable merge sort: chunks are sorted on their own, then merged pairwise with
+    // every merge split along its merge path so that all threads take part
+    template <typename T, typename Comparator = std::less<T>>
+    void merge_sort(T *data, size_t size, Comparator comp = Comparator());
+
+    // stable LSD radix sort on 8 bit digits for unsigned 32 and 64 bit keys, digits
+    // that are the same for every key (the high bytes of small keys) are skipped.
+    // `values` (may be null) are permuted along with the keys.
+    template <typename Key, typename Value>
+    void radix_sort(Key *keys, Value *values, size_t size);
+    template <typename Key>
+    void radix_sort(Key *keys, size_t size);
+
+    /*---Implementation---*/
+    namespace detail
+    {
+        inline size_t chunk_count(size_t size, size_t grain = GRAIN)
+        {
+            return (size + grain - 1) / grain;
+        }
+
+        // f(chunk) for every chunk in [0, chunks)
+        template <typename F>
+        void for_chunks(size_t chunks, F &&f)
+        {
+            Jobs::parallel_for(0, chunks, 1, [&](size_t begin, size_t end)
+                               {
+                for (size_t c = begin; c < end; ++c)
+                    f(c); });
+        }
+
+        // elements of `a` among the first `d` of the stable merge of a and b
+        template <typename T, typename Comparator>
+        size_t co_rank(size_t d, const T *a, size_t m, const T *b, size_t n, Comparator &comp)
+        {
+            size_t lo = d > n ? d - n : 0;
+            size_t hi = std::min(d, m);
+            while (lo < hi)
+            {
+                const size_t i = lo + (hi - lo) / 2;
+                // ties go to a, so a[i] is taken only if b[d - i - 1] is not smaller
+                if (comp(b[d - i - 1], a[i]))
+                    hi = i;
+                else
+                    lo = i + 1;
+            }
+            return lo;
+        }
+    }
+
+    template <typename T, typename Op>
+    T reduce(const T *data, size_t size, T init, Op op)
+    {
+        const size_t chunks = detail::chunk_count(size);
+        if (chunks <= 1)
+        {
+            for (size_t i = 0; i < size; ++i)
+                init = op(init, data[i]);
+            return init;
+        }
+        std::vector<T> partial(chunks);
+        detail::for_chunks(chunks, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+            T acc = data[begin];
+            for (size_t i = begin + 1; i < end; ++i)
+                acc = op(acc, data[i]);
+            partial[c] = acc; });
+        for (const auto &p : partial)
+            init = op(init, p);
+        return init;
+    }
+
+    template <typename T, typename Op>
+    void inclusive_scan(const T *in, T *out, size_t size, Op op)
+    {
+        if (size == 0)
+            return;
+        const size_t chunks = detail::chunk_count(size);
+        if (chunks == 1)
+        {
+            T acc = in[0];
+            out[0] = acc;
+            for (size_t i = 1; i < size; ++i)
+            {
+                acc = op(acc, in[i]);
+                out[i] = acc;
+            }
+            return;
+        }
+        // sum of every chunk but the last, then the carry into every chunk
+        std::vector<T> carry(chunks);
+        detail::for_chunks(chunks - 1, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = begin + GRAIN;
+            T acc = in[begin];
+            for (size_t i = begin + 1; i < end; ++i)
+                acc = op(acc, in[i]);
+            carry[c + 1] = acc; });
+        for (size_t c = 2; c < chunks; ++c)
+            carry[c] = op(carry[c - 1], carry[c]);
+        detail::for_chunks(chunks, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+            T acc = c == 0 ? in[begin] : op(carry[c], in[begin]);
+            out[begin] = acc;
+            for (size_t i = begin + 1; i < end; ++i)
+            {
+                acc = op(acc, in[i]);
+                out[i] = acc;
+            } });
+    }
+
+    template <typename T, typename Op>
+    void exclusive_scan(const T *in, T *out, size_t size, T init, Op op)
+    {
+        const size_t chunks = detail::chunk_count(size);
+        if (chunks <= 1)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                T next = op(init, in[i]);
+                out[i] = std::move(init);
+                init = std::move(next);
+            }
+            return;
+        }
+        std::vector<T> carry(chunks);
+        carry[0] = init;
+        detail::for_chunks(chunks - 1, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = begin + GRAIN;
+            T acc = in[begin];
+            for (size_t i = begin + 1; i < end; ++i)
+                acc = op(acc, in[i]);
+            carry[c + 1] = acc; });
+        for (size_t c = 1; c < chunks; ++c)
+            carry[c] = op(carry[c - 1], carry[c]);
+        detail::for_chunks(chunks, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+            T acc = carry[c];
+            for (size_t i = begin; i < end; ++i)
+            {
+                T next = op(acc, in[i]);
+                out[i] = std::move(acc);
+                acc = std::move(next);
+            } });
+    }
+
+    template <typename T, typename Predicate>
+    size_t partition(T *data, size_t size, Predicate pred)
+    {
+        const size_t chunks = detail::chunk_count(size);
+        if (chunks <= 1)
+            return static_cast<size_t>(std::stable_partition(data, data + size, pred) - data);
+
+        // the predicate runs once per element, its result is kept for the scatter
+        std::vector<uint8_t> flags(size);
+        std::vector<size_t> front(chunks + 1, 0), back(chunks + 1, 0);
+        detail::for_chunks(chunks, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+            size_t count = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                flags[i] = pred(data[i]) ? 1 : 0;
+                count += flags[i];
+            }
+            front[c + 1] = count;
+            back[c + 1] = end - begin - count; });
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            front[c + 1] += front[c];
+            back[c + 1] += back[c];
+        }
+        const size_t rslt = front[chunks];
+
+        std::vector<T> buffer(size);
+        detail::for_chunks(chunks, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+            size_t f = front[c], b = rslt + back[c];
+            for (size_t i = begin; i < end; ++i)
+                buffer[flags[i] ? f++ : b++] = std::move(data[i]); });
+        detail::for_chunks(chunks, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+            std::move(buffer.begin() + begin, buffer.begin() + end, data + begin); });
+        return rslt;
+    }
+
+    template <typename T, typename Comparator>
+    void merge_sort(T *data, size_t size, Comparator comp)
+    {
+        const size_t chunks = detail::chunk_count(size);
+        if (chunks <= 1)
+        {
+            std::stable_sort(data, data + size, comp);
+            return;
+        }
+        detail::for_chunks(chunks, [&](size_t c)
+                           {
+            const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+            std::stable_sort(data + begin, data + end, comp); });
+
+        std::vector<T> buffer(size);
+        T *src = data, *dst = buffer.data();
+        for (size_t width = GRAIN; width < size; width *= 2)
+        {
+            // runs are multiples of GRAIN, so every output chunk lies inside one
+            // merge and finds its inputs by two searches along the merge path
+            detail::for_chunks(chunks, [&](size_t c)
+                               {
+                const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+                const size_t lo = begin / (2 * width) * (2 * width);
+                const size_t mid = std::min(size, lo + width), hi = std::min(size, lo + 2 * width);
+                const T *a = src + lo, *b = src + mid;
+                const size_t m = mid - lo, n = hi - mid;
+                const size_t i0 = detail::co_rank(begin - lo, a, m, b, n, comp);
+                const size_t i1 = detail::co_rank(end - lo, a, m, b, n, comp);
+                const size_t j0 = begin - lo - i0, j1 = end - lo - i1;
+                std::merge(std::make_move_iterator(a + i0), std::make_move_iterator(a + i1),
+                           std::make_move_iterator(b + j0), std::make_move_iterator(b + j1),
+                           dst + begin, comp); });
+            std::swap(src, dst);
+        }
+        if (src != data)
+        {
+            detail::for_chunks(chunks, [&](size_t c)
+                               {
+                const size_t begin = c * GRAIN, end = std::min(size, begin + GRAIN);
+                std::move(src + begin, src + end, data + begin); });
+        }
+    }
+
+    template <typename Key, typename Value>
+    void radix_sort(Key *keys, Value *values, size_t size)
+    {
+        static_assert(std::is_unsigned_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8),
+                      "radix_sort: keys must be 32 or 64 bit unsigned integers");
+        if (size < 2)
+            return;
+        // a few chunks per thread, the histograms cost 256 counters per chunk
+        const size_t threads = Jobs::get_worker_count() + 1;
+        const size_t grain = std::max(GRAIN, (size + 4 * threads - 1) / (4 * threads));
+        const size_t chunks = detail::chunk_count(size, grain);
+
+        std::vector<Key> key_buffer(size);
+        std::vector<Value> value_buffer(values ? size : 0);
+        Key *src_keys = keys, *dst_keys = key_buffer.data();
+        Value *src_values = values, *dst_values = values ? value_buffer.data() : nullptr;
+        std::vector<size_t> counts(chunks * 256);
+
+        for (unsigned shift = 0; shift < sizeof(Key) * 8; shift += 8)
+        {
+            detail::for_chunks(chunks, [&](size_t c)
+                               {
+                size_t *count = counts.data() + c * 256;
+                std::fill(count, count + 256, size_t(0));
+                const size_t begin = c * grain, end = std::min(size, begin + grain);
+                for (size_t i = begin; i < end; ++i)
+                    ++count[(src_keys[i] >> shift) & 0xff]; });
+
+            // offsets digit by digit, chunk by chunk within a digit, which keeps it stable
+            size_t offset = 0;
+            bool skip = false;
+            for (size_t digit = 0; digit < 256 && !skip; ++digit)
+            {
+                const size_t first = offset;
+                for (size_t c = 0; c < chunks; ++c)
+                {
+                    const size_t count = counts[c * 256 + digit];
+                    counts[c * 256 + digit] = offset;
+                    offset += count;
+                }
+                skip = offset - first == size;
+            }
+            if (skip)
+                continue;
+
+            detail::for_chunks(chunks, [&](size_t c)
+                               {
+                size_t *offsets = counts.data() + c * 256;
+                const size_t begin = c * grain, end = std::min(size, begin + grain);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const size_t pos = offsets[(src_keys[i] >> shift) & 0xff]++;
+                    dst_keys[pos] = src_keys[i];
+                    if (src_values)
+                        dst_values[pos] = std::move(src_values[i]);
+                } });
+            std::swap(src_keys, dst_keys);
+            std::swap(src_values, dst_values);
+        }
+
+        if (src_keys != keys)
+        {
+            detail::for_chunks(chunks, [&](size_t c)
+                               {
+                const size_t begin = c * grain, end = std::min(size, begin + grain);
+                std::copy(src_keys + begin, src_keys + end, keys + begin);
+                if (values)
+                    std::move(src_values + begin, src_values + end, values + begin); });
+        }
+    }
+
+    template <typename Key>
+    void radix_sort(Key *keys, size_t size)
+    {
+        radix_sort<Key, uint8_t>(keys, nullptr, size);
+    }
+    /*====*/
+} // namespace Core::Parallel
+
+#endif // CORE_PARALLEL_H
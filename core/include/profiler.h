@@ -0,0 +1,128 @@
+#pragma once
+#ifndef CORE_PROFILER_H
+#define CORE_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Core::Profiler
+{
+    // Scoped CPU timing. A Scope reads a nanosecond steady clock when it opens
+    // and closes and appends one Event to a buffer owned by its thread; the
+    // buffer is handed over, under a lock nobody else contends for, only when
+    // the thread's outermost scope closes. new_frame() collects the events of
+    // all threads into the finished frame, keeps the last frames for the
+    // widgets and, while capturing, everything for export as a Chrome trace
+    // (chrome://tracing, ui.perfetto.dev).
+    //
+    // Use the CORE_PROFILE_* macros, they compile to nothing unless CORE_PROFILER
+    // is defined (the CORE_ENABLE_PROFILER CMake option). Names are not copied
+    // and have to outlive the profiler, string literals or __func__.
+
+    struct Event
+    {
+        const char *name;
+        uint64_t start; // ns, see now()
+        uint64_t end;
+        uint32_t thread;
+        uint32_t depth; // 0 for the outermost scope of its thread
+    };
+
+    struct Frame
+    {
+        uint64_t index = 0;
+        uint64_t start = 0;
+        uint64_t end = 0;
+        uint32_t thread = 0; // the one calling new_frame
+        // ordered by thread, then start
+        std::vector<Event> events;
+
+        double duration_ms() const { return (end - start) * 1e-6; }
+    };
+
+    struct Frame_Stats
+    {
+        size_t count = 0;
+        double mean = 0;
+        double p50 = 0;
+        double p95 = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    class Scope
+    {
+        // attributes
+    private:
+        const char *name;
+        uint64_t start;
+        bool active;
+
+        // constructors and deconstructor
+    public:
+        explicit Scope(const char *name);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    uint64_t now();
+
+    // runtime switch on top of the compile time one, scopes opened while off are not recorded
+    void set_enabled(bool enabled);
+    bool is_enabled();
+
+    // closes the current frame and starts the next one; call once per frame from one thread
+    void new_frame();
+    // drops all kept frames, frame times and the capture
+    void reset();
+
+    // shown in the trace instead of "Thread <id>"; `name` is copied
+    void set_thread_name(const std::string &name);
+    std::string get_thread_name(uint32_t thread);
+
+    // Timings measured elsewhere, e.g. by GPU queries, go to a track of their own
+    // that is shown like a thread. They can be submitted after their frame has
+    // finished, to the kept frame and the capture; false once the frame is gone.
+    uint32_t create_track(const std::string &name);
+    // the frame being recorded, events submitted for it are added when it finishes
+    uint64_t get_frame_index();
+    bool submit(uint64_t frame_index, const std::vector<Event> &events);
+
+    // frames kept for get_frame, frame times kept for get_frame_stats
+    void set_history_size(size_t frames);
+    size_t get_history_size();
+    size_t get_frame_count();
+    // `age` 0 is the last finished frame; false if it is no longer kept
+    bool get_frame(size_t age, Frame &frame);
+    // durations in ms of the kept frames, oldest first
+    std::vector<float> get_frame_times();
+    Frame_Stats get_frame_stats();
+    // nearest-rank percentile, p in [0, 100]; `values` is reordered
+    double percentile(std::vector<double> &values, double p);
+
+    void start_capture();
+    void stop_capture();
+    bool is_capturing();
+    size_t get_capture_frame_count();
+    // the captured frames in the Chrome trace event format
+    std::string chrome_trace();
+    void write_chrome_trace(const std::string &path);
+} // namespace Core::Profiler
+
+#define CORE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CORE_PROFILE_CONCAT(a, b) CORE_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef CORE_PROFILER
+#define CORE_PROFILE_SCOPE(name) ::Core::Profiler::Scope CORE_PROFILE_CONCAT(core_profile_scope_, __COUNTER__)(name)
+#define CORE_PROFILE_FUNCTION() CORE_PROFILE_SCOPE(__func__)
+#define CORE_PROFILE_FRAME() ::Core::Profiler::new_frame()
+#else
+#define CORE_PROFILE_SCOPE(name) ((void)0)
+#define CORE_PROFILE_FUNCTION() ((void)0)
+#define CORE_PROFILE_FRAME() ((void)0)
+#endif
+
+#endif // CORE_PROFILER_H
@@ -2,13 +2,14 @@
 #ifndef QUATERNION_H
 #define QUATERNION_H
 
-#include "matrix.h"
-#include "vector.h"
+#include <tuple>
+#include <type_traits>
+#include "fixed_matrix.h"
 #include "geometry/general.h"
 
 namespace Core
 {
-    class Quaternion
+    class alignas(16) Quaternion
     {
         // attributes
     public:
@@ -16,12 +17,7 @@ namespace Core
 
         // constructors and deconstructor
     public:
-        Quaternion(float w = 1, float x = 0, float y = 0, float z = 0);
-        Quaternion(const Quaternion &other);
-        Quaternion &operator=(const Quaternion &other);
-        Quaternion(Quaternion &&other);
-        Quaternion &operator=(Quaternion &&other);
-        ~Quaternion();
+        constexpr Quaternion(float w = 1, float x = 0, float y = 0, float z = 0) : w(w), x(x), y(y), z(z) {}
         // methods
     public:
         Quaternion operator+(const Quaternion &other) const;
@@ -37,9 +33,9 @@ namespace Core
 
         bool operator!=(const Quaternion &other) const;
 
-        Vector3 operator*(const Vector3 &vector) const;
-        Vector4 operator*(const Vector4 &vector) const;
-        Matrix4 operator*(const Matrix4 &matrix) const;
+        Vec3 operator*(const Vec3 &vector) const;
+        Vec4 operator*(const Vec4 &vector) const;
+        Mat4 operator*(const Mat4 &matrix) const;
 
         // quaternion operations
         Quaternion &normalize();
@@ -47,9 +43,9 @@ namespace Core
         Quaternion inverse() const;
 
         // conversion
-        Matrix4 to_matrix4() const;
-        Matrix3 to_matrix3() const;
-        std::tuple<Vector3, float> to_axis_angle() const;
+        Mat4 to_matrix4() const;
+        Mat3 to_matrix3() const;
+        std::tuple<Vec3, float> to_axis_angle() const;
         float yaw() const;
         float pitch() const;
         float roll() const;
@@ -58,15 +54,18 @@ namespace Core
         // static methods
     public:
         static float dot(const Quaternion &a, const Quaternion &b);
-        static Quaternion identity() { return Quaternion(1, 0, 0, 0); }
+        static constexpr Quaternion identity() { return Quaternion(1, 0, 0, 0); }
         static Quaternion from_euler_angle(float pitch, float yaw, float roll);
         static Quaternion from_euler_angle(const EulerAngle &euler_angle);
-        static Quaternion from_axis_angle(const Vector3 &axis, float angle_rad);
-        static Quaternion from_matrix(const Matrix4 &mat);
-        static Quaternion from_matrix(const Matrix3 &mat);
-        static Quaternion from_basis_vector(const Vector3 &front, const Vector3 &up, const Vector3 &right);
+        static Quaternion from_axis_angle(const Vec3 &axis, float angle_rad);
+        static Quaternion from_matrix(const Mat4 &mat);
+        static Quaternion from_matrix(const Mat3 &mat);
+        static Quaternion from_basis_vector(const Vec3 &front, const Vec3 &up, const Vec3 &right);
     };
 
+    using Quat = Quaternion;
+    static_assert(std::is_trivially_copyable_v<Quat>, "Quaternion must be trivially copyable");
+
 };
 
 #endif // !QUATERNION_H
\ No newline at end of file
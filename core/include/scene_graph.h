@@ -0,0 +1,116 @@
+#pragma once
+#ifndef CORE_SCENE_GRAPH_H
+#define CORE_SCENE_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "configurable.h"
+#include "fixed_matrix.h"
+#include "transform.h"
+
+namespace Core
+{
+    // Parent/child hierarchy of transforms. The world matrix of a node is its local
+    // model matrix followed by its parent's world matrix (row vectors, translation in
+    // row 3): world = local * parent_world.
+    // Nodes are addressed by stable handles. Internally they live in one flat array
+    // sorted breadth-first, so every depth is a contiguous range that only reads the
+    // range before it: update() walks the levels in order and splits each large level
+    // across threads. Only nodes whose transform changed since the last update, and
+    // their subtrees, are recomputed. Changing the hierarchy re-sorts the array on the
+    // next update() and recomputes everything once.
+    // The graph does not own the transforms, they must outlive their nodes.
+    // Several nodes may share one transform: update() fills its cached matrices
+    // before the threads start, so workers never write to it. Anything else
+    // that reads a transform during update() must not be the first to do so
+    // after a change.
+    class Scene_Graph
+    {
+        // structures
+    public:
+        using Node = uint32_t;
+        static constexpr Node NONE = std::numeric_limits<Node>::max();
+
+    private:
+        struct Record
+        {
+            Node parent = NONE;
+            const Transform *local = nullptr;
+            Configurable *object = nullptr;
+            std::vector<Node> children;
+            uint32_t slot = 0;
+            bool alive = false;
+        };
+
+        // attributes
+    private:
+        std::vector<Record> records; // by handle
+        std::vector<Node> free_nodes;
+        std::vector<Node> roots;
+        size_t node_count = 0;
+
+        // by slot, breadth-first
+        std::vector<Node> order;
+        std::vector<uint32_t> parent_slots;
+        std::vector<const Transform *> locals;
+        std::vector<Mat4> world;
+        std::vector<Mat3> world_normal;
+        std::vector<uint8_t> changed;
+        std::vector<size_t> levels; // first slot of every depth, plus the end
+        std::vector<const Transform *> shared_locals; // on more than one node
+
+        bool layout_dirty = false;
+        uint64_t stamp = 0; // Transform::current_version() at the last update
+
+        // constructors and deconstructor
+    public:
+        Scene_Graph() = default;
+        ~Scene_Graph() = default;
+
+        // methods
+    public:
+        // `local` may be null for a pure group node (identity), `object` is what the
+        // node stands for and is only kept for the editor
+        Node create(const Transform *local, Node parent = NONE, Configurable *object = nullptr);
+        // the children of a destroyed node move up to its parent
+        void destroy(Node node);
+        // NONE makes the node a root, throws if `parent` is the node or one of its descendants
+        void set_parent(Node node, Node parent);
+        void set_transform(Node node, const Transform *local);
+
+        bool contains(Node node) const { return node < records.size() && records[node].alive; }
+        size_t size() const { return node_count; }
+        Node get_parent(Node node) const;
+        // children of `node`, the roots for NONE
+        const std::vector<Node> &get_children(Node node) const;
+        Configurable *get_object(Node node) const;
+        const Transform *get_transform(Node node) const;
+        bool is_ancestor(Node ancestor, Node node) const;
+        // root nodes have depth 0
+        size_t get_depth(Node node) const;
+
+        // recomputes dirty world matrices, returns how many were recomputed
+        size_t update();
+        // as of the last update()
+        const Mat4 &get_world_matrix(Node node) const;
+        const Mat3 &get_world_normal_matrix(Node node) const;
+        Vec3 get_world_position(Node node) const;
+        // true if the world matrix was recomputed by the last update()
+        bool is_changed(Node node) const;
+
+    private:
+        const Record &record(Node node, const char *method) const;
+        uint32_t slot(Node node, const char *method) const;
+        void detach(Node node);
+        void rebuild();
+        size_t update_range(size_t begin, size_t end, bool root, bool all);
+    };
+
+    // threads used by Scene_Graph::update, 0 (default) means one per hardware thread
+    void set_scene_graph_threads(size_t threads);
+    size_t get_scene_graph_threads();
+} // namespace Core
+
+#endif // CORE_SCENE_GRAPH_H
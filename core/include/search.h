@@ -0,0 +1,258 @@
+#pragma once
+#ifndef CORE_SEARCH_H
+#define CORE_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "jobs.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CORE_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define CORE_PREFETCH(address) ((void)0)
+#endif
+
+namespace Core::Search
+{
+    // Lookups into sorted tables. All searches return positions in the sorted
+    // order: lower_bound is the first element not less than the key (size if there
+    // is none), find is the position of an equal element or NOT_FOUND.
+    //  - lower_bound on a plain sorted array is branchless: the loop only shrinks a
+    //    length and the compare becomes a conditional move, both candidates for the
+    //    next probe are prefetched, and the last few uint32_t/float keys are counted
+    //    with SIMD compares.
+    //  - Eytzinger stores the keys in breadth-first tree order, so the first levels
+    //    share cache lines and the 16 descendants four levels down are one prefetch.
+    //    It wins over the plain array once the table no longer fits in cache.
+    //  - the batched overloads walk several keys in lockstep so their cache misses
+    //    overlap, large batches are split across Core::Jobs.
+
+    constexpr size_t NOT_FOUND = std::numeric_limits<size_t>::max();
+
+    // keys less than `key` in a small sorted block, i.e. its lower_bound; AVX/AVX2
+    // when the SIMD backend allows it. NaN keys are not supported.
+    size_t lower_bound_block(const uint32_t *data, size_t size, uint32_t key);
+    size_t lower_bound_block(const float *data, size_t size, float key);
+
+    template <typename T, typename Comparator = std::less<T>>
+    size_t lower_bound(const T *data, size_t size, const T &key, Comparator comp = Comparator());
+    template <typename T, typename Comparator = std::less<T>>
+    size_t find(const T *data, size_t size, const T &key, Comparator comp = Comparator());
+    // out[i] = lower_bound(data, size, keys[i])
+    template <typename T, typename Comparator = std::less<T>>
+    void lower_bound(const T *data, size_t size, const T *keys, size_t count, size_t *out, Comparator comp = Comparator());
+
+    // static sorted set in Eytzinger (breadth-first) order, built once from sorted keys
+    template <typename T, typename Comparator = std::less<T>>
+    class Eytzinger
+    {
+        // attributes
+    private:
+        std::vector<T> tree;       // 1-based, tree[0] is unused
+        std::vector<size_t> ranks; // tree position -> sorted position, ranks[0] = size
+        Comparator comp;
+
+        // constructors and deconstructor
+    public:
+        Eytzinger(Comparator comp = Comparator()) : tree(1), ranks(1, 0), comp(comp) {}
+        // `sorted` has to be sorted by `comp`
+        Eytzinger(const T *sorted, size_t size, Comparator comp = Comparator());
+
+        // methods
+    public:
+        size_t size() const { return tree.size() - 1; }
+        bool empty() const { return size() == 0; }
+        size_t lower_bound(const T &key) const { return ranks[lower_bound_node(key)]; }
+        size_t find(const T &key) const;
+        bool contains(const T &key) const { return find(key) != NOT_FOUND; }
+        // out[i] = lower_bound(keys[i])
+        void lower_bound(const T *keys, size_t count, size_t *out) const;
+
+    private:
+        size_t fill(const T *sorted, size_t i, size_t k);
+        size_t lower_bound_node(const T &key) const;
+        void lower_bound_group(const T *keys, size_t count, size_t *out) const;
+    };
+
+    /*---Implementation---*/
+    namespace detail
+    {
+        // keys walked in lockstep by the batched searches
+        constexpr size_t GROUP = 8;
+        // keys per job in a large batch
+        constexpr size_t BATCH_GRAIN = 4096;
+        // elements left for lower_bound_block at the end of a search
+        constexpr size_t BLOCK = 16;
+
+        template <typename T, typename Comparator>
+        constexpr bool has_block_search = (std::is_same_v<T, uint32_t> || std::is_same_v<T, float>) &&
+                                          std::is_same_v<Comparator, std::less<T>>;
+
+        inline void prefetch(const void *base, size_t offset)
+        {
+            // may point past the end, it is only a hint and never dereferenced
+            CORE_PREFETCH(reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(base) + offset));
+        }
+
+        // drops the trailing ones of k and the zero before them
+        inline size_t climb(size_t k)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return k >> __builtin_ffsll(static_cast<long long>(~k));
+#else
+            while (k & 1)
+                k >>= 1;
+            return k >> 1;
+#endif
+        }
+    }
+
+    template <typename T, typename Comparator>
+    size_t lower_bound(const T *data, size_t size, const T &key, Comparator comp)
+    {
+        if (size == 0)
+            return 0;
+        const T *base = data;
+        size_t n = size;
+        constexpr size_t stop = detail::has_block_search<T, Comparator> ? detail::BLOCK : 1;
+        while (n > stop)
+        {
+            const size_t half = n / 2;
+            detail::prefetch(base, (half / 2) * sizeof(T));
+            detail::prefetch(base, (half + half / 2) * sizeof(T));
+            base = comp(base[half], key) ? base + half : base;
+            n -= half;
+        }
+        if constexpr (detail::has_block_search<T, Comparator>)
+            return (base - data) + lower_bound_block(base, n, key);
+        else
+            return (base - data) + (comp(*base, key) ? 1 : 0);
+    }
+
+    template <typename T, typename Comparator>
+    size_t find(const T *data, size_t size, const T &key, Comparator comp)
+    {
+        const size_t i = lower_bound(data, size, key, comp);
+        return i < size && !comp(key, data[i]) ? i : NOT_FOUND;
+    }
+
+    template <typename T, typename Comparator>
+    void lower_bound(const T *data, size_t size, const T *keys, size_t count, size_t *out, Comparator comp)
+    {
+        Jobs::parallel_for(0, count, detail::BATCH_GRAIN, [&](size_t begin, size_t end)
+                           {
+            for (size_t g = begin; g < end; g += detail::GROUP)
+            {
+                const size_t m = std::min(detail::GROUP, end - g);
+                if (size == 0 || m < detail::GROUP)
+                {
+                    for (size_t i = g; i < end; ++i)
+                        out[i] = lower_bound(data, size, keys[i], comp);
+                    continue;
+                }
+                // the sequence of lengths only depends on size, so the keys move in lockstep
+                const T *base[detail::GROUP];
+                for (size_t j = 0; j < detail::GROUP; ++j)
+                    base[j] = data;
+                size_t n = size;
+                while (n > 1)
+                {
+                    const size_t half = n / 2;
+                    for (size_t j = 0; j < detail::GROUP; ++j)
+                        detail::prefetch(base[j], half * sizeof(T));
+                    for (size_t j = 0; j < detail::GROUP; ++j)
+                        base[j] = comp(base[j][half], keys[g + j]) ? base[j] + half : base[j];
+                    n -= half;
+                }
+                for (size_t j = 0; j < detail::GROUP; ++j)
+                    out[g + j] = (base[j] - data) + (comp(*base[j], keys[g + j]) ? 1 : 0);
+            } });
+    }
+
+    template <typename T, typename Comparator>
+    Eytzinger<T, Comparator>::Eytzinger(const T *sorted, size_t size, Comparator comp)
+        : tree(size + 1), ranks(size + 1), comp(comp)
+    {
+        ranks[0] = size;
+        fill(sorted, 0, 1);
+    }
+
+    // in-order walk of the implicit tree hands out the sorted keys
+    template <typename T, typename Comparator>
+    size_t Eytzinger<T, Comparator>::fill(const T *sorted, size_t i, size_t k)
+    {
+        if (k < tree.size())
+        {
+            i = fill(sorted, i, 2 * k);
+            tree[k] = sorted[i];
+            ranks[k] = i++;
+            i = fill(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    template <typename T, typename Comparator>
+    size_t Eytzinger<T, Comparator>::lower_bound_node(const T &key) const
+    {
+        const size_t n = size();
+        // 64 bytes of keys per cache line, four levels down the 16 descendants of
+        // k start at 16k, for 4 byte keys that is exactly one line
+        constexpr size_t ahead = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+        size_t k = 1;
+        while (k <= n)
+        {
+            detail::prefetch(tree.data(), k * ahead * sizeof(T));
+            k = 2 * k + (comp(tree[k], key) ? 1 : 0);
+        }
+        return detail::climb(k);
+    }
+
+    template <typename T, typename Comparator>
+    size_t Eytzinger<T, Comparator>::find(const T &key) const
+    {
+        const size_t k = lower_bound_node(key);
+        return k != 0 && !comp(key, tree[k]) ? ranks[k] : NOT_FOUND;
+    }
+
+    template <typename T, typename Comparator>
+    void Eytzinger<T, Comparator>::lower_bound(const T *keys, size_t count, size_t *out) const
+    {
+        Jobs::parallel_for(0, count, detail::BATCH_GRAIN, [&](size_t begin, size_t end)
+                           {
+            for (size_t g = begin; g < end; g += detail::GROUP)
+                lower_bound_group(keys + g, std::min(detail::GROUP, end - g), out + g); });
+    }
+
+    template <typename T, typename Comparator>
+    void Eytzinger<T, Comparator>::lower_bound_group(const T *keys, size_t count, size_t *out) const
+    {
+        const size_t n = size();
+        size_t k[detail::GROUP];
+        for (size_t j = 0; j < count; ++j)
+            k[j] = 1;
+        // every key needs at most depth steps, the ones done early just wait
+        bool active = n > 0;
+        while (active)
+        {
+            active = false;
+            for (size_t j = 0; j < count; ++j)
+            {
+                if (k[j] <= n)
+                {
+                    k[j] = 2 * k[j] + (comp(tree[k[j]], keys[j]) ? 1 : 0);
+                    detail::prefetch(tree.data(), k[j] * sizeof(T));
+                    active |= k[j] <= n;
+                }
+            }
+        }
+        for (size_t j = 0; j < count; ++j)
+            out[j] = ranks[detail::climb(k[j])];
+    }
+    /*====*/
+} // namespace Core::Search
+
+#endif // CORE_SEARCH_H
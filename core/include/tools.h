@@ -7,6 +7,7 @@
 #include <memory>
 #include <fstream>
 #include <sstream>
+#include "search.h"
 
 namespace Core::Tools
 {
@@ -17,28 +18,13 @@ namespace Core::Tools
     void str_replace(std::string &str, const std::string &from, const std::string &to);
     char* str_replace(char* str, char* from, char* to);
 
-    template <typename T, typename Comparator>
-    unsigned int binary_search(const T *arr, unsigned int size, const T &target)
+    using Search::NOT_FOUND;
+
+    // index of an element equal to `target` in the sorted `arr`, NOT_FOUND if there is none
+    template <typename T, typename Comparator = std::less<T>>
+    size_t binary_search(const T *arr, size_t size, const T &target)
     {
-        unsigned int l = 0;
-        unsigned int r = size - 1;
-        while (l <= r)
-        {
-            unsigned int mid = (l + r) / 2;
-            if (Comparator()(arr[mid], target))
-            {
-                l = mid + 1;
-            }
-            else if (Comparator()(target, arr[mid]))
-            {
-                r = mid - 1;
-            }
-            else
-            {
-                return mid;
-            }
-        }
-        return -1;
+        return Search::find(arr, size, target, Comparator());
     }
 }
 #endif // CORE_TOOLS_H
\ No newline at end of file
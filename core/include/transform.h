@@ -2,8 +2,9 @@
 #ifndef TRANSFORM_H
 #define TRANSFORM_H
 
+#include <cstdint>
 #include <memory>
-#include "vector.h"
+#include "fixed_matrix.h"
 #include "geometry/general.h"
 #include "quaternion.h"
 
@@ -15,40 +16,40 @@ namespace Core
     using Transform_W_Ptr = Transform_U_Ptr;
     using Transform_Ptr = Transform_U_Ptr;
 
-    const Vector3 WORLD_UP = Vector3(0.0f, 1.0f, 0.0f);
-    const Vector3 WORLD_RIGHT = Vector3(-1.0f, 0.0f, 0.0f);
-    const Vector3 WORLD_FRONT = Vector3(0.0f, 0.0f, 1.0f);
+    constexpr Vec3 WORLD_UP = Vec3(0.0f, 1.0f, 0.0f);
+    constexpr Vec3 WORLD_RIGHT = Vec3(-1.0f, 0.0f, 0.0f);
+    constexpr Vec3 WORLD_FRONT = Vec3(0.0f, 0.0f, 1.0f);
     class Transform
     {
     public:
-        Transform(const Vector3 &pos = Vector3(0.0f, 0.0f, 0.0f), const EulerAngle &euler_angle = {0, 0, 0}, const Vector3 &scale = Vector3(1.0, 1.0, 1.0));
+        Transform(const Vec3 &pos = Vec3(0.0f, 0.0f, 0.0f), const EulerAngle &euler_angle = {0, 0, 0}, const Vec3 &scale = Vec3(1.0, 1.0, 1.0));
         Transform(const Transform &transform);
         Transform &operator=(const Transform &transform);
         Transform(Transform &&transform);
         Transform &operator=(Transform &&transform);
 
-        Transform(const Vector3 &pos, const Vector3 &front, const Vector3 &up, const Vector3 &scale = Vector3(1.0, 1.0, 1.0));
+        Transform(const Vec3 &pos, const Vec3 &front, const Vec3 &up, const Vec3 &scale = Vec3(1.0, 1.0, 1.0));
         ~Transform();
 
-        void set_position(Vector3 position);
+        void set_position(Vec3 position);
         void set_position(float x, float y, float z);
 
         void set_orientation(Quaternion rotation);
         void set_orientation(const EulerAngle &euler_angle);
-        void set_orientation(const Vector3 &front, const Vector3 &up);
-        void look_at(const Vector3 &front, const Vector3 &up);
-        void look_at(const Vector3 &target);
+        void set_orientation(const Vec3 &front, const Vec3 &up);
+        void look_at(const Vec3 &front, const Vec3 &up);
+        void look_at(const Vec3 &target);
 
-        void set_front(Vector3 front);
+        void set_front(Vec3 front);
         void set_front(float x, float y, float z);
 
-        void set_up(Vector3 up);
+        void set_up(Vec3 up);
         void set_up(float x, float y, float z);
 
-        void set_right(Vector3 right);
+        void set_right(Vec3 right);
         void set_right(float x, float y, float z);
 
-        void set_scale(Vector3 scale);
+        void set_scale(Vec3 scale);
         void set_scale(float x, float y, float z);
         void set_scale(float scale);
 
@@ -60,43 +61,61 @@ namespace Core
         void move_left(float distance){ move_right(-distance);}
         void move_down(float distance){ move_up(-distance);}
 
-        void move(Vector3 direction, float distance);
+        void move(Vec3 direction, float distance);
 
-        void move_around_vertically(Vector3 center, float angle_degree);
-        void move_around_horizontally(Vector3 center, float angle_degree);
+        void move_around_vertically(Vec3 center, float angle_degree);
+        void move_around_horizontally(Vec3 center, float angle_degree);
 
-        Vector3 get_position();
-        Quaternion get_orientation();
-        EulerAngle get_orientation_euler_angle();
-        Matrix4 get_orientation_matrix();
-        Vector3 get_scale();
+        Vec3 get_position() const;
+        Quaternion get_orientation() const;
+        EulerAngle get_orientation_euler_angle() const;
+        Mat4 get_orientation_matrix() const;
+        Vec3 get_scale() const;
 
-        void translate(Vector3 translation);
+        void translate(Vec3 translation);
         void translate(float x, float y, float z);
 
         void rotate_x(float angle_degree, bool local = true);
         void rotate_y(float angle_degree, bool local = true);
         void rotate_z(float angle_degree, bool local = true);
 
-        // void rotate(float angle_degree, Vector3 axis, bool local = true);
+        // void rotate(float angle_degree, Vec3 axis, bool local = true);
 
-        void angle_axis_rotate(float angle_rad, Vector3 axis, bool local = true);
+        void angle_axis_rotate(float angle_rad, Vec3 axis, bool local = true);
 
         void scale(float x, float y, float z);
-        void scale(Vector3 scale);
+        void scale(Vec3 scale);
         void scale(float scale);
 
-        Vector3 get_front();
-        Vector3 get_right();
-        Vector3 get_up();
+        Vec3 get_front() const;
+        Vec3 get_right() const;
+        Vec3 get_up() const;
 
-        Matrix3 get_normal_matrix();
-        Matrix4 get_model_matrix();
+        // cached, rebuilt on the first call after a setter changed the transform
+        const Mat3 &get_normal_matrix() const;
+        const Mat4 &get_model_matrix() const;
+
+        // Every change stamps the transform with a new, globally increasing version.
+        // A renderer remembers current_version() (or get_version()) when it uploads
+        // and asks changed_since() next frame; new transforms count as changed.
+        uint64_t get_version() const { return m_version; }
+        bool changed_since(uint64_t version) const { return m_version > version; }
+        static uint64_t current_version();
+
+    private:
+        // invalidates the cached matrices, called by every setter
+        void touch();
 
     private:
-        Vector3 m_position;
-        Vector3 m_scale;
+        Vec3 m_position;
+        Vec3 m_scale;
         Quaternion m_orientation;
+
+        uint64_t m_version;
+        mutable Mat4 m_model;
+        mutable Mat3 m_normal;
+        mutable bool m_model_dirty = true;
+        mutable bool m_normal_dirty = true;
     };
 }; // namespace Core
 
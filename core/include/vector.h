@@ -47,6 +47,15 @@ namespace Core
             return *this;
         }
 
+        template <typename E>
+        Vector(const MatrixExpr<E> &expr) : Matrix(expr) {}
+        template <typename E>
+        Vector &operator=(const MatrixExpr<E> &expr)
+        {
+            Matrix::operator=(expr);
+            return *this;
+        }
+
         Vector(float *values, size_t size, bool duplicate) : Matrix(values, size, 1, duplicate) {}
 
         // methods
@@ -111,6 +120,16 @@ namespace Core
             Vector::operator=(std::move(other));
             return *this;
         }
+
+        template <typename E>
+        Vector2(const MatrixExpr<E> &expr) : Vector(expr) {}
+        template <typename E>
+        Vector2 &operator=(const MatrixExpr<E> &expr)
+        {
+            Vector::operator=(expr);
+            return *this;
+        }
+
         // methods
     private:
     protected:
@@ -193,6 +212,15 @@ namespace Core
             return *this;
         }
 
+        template <typename E>
+        Vector3(const MatrixExpr<E> &expr) : Vector(expr) {}
+        template <typename E>
+        Vector3 &operator=(const MatrixExpr<E> &expr)
+        {
+            Vector::operator=(expr);
+            return *this;
+        }
+
         // methods
     private:
     protected:
@@ -287,6 +315,15 @@ namespace Core
             return *this;
         }
 
+        template <typename E>
+        Vector4(const MatrixExpr<E> &expr) : Vector(expr) {}
+        template <typename E>
+        Vector4 &operator=(const MatrixExpr<E> &expr)
+        {
+            Vector::operator=(expr);
+            return *this;
+        }
+
         // methods
     private:
     protected:
@@ -0,0 +1,404 @@
+#include "geometry/batch.h"
+#include "math/simd.h"
+#include "jobs.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#if defined(__GNUC__) || defined(__clang__)
+#define CORE_BATCH_AVX
+#include <immintrin.h>
+#define CORE_TARGET_AVX __attribute__((target("avx")))
+#define CORE_TARGET_FMA __attribute__((target("avx,fma")))
+#endif
+#endif
+
+// the AVX kernel and the scalar one evaluate every point in the same order,
+// keep the compiler from fusing the scalar multiply-adds behind our back
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace Core::Geometry
+{
+    namespace
+    {
+        // points deinterleaved per AoS block, small enough for the stack and L1
+        constexpr size_t BLOCK = 256;
+        // points handed to each thread at least, below that threads cost more than they save
+        constexpr size_t POINTS_PER_THREAD = size_t(1) << 16;
+
+        std::atomic<size_t> batch_threads{0};
+
+        enum Mode
+        {
+            POINT,       // w = 1
+            VECTOR,      // w = 0
+            PROJECT,     // w = 1, divide by the resulting w
+            HOMOGENEOUS, // w read and written
+            NORMAL       // w = 0, renormalize
+        };
+
+        // SoA input and output, out may equal in
+        struct Streams
+        {
+            const float *x, *y, *z, *w;
+            float *ox, *oy, *oz, *ow;
+        };
+
+        // transforms points [begin, end) by the 4x4 row-vector matrix m
+        using Kernel = void (*)(const float *m, const Streams &s, size_t begin, size_t end);
+
+        template <Mode MODE>
+        void kernel_generic(const float *m, const Streams &s, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const float x = s.x[i], y = s.y[i], z = s.z[i];
+                float rx = x * m[0], ry = x * m[1], rz = x * m[2];
+                rx = y * m[4] + rx;
+                ry = y * m[5] + ry;
+                rz = y * m[6] + rz;
+                rx = z * m[8] + rx;
+                ry = z * m[9] + ry;
+                rz = z * m[10] + rz;
+                if constexpr (MODE == POINT || MODE == PROJECT)
+                {
+                    rx = rx + m[12];
+                    ry = ry + m[13];
+                    rz = rz + m[14];
+                }
+                if constexpr (MODE == PROJECT)
+                {
+                    float rw = x * m[3];
+                    rw = y * m[7] + rw;
+                    rw = z * m[11] + rw;
+                    rw = rw + m[15];
+                    const float inv = 1.f / rw;
+                    rx = rx * inv;
+                    ry = ry * inv;
+                    rz = rz * inv;
+                }
+                if constexpr (MODE == HOMOGENEOUS)
+                {
+                    const float w = s.w[i];
+                    float rw = x * m[3];
+                    rw = y * m[7] + rw;
+                    rw = z * m[11] + rw;
+                    rx = w * m[12] + rx;
+                    ry = w * m[13] + ry;
+                    rz = w * m[14] + rz;
+                    s.ow[i] = w * m[15] + rw;
+                }
+                if constexpr (MODE == NORMAL)
+                {
+                    float len2 = rx * rx;
+                    len2 = ry * ry + len2;
+                    len2 = rz * rz + len2;
+                    if (len2 > 0.f)
+                    {
+                        const float inv = 1.f / std::sqrt(len2);
+                        rx = rx * inv;
+                        ry = ry * inv;
+                        rz = rz * inv;
+                    }
+                }
+                s.ox[i] = rx;
+                s.oy[i] = ry;
+                s.oz[i] = rz;
+            }
+        }
+
+#ifdef CORE_BATCH_AVX
+#define CORE_MUL_ADD(x, y, z) _mm256_add_ps(_mm256_mul_ps(x, y), z)
+// 8 points per iteration, the tail goes through the generic kernel
+#define CORE_BATCH_KERNEL(NAME, TARGET, MADD)                                                    \
+    template <Mode MODE>                                                                        \
+    TARGET void NAME(const float *m, const Streams &s, size_t begin, size_t end)                \
+    {                                                                                           \
+        __m256 c[16];                                                                           \
+        for (int j = 0; j < 16; ++j)                                                            \
+            c[j] = _mm256_broadcast_ss(m + j);                                                  \
+        size_t i = begin;                                                                       \
+        for (; i + 8 <= end; i += 8)                                                            \
+        {                                                                                       \
+            const __m256 x = _mm256_loadu_ps(s.x + i);                                          \
+            const __m256 y = _mm256_loadu_ps(s.y + i);                                          \
+            const __m256 z = _mm256_loadu_ps(s.z + i);                                          \
+            __m256 rx = _mm256_mul_ps(x, c[0]);                                                 \
+            __m256 ry = _mm256_mul_ps(x, c[1]);                                                 \
+            __m256 rz = _mm256_mul_ps(x, c[2]);                                                 \
+            rx = MADD(y, c[4], rx);                                                             \
+            ry = MADD(y, c[5], ry);                                                             \
+            rz = MADD(y, c[6], rz);                                                             \
+            rx = MADD(z, c[8], rx);                                                             \
+            ry = MADD(z, c[9], ry);                                                             \
+            rz = MADD(z, c[10], rz);                                                            \
+            if constexpr (MODE == POINT || MODE == PROJECT)                                     \
+            {                                                                                   \
+                rx = _mm256_add_ps(rx, c[12]);                                                  \
+                ry = _mm256_add_ps(ry, c[13]);                                                  \
+                rz = _mm256_add_ps(rz, c[14]);                                                  \
+            }                                                                                   \
+            if constexpr (MODE == PROJECT)                                                      \
+            {                                                                                   \
+                __m256 rw = _mm256_mul_ps(x, c[3]);                                             \
+                rw = MADD(y, c[7], rw);                                                         \
+                rw = MADD(z, c[11], rw);                                                        \
+                rw = _mm256_add_ps(rw, c[15]);                                                  \
+                const __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.f), rw);                      \
+                rx = _mm256_mul_ps(rx, inv);                                                    \
+                ry = _mm256_mul_ps(ry, inv);                                                    \
+                rz = _mm256_mul_ps(rz, inv);                                                    \
+            }                                                                                   \
+            if constexpr (MODE == HOMOGENEOUS)                                                  \
+            {                                                                                   \
+                const __m256 w = _mm256_loadu_ps(s.w + i);                                      \
+                __m256 rw = _mm256_mul_ps(x, c[3]);                                             \
+                rw = MADD(y, c[7], rw);                                                         \
+                rw = MADD(z, c[11], rw);                                                        \
+                rx = MADD(w, c[12], rx);                                                        \
+                ry = MADD(w, c[13], ry);                                                        \
+                rz = MADD(w, c[14], rz);                                                        \
+                _mm256_storeu_ps(s.ow + i, MADD(w, c[15], rw));                                 \
+            }                                                                                   \
+            if constexpr (MODE == NORMAL)                                                       \
+            {                                                                                   \
+                __m256 len2 = _mm256_mul_ps(rx, rx);                                            \
+                len2 = MADD(ry, ry, len2);                                                      \
+                len2 = MADD(rz, rz, len2);                                                      \
+                const __m256 nonzero = _mm256_cmp_ps(len2, _mm256_setzero_ps(), _CMP_GT_OQ);    \
+                const __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.f), _mm256_sqrt_ps(len2));    \
+                rx = _mm256_blendv_ps(rx, _mm256_mul_ps(rx, inv), nonzero);                     \
+                ry = _mm256_blendv_ps(ry, _mm256_mul_ps(ry, inv), nonzero);                     \
+                rz = _mm256_blendv_ps(rz, _mm256_mul_ps(rz, inv), nonzero);                     \
+            }                                                                                   \
+            _mm256_storeu_ps(s.ox + i, rx);                                                     \
+            _mm256_storeu_ps(s.oy + i, ry);                                                     \
+            _mm256_storeu_ps(s.oz + i, rz);                                                     \
+        }                                                                                       \
+        /* the generic tail is SSE code, leave no dirty upper halves behind */                  \
+        _mm256_zeroupper();                                                                     \
+        kernel_generic<MODE>(m, s, i, end);                                                     \
+    }
+
+        CORE_BATCH_KERNEL(kernel_avx, CORE_TARGET_AVX, CORE_MUL_ADD)
+        CORE_BATCH_KERNEL(kernel_fma, CORE_TARGET_FMA, _mm256_fmadd_ps)
+#undef CORE_BATCH_KERNEL
+#undef CORE_MUL_ADD
+#endif
+
+        // FMA only when asked for, so that the default backends agree bit for bit
+        template <Mode MODE>
+        Kernel select_kernel()
+        {
+#ifdef CORE_BATCH_AVX
+            const Math::SIMD::Backend backend = Math::SIMD::get_backend();
+            if (backend == Math::SIMD::FMA)
+                return kernel_fma<MODE>;
+            if (backend == Math::SIMD::AVX)
+                return kernel_avx<MODE>;
+#endif
+            return kernel_generic<MODE>;
+        }
+
+        size_t round_up(size_t x, size_t multiple)
+        {
+            return (x + multiple - 1) / multiple * multiple;
+        }
+
+        // calls f(begin, end) on BLOCK aligned slices of [0, count), one per thread
+        template <typename F>
+        void parallel_for(size_t count, F &&f)
+        {
+            const size_t threads = std::min(get_batch_threads(), std::max<size_t>(1, count / POINTS_PER_THREAD));
+            if (threads <= 1)
+            {
+                f(size_t(0), count);
+                return;
+            }
+            const size_t slice = round_up((count + threads - 1) / threads, BLOCK);
+            Jobs::parallel_for(0, count, slice, f);
+        }
+
+        template <Mode MODE>
+        void run_soa(const float *m, ConstPointsSoA in, PointsSoA out, size_t count)
+        {
+            const Kernel kernel = select_kernel<MODE>();
+            const Streams s{in.x, in.y, in.z, nullptr, out.x, out.y, out.z, nullptr};
+            parallel_for(count, [&](size_t begin, size_t end)
+                         { kernel(m, s, begin, end); });
+        }
+
+        // AoS points are deinterleaved block by block and transformed in place on the stack
+        template <Mode MODE>
+        void run_aos(const float *m, const float *in, float *out, size_t count, size_t stride)
+        {
+            constexpr size_t components = MODE == HOMOGENEOUS ? 4 : 3;
+            if (stride < components)
+                throw std::runtime_error("Geometry::transform: stride is smaller than a point");
+            const Kernel kernel = select_kernel<MODE>();
+            parallel_for(count, [&](size_t begin, size_t end)
+                         {
+                alignas(32) float buffer[components][BLOCK];
+                const Streams s{buffer[0], buffer[1], buffer[2], buffer[components - 1],
+                                buffer[0], buffer[1], buffer[2], buffer[components - 1]};
+                for (size_t b = begin; b < end; b += BLOCK)
+                {
+                    const size_t n = std::min(BLOCK, end - b);
+                    const float *src = in + b * stride;
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        for (size_t c = 0; c < components; ++c)
+                            buffer[c][i] = src[i * stride + c];
+                    }
+                    kernel(m, s, 0, n);
+                    float *dst = out + b * stride;
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        for (size_t c = 0; c < components; ++c)
+                            dst[i * stride + c] = buffer[c][i];
+                    }
+                } });
+        }
+
+        // the normal matrix padded to 4x4, rows stay rows
+        void pad(const Mat3 &matrix, float *m)
+        {
+            for (size_t i = 0; i < 16; ++i)
+                m[i] = 0.f;
+            for (size_t row = 0; row < 3; ++row)
+            {
+                for (size_t col = 0; col < 3; ++col)
+                    m[row * 4 + col] = matrix(row, col);
+            }
+        }
+
+        // row-vector matrix of p -> q * p * conjugate(q), exact for non-unit q as well
+        void rotation_matrix(const Quaternion &q, float *m)
+        {
+            const float ww = q.w * q.w, xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+            const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+            const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+            const float rows[16] = {
+                ww + xx - yy - zz, 2.f * (xy + wz), 2.f * (xz - wy), 0.f,
+                2.f * (xy - wz), ww - xx + yy - zz, 2.f * (yz + wx), 0.f,
+                2.f * (xz + wy), 2.f * (yz - wx), ww - xx - yy + zz, 0.f,
+                0.f, 0.f, 0.f, 1.f};
+            std::copy(rows, rows + 16, m);
+        }
+
+        const float *floats(const Vec3 *v) { return reinterpret_cast<const float *>(v); }
+        float *floats(Vec3 *v) { return reinterpret_cast<float *>(v); }
+        const float *floats(const Vec4 *v) { return reinterpret_cast<const float *>(v); }
+        float *floats(Vec4 *v) { return reinterpret_cast<float *>(v); }
+        constexpr size_t VEC3_STRIDE = sizeof(Vec3) / sizeof(float);
+    }
+
+    void set_batch_threads(size_t threads)
+    {
+        batch_threads = threads;
+    }
+
+    size_t get_batch_threads()
+    {
+        size_t threads = batch_threads;
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        return threads;
+    }
+
+    void transform_points(const Mat4 &matrix, const float *in, float *out, size_t count, size_t stride)
+    {
+        run_aos<POINT>(matrix.data(), in, out, count, stride);
+    }
+
+    void transform_points(const Mat4 &matrix, const Vec3 *in, Vec3 *out, size_t count)
+    {
+        run_aos<POINT>(matrix.data(), floats(in), floats(out), count, VEC3_STRIDE);
+    }
+
+    void transform_points(const Mat4 &matrix, ConstPointsSoA in, PointsSoA out, size_t count)
+    {
+        run_soa<POINT>(matrix.data(), in, out, count);
+    }
+
+    void transform_vectors(const Mat4 &matrix, const float *in, float *out, size_t count, size_t stride)
+    {
+        run_aos<VECTOR>(matrix.data(), in, out, count, stride);
+    }
+
+    void transform_vectors(const Mat4 &matrix, const Vec3 *in, Vec3 *out, size_t count)
+    {
+        run_aos<VECTOR>(matrix.data(), floats(in), floats(out), count, VEC3_STRIDE);
+    }
+
+    void transform_vectors(const Mat4 &matrix, ConstPointsSoA in, PointsSoA out, size_t count)
+    {
+        run_soa<VECTOR>(matrix.data(), in, out, count);
+    }
+
+    void project_points(const Mat4 &matrix, const float *in, float *out, size_t count, size_t stride)
+    {
+        run_aos<PROJECT>(matrix.data(), in, out, count, stride);
+    }
+
+    void project_points(const Mat4 &matrix, const Vec3 *in, Vec3 *out, size_t count)
+    {
+        run_aos<PROJECT>(matrix.data(), floats(in), floats(out), count, VEC3_STRIDE);
+    }
+
+    void project_points(const Mat4 &matrix, ConstPointsSoA in, PointsSoA out, size_t count)
+    {
+        run_soa<PROJECT>(matrix.data(), in, out, count);
+    }
+
+    void transform_points(const Mat4 &matrix, const Vec4 *in, Vec4 *out, size_t count)
+    {
+        run_aos<HOMOGENEOUS>(matrix.data(), floats(in), floats(out), count, 4);
+    }
+
+    void transform_normals(const Mat3 &normal_matrix, const float *in, float *out, size_t count, size_t stride)
+    {
+        float m[16];
+        pad(normal_matrix, m);
+        run_aos<NORMAL>(m, in, out, count, stride);
+    }
+
+    void transform_normals(const Mat3 &normal_matrix, const Vec3 *in, Vec3 *out, size_t count)
+    {
+        transform_normals(normal_matrix, floats(in), floats(out), count, VEC3_STRIDE);
+    }
+
+    void transform_normals(const Mat3 &normal_matrix, ConstPointsSoA in, PointsSoA out, size_t count)
+    {
+        float m[16];
+        pad(normal_matrix, m);
+        run_soa<NORMAL>(m, in, out, count);
+    }
+
+    void rotate_points(const Quaternion &rotation, const float *in, float *out, size_t count, size_t stride)
+    {
+        float m[16];
+        rotation_matrix(rotation, m);
+        run_aos<VECTOR>(m, in, out, count, stride);
+    }
+
+    void rotate_points(const Quaternion &rotation, const Vec3 *in, Vec3 *out, size_t count)
+    {
+        rotate_points(rotation, floats(in), floats(out), count, VEC3_STRIDE);
+    }
+
+    void rotate_points(const Quaternion &rotation, ConstPointsSoA in, PointsSoA out, size_t count)
+    {
+        float m[16];
+        rotation_matrix(rotation, m);
+        run_soa<VECTOR>(m, in, out, count);
+    }
+};
@@ -0,0 +1,300 @@
+#include "geometry/culling.h"
+#include "geometry/batch.h"
+#include "math/simd.h"
+#include "jobs.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#if defined(__GNUC__) || defined(__clang__)
+#define CORE_CULLING_SIMD
+#include <immintrin.h>
+#define CORE_TARGET_SSE2 __attribute__((target("sse2")))
+#define CORE_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace Core::Geometry
+{
+    namespace
+    {
+        // volumes handed to each thread at least, below that threads cost more than they save
+        constexpr size_t VOLUMES_PER_THREAD = size_t(1) << 14;
+
+        // one plane and the coordinates it is tested against: the centers for
+        // spheres, the corner furthest along the normal for boxes
+        struct Plane
+        {
+            float a, b, c, d;
+            const float *x, *y, *z;
+        };
+
+        // a volume is out if it is behind one plane by more than its radius, boxes have none
+        struct Input
+        {
+            Plane planes[6];
+            const float *radius;
+            uint8_t *visible;
+        };
+
+        // tests volumes [begin, end), returns how many are visible
+        using Kernel = size_t (*)(const Input &in, size_t begin, size_t end);
+
+        template <bool SPHERE>
+        size_t kernel_generic(const Input &in, size_t begin, size_t end)
+        {
+            size_t rslt = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const float neg_radius = SPHERE ? 0.f - in.radius[i] : 0.f;
+                bool outside = false;
+                for (const Plane &p : in.planes)
+                {
+                    float d = p.x[i] * p.a;
+                    d = p.y[i] * p.b + d;
+                    d = p.z[i] * p.c + d;
+                    d = d + p.d;
+                    outside |= d < neg_radius;
+                }
+                in.visible[i] = !outside;
+                rslt += !outside;
+            }
+            return rslt;
+        }
+
+#ifdef CORE_CULLING_SIMD
+        // 4 volumes per iteration, the tail goes through the generic kernel
+        template <bool SPHERE>
+        CORE_TARGET_SSE2 size_t kernel_sse2(const Input &in, size_t begin, size_t end)
+        {
+            size_t rslt = 0;
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4)
+            {
+                const __m128 neg_radius = SPHERE ? _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(in.radius + i)) : _mm_setzero_ps();
+                __m128 outside = _mm_setzero_ps();
+                for (const Plane &p : in.planes)
+                {
+                    __m128 d = _mm_mul_ps(_mm_loadu_ps(p.x + i), _mm_set1_ps(p.a));
+                    d = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p.y + i), _mm_set1_ps(p.b)), d);
+                    d = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p.z + i), _mm_set1_ps(p.c)), d);
+                    d = _mm_add_ps(d, _mm_set1_ps(p.d));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(d, neg_radius));
+                }
+                const int mask = _mm_movemask_ps(outside);
+                for (int k = 0; k < 4; ++k)
+                {
+                    const bool visible = !((mask >> k) & 1);
+                    in.visible[i + k] = visible;
+                    rslt += visible;
+                }
+            }
+            return rslt + kernel_generic<SPHERE>(in, i, end);
+        }
+
+        // 8 volumes per iteration
+        template <bool SPHERE>
+        CORE_TARGET_AVX size_t kernel_avx(const Input &in, size_t begin, size_t end)
+        {
+            size_t rslt = 0;
+            size_t i = begin;
+            for (; i + 8 <= end; i += 8)
+            {
+                const __m256 neg_radius = SPHERE ? _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(in.radius + i)) : _mm256_setzero_ps();
+                __m256 outside = _mm256_setzero_ps();
+                for (const Plane &p : in.planes)
+                {
+                    __m256 d = _mm256_mul_ps(_mm256_loadu_ps(p.x + i), _mm256_set1_ps(p.a));
+                    d = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(p.y + i), _mm256_set1_ps(p.b)), d);
+                    d = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(p.z + i), _mm256_set1_ps(p.c)), d);
+                    d = _mm256_add_ps(d, _mm256_set1_ps(p.d));
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, neg_radius, _CMP_LT_OQ));
+                }
+                const int mask = _mm256_movemask_ps(outside);
+                for (int k = 0; k < 8; ++k)
+                {
+                    const bool visible = !((mask >> k) & 1);
+                    in.visible[i + k] = visible;
+                    rslt += visible;
+                }
+            }
+            // the generic tail is SSE code, leave no dirty upper halves behind
+            _mm256_zeroupper();
+            return rslt + kernel_generic<SPHERE>(in, i, end);
+        }
+#endif
+
+        // the multiply-adds are never fused, so FMA runs the AVX kernel
+        template <bool SPHERE>
+        Kernel select_kernel()
+        {
+#ifdef CORE_CULLING_SIMD
+            const Math::SIMD::Backend backend = Math::SIMD::get_backend();
+            if (backend == Math::SIMD::AVX || backend == Math::SIMD::FMA)
+                return kernel_avx<SPHERE>;
+            if (backend == Math::SIMD::SSE2)
+                return kernel_sse2<SPHERE>;
+#endif
+            return kernel_generic<SPHERE>;
+        }
+
+        template <bool SPHERE>
+        size_t run(const Input &in, size_t count)
+        {
+            const Kernel kernel = select_kernel<SPHERE>();
+            const size_t threads = std::min(get_batch_threads(), std::max<size_t>(1, count / VOLUMES_PER_THREAD));
+            if (threads <= 1)
+                return kernel(in, 0, count);
+            // slices stay a multiple of 8, only the last one has a tail
+            const size_t slice = ((count + threads - 1) / threads + 7) / 8 * 8;
+            std::atomic<size_t> rslt{0};
+            Jobs::parallel_for(0, count, slice, [&](size_t begin, size_t end)
+                               { rslt += kernel(in, begin, end); });
+            return rslt;
+        }
+
+        Plane plane_of(const Vec4 &plane)
+        {
+            return {plane.x(), plane.y(), plane.z(), plane.w(), nullptr, nullptr, nullptr};
+        }
+
+        Vec4 normalized_plane(float a, float b, float c, float d)
+        {
+            const float length = std::sqrt(a * a + b * b + c * c);
+            const float inv = length > 0.f ? 1.f / length : 0.f;
+            return Vec4(a * inv, b * inv, c * inv, d * inv);
+        }
+    }
+
+    Frustum extract_frustum(const Mat4 &view_projection)
+    {
+        // clip(j) = sum_k p(k) * m(k, j): each plane combines column 3 with one of the others
+        const Mat4 &m = view_projection;
+        Frustum rslt;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            rslt.planes[i * 2] = normalized_plane(m(0, 3) + m(0, i), m(1, 3) + m(1, i), m(2, 3) + m(2, i), m(3, 3) + m(3, i));
+            rslt.planes[i * 2 + 1] = normalized_plane(m(0, 3) - m(0, i), m(1, 3) - m(1, i), m(2, 3) - m(2, i), m(3, 3) - m(3, i));
+        }
+        return rslt;
+    }
+
+    AABB compute_aabb(const float *points, size_t count, size_t stride)
+    {
+        AABB rslt;
+        if (count == 0)
+            return rslt;
+        rslt.min = Vec3(points[0], points[1], points[2]);
+        rslt.max = rslt.min;
+        for (size_t i = 1; i < count; ++i)
+        {
+            const float *p = points + i * stride;
+            for (size_t c = 0; c < 3; ++c)
+            {
+                rslt.min.values[c] = std::min(rslt.min.values[c], p[c]);
+                rslt.max.values[c] = std::max(rslt.max.values[c], p[c]);
+            }
+        }
+        return rslt;
+    }
+
+    BoundingSphere compute_sphere(const float *points, size_t count, size_t stride)
+    {
+        const AABB box = compute_aabb(points, count, stride);
+        BoundingSphere rslt;
+        rslt.center = (box.min + box.max) * 0.5f;
+        float radius2 = 0.f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float *p = points + i * stride;
+            const float x = p[0] - rslt.center.x(), y = p[1] - rslt.center.y(), z = p[2] - rslt.center.z();
+            radius2 = std::max(radius2, x * x + y * y + z * z);
+        }
+        rslt.radius = std::sqrt(radius2);
+        return rslt;
+    }
+
+    AABB transform_aabb(const Mat4 &matrix, const AABB &box)
+    {
+        // center and half extents, the extents through the absolute matrix
+        const Vec3 center = (box.min + box.max) * 0.5f;
+        const Vec3 extent = (box.max - box.min) * 0.5f;
+        AABB rslt;
+        for (size_t j = 0; j < 3; ++j)
+        {
+            float c = matrix(3, j);
+            float e = 0.f;
+            for (size_t k = 0; k < 3; ++k)
+            {
+                c += center.values[k] * matrix(k, j);
+                e += extent.values[k] * std::fabs(matrix(k, j));
+            }
+            rslt.min.values[j] = c - e;
+            rslt.max.values[j] = c + e;
+        }
+        return rslt;
+    }
+
+    BoundingSphere transform_sphere(const Mat4 &matrix, const BoundingSphere &sphere)
+    {
+        BoundingSphere rslt;
+        float scale2 = 0.f;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            // row k is where the unit axis k goes
+            scale2 = std::max(scale2, matrix(k, 0) * matrix(k, 0) + matrix(k, 1) * matrix(k, 1) + matrix(k, 2) * matrix(k, 2));
+        }
+        for (size_t j = 0; j < 3; ++j)
+        {
+            rslt.center.values[j] = sphere.center.x() * matrix(0, j) + sphere.center.y() * matrix(1, j) + sphere.center.z() * matrix(2, j) + matrix(3, j);
+        }
+        rslt.radius = sphere.radius * std::sqrt(scale2);
+        return rslt;
+    }
+
+    bool intersects(const Frustum &frustum, const BoundingSphere &sphere)
+    {
+        uint8_t visible = 0;
+        cull_spheres(frustum, {&sphere.center.values[0], &sphere.center.values[1], &sphere.center.values[2], &sphere.radius}, &visible, 1);
+        return visible;
+    }
+
+    bool intersects(const Frustum &frustum, const AABB &box)
+    {
+        uint8_t visible = 0;
+        cull_aabbs(frustum, {&box.min.values[0], &box.min.values[1], &box.min.values[2], &box.max.values[0], &box.max.values[1], &box.max.values[2]}, &visible, 1);
+        return visible;
+    }
+
+    size_t cull_spheres(const Frustum &frustum, SpheresSoA spheres, uint8_t *visible, size_t count)
+    {
+        Input in;
+        for (size_t i = 0; i < 6; ++i)
+        {
+            in.planes[i] = plane_of(frustum.planes[i]);
+            in.planes[i].x = spheres.x;
+            in.planes[i].y = spheres.y;
+            in.planes[i].z = spheres.z;
+        }
+        in.radius = spheres.radius;
+        in.visible = visible;
+        return run<true>(in, count);
+    }
+
+    size_t cull_aabbs(const Frustum &frustum, AABBsSoA boxes, uint8_t *visible, size_t count)
+    {
+        Input in;
+        for (size_t i = 0; i < 6; ++i)
+        {
+            // the corner furthest along the normal is the last one to leave
+            in.planes[i] = plane_of(frustum.planes[i]);
+            in.planes[i].x = in.planes[i].a >= 0.f ? boxes.max_x : boxes.min_x;
+            in.planes[i].y = in.planes[i].b >= 0.f ? boxes.max_y : boxes.min_y;
+            in.planes[i].z = in.planes[i].c >= 0.f ? boxes.max_z : boxes.min_z;
+        }
+        in.radius = nullptr;
+        in.visible = visible;
+        return run<false>(in, count);
+    }
+};
@@ -0,0 +1,434 @@
+#include "fixed_matrix.h"
+#include <algorithm>
+#include <stdexcept>
+#include "math/base.h"
+#include "math/simd.h"
+
+namespace Core
+{
+    /*--------------------------------Mat3--------------------------------*/
+
+    Mat3::Mat3(const Matrix3 &other)
+    {
+        const float *src = other.data();
+        for (size_t i = 0; i < 9; ++i)
+        {
+            values[i] = src[i];
+        }
+    }
+
+    Mat3::Mat3(const Matrix &other) : values{}
+    {
+        size_t row = std::min<size_t>(3, other.rows());
+        size_t col = std::min<size_t>(3, other.cols());
+        for (size_t i = 0; i < row; ++i)
+        {
+            for (size_t j = 0; j < col; ++j)
+                (*this)(i, j) = other(i, j);
+        }
+    }
+
+    Mat3::Mat3(const Mat4 &other)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+                (*this)(i, j) = other(i, j);
+        }
+    }
+
+    Mat3::operator Matrix3() const
+    {
+        return Matrix3(values[0], values[1], values[2],
+                       values[3], values[4], values[5],
+                       values[6], values[7], values[8]);
+    }
+
+    Mat3 Mat3::operator+(const Mat3 &other) const
+    {
+        Mat3 rslt;
+        for (size_t i = 0; i < 9; ++i)
+        {
+            rslt.values[i] = values[i] + other.values[i];
+        }
+        return rslt;
+    }
+
+    Mat3 Mat3::operator-(const Mat3 &other) const
+    {
+        Mat3 rslt;
+        for (size_t i = 0; i < 9; ++i)
+        {
+            rslt.values[i] = values[i] - other.values[i];
+        }
+        return rslt;
+    }
+
+    Mat3 Mat3::operator*(float scalar) const
+    {
+        Mat3 rslt;
+        for (size_t i = 0; i < 9; ++i)
+        {
+            rslt.values[i] = values[i] * scalar;
+        }
+        return rslt;
+    }
+
+    Mat3 Mat3::operator*(const Mat3 &other) const
+    {
+        Mat3 rslt;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                rslt(i, j) = (*this)(i, 0) * other(0, j) + (*this)(i, 1) * other(1, j) + (*this)(i, 2) * other(2, j);
+            }
+        }
+        return rslt;
+    }
+
+    Vec3 Mat3::operator*(const Vec3 &vector) const
+    {
+        return Vec3(values[0] * vector[0] + values[1] * vector[1] + values[2] * vector[2],
+                    values[3] * vector[0] + values[4] * vector[1] + values[5] * vector[2],
+                    values[6] * vector[0] + values[7] * vector[1] + values[8] * vector[2]);
+    }
+
+    bool Mat3::operator==(const Mat3 &other) const
+    {
+        for (size_t i = 0; i < 9; ++i)
+        {
+            if (!Math::equal(values[i], other.values[i]))
+                return false;
+        }
+        return true;
+    }
+
+    void Mat3::fill(float value)
+    {
+        for (size_t i = 0; i < 9; ++i)
+        {
+            values[i] = value;
+        }
+    }
+
+    Mat3 Mat3::transpose() const
+    {
+        return Mat3(values[0], values[3], values[6],
+                    values[1], values[4], values[7],
+                    values[2], values[5], values[8]);
+    }
+
+    float Mat3::determinant() const
+    {
+        const Mat3 &m = *this;
+        return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1)) -
+               m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0)) +
+               m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+    }
+
+    Mat3 Mat3::inverse() const
+    {
+        float det = determinant();
+        if (Math::equal(det, 0.f))
+            throw std::runtime_error("Mat3::inverse: determinant is zero");
+        const Mat3 &m = *this;
+        float inv_det = 1.f / det;
+        return Mat3((m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1)) * inv_det,
+                    (m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2)) * inv_det,
+                    (m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1)) * inv_det,
+                    (m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2)) * inv_det,
+                    (m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0)) * inv_det,
+                    (m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2)) * inv_det,
+                    (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0)) * inv_det,
+                    (m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1)) * inv_det,
+                    (m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)) * inv_det);
+    }
+
+    void Mat3::translate(const Vec2 &translation)
+    {
+        (*this)(0, 2) += translation.x();
+        (*this)(1, 2) += translation.y();
+    }
+
+    void Mat3::rotate(float angle_rad, const Vec2 &center)
+    {
+        float c = std::cos(angle_rad);
+        float s = std::sin(angle_rad);
+        float t = 1.f - c;
+        float x = center.x();
+        float y = center.y();
+        (*this)(0, 0) = t * x * x + c;
+        (*this)(0, 1) = t * x * y - s * y;
+        (*this)(0, 2) = x - (*this)(0, 0) * x - (*this)(0, 1) * y;
+        (*this)(1, 0) = t * x * y + s * y;
+        (*this)(1, 1) = t * y * y + c;
+        (*this)(1, 2) = y - (*this)(1, 0) * x - (*this)(1, 1) * y;
+    }
+
+    void Mat3::scale(const Vec2 &scale)
+    {
+        (*this)(0, 0) *= scale.x();
+        (*this)(1, 1) *= scale.y();
+    }
+
+    Mat3 Mat3::translate(const Vec2 &translation) const
+    {
+        Mat3 rslt(*this);
+        rslt.translate(translation);
+        return rslt;
+    }
+
+    Mat3 Mat3::rotate(float angle_rad, const Vec2 &center) const
+    {
+        Mat3 rslt(*this);
+        rslt.rotate(angle_rad, center);
+        return rslt;
+    }
+
+    Mat3 Mat3::scale(const Vec2 &scale) const
+    {
+        Mat3 rslt(*this);
+        rslt.scale(scale);
+        return rslt;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const Mat3 &matrix)
+    {
+        for (size_t row = 0; row < 3; ++row)
+        {
+            os << "[" << matrix(row, 0) << ", " << matrix(row, 1) << ", " << matrix(row, 2) << "]" << std::endl;
+        }
+        return os;
+    }
+
+    /*--------------------------------Mat4--------------------------------*/
+
+    Mat4::Mat4(const Matrix4 &other)
+    {
+        const float *src = other.data();
+        for (size_t i = 0; i < 16; ++i)
+        {
+            values[i] = src[i];
+        }
+    }
+
+    Mat4::Mat4(const Matrix &other) : values{}
+    {
+        size_t row = std::min<size_t>(4, other.rows());
+        size_t col = std::min<size_t>(4, other.cols());
+        for (size_t i = 0; i < row; ++i)
+        {
+            for (size_t j = 0; j < col; ++j)
+                (*this)(i, j) = other(i, j);
+        }
+    }
+
+    Mat4::operator Matrix4() const
+    {
+        return Matrix4(values[0], values[1], values[2], values[3],
+                       values[4], values[5], values[6], values[7],
+                       values[8], values[9], values[10], values[11],
+                       values[12], values[13], values[14], values[15]);
+    }
+
+    Mat4 Mat4::operator+(const Mat4 &other) const
+    {
+        Mat4 rslt;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            rslt.values[i] = values[i] + other.values[i];
+        }
+        return rslt;
+    }
+
+    Mat4 Mat4::operator-(const Mat4 &other) const
+    {
+        Mat4 rslt;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            rslt.values[i] = values[i] - other.values[i];
+        }
+        return rslt;
+    }
+
+    Mat4 Mat4::operator*(float scalar) const
+    {
+        Mat4 rslt;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            rslt.values[i] = values[i] * scalar;
+        }
+        return rslt;
+    }
+
+    Mat4 Mat4::operator*(const Mat4 &other) const
+    {
+        Mat4 rslt;
+        Math::SIMD::mat4_mul(values, other.values, rslt.values);
+        return rslt;
+    }
+
+    Vec4 Mat4::operator*(const Vec4 &vector) const
+    {
+        Vec4 rslt;
+        Math::SIMD::mat4_mul_vec4(values, vector.values, rslt.values);
+        return rslt;
+    }
+
+    bool Mat4::operator==(const Mat4 &other) const
+    {
+        for (size_t i = 0; i < 16; ++i)
+        {
+            if (!Math::equal(values[i], other.values[i]))
+                return false;
+        }
+        return true;
+    }
+
+    void Mat4::fill(float value)
+    {
+        for (size_t i = 0; i < 16; ++i)
+        {
+            values[i] = value;
+        }
+    }
+
+    Mat4 Mat4::transpose() const
+    {
+        Mat4 rslt;
+        Math::SIMD::mat4_transpose(values, rslt.values);
+        return rslt;
+    }
+
+    float Mat4::determinant() const
+    {
+        const float *m = values;
+        // 2x2 minors of the lower two rows
+        float s0 = m[8] * m[13] - m[9] * m[12];
+        float s1 = m[8] * m[14] - m[10] * m[12];
+        float s2 = m[8] * m[15] - m[11] * m[12];
+        float s3 = m[9] * m[14] - m[10] * m[13];
+        float s4 = m[9] * m[15] - m[11] * m[13];
+        float s5 = m[10] * m[15] - m[11] * m[14];
+
+        return m[0] * (m[5] * s5 - m[6] * s4 + m[7] * s3) -
+               m[1] * (m[4] * s5 - m[6] * s2 + m[7] * s1) +
+               m[2] * (m[4] * s4 - m[5] * s2 + m[7] * s0) -
+               m[3] * (m[4] * s3 - m[5] * s1 + m[6] * s0);
+    }
+
+    Mat4 Mat4::inverse() const
+    {
+        // closed form adjugate, using the 2x2 minors of the upper and lower row pairs
+        const float *m = values;
+        float a0 = m[0] * m[5] - m[1] * m[4];
+        float a1 = m[0] * m[6] - m[2] * m[4];
+        float a2 = m[0] * m[7] - m[3] * m[4];
+        float a3 = m[1] * m[6] - m[2] * m[5];
+        float a4 = m[1] * m[7] - m[3] * m[5];
+        float a5 = m[2] * m[7] - m[3] * m[6];
+        float b0 = m[8] * m[13] - m[9] * m[12];
+        float b1 = m[8] * m[14] - m[10] * m[12];
+        float b2 = m[8] * m[15] - m[11] * m[12];
+        float b3 = m[9] * m[14] - m[10] * m[13];
+        float b4 = m[9] * m[15] - m[11] * m[13];
+        float b5 = m[10] * m[15] - m[11] * m[14];
+
+        float det = a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0;
+        if (Math::equal(det, 0.f))
+            throw std::runtime_error("Mat4::inverse: determinant is zero");
+        float inv_det = 1.f / det;
+
+        Mat4 rslt;
+        float *r = rslt.values;
+        r[0] = (m[5] * b5 - m[6] * b4 + m[7] * b3) * inv_det;
+        r[1] = (-m[1] * b5 + m[2] * b4 - m[3] * b3) * inv_det;
+        r[2] = (m[13] * a5 - m[14] * a4 + m[15] * a3) * inv_det;
+        r[3] = (-m[9] * a5 + m[10] * a4 - m[11] * a3) * inv_det;
+        r[4] = (-m[4] * b5 + m[6] * b2 - m[7] * b1) * inv_det;
+        r[5] = (m[0] * b5 - m[2] * b2 + m[3] * b1) * inv_det;
+        r[6] = (-m[12] * a5 + m[14] * a2 - m[15] * a1) * inv_det;
+        r[7] = (m[8] * a5 - m[10] * a2 + m[11] * a1) * inv_det;
+        r[8] = (m[4] * b4 - m[5] * b2 + m[7] * b0) * inv_det;
+        r[9] = (-m[0] * b4 + m[1] * b2 - m[3] * b0) * inv_det;
+        r[10] = (m[12] * a4 - m[13] * a2 + m[15] * a0) * inv_det;
+        r[11] = (-m[8] * a4 + m[9] * a2 - m[11] * a0) * inv_det;
+        r[12] = (-m[4] * b3 + m[5] * b1 - m[6] * b0) * inv_det;
+        r[13] = (m[0] * b3 - m[1] * b1 + m[2] * b0) * inv_det;
+        r[14] = (-m[12] * a3 + m[13] * a1 - m[14] * a0) * inv_det;
+        r[15] = (m[8] * a3 - m[9] * a1 + m[10] * a0) * inv_det;
+        return rslt;
+    }
+
+    Mat4 Mat4::inverse_affine() const
+    {
+        Mat4 rslt;
+        if (!Math::SIMD::mat4_inverse_affine_either(values, rslt.values))
+            throw std::runtime_error("Mat4::inverse_affine: not affine or the determinant is zero");
+        return rslt;
+    }
+
+    void Mat4::translate(const Vec3 &translation)
+    {
+        (*this)(0, 3) += translation.x();
+        (*this)(1, 3) += translation.y();
+        (*this)(2, 3) += translation.z();
+    }
+
+    void Mat4::scale(const Vec3 &scale)
+    {
+        (*this)(0, 0) *= scale.x();
+        (*this)(1, 1) *= scale.y();
+        (*this)(2, 2) *= scale.z();
+    }
+
+    void Mat4::rotate(float angle_rad, const Vec3 &axis)
+    {
+        float c = std::cos(angle_rad);
+        float s = std::sin(angle_rad);
+        float t = 1 - c;
+        float x = axis.x();
+        float y = axis.y();
+        float z = axis.z();
+        (*this)(0, 0) = t * x * x + c;
+        (*this)(0, 1) = t * x * y - s * z;
+        (*this)(0, 2) = t * x * z + s * y;
+        (*this)(1, 0) = t * x * y + s * z;
+        (*this)(1, 1) = t * y * y + c;
+        (*this)(1, 2) = t * y * z - s * x;
+        (*this)(2, 0) = t * x * z - s * y;
+        (*this)(2, 1) = t * y * z + s * x;
+        (*this)(2, 2) = t * z * z + c;
+    }
+
+    Mat4 Mat4::translate(const Vec3 &translation) const
+    {
+        Mat4 rslt(*this);
+        rslt.translate(translation);
+        return rslt;
+    }
+
+    Mat4 Mat4::scale(const Vec3 &scale) const
+    {
+        Mat4 rslt(*this);
+        rslt.scale(scale);
+        return rslt;
+    }
+
+    Mat4 Mat4::rotate(float angle_rad, const Vec3 &axis) const
+    {
+        Mat4 rslt(*this);
+        rslt.rotate(angle_rad, axis);
+        return rslt;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const Mat4 &matrix)
+    {
+        for (size_t row = 0; row < 4; ++row)
+        {
+            os << "[" << matrix(row, 0) << ", " << matrix(row, 1) << ", " << matrix(row, 2) << ", " << matrix(row, 3) << "]" << std::endl;
+        }
+        return os;
+    }
+} // namespace Core
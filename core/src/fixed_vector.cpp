@@ -0,0 +1,22 @@
+#include "fixed_vector.h"
+
+namespace Core
+{
+    std::ostream &operator<<(std::ostream &os, const Vec2 &vector)
+    {
+        os << "[" << vector.x() << ", " << vector.y() << "]" << std::endl;
+        return os;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const Vec3 &vector)
+    {
+        os << "[" << vector.x() << ", " << vector.y() << ", " << vector.z() << "]" << std::endl;
+        return os;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const Vec4 &vector)
+    {
+        os << "[" << vector.x() << ", " << vector.y() << ", " << vector.z() << ", " << vector.w() << "]" << std::endl;
+        return os;
+    }
+} // namespace Core
@@ -0,0 +1,267 @@
+#include "math/gemm.h"
+#include "math/simd.h"
+#include "jobs.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#if defined(__GNUC__) || defined(__clang__)
+#define CORE_GEMM_AVX
+#include <immintrin.h>
+#define CORE_TARGET_AVX __attribute__((target("avx")))
+#define CORE_TARGET_FMA __attribute__((target("avx,fma")))
+#endif
+#endif
+
+namespace Core
+{
+    namespace Math
+    {
+        namespace
+        {
+            // register tile of the microkernel
+            constexpr size_t MR = 6;
+            constexpr size_t NR = 16;
+            // cache blocks: an MR x KC panel of A and a KC x NR panel of B fit in L1,
+            // the packed MC x KC block of A in L2 and the KC x NC block of B in L3
+            constexpr size_t KC = 256;
+            constexpr size_t MC = 120;
+            constexpr size_t NC = 3072;
+            // flops handed to each thread at least, below that threads cost more than they save
+            constexpr size_t FLOPS_PER_THREAD = size_t(1) << 24;
+
+            std::atomic<size_t> gemm_threads{0};
+
+            // acc (MR x NR) = sum_p a_panel(:, p) * b_panel(p, :)
+            using Kernel = void (*)(size_t kc, const float *a, const float *b, float *acc);
+
+            void kernel_generic(size_t kc, const float *a, const float *b, float *acc)
+            {
+                float c[MR * NR] = {};
+                for (size_t p = 0; p < kc; ++p, a += MR, b += NR)
+                {
+                    for (size_t r = 0; r < MR; ++r)
+                    {
+                        const float ar = a[r];
+                        for (size_t j = 0; j < NR; ++j)
+                            c[r * NR + j] += ar * b[j];
+                    }
+                }
+                std::copy(c, c + MR * NR, acc);
+            }
+
+#ifdef CORE_GEMM_AVX
+#define CORE_MUL_ADD(x, y, z) _mm256_add_ps(_mm256_mul_ps(x, y), z)
+#define CORE_GEMM_ROW(r, MADD)                  \
+    ar = _mm256_broadcast_ss(a + r);            \
+    c##r##0 = MADD(ar, b0, c##r##0);            \
+    c##r##1 = MADD(ar, b1, c##r##1);
+#define CORE_GEMM_KERNEL(MADD)                                                                 \
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps(), c10 = _mm256_setzero_ps(); \
+    __m256 c11 = _mm256_setzero_ps(), c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps(); \
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps(), c40 = _mm256_setzero_ps(); \
+    __m256 c41 = _mm256_setzero_ps(), c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps(); \
+    for (size_t p = 0; p < kc; ++p, a += MR, b += NR)                                         \
+    {                                                                                          \
+        const __m256 b0 = _mm256_loadu_ps(b);                                                  \
+        const __m256 b1 = _mm256_loadu_ps(b + 8);                                              \
+        __m256 ar;                                                                             \
+        CORE_GEMM_ROW(0, MADD)                                                                 \
+        CORE_GEMM_ROW(1, MADD)                                                                 \
+        CORE_GEMM_ROW(2, MADD)                                                                 \
+        CORE_GEMM_ROW(3, MADD)                                                                 \
+        CORE_GEMM_ROW(4, MADD)                                                                 \
+        CORE_GEMM_ROW(5, MADD)                                                                 \
+    }                                                                                          \
+    _mm256_storeu_ps(acc + 0, c00);                                                            \
+    _mm256_storeu_ps(acc + 8, c01);                                                            \
+    _mm256_storeu_ps(acc + 16, c10);                                                           \
+    _mm256_storeu_ps(acc + 24, c11);                                                           \
+    _mm256_storeu_ps(acc + 32, c20);                                                           \
+    _mm256_storeu_ps(acc + 40, c21);                                                           \
+    _mm256_storeu_ps(acc + 48, c30);                                                           \
+    _mm256_storeu_ps(acc + 56, c31);                                                           \
+    _mm256_storeu_ps(acc + 64, c40);                                                           \
+    _mm256_storeu_ps(acc + 72, c41);                                                           \
+    _mm256_storeu_ps(acc + 80, c50);                                                           \
+    _mm256_storeu_ps(acc + 88, c51);
+
+            static_assert(MR == 6 && NR == 16, "the AVX kernels are written for a 6 x 16 tile");
+
+            CORE_TARGET_AVX void kernel_avx(size_t kc, const float *a, const float *b, float *acc)
+            {
+                CORE_GEMM_KERNEL(CORE_MUL_ADD)
+            }
+
+            CORE_TARGET_FMA void kernel_fma(size_t kc, const float *a, const float *b, float *acc)
+            {
+                CORE_GEMM_KERNEL(_mm256_fmadd_ps)
+            }
+#undef CORE_GEMM_KERNEL
+#undef CORE_GEMM_ROW
+#undef CORE_MUL_ADD
+#endif
+
+            // GEMM carries no bit-exactness promise, so FMA is used whenever the
+            // backend allows AVX; SIMD::set_backend(SCALAR) forces the generic kernel
+            Kernel select_kernel()
+            {
+#ifdef CORE_GEMM_AVX
+                if (SIMD::get_backend() >= SIMD::AVX)
+                    return SIMD::is_supported(SIMD::FMA) ? kernel_fma : kernel_avx;
+#endif
+                return kernel_generic;
+            }
+
+            // rows [0, mc) x cols [0, kc) of a into MR-row panels, column-major inside a panel
+            void pack_a(size_t mc, size_t kc, const float *a, size_t lda, float *packed)
+            {
+                for (size_t ir = 0; ir < mc; ir += MR)
+                {
+                    const size_t mr = std::min(MR, mc - ir);
+                    for (size_t r = 0; r < mr; ++r)
+                    {
+                        const float *row = a + (ir + r) * lda;
+                        for (size_t p = 0; p < kc; ++p)
+                            packed[p * MR + r] = row[p];
+                    }
+                    for (size_t r = mr; r < MR; ++r)
+                    {
+                        for (size_t p = 0; p < kc; ++p)
+                            packed[p * MR + r] = 0.f;
+                    }
+                    packed += MR * kc;
+                }
+            }
+
+            // rows [0, kc) x cols [0, nc) of b into NR-column panels, row-major inside a panel
+            void pack_b(size_t kc, size_t nc, const float *b, size_t ldb, float *packed)
+            {
+                for (size_t jr = 0; jr < nc; jr += NR)
+                {
+                    const size_t nr = std::min(NR, nc - jr);
+                    for (size_t p = 0; p < kc; ++p)
+                    {
+                        const float *row = b + p * ldb + jr;
+                        float *dst = packed + p * NR;
+                        std::copy(row, row + nr, dst);
+                        std::fill(dst + nr, dst + NR, 0.f);
+                    }
+                    packed += NR * kc;
+                }
+            }
+
+            void store_tile(const float *acc, float *c, size_t ldc, size_t mr, size_t nr, float alpha, float beta)
+            {
+                for (size_t r = 0; r < mr; ++r)
+                {
+                    const float *src = acc + r * NR;
+                    float *dst = c + r * ldc;
+                    if (beta == 0.f)
+                    {
+                        for (size_t j = 0; j < nr; ++j)
+                            dst[j] = alpha * src[j];
+                    }
+                    else if (beta == 1.f)
+                    {
+                        for (size_t j = 0; j < nr; ++j)
+                            dst[j] += alpha * src[j];
+                    }
+                    else
+                    {
+                        for (size_t j = 0; j < nr; ++j)
+                            dst[j] = alpha * src[j] + beta * dst[j];
+                    }
+                }
+            }
+
+            size_t round_up(size_t x, size_t multiple)
+            {
+                return (x + multiple - 1) / multiple * multiple;
+            }
+        }
+
+        void set_gemm_threads(size_t threads)
+        {
+            gemm_threads = threads;
+        }
+
+        size_t get_gemm_threads()
+        {
+            size_t threads = gemm_threads;
+            if (threads == 0)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            return threads;
+        }
+
+        void gemm(size_t m, size_t n, size_t k,
+                  float alpha, const float *a, size_t lda,
+                  const float *b, size_t ldb,
+                  float beta, float *c, size_t ldc)
+        {
+            if (m == 0 || n == 0)
+                return;
+            if (k == 0 || alpha == 0.f)
+            {
+                for (size_t i = 0; i < m; ++i)
+                {
+                    float *row = c + i * ldc;
+                    for (size_t j = 0; j < n; ++j)
+                        row[j] = beta == 0.f ? 0.f : beta * row[j];
+                }
+                return;
+            }
+
+            const Kernel kernel = select_kernel();
+            const size_t flops = 2 * m * n * k;
+            const size_t threads = std::min({get_gemm_threads(), std::max<size_t>(1, flops / FLOPS_PER_THREAD),
+                                              (m + MR - 1) / MR});
+            // rows per block: at most MC, but small enough that every thread gets one
+            const size_t mc = std::min(MC, round_up((m + threads - 1) / threads, MR));
+
+            std::vector<float> packed_b(KC * round_up(std::min(n, NC), NR));
+            std::vector<std::vector<float>> packed_a(threads, std::vector<float>(MC * KC));
+
+            for (size_t jc = 0; jc < n; jc += NC)
+            {
+                const size_t nc = std::min(NC, n - jc);
+                for (size_t pc = 0; pc < k; pc += KC)
+                {
+                    const size_t kc = std::min(KC, k - pc);
+                    // beta only applies to the first slice of k, later ones accumulate
+                    const float beta_pc = pc == 0 ? beta : 1.f;
+                    pack_b(kc, nc, b + pc * ldb + jc, ldb, packed_b.data());
+
+                    auto work = [&, kc, nc, jc, pc, beta_pc](size_t t)
+                    {
+                        float acc[MR * NR];
+                        float *ap = packed_a[t].data();
+                        for (size_t ic = t * mc; ic < m; ic += threads * mc)
+                        {
+                            const size_t mcb = std::min(mc, m - ic);
+                            pack_a(mcb, kc, a + ic * lda + pc, lda, ap);
+                            for (size_t jr = 0; jr < nc; jr += NR)
+                            {
+                                const size_t nr = std::min(NR, nc - jr);
+                                const float *bp = packed_b.data() + jr * kc;
+                                for (size_t ir = 0; ir < mcb; ir += MR)
+                                {
+                                    const size_t mr = std::min(MR, mcb - ir);
+                                    kernel(kc, ap + ir * kc, bp, acc);
+                                    store_tile(acc, c + (ic + ir) * ldc + jc + jr, ldc, mr, nr, alpha, beta_pc);
+                                }
+                            }
+                        }
+                    };
+
+                    Jobs::parallel_for(0, threads, 1, [&](size_t begin, size_t end)
+                                       {
+                        for (size_t t = begin; t < end; ++t)
+                            work(t); });
+                }
+            }
+        }
+    };
+};
@@ -40,6 +40,31 @@ namespace Core::Geometry
         return vector * (1.0f / length);
     }
 
+    float distance(const Core::Vec2 &v1, const Core::Vec2 &v2)
+    {
+        return (v1 - v2).length();
+    }
+
+    float distance(const Core::Vec3 &v1, const Core::Vec3 &v2)
+    {
+        return (v1 - v2).length();
+    }
+
+    Core::Vec2 normalize(const Core::Vec2 &vector)
+    {
+        return vector.normalized();
+    }
+
+    Core::Vec3 normalize(const Core::Vec3 &vector)
+    {
+        return vector.normalized();
+    }
+
+    Core::Vec4 normalize(const Core::Vec4 &vector)
+    {
+        return vector.normalized();
+    }
+
     float dist_point_line(const Core::Vector &p, const Line &line)
     {
         Core::Vector v = p - line.origin;
@@ -73,7 +98,7 @@ namespace Core::Geometry
         return Core::Quaternion(cos(half_angle), x * sin_half_angle, y * sin_half_angle, z * sin_half_angle);
     }
 
-    Core::Quaternion angle_axis(float angle_rad, const Core::Vector3 &axis)
+    Core::Quaternion angle_axis(float angle_rad, const Core::Vec3 &axis)
     {
         return angle_axis(angle_rad, axis.x(), axis.y(), axis.z());
     }
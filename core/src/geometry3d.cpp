@@ -4,23 +4,23 @@
 #include "geometry/general.h"
 namespace Core::Geometry
 {
-    Core::Matrix4 translate(const Core::Matrix4 &matrix, float x, float y, float z) // column major
+    Core::Mat4 translate(const Core::Mat4 &matrix, float x, float y, float z) // column major
     {
-        Core::Matrix4 rslt = matrix;
+        Core::Mat4 rslt = matrix;
         rslt(3, 0) += x;
         rslt(3, 1) += y;
         rslt(3, 2) += z;
         return rslt;
     }
 
-    Core::Matrix4 translate(const Core::Matrix4 &matrix, const Core::Vector3 &translation)
+    Core::Mat4 translate(const Core::Mat4 &matrix, const Core::Vec3 &translation)
     {
         return translate(matrix, translation.x(), translation.y(), translation.z());
     }
 
-    Core::Matrix4 rotate(const Core::Matrix4 &matrix, float angle_rad, float x, float y, float z)
+    Core::Mat4 rotate(const Core::Mat4 &matrix, float angle_rad, float x, float y, float z)
     {
-        Core::Matrix4 rslt = matrix;
+        Core::Mat4 rslt = matrix;
         float c = std::cos(angle_rad);
         float s = std::sin(angle_rad);
         float t = 1 - c;
@@ -36,15 +36,15 @@ namespace Core::Geometry
         return rslt;
     }
 
-    Core::Matrix4 rotate(const Core::Matrix4 &matrix, float angle_rad, Core::Vector3 axis)
+    Core::Mat4 rotate(const Core::Mat4 &matrix, float angle_rad, Core::Vec3 axis)
     {
         axis = normalize(axis);
         return rotate(matrix, angle_rad, axis.x(), axis.y(), axis.z());
     }
 
-    Core::Matrix4 scale(const Core::Matrix4 &matrix, float x, float y, float z) // column major
+    Core::Mat4 scale(const Core::Mat4 &matrix, float x, float y, float z) // column major
     {
-        Core::Matrix4 rslt = matrix;
+        Core::Mat4 rslt = matrix;
         rslt(0, 0) *= x;
         rslt(0, 1) *= x;
         rslt(0, 2) *= x;
@@ -60,35 +60,35 @@ namespace Core::Geometry
         return rslt;
     }
 
-    Core::Matrix4 scale(const Core::Matrix4 &matrix, float scalar)
+    Core::Mat4 scale(const Core::Mat4 &matrix, float scalar)
     {
         return scale(matrix, scalar, scalar, scalar);
     }
 
-    Core::Matrix4 scale(const Core::Matrix4 &matrix, const Core::Vector3 &scalar)
+    Core::Mat4 scale(const Core::Mat4 &matrix, const Core::Vec3 &scalar)
     {
         return scale(matrix, scalar.x(), scalar.y(), scalar.z());
     }
 
-    Core::Matrix4 look_at(const Core::Vector3 &eye, const Core::Vector3 &center, const Core::Vector3 &up)
+    Core::Mat4 look_at(const Core::Vec3 &eye, const Core::Vec3 &center, const Core::Vec3 &up)
     {
-        Core::Vector3 f = normalize(center - eye);
-        Core::Vector3 s = normalize(Core::Vector3::cross(f, up));
-        Core::Vector3 u = Core::Vector3::cross(s, f);
+        Core::Vec3 f = normalize(center - eye);
+        Core::Vec3 s = normalize(Core::Vec3::cross(f, up));
+        Core::Vec3 u = Core::Vec3::cross(s, f);
 
-        Core::Matrix4 rslt;
+        Core::Mat4 rslt;
         rslt(0, 0) = s.x();
         rslt(1, 0) = s.y();
         rslt(2, 0) = s.z();
-        rslt(3, 0) = -Core::Vector::dot(s, eye);
+        rslt(3, 0) = -Core::Vec3::dot(s, eye);
         rslt(0, 1) = u.x();
         rslt(1, 1) = u.y();
         rslt(2, 1) = u.z();
-        rslt(3, 1) = -Core::Vector::dot(u, eye);
+        rslt(3, 1) = -Core::Vec3::dot(u, eye);
         rslt(0, 2) = -f.x();
         rslt(1, 2) = -f.y();
         rslt(2, 2) = -f.z();
-        rslt(3, 2) = Core::Vector::dot(f, eye);
+        rslt(3, 2) = Core::Vec3::dot(f, eye);
         rslt(0, 3) = 0;
         rslt(1, 3) = 0;
         rslt(2, 3) = 0;
@@ -96,9 +96,9 @@ namespace Core::Geometry
 
         return rslt;
     }
-    Core::Matrix4 perspective(float fov_rad, float aspect, float near, float far)
+    Core::Mat4 perspective(float fov_rad, float aspect, float near, float far)
     {
-        Core::Matrix4 rslt = Core::Matrix4::identity();
+        Core::Mat4 rslt = Core::Mat4::identity();
         float f = 1.0f / std::tan(fov_rad * 0.5f);
         rslt(0, 0) = f / aspect;
         rslt(1, 1) = f;
@@ -109,9 +109,9 @@ namespace Core::Geometry
         return rslt;
     }
 
-    Core::Matrix4 orthographic(float left, float right, float bottom, float top, float near, float far)
+    Core::Mat4 orthographic(float left, float right, float bottom, float top, float near, float far)
     {
-        Core::Matrix4 rslt = Core::Matrix4::identity();
+        Core::Mat4 rslt = Core::Mat4::identity();
         rslt(0, 0) = 2.f / (right - left);
         rslt(1, 1) = 2.f / (top - bottom);
         rslt(2, 2) = -2.f / (far - near);
@@ -121,14 +121,14 @@ namespace Core::Geometry
         return rslt;
     }
 
-    Core::Matrix4 orthographic(float left, float right, float bottom, float top)
+    Core::Mat4 orthographic(float left, float right, float bottom, float top)
     {
         return orthographic(left, right, bottom, top, -1.f, 1.f);
     }
 
-    Core::Matrix4 frustum(float left, float right, float bottom, float top, float near, float far)
+    Core::Mat4 frustum(float left, float right, float bottom, float top, float near, float far)
     {
-        Core::Matrix4 rslt = Core::Matrix4::identity();
+        Core::Mat4 rslt = Core::Mat4::identity();
         rslt(0, 0) = 2.f * near / (right - left);
         rslt(1, 1) = 2.f * near / (top - bottom);
         rslt(2, 0) = (right + left) / (right - left);
@@ -140,33 +140,33 @@ namespace Core::Geometry
         return rslt;
     }
 
-    Core::Quaternion quat_look_at(const Core::Vector3 &direction, const Core::Vector3 &up)
+    Core::Quaternion quat_look_at(const Core::Vec3 &direction, const Core::Vec3 &up)
     {
-        Core::Matrix3 m = Core::Matrix3::identity();
-        Core::Vector3 front = -direction;
+        Core::Mat3 m = Core::Mat3::identity();
+        Core::Vec3 front = -direction;
         m(2, 0) = front.x();
         m(2, 1) = front.y();
         m(2, 2) = front.z();
-        Core::Vector3 right = Core::Vector3::cross(up, front);
-        float inv_sqrt = 1.f / std::sqrt(std::fmax(Core::Constants::EPSILON_F, Core::Vector3::dot(right, right)));
+        Core::Vec3 right = Core::Vec3::cross(up, front);
+        float inv_sqrt = 1.f / std::sqrt(std::fmax(Core::Constants::EPSILON_F, Core::Vec3::dot(right, right)));
         right *= inv_sqrt;
         m(0, 0) = right.x();
         m(0, 1) = right.y();
         m(0, 2) = right.z();
-        Core::Vector3 up_ = normalize(Core::Vector3::cross(front, right));
+        Core::Vec3 up_ = normalize(Core::Vec3::cross(front, right));
         m(1, 0) = up_.x();
         m(1, 1) = up_.y();
         m(1, 2) = up_.z();
         return Core::Quaternion::from_matrix(m);
     }
 
-    void orthonomalize(Core::Vector3 &up, Core::Vector3 &front, Core::Vector3 &right)
+    void orthonomalize(Core::Vec3 &up, Core::Vec3 &front, Core::Vec3 &right)
     {
         up = normalize(up);
         front = normalize(front);
         right = normalize(right);
-        right = normalize(Core::Vector3::cross(front, up));
-        up = Core::Vector3::cross(right, front);
+        right = normalize(Core::Vec3::cross(front, up));
+        up = Core::Vec3::cross(right, front);
     }
 
 }
@@ -0,0 +1,290 @@
+#include "jobs.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+
+namespace Core::Jobs
+{
+    namespace
+    {
+        struct Task
+        {
+            Job job;
+            Counter *counter = nullptr;
+        };
+
+        // a mutex is plenty here: jobs are coarse and the owner and thieves
+        // touch opposite ends
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+    }
+
+    class Scheduler
+    {
+        // attributes
+    private:
+        std::vector<std::unique_ptr<Queue>> queues; // one per worker
+        Queue shared;                               // jobs from outside the pool
+        std::vector<std::thread> workers;
+        std::atomic<size_t> queued{0};
+        std::atomic<size_t> sleeping{0};
+        std::atomic<bool> stopping{false};
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+
+        static thread_local Scheduler *owner;
+        static thread_local size_t index;
+
+        // constructors and deconstructor
+    public:
+        explicit Scheduler(size_t worker_count)
+        {
+            for (size_t i = 0; i < worker_count; ++i)
+                queues.emplace_back(new Queue());
+            for (size_t i = 0; i < worker_count; ++i)
+                workers.emplace_back([this, i]
+                                     { loop(i); });
+        }
+
+        ~Scheduler()
+        {
+            // whatever is still queued runs before the workers leave
+            while (help())
+                ;
+            stopping = true;
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+            }
+            wake.notify_all();
+            for (auto &worker : workers)
+                worker.join();
+        }
+
+        // methods
+    public:
+        size_t worker_count() const { return workers.size(); }
+        size_t worker_index() const { return owner == this ? index : NONE; }
+
+        void run(Job job, Counter *counter)
+        {
+            if (counter)
+                counter->add(1);
+            submit({std::move(job), counter});
+        }
+
+        void run_after(Counter &dependency, Job job, Counter *counter)
+        {
+            if (counter)
+                counter->add(1);
+            {
+                // finish() takes the list under the same lock after the count hit zero
+                std::lock_guard<std::mutex> lock(dependency.mutex);
+                if (!dependency.done())
+                {
+                    dependency.continuations.emplace_back(std::move(job), counter);
+                    return;
+                }
+            }
+            submit({std::move(job), counter});
+        }
+
+        void wait(Counter &counter)
+        {
+            while (!counter.done())
+            {
+                if (!help())
+                    std::this_thread::yield();
+            }
+            // the job that brought it to zero may still hold the lock, see finish()
+            std::lock_guard<std::mutex> lock(counter.mutex);
+        }
+
+        bool help()
+        {
+            Task task;
+            if (!pop(worker_index(), task))
+                return false;
+            execute(task);
+            return true;
+        }
+
+        // The decrement happens under the counter's lock and wait() takes that
+        // lock once after it saw zero, so a waiter can only return, and destroy
+        // a Counter on its stack, after this thread let go of it.
+        void finish(Counter &counter)
+        {
+            std::vector<std::pair<Job, Counter *>> ready;
+            {
+                std::lock_guard<std::mutex> lock(counter.mutex);
+                if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    return;
+                ready.swap(counter.continuations);
+            }
+            // the counter may be gone from here on
+            for (auto &continuation : ready)
+                submit({std::move(continuation.first), continuation.second});
+        }
+
+    private:
+        void submit(Task task)
+        {
+            const size_t i = worker_index();
+            Queue &queue = i == NONE ? shared : *queues[i];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+            queued.fetch_add(1);
+            if (sleeping.load() > 0)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(sleep_mutex);
+                }
+                wake.notify_one();
+            }
+        }
+
+        static bool take(Queue &queue, Task &task, bool back)
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                return false;
+            if (back)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            return true;
+        }
+
+        // own jobs newest first, then the shared queue, then steal the oldest of another worker
+        bool pop(size_t i, Task &task)
+        {
+            if (queued.load(std::memory_order_relaxed) == 0)
+                return false;
+            bool found = (i != NONE && take(*queues[i], task, true)) || take(shared, task, false);
+            const size_t n = queues.size();
+            for (size_t k = 1; !found && k <= n; ++k)
+            {
+                const size_t victim = i == NONE ? k - 1 : (i + k) % n;
+                found = victim != i && take(*queues[victim], task, false);
+            }
+            if (found)
+                queued.fetch_sub(1);
+            return found;
+        }
+
+        void execute(Task &task)
+        {
+            task.job();
+            if (task.counter)
+                finish(*task.counter);
+        }
+
+        void loop(size_t i)
+        {
+            owner = this;
+            index = i;
+            while (!stopping)
+            {
+                Task task;
+                if (pop(i, task))
+                {
+                    execute(task);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                sleeping.fetch_add(1);
+                wake.wait(lock, [this]
+                          { return stopping || queued.load() > 0; });
+                sleeping.fetch_sub(1);
+            }
+        }
+    };
+
+    thread_local Scheduler *Scheduler::owner = nullptr;
+    thread_local size_t Scheduler::index = NONE;
+
+    namespace
+    {
+        std::mutex pool_mutex;
+        std::unique_ptr<Scheduler> pool_holder;
+        std::atomic<Scheduler *> pool_ptr{nullptr};
+
+        size_t default_threads()
+        {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        Scheduler &pool()
+        {
+            Scheduler *rslt = pool_ptr.load(std::memory_order_acquire);
+            if (rslt)
+                return *rslt;
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (!pool_holder)
+            {
+                pool_holder.reset(new Scheduler(default_threads() - 1));
+                pool_ptr.store(pool_holder.get(), std::memory_order_release);
+            }
+            return *pool_holder;
+        }
+    }
+
+    void init(size_t threads)
+    {
+        if (threads == 0)
+            threads = default_threads();
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_ptr = nullptr;
+        pool_holder.reset();
+        pool_holder.reset(new Scheduler(threads - 1));
+        pool_ptr.store(pool_holder.get(), std::memory_order_release);
+    }
+
+    void shutdown()
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_ptr = nullptr;
+        pool_holder.reset();
+    }
+
+    size_t get_worker_count()
+    {
+        return pool().worker_count();
+    }
+
+    size_t get_worker_index()
+    {
+        return pool().worker_index();
+    }
+
+    void run(Job job, Counter *counter)
+    {
+        pool().run(std::move(job), counter);
+    }
+
+    void run_after(Counter &dependency, Job job, Counter *counter)
+    {
+        pool().run_after(dependency, std::move(job), counter);
+    }
+
+    void wait(Counter &counter)
+    {
+        pool().wait(counter);
+    }
+
+    bool help()
+    {
+        return pool().help();
+    }
+} // namespace Core::Jobs
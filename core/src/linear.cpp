@@ -0,0 +1,596 @@
+#include "math/linear.h"
+#include "math/gemm.h"
+#include <algorithm>
+#include <cfloat>
+#include <stdexcept>
+#include <string>
+
+namespace Core
+{
+    namespace Math
+    {
+        namespace
+        {
+            // columns held in registers by the update kernels
+            constexpr size_t TILE = 16;
+
+            float dot(const float *a, const float *b, size_t n)
+            {
+                // independent partial sums so the loop does not serialise on one add
+                float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    s0 += a[i] * b[i];
+                    s1 += a[i + 1] * b[i + 1];
+                    s2 += a[i + 2] * b[i + 2];
+                    s3 += a[i + 3] * b[i + 3];
+                }
+                for (; i < n; ++i)
+                    s0 += a[i] * b[i];
+                return (s0 + s1) + (s2 + s3);
+            }
+
+            // row -= scalar * source
+            void axpy(float *row, const float *source, float scalar, size_t n)
+            {
+                for (size_t j = 0; j < n; ++j)
+                    row[j] -= scalar * source[j];
+            }
+
+            // c[j] -= sum_k l[k] * u(k, j) for j < width, u has stride ldu; the running
+            // values of c are kept in a small tile so only u is streamed from memory
+            void rank_update(float *c, const float *l, const float *u, size_t ldu, size_t depth, size_t width)
+            {
+                size_t j = 0;
+                for (; j + TILE <= width; j += TILE)
+                {
+                    float acc[TILE];
+                    for (size_t t = 0; t < TILE; ++t)
+                        acc[t] = c[j + t];
+                    for (size_t k = 0; k < depth; ++k)
+                    {
+                        const float lk = l[k];
+                        const float *uk = u + k * ldu + j;
+                        for (size_t t = 0; t < TILE; ++t)
+                            acc[t] -= lk * uk[t];
+                    }
+                    for (size_t t = 0; t < TILE; ++t)
+                        c[j + t] = acc[t];
+                }
+                for (; j < width; ++j)
+                {
+                    float acc = c[j];
+                    for (size_t k = 0; k < depth; ++k)
+                        acc -= l[k] * u[k * ldu + j];
+                    c[j] = acc;
+                }
+            }
+
+            float max_abs(const Matrix &matrix)
+            {
+                float rslt = 0.f;
+                const float *a = matrix.data();
+                for (size_t i = 0; i < matrix.size(); ++i)
+                    rslt = std::max(rslt, std::fabs(a[i]));
+                return rslt;
+            }
+
+            // forward substitution on the rows of b (n x nrhs), l is n x n with stride ldl
+            void lower_solve(const float *l, size_t ldl, size_t n, float *b, size_t nrhs, bool unit_diagonal)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    float *bi = b + i * nrhs;
+                    const float *li = l + i * ldl;
+                    for (size_t k = 0; k < i; ++k)
+                    {
+                        if (li[k] != 0.f)
+                            axpy(bi, b + k * nrhs, li[k], nrhs);
+                    }
+                    if (!unit_diagonal)
+                    {
+                        for (size_t j = 0; j < nrhs; ++j)
+                            bi[j] /= li[i];
+                    }
+                }
+            }
+
+            // back substitution on the rows of b (n x nrhs), u is n x n with stride ldu
+            void upper_solve(const float *u, size_t ldu, size_t n, float *b, size_t nrhs, bool unit_diagonal)
+            {
+                for (size_t i = n; i-- > 0;)
+                {
+                    float *bi = b + i * nrhs;
+                    const float *ui = u + i * ldu;
+                    for (size_t k = i + 1; k < n; ++k)
+                    {
+                        if (ui[k] != 0.f)
+                            axpy(bi, b + k * nrhs, ui[k], nrhs);
+                    }
+                    if (!unit_diagonal)
+                    {
+                        for (size_t j = 0; j < nrhs; ++j)
+                            bi[j] /= ui[i];
+                    }
+                }
+            }
+
+            // solves L^T x = b, sweeping the rows of L instead of its columns
+            void lower_transposed_solve(const float *l, size_t n, float *b, size_t nrhs)
+            {
+                for (size_t i = n; i-- > 0;)
+                {
+                    float *bi = b + i * nrhs;
+                    const float *li = l + i * n;
+                    for (size_t j = 0; j < nrhs; ++j)
+                        bi[j] /= li[i];
+                    for (size_t k = 0; k < i; ++k)
+                    {
+                        if (li[k] != 0.f)
+                            axpy(b + k * nrhs, bi, li[k], nrhs);
+                    }
+                }
+            }
+
+            // applies H = I - tau * v * v^T to the columns [c0, c1) of the rows [k, m) of c,
+            // v(k) = 1 and v(i) = qr(i, k) below, qr has stride ldv
+            void apply_reflector(const float *qr, size_t ldv, size_t k, size_t m, float tau,
+                                 float *c, size_t ldc, size_t c0, size_t c1, std::vector<float> &w)
+            {
+                if (tau == 0.f || c0 >= c1)
+                    return;
+                const size_t width = c1 - c0;
+                w.assign(c + k * ldc + c0, c + k * ldc + c1);
+                for (size_t i = k + 1; i < m; ++i)
+                {
+                    const float vi = qr[i * ldv + k];
+                    const float *ci = c + i * ldc + c0;
+                    for (size_t j = 0; j < width; ++j)
+                        w[j] += vi * ci[j];
+                }
+                axpy(c + k * ldc + c0, w.data(), tau, width);
+                for (size_t i = k + 1; i < m; ++i)
+                {
+                    const float vi = qr[i * ldv + k];
+                    if (vi != 0.f)
+                        axpy(c + i * ldc + c0, w.data(), tau * vi, width);
+                }
+            }
+
+            void check_rhs(const char *name, size_t rows, const Matrix &b)
+            {
+                if (b.rows() != rows)
+                    throw std::runtime_error(std::string(name) + ": right hand side has the wrong number of rows");
+            }
+        }
+
+        /*-------------------------------- LU --------------------------------*/
+
+        LU::LU(const Matrix &matrix)
+            : lu(matrix), pivots(matrix.rows()), parity(1), singular(false)
+        {
+            if (!matrix.is_square())
+                throw std::runtime_error("Math::LU: matrix must be square");
+
+            const size_t n = lu.rows();
+            float *a = lu.data();
+            const float tolerance = n * FLT_EPSILON * max_abs(matrix);
+
+            for (size_t k0 = 0; k0 < n; k0 += BLOCK_SIZE)
+            {
+                const size_t k1 = std::min(n, k0 + BLOCK_SIZE);
+
+                // factor the panel [k0, k1), row swaps are applied to whole rows
+                for (size_t k = k0; k < k1; ++k)
+                {
+                    size_t p = k;
+                    float max = std::fabs(a[k * n + k]);
+                    for (size_t i = k + 1; i < n; ++i)
+                    {
+                        float v = std::fabs(a[i * n + k]);
+                        if (v > max)
+                        {
+                            max = v;
+                            p = i;
+                        }
+                    }
+                    pivots[k] = p;
+                    if (p != k)
+                    {
+                        std::swap_ranges(a + k * n, a + k * n + n, a + p * n);
+                        parity = -parity;
+                    }
+                    if (max <= tolerance)
+                        singular = true;
+                    if (max == 0.f)
+                        continue;
+
+                    const float *rk = a + k * n;
+                    for (size_t i = k + 1; i < n; ++i)
+                    {
+                        float *ri = a + i * n;
+                        ri[k] /= rk[k];
+                        if (ri[k] != 0.f)
+                            axpy(ri + k + 1, rk + k + 1, ri[k], k1 - k - 1);
+                    }
+                }
+                if (k1 == n)
+                    break;
+
+                // U12 = L11^-1 * A12
+                for (size_t k = k0; k < k1; ++k)
+                {
+                    const float *rk = a + k * n;
+                    for (size_t i = k + 1; i < k1; ++i)
+                    {
+                        float *ri = a + i * n;
+                        if (ri[k] != 0.f)
+                            axpy(ri + k1, rk + k1, ri[k], n - k1);
+                    }
+                }
+
+                // A22 -= L21 * U12
+                gemm(n - k1, n - k1, k1 - k0, -1.f, a + k1 * n + k0, n, a + k0 * n + k1, n, 1.f, a + k1 * n + k1, n);
+            }
+        }
+
+        std::vector<size_t> LU::pivot_order() const
+        {
+            std::vector<size_t> rslt(dim());
+            for (size_t i = 0; i < rslt.size(); ++i)
+                rslt[i] = i;
+            for (size_t k = 0; k < pivots.size(); ++k)
+                std::swap(rslt[k], rslt[pivots[k]]);
+            return rslt;
+        }
+
+        Matrix LU::lower() const
+        {
+            Matrix rslt(dim(), dim());
+            for (size_t i = 0; i < dim(); ++i)
+            {
+                for (size_t j = 0; j < i; ++j)
+                    rslt(i, j) = lu(i, j);
+                rslt(i, i) = 1.f;
+            }
+            return rslt;
+        }
+
+        Matrix LU::upper() const
+        {
+            Matrix rslt(dim(), dim());
+            for (size_t i = 0; i < dim(); ++i)
+            {
+                for (size_t j = i; j < dim(); ++j)
+                    rslt(i, j) = lu(i, j);
+            }
+            return rslt;
+        }
+
+        float LU::determinant() const
+        {
+            double rslt = parity;
+            for (size_t i = 0; i < dim(); ++i)
+                rslt *= lu(i, i);
+            return static_cast<float>(rslt);
+        }
+
+        Matrix LU::solve(const Matrix &b) const
+        {
+            check_rhs("Math::LU::solve", dim(), b);
+            if (singular)
+                throw std::runtime_error("Math::LU::solve: matrix is singular");
+
+            const size_t nrhs = b.cols();
+            Matrix rslt(b);
+            float *x = rslt.data();
+            for (size_t k = 0; k < pivots.size(); ++k)
+            {
+                if (pivots[k] != k)
+                    std::swap_ranges(x + k * nrhs, x + (k + 1) * nrhs, x + pivots[k] * nrhs);
+            }
+            lower_solve(lu.data(), dim(), dim(), x, nrhs, true);
+            upper_solve(lu.data(), dim(), dim(), x, nrhs, false);
+            return rslt;
+        }
+
+        MatrixS LU::inverse() const
+        {
+            return solve(MatrixS::identity(dim()));
+        }
+
+        /*-------------------------------- QR --------------------------------*/
+
+        QR::QR(const Matrix &matrix)
+            : qr(matrix), tau(matrix.cols()), full_rank(true)
+        {
+            if (matrix.rows() < matrix.cols())
+                throw std::runtime_error("Math::QR: matrix must have at least as many rows as columns");
+
+            const size_t m = qr.rows();
+            const size_t n = qr.cols();
+            float *a = qr.data();
+            const float tolerance = m * FLT_EPSILON * max_abs(matrix);
+            std::vector<float> w, v, t(BLOCK_SIZE * BLOCK_SIZE), g(BLOCK_SIZE * BLOCK_SIZE);
+
+            for (size_t k0 = 0; k0 < n; k0 += BLOCK_SIZE)
+            {
+                const size_t k1 = std::min(n, k0 + BLOCK_SIZE);
+                const size_t kb = k1 - k0;
+
+                // unblocked Householder on the panel
+                for (size_t k = k0; k < k1; ++k)
+                {
+                    const float alpha = a[k * n + k];
+                    float sigma = 0.f;
+                    for (size_t i = k + 1; i < m; ++i)
+                        sigma += a[i * n + k] * a[i * n + k];
+
+                    if (sigma == 0.f)
+                        tau[k] = 0.f;
+                    else
+                    {
+                        const float beta = -std::copysign(std::sqrt(alpha * alpha + sigma), alpha);
+                        const float scale = 1.f / (alpha - beta);
+                        tau[k] = (beta - alpha) / beta;
+                        for (size_t i = k + 1; i < m; ++i)
+                            a[i * n + k] *= scale;
+                        a[k * n + k] = beta;
+                    }
+                    if (std::fabs(a[k * n + k]) <= tolerance)
+                        full_rank = false;
+                    apply_reflector(a, n, k, m, tau[k], a, n, k + 1, k1, w);
+                }
+                if (k1 == n)
+                    break;
+
+                // copy V (rows [k0, m), kb columns) out with its explicit zeros and ones
+                v.assign((m - k0) * kb, 0.f);
+                for (size_t r = k0; r < m; ++r)
+                {
+                    float *vr = v.data() + (r - k0) * kb;
+                    for (size_t p = 0; p < kb && k0 + p <= r; ++p)
+                        vr[p] = k0 + p == r ? 1.f : a[r * n + k0 + p];
+                }
+
+                // H_k0 ... H_k1-1 = I - V * T * V^T, T built from G = V^T * V
+                std::fill(g.begin(), g.end(), 0.f);
+                for (size_t r = 0; r < m - k0; ++r)
+                {
+                    const float *vr = v.data() + r * kb;
+                    for (size_t p = 0; p < kb; ++p)
+                    {
+                        for (size_t q = 0; q < p; ++q)
+                            g[q * kb + p] += vr[q] * vr[p];
+                    }
+                }
+                std::fill(t.begin(), t.end(), 0.f);
+                for (size_t p = 0; p < kb; ++p)
+                {
+                    // T(0:p, p) = -tau_p * T(0:p, 0:p) * G(0:p, p)
+                    for (size_t q = 0; q < p; ++q)
+                    {
+                        float sum = 0.f;
+                        for (size_t s = q; s < p; ++s)
+                            sum += t[q * kb + s] * g[s * kb + p];
+                        t[q * kb + p] = -tau[k0 + p] * sum;
+                    }
+                    t[p * kb + p] = tau[k0 + p];
+                }
+
+                // A2 = (I - V * T^T * V^T) * A2 through W = T^T * V^T * A2,
+                // V^T * A2 is accumulated TILE columns at a time
+                const size_t n2 = n - k1;
+                w.assign(kb * n2, 0.f);
+                for (size_t j0 = 0; j0 < n2; j0 += TILE)
+                {
+                    const size_t width = std::min(TILE, n2 - j0);
+                    float acc[BLOCK_SIZE * TILE] = {};
+                    for (size_t r = k0; r < m; ++r)
+                    {
+                        const float *row = a + r * n + k1 + j0;
+                        const float *vr = v.data() + (r - k0) * kb;
+                        for (size_t p = 0; p < kb; ++p)
+                        {
+                            float *ap = acc + p * TILE;
+                            if (width == TILE)
+                            {
+                                for (size_t j = 0; j < TILE; ++j)
+                                    ap[j] += vr[p] * row[j];
+                            }
+                            else
+                            {
+                                for (size_t j = 0; j < width; ++j)
+                                    ap[j] += vr[p] * row[j];
+                            }
+                        }
+                    }
+                    for (size_t p = 0; p < kb; ++p)
+                        std::copy(acc + p * TILE, acc + p * TILE + width, w.data() + p * n2 + j0);
+                }
+                for (size_t p = kb; p-- > 0;)
+                {
+                    float *wp = w.data() + p * n2;
+                    for (size_t j = 0; j < n2; ++j)
+                        wp[j] *= t[p * kb + p];
+                    for (size_t q = 0; q < p; ++q)
+                        axpy(wp, w.data() + q * n2, -t[q * kb + p], n2);
+                }
+                for (size_t r = k0; r < m; ++r)
+                    rank_update(a + r * n + k1, v.data() + (r - k0) * kb, w.data(), n2, kb, n2);
+            }
+        }
+
+        Matrix QR::q() const
+        {
+            const size_t m = qr.rows();
+            const size_t n = qr.cols();
+            Matrix rslt(m, n);
+            for (size_t i = 0; i < n; ++i)
+                rslt(i, i) = 1.f;
+            std::vector<float> w;
+            for (size_t k = n; k-- > 0;)
+                apply_reflector(qr.data(), n, k, m, tau[k], rslt.data(), n, k, n, w);
+            return rslt;
+        }
+
+        Matrix QR::r() const
+        {
+            const size_t n = qr.cols();
+            Matrix rslt(n, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                for (size_t j = i; j < n; ++j)
+                    rslt(i, j) = qr(i, j);
+            }
+            return rslt;
+        }
+
+        Matrix QR::solve(const Matrix &b) const
+        {
+            const size_t m = qr.rows();
+            const size_t n = qr.cols();
+            check_rhs("Math::QR::solve", m, b);
+            if (!full_rank)
+                throw std::runtime_error("Math::QR::solve: matrix is rank deficient");
+
+            // y = Q^T * b
+            const size_t nrhs = b.cols();
+            Matrix y(b);
+            std::vector<float> w;
+            for (size_t k = 0; k < n; ++k)
+                apply_reflector(qr.data(), n, k, m, tau[k], y.data(), nrhs, 0, nrhs, w);
+
+            Matrix rslt(y.data(), n, nrhs, true);
+            upper_solve(qr.data(), n, n, rslt.data(), nrhs, false);
+            return rslt;
+        }
+
+        /*----------------------------- Cholesky -----------------------------*/
+
+        Cholesky::Cholesky(const Matrix &matrix)
+            : l(matrix), positive_definite(true)
+        {
+            if (!matrix.is_square())
+                throw std::runtime_error("Math::Cholesky: matrix must be square");
+
+            const size_t n = l.rows();
+            float *a = l.data();
+
+            for (size_t k0 = 0; k0 < n && positive_definite; k0 += BLOCK_SIZE)
+            {
+                const size_t k1 = std::min(n, k0 + BLOCK_SIZE);
+
+                // diagonal block, the earlier panels are already subtracted
+                for (size_t j = k0; j < k1; ++j)
+                {
+                    float *rj = a + j * n;
+                    const float d = rj[j] - dot(rj + k0, rj + k0, j - k0);
+                    if (!(d > 0.f))
+                    {
+                        positive_definite = false;
+                        break;
+                    }
+                    rj[j] = std::sqrt(d);
+                    for (size_t i = j + 1; i < k1; ++i)
+                    {
+                        float *ri = a + i * n;
+                        ri[j] = (ri[j] - dot(ri + k0, rj + k0, j - k0)) / rj[j];
+                    }
+                }
+                if (!positive_definite || k1 == n)
+                    break;
+
+                // L21 = A21 * L11^-T
+                for (size_t i = k1; i < n; ++i)
+                {
+                    float *ri = a + i * n;
+                    for (size_t j = k0; j < k1; ++j)
+                    {
+                        const float *rj = a + j * n;
+                        ri[j] = (ri[j] - dot(ri + k0, rj + k0, j - k0)) / rj[j];
+                    }
+                }
+
+                // A22 -= L21 * L21^T, lower triangle only
+                for (size_t i = k1; i < n; ++i)
+                {
+                    float *ri = a + i * n;
+                    for (size_t j = k1; j <= i; ++j)
+                        ri[j] -= dot(ri + k0, a + j * n + k0, k1 - k0);
+                }
+            }
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                for (size_t j = i + 1; j < n; ++j)
+                    a[i * n + j] = 0.f;
+            }
+        }
+
+        float Cholesky::determinant() const
+        {
+            double rslt = 1.0;
+            for (size_t i = 0; i < l.rows(); ++i)
+                rslt *= static_cast<double>(l(i, i)) * l(i, i);
+            return positive_definite ? static_cast<float>(rslt) : 0.f;
+        }
+
+        Matrix Cholesky::solve(const Matrix &b) const
+        {
+            check_rhs("Math::Cholesky::solve", l.rows(), b);
+            if (!positive_definite)
+                throw std::runtime_error("Math::Cholesky::solve: matrix is not positive definite");
+
+            Matrix rslt(b);
+            lower_solve(l.data(), l.rows(), l.rows(), rslt.data(), b.cols(), false);
+            lower_transposed_solve(l.data(), l.rows(), rslt.data(), b.cols());
+            return rslt;
+        }
+
+        MatrixS Cholesky::inverse() const
+        {
+            return solve(MatrixS::identity(l.rows()));
+        }
+
+        /*------------------------------ helpers -----------------------------*/
+
+        Matrix solve_lower(const Matrix &l, const Matrix &b, bool unit_diagonal)
+        {
+            if (!l.is_square())
+                throw std::runtime_error("Math::solve_lower: matrix must be square");
+            check_rhs("Math::solve_lower", l.rows(), b);
+            Matrix rslt(b);
+            lower_solve(l.data(), l.cols(), l.rows(), rslt.data(), b.cols(), unit_diagonal);
+            return rslt;
+        }
+
+        Matrix solve_upper(const Matrix &u, const Matrix &b, bool unit_diagonal)
+        {
+            if (!u.is_square())
+                throw std::runtime_error("Math::solve_upper: matrix must be square");
+            check_rhs("Math::solve_upper", u.rows(), b);
+            Matrix rslt(b);
+            upper_solve(u.data(), u.cols(), u.rows(), rslt.data(), b.cols(), unit_diagonal);
+            return rslt;
+        }
+
+        Matrix solve(const Matrix &a, const Matrix &b)
+        {
+            if (a.is_square())
+                return LU(a).solve(b);
+            return QR(a).solve(b);
+        }
+
+        MatrixS inverse(const Matrix &matrix)
+        {
+            return LU(matrix).inverse();
+        }
+
+        float determinant(const Matrix &matrix)
+        {
+            return LU(matrix).determinant();
+        }
+    };
+};
@@ -0,0 +1,305 @@
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+namespace Core
+{
+    namespace
+    {
+        // entries popped per history/file update
+        constexpr size_t DRAIN_BATCH = 256;
+        // a wakeup lost to the lock-free notify costs at most this much latency
+        constexpr auto IDLE_WAIT = std::chrono::milliseconds(10);
+
+        uint32_t thread_number()
+        {
+            static std::atomic<uint32_t> next{0};
+            thread_local const uint32_t number = next++;
+            return number;
+        }
+
+        size_t round_up_pow2(size_t n)
+        {
+            size_t rslt = 2;
+            while (rslt < n)
+                rslt <<= 1;
+            return rslt;
+        }
+    }
+
+    Logger::Logger(size_t capacity, size_t history_capacity)
+        : cells(new Cell[round_up_pow2(capacity)]),
+          mask(round_up_pow2(capacity) - 1),
+          history_capacity(std::max<size_t>(1, history_capacity))
+    {
+        for (size_t i = 0; i <= mask; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        consumer = std::thread(&Logger::run, this);
+    }
+
+    Logger::~Logger()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        consumer.join();
+    }
+
+    bool Logger::log(Level level, const char *msg, size_t length)
+    {
+        // bounded MPSC queue: a cell is free for position pos when its sequence is pos
+        // and holds an entry for the consumer once it is pos + 1
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &cells[pos & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                ++dropped;
+                return false;
+            }
+            else
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+        fill(cell->entry, level, msg, length);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        if (waiting.load())
+            wake.notify_one();
+        return true;
+    }
+
+    void Logger::flush()
+    {
+        const size_t target = enqueue_pos.load();
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.notify_one();
+        drained.wait(lock, [&]
+                     { return completed_pos.load() >= target; });
+    }
+
+    void Logger::open_file(const std::string &path, size_t max_bytes, size_t max_files)
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        std::ofstream f(path, std::ios::out | std::ios::app | std::ios::binary);
+        if (!f.is_open())
+            throw std::runtime_error("Logger::open_file: can not open " + path);
+        f.seekp(0, std::ios::end);
+        file = std::move(f);
+        file_path = path;
+        file_size = static_cast<size_t>(file.tellp());
+        file_max_bytes = max_bytes;
+        file_max_files = std::max<size_t>(1, max_files);
+    }
+
+    void Logger::close_file()
+    {
+        flush();
+        std::lock_guard<std::mutex> lock(file_mutex);
+        if (file.is_open())
+            file.close();
+        file_path.clear();
+    }
+
+    bool Logger::has_file()
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        return file.is_open();
+    }
+
+    size_t Logger::history_size() const
+    {
+        std::lock_guard<std::mutex> lock(history_mutex);
+        return history.size();
+    }
+
+    size_t Logger::read_history(size_t first, size_t count, std::vector<Line> &out) const
+    {
+        std::lock_guard<std::mutex> lock(history_mutex);
+        const size_t size = history.size();
+        if (first >= size)
+            return 0;
+        count = std::min(count, size - first);
+        for (size_t i = 0; i < count; ++i)
+            out.push_back(history[(history_head + first + i) % size]);
+        return count;
+    }
+
+    void Logger::clear_history()
+    {
+        std::lock_guard<std::mutex> lock(history_mutex);
+        history.clear();
+        history_head = 0;
+    }
+
+    void Logger::set_history_capacity(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(history_mutex);
+        capacity = std::max<size_t>(1, capacity);
+        // unroll into oldest-first order and keep the newest lines
+        std::rotate(history.begin(), history.begin() + history_head, history.end());
+        history_head = 0;
+        if (history.size() > capacity)
+            history.erase(history.begin(), history.end() - capacity);
+        history_capacity = capacity;
+    }
+
+    size_t Logger::get_history_capacity() const
+    {
+        std::lock_guard<std::mutex> lock(history_mutex);
+        return history_capacity;
+    }
+
+    std::string Logger::format(const Entry &entry)
+    {
+        const time_t seconds = static_cast<time_t>(entry.time / 1000000);
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        char prefix[64];
+        const int n = std::snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%06u [%s] [T%u] ",
+                                    local.tm_hour, local.tm_min, local.tm_sec, unsigned(entry.time % 1000000),
+                                    level_name(entry.level), entry.thread);
+        std::string rslt(prefix, n > 0 ? size_t(n) : 0);
+        rslt.append(entry.text, entry.length);
+        return rslt;
+    }
+
+    const char *Logger::level_name(Level level)
+    {
+        switch (level)
+        {
+        case LEVEL_DEBUG:
+            return "DEBUG";
+        case LEVEL_INFO:
+            return "INFO";
+        case LEVEL_WARN:
+            return "WARN";
+        default:
+            return "ERROR";
+        }
+    }
+
+    void Logger::fill(Entry &entry, Level level, const char *msg, size_t length)
+    {
+        entry.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        entry.thread = thread_number();
+        entry.level = level;
+        entry.length = static_cast<uint16_t>(std::min(length, TEXT_SIZE));
+        std::memcpy(entry.text, msg, entry.length);
+        if (length > TEXT_SIZE)
+            std::memcpy(entry.text + TEXT_SIZE - 3, "...", 3);
+    }
+
+    bool Logger::pop(Entry &entry)
+    {
+        Cell &cell = cells[dequeue_pos & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos + 1)
+            return false;
+        entry = cell.entry;
+        cell.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+        ++dequeue_pos;
+        return true;
+    }
+
+    void Logger::run()
+    {
+        while (true)
+        {
+            const size_t count = drain();
+            std::unique_lock<std::mutex> lock(mutex);
+            drained.notify_all();
+            if (count > 0)
+                continue;
+            if (stopping)
+                break;
+            waiting = true;
+            // producers only notify when they see `waiting`, the timeout covers the race
+            wake.wait_for(lock, IDLE_WAIT);
+            waiting = false;
+        }
+    }
+
+    size_t Logger::drain()
+    {
+        std::vector<Line> lines;
+        Entry entry;
+        while (lines.size() < DRAIN_BATCH && pop(entry))
+            lines.push_back({entry.level, format(entry)});
+        const size_t drops = dropped;
+        if (drops != reported_drops)
+        {
+            const std::string msg = "Logger: " + std::to_string(drops - reported_drops) + " messages dropped, the ring buffer was full";
+            fill(entry, LEVEL_WARN, msg.data(), msg.size());
+            lines.push_back({LEVEL_WARN, format(entry)});
+            reported_drops = drops;
+        }
+        if (lines.empty())
+            return 0;
+        write_lines(lines);
+        {
+            std::lock_guard<std::mutex> lock(history_mutex);
+            for (auto &line : lines)
+            {
+                if (history.size() < history_capacity)
+                    history.push_back(std::move(line));
+                else
+                {
+                    history[history_head] = std::move(line);
+                    history_head = (history_head + 1) % history.size();
+                }
+            }
+        }
+        // flush() waits on this, so publish it only once the lines are visible
+        completed_pos.store(dequeue_pos);
+        return lines.size();
+    }
+
+    void Logger::write_lines(const std::vector<Line> &lines)
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        if (!file.is_open())
+            return;
+        for (const auto &line : lines)
+        {
+            if (file_max_bytes > 0 && file_size > 0 && file_size + line.text.size() + 1 > file_max_bytes)
+                rotate();
+            if (!file.is_open())
+                return;
+            file << line.text << '\n';
+            file_size += line.text.size() + 1;
+        }
+        file.flush();
+    }
+
+    void Logger::rotate()
+    {
+        file.close();
+        // path.<n-1> is the oldest one kept
+        std::remove((file_path + "." + std::to_string(file_max_files - 1)).c_str());
+        for (size_t i = file_max_files - 1; i > 1; --i)
+            std::rename((file_path + "." + std::to_string(i - 1)).c_str(), (file_path + "." + std::to_string(i)).c_str());
+        if (file_max_files > 1)
+            std::rename(file_path.c_str(), (file_path + ".1").c_str());
+        else
+            std::remove(file_path.c_str());
+        file.open(file_path, std::ios::out | std::ios::trunc | std::ios::binary);
+        file_size = 0;
+    }
+} // namespace Core
@@ -3,6 +3,10 @@
 #include "vector.h"
 #include <iostream>
 #include "math/base.h"
+#include "math/simd.h"
+#include "math/linear.h"
+#include "math/gemm.h"
+#include "fixed_vector.h"
 
 namespace Core
 {
@@ -33,11 +37,15 @@ namespace Core
     {
         if (this != &other)
         {
-            free_data();
-            own_data = true;
+            // keep our buffer when it already has the right size
+            if (!own_data || size() != other.size())
+            {
+                free_data();
+                own_data = true;
+                values = new float[other.size()];
+            }
             _rows = other._rows;
             _cols = other._cols;
-            values = new float[size()];
             for (size_t i = 0; i < size(); ++i)
             {
                 values[i] = other.values[i];
@@ -139,39 +147,41 @@ namespace Core
         return values[index(row, col)];
     }
 
-    Matrix Matrix::operator+(const Matrix &other) const
+    Matrix &Matrix::operator+=(const Matrix &other)
     {
-        Matrix result(_rows, _cols);
         for (size_t i = 0; i < size(); ++i)
         {
-            result.values[i] = values[i] + other.values[i];
+            values[i] += other.values[i];
         }
-        return result;
+        return *this;
     }
 
-    Matrix Matrix::operator-(const Matrix &other) const
+    Matrix &Matrix::operator-=(const Matrix &other)
     {
-        Matrix result(_rows, _cols);
         for (size_t i = 0; i < size(); ++i)
         {
-            result.values[i] = values[i] - other.values[i];
+            values[i] -= other.values[i];
         }
-        return result;
+        return *this;
     }
 
-    Matrix Matrix::operator*(float scalar) const
+    Matrix &Matrix::operator*=(float scalar)
     {
-        Matrix result(_rows, _cols);
         for (size_t i = 0; i < size(); ++i)
         {
-            result.values[i] = values[i] * scalar;
+            values[i] *= scalar;
         }
-        return result;
+        return *this;
     }
 
     Matrix Matrix::operator*(const Matrix &other) const
     {
         Matrix result(_rows, other._cols);
+        if (_rows * _cols * other._cols >= Math::GEMM_THRESHOLD)
+        {
+            Math::gemm(_rows, other._cols, _cols, 1.f, values, _cols, other.values, other._cols, 0.f, result.values, other._cols);
+            return result;
+        }
         for (size_t i = 0; i < _rows; ++i)
         {
             for (size_t j = 0; j < other._cols; ++j)
@@ -198,16 +208,6 @@ namespace Core
     //     return result;
     // }
 
-    Matrix Matrix::operator-() const
-    {
-        Matrix result(_rows, _cols);
-        for (size_t i = 0; i < size(); ++i)
-        {
-            result.values[i] = -values[i];
-        }
-        return result;
-    }
-
     bool Matrix::operator==(const Matrix &other) const
     {
         if (_rows != other._rows || _cols != other._cols)
@@ -266,20 +266,6 @@ namespace Core
         return result;
     }
 
-    Matrix Matrix::transpose() const
-    {
-        Matrix result(_cols, _rows);
-        for (size_t i = 0; i < _rows; ++i)
-        {
-            for (size_t j = 0; j < _cols; ++j)
-            {
-                float v = values[index(i, j)];
-                result(j, i) = v;
-            }
-        }
-        return result;
-    }
-
     Matrix Matrix::submatrix(size_t row, size_t col) const
     {
         Matrix result(_rows - 1, _cols - 1);
@@ -352,32 +338,15 @@ namespace Core
 
     float MatrixS::determinant() const
     {
-        if (dim() == 1)
-            return values[0];
-        if (dim() == 2)
-            return values[0] * values[3] - values[1] * values[2];
-        float result = 0;
-        for (size_t i = 0; i < _cols; ++i)
-        {
-            result += std::pow(-1, i) * values[i] * MatrixS(submatrix(0, i)).determinant();
-        }
-        return result;
+        return Math::LU(*this).determinant();
     }
 
     MatrixS MatrixS::inverse() const
     {
-        float det = determinant();
-        if (Math::equal(det, 0.f))
+        Math::LU lu(*this);
+        if (lu.is_singular())
             throw std::runtime_error("MatrixS::inverse: determinant is zero");
-        MatrixS result(dim());
-        for (size_t i = 0; i < _rows; ++i)
-        {
-            for (size_t j = 0; j < _cols; ++j)
-            {
-                result(i, j) = std::pow(-1, i + j) * MatrixS(submatrix(j, i)).determinant() / det;
-            }
-        }
-        return result;
+        return lu.inverse();
     }
 
     float MatrixS::trace() const
@@ -504,6 +473,35 @@ namespace Core
         return *this;
     }
 
+    Matrix4 Matrix4::operator*(const Matrix4 &other) const
+    {
+        Matrix4 rslt;
+        Math::SIMD::mat4_mul(values, other.values, rslt.values);
+        return rslt;
+    }
+
+    Vec4 Matrix4::operator*(const Vec4 &vector) const
+    {
+        Vec4 rslt;
+        Math::SIMD::mat4_mul_vec4(values, vector.data(), rslt.data());
+        return rslt;
+    }
+
+    Matrix4 Matrix4::transpose() const
+    {
+        Matrix4 rslt;
+        Math::SIMD::mat4_transpose(values, rslt.values);
+        return rslt;
+    }
+
+    Matrix4 Matrix4::inverse_affine() const
+    {
+        Matrix4 rslt;
+        if (!Math::SIMD::mat4_inverse_affine_either(values, rslt.values))
+            throw std::runtime_error("Matrix4::inverse_affine: not affine or the determinant is zero");
+        return rslt;
+    }
+
     void Matrix4::translate(const Vector3 &translation)
     {
         (*this)(0, 3) += translation.x();
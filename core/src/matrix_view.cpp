@@ -0,0 +1,98 @@
+#include "matrix_view.h"
+#include <stdexcept>
+#include <utility>
+#include "math/gemm.h"
+
+namespace Core
+{
+    ConstMatrixView ConstMatrixView::block(size_t row, size_t col, size_t rows, size_t cols) const
+    {
+        if (row + rows > _rows || col + cols > _cols)
+            throw std::runtime_error("ConstMatrixView::block: block out of range");
+        return ConstMatrixView(values + row * _row_stride + col * _col_stride, rows, cols, _row_stride, _col_stride);
+    }
+
+    MatrixView MatrixView::block(size_t row, size_t col, size_t rows, size_t cols) const
+    {
+        if (row + rows > _rows || col + cols > _cols)
+            throw std::runtime_error("MatrixView::block: block out of range");
+        return MatrixView(values + row * _row_stride + col * _col_stride, rows, cols, _row_stride, _col_stride);
+    }
+
+    MatrixView &MatrixView::operator*=(float scalar)
+    {
+        for (size_t row = 0; row < _rows; ++row)
+            scale_row(row, scalar);
+        return *this;
+    }
+
+    void MatrixView::fill(float value)
+    {
+        for (size_t row = 0; row < _rows; ++row)
+        {
+            float *dst = values + row * _row_stride;
+            for (size_t col = 0; col < _cols; ++col)
+                dst[col * _col_stride] = value;
+        }
+    }
+
+    void MatrixView::swap_rows(size_t row1, size_t row2)
+    {
+        if (row1 >= _rows || row2 >= _rows)
+            throw std::runtime_error("MatrixView::swap_rows: row out of range");
+        if (row1 == row2)
+            return;
+        float *a = values + row1 * _row_stride;
+        float *b = values + row2 * _row_stride;
+        for (size_t col = 0; col < _cols; ++col)
+            std::swap(a[col * _col_stride], b[col * _col_stride]);
+    }
+
+    void MatrixView::scale_row(size_t row, float scalar)
+    {
+        if (row >= _rows)
+            throw std::runtime_error("MatrixView::scale_row: row out of range");
+        float *dst = values + row * _row_stride;
+        for (size_t col = 0; col < _cols; ++col)
+            dst[col * _col_stride] *= scalar;
+    }
+
+    void MatrixView::add_row(size_t target, size_t source, float scalar)
+    {
+        if (target >= _rows || source >= _rows)
+            throw std::runtime_error("MatrixView::add_row: row out of range");
+        float *dst = values + target * _row_stride;
+        const float *src = values + source * _row_stride;
+        for (size_t col = 0; col < _cols; ++col)
+            dst[col * _col_stride] += src[col * _col_stride] * scalar;
+    }
+
+    Matrix multiply(const ConstMatrixView &lhs, const ConstMatrixView &rhs)
+    {
+        if (lhs.cols() != rhs.rows())
+            throw std::runtime_error("multiply: shape mismatch");
+        const size_t m = lhs.rows(), n = rhs.cols(), k = lhs.cols();
+        Matrix rslt(m, n);
+        if (m * n * k >= Math::GEMM_THRESHOLD)
+        {
+            // gemm walks rows, a view with another column stride is made dense first
+            const Matrix lhs_copy = lhs.col_stride() == 1 ? Matrix() : Matrix(lhs);
+            const Matrix rhs_copy = rhs.col_stride() == 1 ? Matrix() : Matrix(rhs);
+            const ConstMatrixView a = lhs.col_stride() == 1 ? lhs : ConstMatrixView(lhs_copy);
+            const ConstMatrixView b = rhs.col_stride() == 1 ? rhs : ConstMatrixView(rhs_copy);
+            Math::gemm(m, n, k, 1.f, a.data(), a.row_stride(), b.data(), b.row_stride(), 0.f, rslt.data(), n);
+            return rslt;
+        }
+        for (size_t i = 0; i < m; ++i)
+        {
+            float *dst = rslt.data() + i * n;
+            for (size_t p = 0; p < k; ++p)
+            {
+                const float scale = lhs(i, p);
+                for (size_t j = 0; j < n; ++j)
+                    dst[j] += scale * rhs(p, j);
+            }
+        }
+        return rslt;
+    }
+};
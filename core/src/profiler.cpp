@@ -0,0 +1,416 @@
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace Core::Profiler
+{
+    namespace
+    {
+        struct Thread_Buffer
+        {
+            uint32_t thread = 0;
+            // owner only
+            uint32_t depth = 0;
+            std::vector<Event> local;
+            // handed over to new_frame
+            std::mutex mutex;
+            std::vector<Event> shared;
+        };
+
+        // outside State so that opening a scope skips its initialisation guard
+        std::atomic<bool> enabled{true};
+
+        struct State
+        {
+            std::atomic<uint32_t> next_thread{0};
+
+            // everything below
+            std::mutex mutex;
+            std::vector<std::shared_ptr<Thread_Buffer>> buffers;
+            std::map<uint32_t, std::string> names;
+            uint64_t frame_index = 0;
+            uint64_t frame_start = now();
+            size_t history_size = 300;
+            std::deque<Frame> frames;
+            std::deque<float> times;
+            // submitted for the frame being recorded
+            std::vector<Event> pending;
+            bool capturing = false;
+            std::vector<Frame> capture;
+        };
+
+        State &state()
+        {
+            static State s;
+            return s;
+        }
+
+        std::shared_ptr<Thread_Buffer> register_thread()
+        {
+            State &s = state();
+            auto rslt = std::make_shared<Thread_Buffer>();
+            rslt->thread = s.next_thread++;
+            rslt->local.reserve(256);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.buffers.push_back(rslt);
+            return rslt;
+        }
+
+        // the registry keeps the buffer alive after its thread exited, until
+        // new_frame collected it; the plain pointer is the cheap per-scope access
+        thread_local std::shared_ptr<Thread_Buffer> owned_buffer;
+        thread_local Thread_Buffer *current_buffer = nullptr;
+
+        bool event_less(const Event &a, const Event &b)
+        {
+            return a.thread != b.thread ? a.thread < b.thread : (a.start != b.start ? a.start < b.start : a.depth < b.depth);
+        }
+
+        // keeps `events` ordered by thread, then start
+        void merge_events(std::vector<Event> &events, const std::vector<Event> &added)
+        {
+            const size_t middle = events.size();
+            events.insert(events.end(), added.begin(), added.end());
+            std::sort(events.begin() + middle, events.end(), event_less);
+            std::inplace_merge(events.begin(), events.begin() + middle, events.end(), event_less);
+        }
+
+        Thread_Buffer &buffer()
+        {
+            if (!current_buffer)
+            {
+                owned_buffer = register_thread();
+                current_buffer = owned_buffer.get();
+            }
+            return *current_buffer;
+        }
+
+        void append_json_string(std::string &out, const char *str)
+        {
+            out += '"';
+            for (const char *c = str; *c; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    out += '\\';
+                    out += *c;
+                }
+                else if (static_cast<unsigned char>(*c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(*c));
+                    out += escaped;
+                }
+                else
+                    out += *c;
+            }
+            out += '"';
+        }
+
+        // a complete ("X") event, times in microseconds relative to `origin`
+        void append_event(std::string &out, const char *name, uint64_t start, uint64_t end, uint32_t thread, uint64_t origin)
+        {
+            char fields[128];
+            std::snprintf(fields, sizeof(fields), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u},\n",
+                          (start - origin) * 1e-3, (end - start) * 1e-3, thread);
+            out += "{\"name\":";
+            append_json_string(out, name);
+            out += fields;
+        }
+    }
+
+    Scope::Scope(const char *name) : name(name), start(0), active(enabled.load(std::memory_order_relaxed))
+    {
+        if (active)
+        {
+            ++buffer().depth;
+            start = now();
+        }
+    }
+
+    Scope::~Scope()
+    {
+        if (!active)
+            return;
+        const uint64_t end = now();
+        Thread_Buffer &b = buffer();
+        --b.depth;
+        b.local.push_back({name, start, end, b.thread, b.depth});
+        if (b.depth == 0)
+        {
+            std::lock_guard<std::mutex> lock(b.mutex);
+            b.shared.insert(b.shared.end(), b.local.begin(), b.local.end());
+            b.local.clear();
+        }
+    }
+
+    uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void set_enabled(bool on)
+    {
+        enabled = on;
+    }
+
+    bool is_enabled()
+    {
+        return enabled;
+    }
+
+    void new_frame()
+    {
+        State &s = state();
+        const uint32_t thread = buffer().thread;
+        std::lock_guard<std::mutex> lock(s.mutex);
+        Frame frame;
+        frame.index = s.frame_index++;
+        frame.start = s.frame_start;
+        frame.end = now();
+        frame.thread = thread;
+        s.frame_start = frame.end;
+        for (auto &b : s.buffers)
+        {
+            std::lock_guard<std::mutex> buffer_lock(b->mutex);
+            frame.events.insert(frame.events.end(), b->shared.begin(), b->shared.end());
+            b->shared.clear();
+        }
+        // only the registry holds buffers of exited threads, they have nothing left to hand over
+        s.buffers.erase(std::remove_if(s.buffers.begin(), s.buffers.end(), [](const std::shared_ptr<Thread_Buffer> &b)
+                                       { return b.use_count() == 1; }),
+                        s.buffers.end());
+        frame.events.insert(frame.events.end(), s.pending.begin(), s.pending.end());
+        s.pending.clear();
+        std::sort(frame.events.begin(), frame.events.end(), event_less);
+
+        s.times.push_back(static_cast<float>(frame.duration_ms()));
+        if (s.capturing)
+            s.capture.push_back(frame);
+        s.frames.push_back(std::move(frame));
+        while (s.frames.size() > s.history_size)
+            s.frames.pop_front();
+        while (s.times.size() > s.history_size)
+            s.times.pop_front();
+    }
+
+    void reset()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.frames.clear();
+        s.times.clear();
+        s.capture.clear();
+        s.pending.clear();
+        s.frame_start = now();
+    }
+
+    void set_thread_name(const std::string &name)
+    {
+        const uint32_t thread = buffer().thread;
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.names[thread] = name;
+    }
+
+    std::string get_thread_name(uint32_t thread)
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.names.find(thread);
+        return it != s.names.end() ? it->second : "Thread " + std::to_string(thread);
+    }
+
+    uint32_t create_track(const std::string &name)
+    {
+        State &s = state();
+        const uint32_t track = s.next_thread++;
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.names[track] = name;
+        return track;
+    }
+
+    uint64_t get_frame_index()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.frame_index;
+    }
+
+    bool submit(uint64_t frame_index, const std::vector<Event> &events)
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (frame_index == s.frame_index)
+        {
+            s.pending.insert(s.pending.end(), events.begin(), events.end());
+            return true;
+        }
+        bool rslt = false;
+        // both are ordered by index
+        auto by_index = [](const Frame &frame, uint64_t index)
+        { return frame.index < index; };
+        auto frame = std::lower_bound(s.frames.begin(), s.frames.end(), frame_index, by_index);
+        if (frame != s.frames.end() && frame->index == frame_index)
+        {
+            merge_events(frame->events, events);
+            rslt = true;
+        }
+        auto captured = std::lower_bound(s.capture.begin(), s.capture.end(), frame_index, by_index);
+        if (captured != s.capture.end() && captured->index == frame_index)
+        {
+            merge_events(captured->events, events);
+            rslt = true;
+        }
+        return rslt;
+    }
+
+    void set_history_size(size_t frames)
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.history_size = std::max<size_t>(1, frames);
+        while (s.frames.size() > s.history_size)
+            s.frames.pop_front();
+        while (s.times.size() > s.history_size)
+            s.times.pop_front();
+    }
+
+    size_t get_history_size()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.history_size;
+    }
+
+    size_t get_frame_count()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.frames.size();
+    }
+
+    bool get_frame(size_t age, Frame &frame)
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (age >= s.frames.size())
+            return false;
+        frame = s.frames[s.frames.size() - 1 - age];
+        return true;
+    }
+
+    std::vector<float> get_frame_times()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return std::vector<float>(s.times.begin(), s.times.end());
+    }
+
+    Frame_Stats get_frame_stats()
+    {
+        const auto times = get_frame_times();
+        Frame_Stats rslt;
+        rslt.count = times.size();
+        if (times.empty())
+            return rslt;
+        std::vector<double> values(times.begin(), times.end());
+        double sum = 0;
+        for (double v : values)
+            sum += v;
+        rslt.mean = sum / values.size();
+        rslt.max = *std::max_element(values.begin(), values.end());
+        rslt.p50 = percentile(values, 50);
+        rslt.p95 = percentile(values, 95);
+        rslt.p99 = percentile(values, 99);
+        return rslt;
+    }
+
+    double percentile(std::vector<double> &values, double p)
+    {
+        if (values.empty())
+            return 0;
+        const double rank = std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * values.size());
+        const size_t i = std::min(values.size(), std::max<size_t>(1, static_cast<size_t>(rank))) - 1;
+        std::nth_element(values.begin(), values.begin() + i, values.end());
+        return values[i];
+    }
+
+    void start_capture()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.capture.clear();
+        s.capturing = true;
+    }
+
+    void stop_capture()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.capturing = false;
+    }
+
+    bool is_capturing()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.capturing;
+    }
+
+    size_t get_capture_frame_count()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.capture.size();
+    }
+
+    std::string chrome_trace()
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        std::string rslt = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        const uint64_t origin = s.capture.empty() ? 0 : s.capture.front().start;
+        std::map<uint32_t, bool> threads;
+        for (const auto &frame : s.capture)
+        {
+            const std::string name = "Frame " + std::to_string(frame.index);
+            append_event(rslt, name.c_str(), frame.start, frame.end, frame.thread, origin);
+            threads[frame.thread] = true;
+            for (const auto &e : frame.events)
+            {
+                append_event(rslt, e.name, e.start, e.end, e.thread, origin);
+                threads[e.thread] = true;
+            }
+        }
+        rslt += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"AllVis\"}}";
+        for (const auto &t : threads)
+        {
+            auto it = s.names.find(t.first);
+            const std::string name = it != s.names.end() ? it->second : "Thread " + std::to_string(t.first);
+            rslt += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(t.first) + ",\"args\":{\"name\":";
+            append_json_string(rslt, name.c_str());
+            rslt += "}}";
+        }
+        rslt += "\n]}\n";
+        return rslt;
+    }
+
+    void write_chrome_trace(const std::string &path)
+    {
+        const std::string trace = chrome_trace();
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        if (!file.is_open())
+            throw std::runtime_error("Profiler::write_chrome_trace: can not open " + path);
+        file << trace;
+    }
+} // namespace Core::Profiler
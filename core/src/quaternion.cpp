@@ -6,38 +6,6 @@
 
 namespace Core
 {
-    Quaternion::Quaternion(float w, float x, float y, float z) : w(w), x(x), y(y), z(z) {}
-
-    Quaternion::Quaternion(const Quaternion &other)
-        : w(other.w), x(other.x), y(other.y), z(other.z)
-    {
-    }
-
-    Quaternion &Quaternion::operator=(const Quaternion &other)
-    {
-        w = other.w;
-        x = other.x;
-        y = other.y;
-        z = other.z;
-        return *this;
-    }
-
-    Quaternion::Quaternion(Quaternion &&other)
-        : w(other.w), x(other.x), y(other.y), z(other.z)
-    {
-    }
-
-    Quaternion &Quaternion::operator=(Quaternion &&other)
-    {
-        w = other.w;
-        x = other.x;
-        y = other.y;
-        z = other.z;
-        return *this;
-    }
-
-    Quaternion::~Quaternion() {}
-
     Quaternion Quaternion::operator+(const Quaternion &other) const
     {
         return Quaternion(w + other.w, x + other.x, y + other.y, z + other.z);
@@ -62,21 +30,21 @@ namespace Core
         return Quaternion(w * scalar, x * scalar, y * scalar, z * scalar);
     }
 
-    Vector3 Quaternion::operator*(const Vector3 &vector) const
+    Vec3 Quaternion::operator*(const Vec3 &vector) const
     {
         Quaternion q = *this * Quaternion(0, vector.x(), vector.y(), vector.z()) * conjugate();
-        return Vector3(q.x, q.y, q.z);
+        return Vec3(q.x, q.y, q.z);
     }
 
-    Vector4 Quaternion::operator*(const Vector4 &vector) const
+    Vec4 Quaternion::operator*(const Vec4 &vector) const
     {
         Quaternion q = *this * Quaternion(0, vector.x(), vector.y(), vector.z()) * conjugate();
-        return Vector4(q.x, q.y, q.z, vector.w());
+        return Vec4(q.x, q.y, q.z, vector.w());
     }
 
-    Matrix4 Quaternion::operator*(const Matrix4 &matrix) const
+    Mat4 Quaternion::operator*(const Mat4 &matrix) const
     {
-        Matrix4 rslt;
+        Mat4 rslt;
         rslt(0, 0) = w * w + x * x - y * y - z * z;
         rslt(0, 1) = 2.f * x * y - 2.f * w * z;
         rslt(0, 2) = 2.f * x * z + 2.f * w * y;
@@ -116,9 +84,9 @@ namespace Core
         return conjugate() * (1.0f / dot(*this, *this));
     }
 
-    Matrix4 Quaternion::to_matrix4() const
+    Mat4 Quaternion::to_matrix4() const
     {
-        Matrix4 rslt = Matrix4::identity();
+        Mat4 rslt = Mat4::identity();
         float xx = x * x;
         float xy = x * y;
         float xz = x * z;
@@ -143,9 +111,9 @@ namespace Core
         return rslt;
     }
 
-    Matrix3 Quaternion::to_matrix3() const
+    Mat3 Quaternion::to_matrix3() const
     {
-        Matrix3 rslt = Matrix3::identity();
+        Mat3 rslt = Mat3::identity();
         float xx = x * x;
         float xy = x * y;
         float xz = x * z;
@@ -170,17 +138,17 @@ namespace Core
         return rslt;
     }
 
-    std::tuple<Vector3, float> Quaternion::to_axis_angle() const
+    std::tuple<Vec3, float> Quaternion::to_axis_angle() const
     {
         float angle = 2 * acos(w);
         float s = std::sqrt(1 - w * w);
         if (s < 0.0001)
         {
-            return std::make_tuple(Vector3(1.f, 0.f, 0.f), 0);
+            return std::make_tuple(Vec3(1.f, 0.f, 0.f), 0.f);
         }
         else
         {
-            return std::make_tuple(Vector3(x / s, y / s, z / s), angle);
+            return std::make_tuple(Vec3(x / s, y / s, z / s), angle);
         }
     }
 
@@ -238,14 +206,14 @@ namespace Core
         return from_euler_angle(euler_angle.pitch, euler_angle.yaw, euler_angle.roll);
     }
 
-    Quaternion Quaternion::from_axis_angle(const Vector3 &axis, float angle_rad)
+    Quaternion Quaternion::from_axis_angle(const Vec3 &axis, float angle_rad)
     {
         float half_angle = angle_rad * 0.5f;
         float s = std::sin(half_angle);
         return Quaternion(std::cos(half_angle), axis.x() * s, axis.y() * s, axis.z() * s);
     }
 
-    Quaternion Quaternion::from_matrix(const Matrix3 &mat)
+    Quaternion Quaternion::from_matrix(const Mat3 &mat)
     {
         float x_sq = mat(0, 0) - mat(1, 1) - mat(2, 2);
         float y_sq = -mat(0, 0) + mat(1, 1) - mat(2, 2);
@@ -288,14 +256,14 @@ namespace Core
         }
     }
 
-    Quaternion Quaternion::from_matrix(const Matrix4 &mat)
+    Quaternion Quaternion::from_matrix(const Mat4 &mat)
     {
-        return from_matrix(Matrix3(mat));
+        return from_matrix(Mat3(mat));
     }
 
-    Quaternion Quaternion::from_basis_vector(const Vector3 &front, const Vector3 &up, const Vector3 &right)
+    Quaternion Quaternion::from_basis_vector(const Vec3 &front, const Vec3 &up, const Vec3 &right)
     {
-        Matrix3 mat;
+        Mat3 mat;
         mat(0, 0) = right.x();
         mat(0, 1) = right.y();
         mat(0, 2) = right.z();
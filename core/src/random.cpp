@@ -0,0 +1,381 @@
+#include "math/random.h"
+#include "math/simd.h"
+#include "jobs.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#if defined(__GNUC__) || defined(__clang__)
+#define CORE_RANDOM_AVX2
+#include <immintrin.h>
+#define CORE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// the AVX2 conversion and the scalar one round the same way, keep the compiler
+// from fusing the scalar multiply-adds behind our back
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace Core::Math
+{
+    namespace
+    {
+        constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+        constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+        constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+        constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+        constexpr size_t PHILOX_ROUNDS = 10;
+
+        // elements generated per step of a bulk fill, the words live on the stack
+        constexpr size_t CHUNK = 1024;
+        // elements handed to each thread at least
+        constexpr size_t ELEMENTS_PER_THREAD = size_t(1) << 16;
+        constexpr float TWO_PI = 6.283185307179586f;
+
+        std::atomic<size_t> random_threads{0};
+
+        uint32_t lo(uint64_t x) { return static_cast<uint32_t>(x); }
+        uint32_t hi(uint64_t x) { return static_cast<uint32_t>(x >> 32); }
+
+        // blocks [counter, counter + count) into out, 4 words each
+        void blocks_generic(uint64_t seed, uint64_t stream, uint64_t counter, size_t count, uint32_t *out)
+        {
+            for (size_t b = 0; b < count; ++b, out += 4)
+            {
+                uint32_t c0 = lo(counter + b), c1 = hi(counter + b), c2 = lo(stream), c3 = hi(stream);
+                uint32_t k0 = lo(seed), k1 = hi(seed);
+                for (size_t r = 0; r < PHILOX_ROUNDS; ++r)
+                {
+                    const uint64_t p0 = uint64_t(PHILOX_M0) * c0;
+                    const uint64_t p1 = uint64_t(PHILOX_M1) * c2;
+                    c0 = hi(p1) ^ c1 ^ k0;
+                    c1 = lo(p1);
+                    c2 = hi(p0) ^ c3 ^ k1;
+                    c3 = lo(p0);
+                    k0 += PHILOX_W0;
+                    k1 += PHILOX_W1;
+                }
+                out[0] = c0;
+                out[1] = c1;
+                out[2] = c2;
+                out[3] = c3;
+            }
+        }
+
+#ifdef CORE_RANDOM_AVX2
+        // low and high halves of the 32 x 32 bit products of every lane with m
+        CORE_TARGET_AVX2 inline void mulhilo(__m256i a, __m256i m, __m256i &lo, __m256i &hi)
+        {
+            const __m256i even = _mm256_mul_epu32(a, m);
+            const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+            lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+            hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+        }
+
+        // 8 blocks per iteration, one per lane, the tail goes through the generic version
+        CORE_TARGET_AVX2 void blocks_avx2(uint64_t seed, uint64_t stream, uint64_t counter, size_t count, uint32_t *out)
+        {
+            const __m256i m0 = _mm256_set1_epi32(static_cast<int>(PHILOX_M0));
+            const __m256i m1 = _mm256_set1_epi32(static_cast<int>(PHILOX_M1));
+            size_t b = 0;
+            for (; b + 8 <= count; b += 8, out += 32)
+            {
+                alignas(32) uint32_t low[8], high[8];
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    low[i] = lo(counter + b + i);
+                    high[i] = hi(counter + b + i);
+                }
+                __m256i c0 = _mm256_load_si256(reinterpret_cast<const __m256i *>(low));
+                __m256i c1 = _mm256_load_si256(reinterpret_cast<const __m256i *>(high));
+                __m256i c2 = _mm256_set1_epi32(static_cast<int>(lo(stream)));
+                __m256i c3 = _mm256_set1_epi32(static_cast<int>(hi(stream)));
+                uint32_t k0 = lo(seed), k1 = hi(seed);
+                for (size_t r = 0; r < PHILOX_ROUNDS; ++r)
+                {
+                    __m256i lo0, hi0, lo1, hi1;
+                    mulhilo(c0, m0, lo0, hi0);
+                    mulhilo(c2, m1, lo1, hi1);
+                    c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(k0)));
+                    c1 = lo1;
+                    c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(k1)));
+                    c3 = lo0;
+                    k0 += PHILOX_W0;
+                    k1 += PHILOX_W1;
+                }
+                // lanes hold one word of each block, interleave them back to block order
+                const __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+                const __m256i t1 = _mm256_unpackhi_epi32(c0, c1);
+                const __m256i t2 = _mm256_unpacklo_epi32(c2, c3);
+                const __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+                const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+                const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+                const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+                const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+                __m256i *dst = reinterpret_cast<__m256i *>(out);
+                _mm256_storeu_si256(dst + 0, _mm256_permute2x128_si256(u0, u1, 0x20));
+                _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(u2, u3, 0x20));
+                _mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(u0, u1, 0x31));
+                _mm256_storeu_si256(dst + 3, _mm256_permute2x128_si256(u2, u3, 0x31));
+            }
+            // the generic tail and the callers are SSE code, leave no dirty upper halves behind
+            _mm256_zeroupper();
+            blocks_generic(seed, stream, counter + b, count - b, out);
+        }
+
+        CORE_TARGET_AVX2 void to_uniform_avx2(const uint32_t *words, size_t count, float min, float scale, float *out)
+        {
+            const __m256 vmin = _mm256_set1_ps(min);
+            const __m256 vscale = _mm256_set1_ps(scale);
+            const __m256 unit = _mm256_set1_ps(1.f / 16777216.f);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i w = _mm256_srli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i)), 8);
+                const __m256 u = _mm256_mul_ps(_mm256_cvtepi32_ps(w), unit);
+                _mm256_storeu_ps(out + i, _mm256_add_ps(vmin, _mm256_mul_ps(vscale, u)));
+            }
+            for (; i < count; ++i)
+                out[i] = min + scale * Philox::to_unit(words[i]);
+        }
+#endif
+
+        void to_uniform_generic(const uint32_t *words, size_t count, float min, float scale, float *out)
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = min + scale * Philox::to_unit(words[i]);
+        }
+
+        bool use_avx2()
+        {
+#ifdef CORE_RANDOM_AVX2
+            // integer only, so the result is the same either way; SCALAR still disables it
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported && SIMD::get_backend() >= SIMD::AVX;
+#else
+            return false;
+#endif
+        }
+
+        // words [first, first + count) of a stream
+        void words(uint64_t seed, uint64_t stream, uint64_t first, size_t count, uint32_t *out)
+        {
+            uint32_t block[4];
+            size_t i = 0;
+            // head of a partial block
+            if (first % 4 != 0)
+            {
+                Philox::block(seed, stream, first / 4, block);
+                for (; i < count && (first + i) % 4 != 0; ++i)
+                    out[i] = block[(first + i) % 4];
+            }
+            const size_t full = (count - i) / 4;
+#ifdef CORE_RANDOM_AVX2
+            if (use_avx2())
+                blocks_avx2(seed, stream, (first + i) / 4, full, out + i);
+            else
+#endif
+                blocks_generic(seed, stream, (first + i) / 4, full, out + i);
+            i += full * 4;
+            // tail of a partial block
+            if (i < count)
+            {
+                Philox::block(seed, stream, (first + i) / 4, block);
+                for (size_t j = 0; i < count; ++i, ++j)
+                    out[i] = block[j];
+            }
+        }
+
+        // the pair behind two normals, u1 in (0, 1] so that the log stays finite
+        void box_muller(uint32_t w0, uint32_t w1, float &a, float &b)
+        {
+            const float u1 = static_cast<float>((w0 >> 8) + 1) * (1.f / 16777216.f);
+            const float r = std::sqrt(-2.f * std::log(u1));
+            const float phi = TWO_PI * Philox::to_unit(w1);
+            a = r * std::cos(phi);
+            b = r * std::sin(phi);
+        }
+
+        Vec3 sphere(uint32_t w0, uint32_t w1)
+        {
+            const float z = 1.f - 2.f * Philox::to_unit(w0);
+            const float r = std::sqrt(std::max(0.f, 1.f - z * z));
+            const float phi = TWO_PI * Philox::to_unit(w1);
+            return Vec3(r * std::cos(phi), r * std::sin(phi), z);
+        }
+
+        size_t round_up(size_t x, size_t multiple)
+        {
+            return (x + multiple - 1) / multiple * multiple;
+        }
+
+        // calls f(begin, end) on CHUNK aligned slices of [0, count), one per thread; a
+        // slice only depends on its bounds, so the split does not change the numbers
+        template <typename F>
+        void parallel_for(size_t count, F &&f)
+        {
+            const size_t threads = std::min(get_random_threads(), std::max<size_t>(1, count / ELEMENTS_PER_THREAD));
+            if (threads <= 1)
+            {
+                f(size_t(0), count);
+                return;
+            }
+            const size_t slice = round_up((count + threads - 1) / threads, CHUNK);
+            Jobs::parallel_for(0, count, slice, f);
+        }
+
+        // runs f(first element, elements, words) over a fill taking words_per_element
+        // words per element; the word count of a chunk is rounded up to whole pairs
+        template <typename F>
+        void fill_chunks(uint64_t seed, uint64_t stream, uint64_t base, size_t count, size_t words_per_element, F &&f)
+        {
+            parallel_for(count, [&](size_t begin, size_t end)
+                         {
+                uint32_t buffer[2 * CHUNK];
+                for (size_t b = begin; b < end; b += CHUNK)
+                {
+                    const size_t n = std::min(CHUNK, end - b);
+                    const size_t w = round_up(n * words_per_element, 2);
+                    words(seed, stream, base + b * words_per_element, w, buffer);
+                    f(b, n, buffer);
+                } });
+        }
+
+        std::atomic<uint64_t> next_stream{0};
+        std::atomic<uint64_t> next_stream_s{0};
+
+        uint64_t device_seed()
+        {
+            std::random_device rd;
+            return (uint64_t(rd()) << 32) | rd();
+        }
+    }
+
+    Philox::result_type Philox::operator()()
+    {
+        const uint64_t word = position++;
+        if (word / 4 != cached)
+        {
+            cached = word / 4;
+            block(_seed, _stream, cached, cache);
+        }
+        return cache[word % 4];
+    }
+
+    uint32_t Philox::bounded(uint32_t range)
+    {
+        // Lemire's multiply-shift with rejection of the biased low products
+        uint64_t m = uint64_t((*this)()) * range;
+        if (lo(m) < range)
+        {
+            const uint32_t threshold = (0u - range) % range;
+            while (lo(m) < threshold)
+                m = uint64_t((*this)()) * range;
+        }
+        return hi(m);
+    }
+
+    float Philox::normal()
+    {
+        const uint32_t w0 = (*this)();
+        const uint32_t w1 = (*this)();
+        float a, b;
+        box_muller(w0, w1, a, b);
+        return a;
+    }
+
+    void Philox::fill_uniform(float *out, size_t count, float min, float max)
+    {
+        const float scale = max - min;
+        fill_chunks(_seed, _stream, position, count, 1, [&](size_t begin, size_t n, const uint32_t *w)
+                    {
+#ifdef CORE_RANDOM_AVX2
+            if (use_avx2())
+            {
+                to_uniform_avx2(w, n, min, scale, out + begin);
+                return;
+            }
+#endif
+            to_uniform_generic(w, n, min, scale, out + begin); });
+        position += count;
+    }
+
+    void Philox::fill_normal(float *out, size_t count, float mean, float stddev)
+    {
+        // element i is half of pair i / 2, so chunks (even sized) never split a pair
+        static_assert(CHUNK % 2 == 0, "a chunk must hold whole pairs");
+        fill_chunks(_seed, _stream, position, count, 1, [&](size_t begin, size_t n, const uint32_t *w)
+                    {
+            for (size_t i = 0; i < n; i += 2)
+            {
+                float a, b;
+                box_muller(w[i], w[i + 1], a, b);
+                out[begin + i] = mean + stddev * a;
+                if (i + 1 < n)
+                    out[begin + i + 1] = mean + stddev * b;
+            } });
+        position += round_up(count, 2);
+    }
+
+    void Philox::fill_unit_sphere(Vec3 *out, size_t count)
+    {
+        fill_chunks(_seed, _stream, position, count, 2, [&](size_t begin, size_t n, const uint32_t *w)
+                    {
+            for (size_t i = 0; i < n; ++i)
+                out[begin + i] = sphere(w[2 * i], w[2 * i + 1]); });
+        position += 2 * count;
+    }
+
+    void Philox::fill_hemisphere(Vec3 *out, size_t count, const Vec3 &normal)
+    {
+        fill_chunks(_seed, _stream, position, count, 2, [&](size_t begin, size_t n, const uint32_t *w)
+                    {
+            for (size_t i = 0; i < n; ++i)
+            {
+                const Vec3 v = sphere(w[2 * i], w[2 * i + 1]);
+                out[begin + i] = Vec3::dot(v, normal) < 0.f ? -v : v;
+            } });
+        position += 2 * count;
+    }
+
+    void Philox::block(uint64_t seed, uint64_t stream, uint64_t counter, uint32_t out[4])
+    {
+        blocks_generic(seed, stream, counter, 1, out);
+    }
+
+    void set_random_threads(size_t threads)
+    {
+        random_threads = threads;
+    }
+
+    size_t get_random_threads()
+    {
+        size_t threads = random_threads;
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        return threads;
+    }
+
+    Philox &thread_generator()
+    {
+        static const uint64_t seed = device_seed();
+        thread_local Philox gen(seed, next_stream++);
+        return gen;
+    }
+
+    Philox &thread_generator_s()
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &Config::random_seed, sizeof(bits));
+        thread_local Philox gen(bits, next_stream_s++);
+        return gen;
+    }
+};
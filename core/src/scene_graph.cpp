@@ -0,0 +1,300 @@
+#include "scene_graph.h"
+#include "jobs.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace Core
+{
+    namespace
+    {
+        std::atomic<size_t> scene_graph_threads{0};
+
+        // below this a level is not worth a thread
+        constexpr size_t NODES_PER_THREAD = 4096;
+
+        // calls f(begin, end) and returns the sum of its results, split across threads
+        template <typename F>
+        size_t parallel_for(size_t begin, size_t end, F &&f)
+        {
+            const size_t count = end - begin;
+            const size_t threads = std::min(get_scene_graph_threads(), std::max<size_t>(1, count / NODES_PER_THREAD));
+            if (threads <= 1)
+                return f(begin, end);
+            std::atomic<size_t> rslt{0};
+            Jobs::parallel_for(begin, end, (count + threads - 1) / threads, [&](size_t b, size_t e)
+                               { rslt += f(b, e); });
+            return rslt;
+        }
+    }
+
+    Scene_Graph::Node Scene_Graph::create(const Transform *local, Node parent, Configurable *object)
+    {
+        if (parent != NONE && !contains(parent))
+            throw std::runtime_error("Scene_Graph::create: invalid parent");
+        Node node;
+        if (!free_nodes.empty())
+        {
+            node = free_nodes.back();
+            free_nodes.pop_back();
+        }
+        else
+        {
+            node = static_cast<Node>(records.size());
+            records.emplace_back();
+        }
+        Record &r = records[node];
+        r.parent = parent;
+        r.local = local;
+        r.object = object;
+        r.children.clear();
+        r.alive = true;
+        (parent == NONE ? roots : records[parent].children).push_back(node);
+        ++node_count;
+        layout_dirty = true;
+        return node;
+    }
+
+    void Scene_Graph::destroy(Node node)
+    {
+        const Node parent = record(node, "Scene_Graph::destroy").parent;
+        detach(node);
+        auto &siblings = parent == NONE ? roots : records[parent].children;
+        for (Node child : records[node].children)
+        {
+            records[child].parent = parent;
+            siblings.push_back(child);
+        }
+        Record &r = records[node];
+        r.children.clear();
+        r.local = nullptr;
+        r.object = nullptr;
+        r.alive = false;
+        free_nodes.push_back(node);
+        --node_count;
+        layout_dirty = true;
+    }
+
+    void Scene_Graph::set_parent(Node node, Node parent)
+    {
+        const Record &r = record(node, "Scene_Graph::set_parent");
+        if (parent != NONE && !contains(parent))
+            throw std::runtime_error("Scene_Graph::set_parent: invalid parent");
+        if (parent == node || is_ancestor(node, parent))
+            throw std::runtime_error("Scene_Graph::set_parent: a node can not be its own ancestor");
+        if (r.parent == parent)
+            return;
+        detach(node);
+        records[node].parent = parent;
+        (parent == NONE ? roots : records[parent].children).push_back(node);
+        layout_dirty = true;
+    }
+
+    void Scene_Graph::set_transform(Node node, const Transform *local)
+    {
+        record(node, "Scene_Graph::set_transform");
+        records[node].local = local;
+        // the new transform may be older than the last update
+        layout_dirty = true;
+    }
+
+    Scene_Graph::Node Scene_Graph::get_parent(Node node) const
+    {
+        return record(node, "Scene_Graph::get_parent").parent;
+    }
+
+    const std::vector<Scene_Graph::Node> &Scene_Graph::get_children(Node node) const
+    {
+        if (node == NONE)
+            return roots;
+        return record(node, "Scene_Graph::get_children").children;
+    }
+
+    Configurable *Scene_Graph::get_object(Node node) const
+    {
+        return record(node, "Scene_Graph::get_object").object;
+    }
+
+    const Transform *Scene_Graph::get_transform(Node node) const
+    {
+        return record(node, "Scene_Graph::get_transform").local;
+    }
+
+    bool Scene_Graph::is_ancestor(Node ancestor, Node node) const
+    {
+        if (!contains(ancestor) || !contains(node))
+            return false;
+        for (Node p = records[node].parent; p != NONE; p = records[p].parent)
+        {
+            if (p == ancestor)
+                return true;
+        }
+        return false;
+    }
+
+    size_t Scene_Graph::get_depth(Node node) const
+    {
+        size_t depth = 0;
+        for (Node p = record(node, "Scene_Graph::get_depth").parent; p != NONE; p = records[p].parent)
+            ++depth;
+        return depth;
+    }
+
+    size_t Scene_Graph::update()
+    {
+        const bool all = layout_dirty;
+        if (layout_dirty)
+            rebuild();
+        const uint64_t now = Transform::current_version();
+        // the workers only read the caches of shared transforms, fill them here
+        for (const Transform *local : shared_locals)
+        {
+            if (all || local->changed_since(stamp))
+            {
+                local->get_model_matrix();
+                local->get_normal_matrix();
+            }
+        }
+        size_t rslt = 0;
+        for (size_t level = 0; level + 1 < levels.size(); ++level)
+        {
+            rslt += parallel_for(levels[level], levels[level + 1], [&](size_t begin, size_t end)
+                                 { return update_range(begin, end, level == 0, all); });
+        }
+        stamp = now;
+        return rslt;
+    }
+
+    const Mat4 &Scene_Graph::get_world_matrix(Node node) const
+    {
+        return world[slot(node, "Scene_Graph::get_world_matrix")];
+    }
+
+    const Mat3 &Scene_Graph::get_world_normal_matrix(Node node) const
+    {
+        return world_normal[slot(node, "Scene_Graph::get_world_normal_matrix")];
+    }
+
+    Vec3 Scene_Graph::get_world_position(Node node) const
+    {
+        const Mat4 &m = get_world_matrix(node);
+        return Vec3(m(3, 0), m(3, 1), m(3, 2));
+    }
+
+    bool Scene_Graph::is_changed(Node node) const
+    {
+        return changed[slot(node, "Scene_Graph::is_changed")] != 0;
+    }
+
+    const Scene_Graph::Record &Scene_Graph::record(Node node, const char *method) const
+    {
+        if (!contains(node))
+            throw std::runtime_error(std::string(method) + ": invalid node");
+        return records[node];
+    }
+
+    uint32_t Scene_Graph::slot(Node node, const char *method) const
+    {
+        const Record &r = record(node, method);
+        if (layout_dirty)
+            throw std::runtime_error(std::string(method) + ": the hierarchy changed, call update() first");
+        return r.slot;
+    }
+
+    void Scene_Graph::detach(Node node)
+    {
+        const Node parent = records[node].parent;
+        auto &siblings = parent == NONE ? roots : records[parent].children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+    }
+
+    void Scene_Graph::rebuild()
+    {
+        // breadth-first, so depths are contiguous and siblings adjacent
+        order.clear();
+        order.reserve(node_count);
+        levels.clear();
+        order.insert(order.end(), roots.begin(), roots.end());
+        size_t begin = 0;
+        while (begin < order.size())
+        {
+            levels.push_back(begin);
+            const size_t end = order.size();
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto &children = records[order[i]].children;
+                order.insert(order.end(), children.begin(), children.end());
+            }
+            begin = end;
+        }
+        levels.push_back(order.size());
+
+        parent_slots.resize(order.size());
+        locals.resize(order.size());
+        world.resize(order.size());
+        world_normal.resize(order.size());
+        changed.assign(order.size(), 0);
+        for (size_t i = 0; i < order.size(); ++i)
+            records[order[i]].slot = static_cast<uint32_t>(i);
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            const Record &r = records[order[i]];
+            parent_slots[i] = r.parent == NONE ? 0 : records[r.parent].slot;
+            locals[i] = r.local;
+        }
+        shared_locals.assign(locals.begin(), locals.end());
+        std::sort(shared_locals.begin(), shared_locals.end());
+        auto last = shared_locals.begin();
+        for (auto it = shared_locals.begin(); it != shared_locals.end();)
+        {
+            auto next = std::upper_bound(it, shared_locals.end(), *it);
+            if (*it && next - it > 1)
+                *last++ = *it;
+            it = next;
+        }
+        shared_locals.erase(last, shared_locals.end());
+        layout_dirty = false;
+    }
+
+    size_t Scene_Graph::update_range(size_t begin, size_t end, bool root, bool all)
+    {
+        size_t rslt = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Transform *local = locals[i];
+            const bool dirty = all || (local && local->changed_since(stamp)) || (!root && changed[parent_slots[i]]);
+            changed[i] = dirty;
+            if (!dirty)
+                continue;
+            ++rslt;
+            const Mat4 &m = local ? local->get_model_matrix() : Mat4::identity();
+            const Mat3 &n = local ? local->get_normal_matrix() : Mat3::identity();
+            if (root)
+            {
+                world[i] = m;
+                world_normal[i] = n;
+            }
+            else
+            {
+                world[i] = m * world[parent_slots[i]];
+                world_normal[i] = n * world_normal[parent_slots[i]];
+            }
+        }
+        return rslt;
+    }
+
+    void set_scene_graph_threads(size_t threads)
+    {
+        scene_graph_threads = threads;
+    }
+
+    size_t get_scene_graph_threads()
+    {
+        size_t threads = scene_graph_threads;
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        return threads;
+    }
+} // namespace Core
@@ -0,0 +1,84 @@
+#include "search.h"
+#include "math/simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#if defined(__GNUC__) || defined(__clang__)
+#define CORE_SEARCH_AVX
+#include <immintrin.h>
+#define CORE_TARGET_AVX __attribute__((target("avx,popcnt")))
+#define CORE_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+#endif
+
+namespace Core::Search
+{
+    namespace
+    {
+        // sorted data: the keys below `key` are a prefix, counting them is the lower bound
+        template <typename T>
+        size_t count_less(const T *data, size_t size, T key)
+        {
+            size_t rslt = 0;
+            for (size_t i = 0; i < size; ++i)
+                rslt += data[i] < key ? 1 : 0;
+            return rslt;
+        }
+
+#ifdef CORE_SEARCH_AVX
+        CORE_TARGET_AVX2 size_t count_less_avx2(const uint32_t *data, size_t size, uint32_t key)
+        {
+            // unsigned compare through the signed one with the sign bits flipped
+            const __m256i bias = _mm256_set1_epi32(int(0x80000000u));
+            const __m256i k = _mm256_xor_si256(_mm256_set1_epi32(int(key)), bias);
+            size_t rslt = 0, i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), bias);
+                rslt += _mm_popcnt_u32(unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, v)))));
+            }
+            _mm256_zeroupper();
+            return rslt + count_less(data + i, size - i, key);
+        }
+
+        CORE_TARGET_AVX size_t count_less_avx(const float *data, size_t size, float key)
+        {
+            const __m256 k = _mm256_set1_ps(key);
+            size_t rslt = 0, i = 0;
+            for (; i + 8 <= size; i += 8)
+                rslt += _mm_popcnt_u32(unsigned(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data + i), k, _CMP_LT_OQ))));
+            _mm256_zeroupper();
+            return rslt + count_less(data + i, size - i, key);
+        }
+
+        bool use_avx()
+        {
+            static const bool supported = __builtin_cpu_supports("popcnt");
+            return supported && Math::SIMD::get_backend() >= Math::SIMD::AVX;
+        }
+
+        bool use_avx2()
+        {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported && use_avx();
+        }
+#endif
+    }
+
+    size_t lower_bound_block(const uint32_t *data, size_t size, uint32_t key)
+    {
+#ifdef CORE_SEARCH_AVX
+        if (size >= 8 && use_avx2())
+            return count_less_avx2(data, size, key);
+#endif
+        return count_less(data, size, key);
+    }
+
+    size_t lower_bound_block(const float *data, size_t size, float key)
+    {
+#ifdef CORE_SEARCH_AVX
+        if (size >= 8 && use_avx())
+            return count_less_avx(data, size, key);
+#endif
+        return count_less(data, size, key);
+    }
+} // namespace Core::Search
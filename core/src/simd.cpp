@@ -0,0 +1,447 @@
+#include "math/simd.h"
+#include "math/base.h"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CORE_SIMD_SSE2
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define CORE_SIMD_AVX
+#include <immintrin.h>
+#define CORE_TARGET_AVX __attribute__((target("avx")))
+#define CORE_TARGET_FMA __attribute__((target("avx,fma")))
+#endif
+#endif
+
+// The SIMD kernels and the scalar fallback evaluate every element in the same
+// order, keep the compiler from fusing the scalar multiply-adds behind our back.
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace Core::Math::SIMD
+{
+    namespace
+    {
+        /*-------------------------------scalar-------------------------------*/
+
+        void mat4_mul_scalar(const float *a, const float *b, float *rslt)
+        {
+            float tmp[16];
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = 0; j < 4; ++j)
+                {
+                    float s = a[i * 4 + 0] * b[0 + j];
+                    s = s + a[i * 4 + 1] * b[4 + j];
+                    s = s + a[i * 4 + 2] * b[8 + j];
+                    s = s + a[i * 4 + 3] * b[12 + j];
+                    tmp[i * 4 + j] = s;
+                }
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                rslt[i] = tmp[i];
+            }
+        }
+
+        void mat4_mul_vec4_scalar(const float *m, const float *v, float *rslt)
+        {
+            float tmp[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                float s = m[i * 4 + 0] * v[0];
+                s = s + m[i * 4 + 1] * v[1];
+                s = s + m[i * 4 + 2] * v[2];
+                s = s + m[i * 4 + 3] * v[3];
+                tmp[i] = s;
+            }
+            for (int i = 0; i < 4; ++i)
+            {
+                rslt[i] = tmp[i];
+            }
+        }
+
+        void mat4_transpose_scalar(const float *m, float *rslt)
+        {
+            float tmp[16];
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = 0; j < 4; ++j)
+                {
+                    tmp[j * 4 + i] = m[i * 4 + j];
+                }
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                rslt[i] = tmp[i];
+            }
+        }
+
+        bool mat4_inverse_affine_scalar(const float *m, float *rslt)
+        {
+            const float *r0 = m;
+            const float *r1 = m + 4;
+            const float *r2 = m + 8;
+            const float *t = m + 12;
+            // the columns of the inverse 3x3 block are the cross products of its rows
+            float c[3][3] = {
+                {r1[1] * r2[2] - r1[2] * r2[1], r1[2] * r2[0] - r1[0] * r2[2], r1[0] * r2[1] - r1[1] * r2[0]},
+                {r2[1] * r0[2] - r2[2] * r0[1], r2[2] * r0[0] - r2[0] * r0[2], r2[0] * r0[1] - r2[1] * r0[0]},
+                {r0[1] * r1[2] - r0[2] * r1[1], r0[2] * r1[0] - r0[0] * r1[2], r0[0] * r1[1] - r0[1] * r1[0]}};
+            float det = (r0[0] * c[0][0] + r0[1] * c[0][1]) + r0[2] * c[0][2];
+            if (Math::equal(det, 0.f))
+                return false;
+            float inv_det = 1.f / det;
+
+            float tmp[16];
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    tmp[i * 4 + j] = c[j][i] * inv_det;
+                }
+                tmp[i * 4 + 3] = 0.f;
+            }
+            for (int j = 0; j < 3; ++j)
+            {
+                tmp[12 + j] = -((t[0] * tmp[j] + t[1] * tmp[4 + j]) + t[2] * tmp[8 + j]);
+            }
+            tmp[15] = 1.f;
+            for (int i = 0; i < 16; ++i)
+            {
+                rslt[i] = tmp[i];
+            }
+            return true;
+        }
+
+#ifdef CORE_SIMD_SSE2
+        /*--------------------------------SSE2--------------------------------*/
+
+#define CORE_SPLAT(v, i) _mm_shuffle_ps((v), (v), _MM_SHUFFLE((i), (i), (i), (i)))
+
+        void mat4_mul_sse2(const float *a, const float *b, float *rslt)
+        {
+            __m128 b0 = _mm_loadu_ps(b);
+            __m128 b1 = _mm_loadu_ps(b + 4);
+            __m128 b2 = _mm_loadu_ps(b + 8);
+            __m128 b3 = _mm_loadu_ps(b + 12);
+            __m128 r[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                __m128 ai = _mm_loadu_ps(a + i * 4);
+                __m128 s = _mm_mul_ps(CORE_SPLAT(ai, 0), b0);
+                s = _mm_add_ps(s, _mm_mul_ps(CORE_SPLAT(ai, 1), b1));
+                s = _mm_add_ps(s, _mm_mul_ps(CORE_SPLAT(ai, 2), b2));
+                s = _mm_add_ps(s, _mm_mul_ps(CORE_SPLAT(ai, 3), b3));
+                r[i] = s;
+            }
+            for (int i = 0; i < 4; ++i)
+            {
+                _mm_storeu_ps(rslt + i * 4, r[i]);
+            }
+        }
+
+        void mat4_mul_vec4_sse2(const float *m, const float *v, float *rslt)
+        {
+            __m128 c0 = _mm_loadu_ps(m);
+            __m128 c1 = _mm_loadu_ps(m + 4);
+            __m128 c2 = _mm_loadu_ps(m + 8);
+            __m128 c3 = _mm_loadu_ps(m + 12);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            __m128 vv = _mm_loadu_ps(v);
+            __m128 s = _mm_mul_ps(c0, CORE_SPLAT(vv, 0));
+            s = _mm_add_ps(s, _mm_mul_ps(c1, CORE_SPLAT(vv, 1)));
+            s = _mm_add_ps(s, _mm_mul_ps(c2, CORE_SPLAT(vv, 2)));
+            s = _mm_add_ps(s, _mm_mul_ps(c3, CORE_SPLAT(vv, 3)));
+            _mm_storeu_ps(rslt, s);
+        }
+
+        void mat4_transpose_sse2(const float *m, float *rslt)
+        {
+            __m128 r0 = _mm_loadu_ps(m);
+            __m128 r1 = _mm_loadu_ps(m + 4);
+            __m128 r2 = _mm_loadu_ps(m + 8);
+            __m128 r3 = _mm_loadu_ps(m + 12);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(rslt, r0);
+            _mm_storeu_ps(rslt + 4, r1);
+            _mm_storeu_ps(rslt + 8, r2);
+            _mm_storeu_ps(rslt + 12, r3);
+        }
+
+        inline __m128 cross3(__m128 a, __m128 b)
+        {
+            __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 a_zxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+            __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 b_zxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+            return _mm_sub_ps(_mm_mul_ps(a_yzx, b_zxy), _mm_mul_ps(a_zxy, b_yzx));
+        }
+
+        bool mat4_inverse_affine_sse2(const float *m, float *rslt)
+        {
+            const __m128 mask_xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+            __m128 r0 = _mm_and_ps(_mm_loadu_ps(m), mask_xyz);
+            __m128 r1 = _mm_and_ps(_mm_loadu_ps(m + 4), mask_xyz);
+            __m128 r2 = _mm_and_ps(_mm_loadu_ps(m + 8), mask_xyz);
+            __m128 t = _mm_loadu_ps(m + 12);
+
+            __m128 c0 = cross3(r1, r2);
+            __m128 c1 = cross3(r2, r0);
+            __m128 c2 = cross3(r0, r1);
+
+            __m128 p = _mm_mul_ps(r0, c0);
+            __m128 d = _mm_add_ss(p, CORE_SPLAT(p, 1));
+            d = _mm_add_ss(d, _mm_movehl_ps(p, p));
+            float det = _mm_cvtss_f32(d);
+            if (Math::equal(det, 0.f))
+                return false;
+            __m128 inv_det = _mm_set1_ps(1.f / det);
+
+            __m128 c3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            c0 = _mm_mul_ps(c0, inv_det);
+            c1 = _mm_mul_ps(c1, inv_det);
+            c2 = _mm_mul_ps(c2, inv_det);
+
+            __m128 tr = _mm_mul_ps(CORE_SPLAT(t, 0), c0);
+            tr = _mm_add_ps(tr, _mm_mul_ps(CORE_SPLAT(t, 1), c1));
+            tr = _mm_add_ps(tr, _mm_mul_ps(CORE_SPLAT(t, 2), c2));
+            tr = _mm_xor_ps(tr, _mm_set1_ps(-0.f));
+
+            _mm_storeu_ps(rslt, c0);
+            _mm_storeu_ps(rslt + 4, c1);
+            _mm_storeu_ps(rslt + 8, c2);
+            _mm_storeu_ps(rslt + 12, tr);
+            rslt[3] = 0.f;
+            rslt[7] = 0.f;
+            rslt[11] = 0.f;
+            rslt[15] = 1.f;
+            return true;
+        }
+#endif // CORE_SIMD_SSE2
+
+#ifdef CORE_SIMD_AVX
+        /*--------------------------------AVX---------------------------------*/
+
+        // two output rows per iteration: the low lane holds row i, the high lane row i + 1
+        CORE_TARGET_AVX void mat4_mul_avx(const float *a, const float *b, float *rslt)
+        {
+            __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b));
+            __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 4));
+            __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 8));
+            __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 12));
+            __m256 a01 = _mm256_loadu_ps(a);
+            __m256 a23 = _mm256_loadu_ps(a + 8);
+
+            __m256 s01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+            s01 = _mm256_add_ps(s01, _mm256_mul_ps(_mm256_permute_ps(a01, 0x55), b1));
+            s01 = _mm256_add_ps(s01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xAA), b2));
+            s01 = _mm256_add_ps(s01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xFF), b3));
+
+            __m256 s23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+            s23 = _mm256_add_ps(s23, _mm256_mul_ps(_mm256_permute_ps(a23, 0x55), b1));
+            s23 = _mm256_add_ps(s23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xAA), b2));
+            s23 = _mm256_add_ps(s23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xFF), b3));
+
+            _mm256_storeu_ps(rslt, s01);
+            _mm256_storeu_ps(rslt + 8, s23);
+            _mm256_zeroupper();
+        }
+
+        CORE_TARGET_FMA void mat4_mul_fma(const float *a, const float *b, float *rslt)
+        {
+            __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b));
+            __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 4));
+            __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 8));
+            __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 12));
+            __m256 a01 = _mm256_loadu_ps(a);
+            __m256 a23 = _mm256_loadu_ps(a + 8);
+
+            __m256 s01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+            s01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x55), b1, s01);
+            s01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xAA), b2, s01);
+            s01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xFF), b3, s01);
+
+            __m256 s23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+            s23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0x55), b1, s23);
+            s23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xAA), b2, s23);
+            s23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xFF), b3, s23);
+
+            _mm256_storeu_ps(rslt, s01);
+            _mm256_storeu_ps(rslt + 8, s23);
+            _mm256_zeroupper();
+        }
+
+        CORE_TARGET_FMA void mat4_mul_vec4_fma(const float *m, const float *v, float *rslt)
+        {
+            __m128 c0 = _mm_loadu_ps(m);
+            __m128 c1 = _mm_loadu_ps(m + 4);
+            __m128 c2 = _mm_loadu_ps(m + 8);
+            __m128 c3 = _mm_loadu_ps(m + 12);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            __m128 vv = _mm_loadu_ps(v);
+            __m128 s = _mm_mul_ps(c0, CORE_SPLAT(vv, 0));
+            s = _mm_fmadd_ps(c1, CORE_SPLAT(vv, 1), s);
+            s = _mm_fmadd_ps(c2, CORE_SPLAT(vv, 2), s);
+            s = _mm_fmadd_ps(c3, CORE_SPLAT(vv, 3), s);
+            _mm_storeu_ps(rslt, s);
+        }
+#endif // CORE_SIMD_AVX
+
+        /*------------------------------dispatch------------------------------*/
+
+        struct Kernels
+        {
+            Backend backend;
+            void (*mul)(const float *, const float *, float *);
+            void (*mul_vec4)(const float *, const float *, float *);
+            void (*transpose)(const float *, float *);
+            bool (*inverse_affine)(const float *, float *);
+        };
+
+        Kernels make_kernels(Backend backend)
+        {
+            switch (backend)
+            {
+#ifdef CORE_SIMD_AVX
+            case FMA:
+                return {FMA, mat4_mul_fma, mat4_mul_vec4_fma, mat4_transpose_sse2, mat4_inverse_affine_sse2};
+            case AVX:
+                return {AVX, mat4_mul_avx, mat4_mul_vec4_sse2, mat4_transpose_sse2, mat4_inverse_affine_sse2};
+#endif
+#ifdef CORE_SIMD_SSE2
+            case SSE2:
+                return {SSE2, mat4_mul_sse2, mat4_mul_vec4_sse2, mat4_transpose_sse2, mat4_inverse_affine_sse2};
+#endif
+            default:
+                return {SCALAR, mat4_mul_scalar, mat4_mul_vec4_scalar, mat4_transpose_scalar, mat4_inverse_affine_scalar};
+            }
+        }
+
+        // one immutable table per backend; switching swaps the pointer, so a
+        // kernel call racing with set_backend() runs entirely on either table
+        const Kernels &kernels_of(Backend backend)
+        {
+            static const Kernels tables[] = {make_kernels(SCALAR), make_kernels(SSE2), make_kernels(AVX), make_kernels(FMA)};
+            return tables[backend];
+        }
+
+        std::atomic<const Kernels *> &current_kernels()
+        {
+            static std::atomic<const Kernels *> current{&kernels_of(best_backend())};
+            return current;
+        }
+
+        const Kernels &kernels()
+        {
+            return *current_kernels().load(std::memory_order_acquire);
+        }
+    } // namespace
+
+    bool is_supported(Backend backend)
+    {
+        switch (backend)
+        {
+        case SCALAR:
+            return true;
+#ifdef CORE_SIMD_SSE2
+        case SSE2:
+            return true;
+#endif
+#ifdef CORE_SIMD_AVX
+        case AVX:
+            return __builtin_cpu_supports("avx");
+        case FMA:
+            return __builtin_cpu_supports("avx") && __builtin_cpu_supports("fma");
+#endif
+        default:
+            return false;
+        }
+    }
+
+    Backend best_backend()
+    {
+        static const Backend best = is_supported(AVX) ? AVX : is_supported(SSE2) ? SSE2
+                                                                                 : SCALAR;
+        return best;
+    }
+
+    Backend get_backend()
+    {
+        return kernels().backend;
+    }
+
+    Backend set_backend(Backend backend)
+    {
+        int b = backend;
+        while (b > SCALAR && !is_supported(Backend(b)))
+        {
+            --b;
+        }
+        current_kernels().store(&kernels_of(Backend(b)), std::memory_order_release);
+        return Backend(b);
+    }
+
+    const char *backend_name(Backend backend)
+    {
+        switch (backend)
+        {
+        case SCALAR:
+            return "scalar";
+        case SSE2:
+            return "sse2";
+        case AVX:
+            return "avx";
+        case FMA:
+            return "fma";
+        default:
+            return "unknown";
+        }
+    }
+
+    void mat4_mul(const float *a, const float *b, float *rslt)
+    {
+        kernels().mul(a, b, rslt);
+    }
+
+    void mat4_mul_vec4(const float *m, const float *v, float *rslt)
+    {
+        kernels().mul_vec4(m, v, rslt);
+    }
+
+    void mat4_transpose(const float *m, float *rslt)
+    {
+        kernels().transpose(m, rslt);
+    }
+
+    bool mat4_inverse_affine(const float *m, float *rslt)
+    {
+        return kernels().inverse_affine(m, rslt);
+    }
+
+    bool mat4_inverse_affine_either(const float *m, float *rslt)
+    {
+        if (m[3] == 0.f && m[7] == 0.f && m[11] == 0.f && m[15] == 1.f)
+        {
+            return mat4_inverse_affine(m, rslt);
+        }
+        if (m[12] == 0.f && m[13] == 0.f && m[14] == 0.f && m[15] == 1.f)
+        {
+            // column-vector form: the inverse of the transpose is the transposed inverse
+            float transposed[16];
+            mat4_transpose(m, transposed);
+            if (!mat4_inverse_affine(transposed, transposed))
+            {
+                return false;
+            }
+            mat4_transpose(transposed, rslt);
+            return true;
+        }
+        return false;
+    }
+} // namespace Core::Math::SIMD
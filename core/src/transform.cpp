@@ -1,16 +1,24 @@
 #include "transform.h"
+#include <atomic>
 
 #include "geometry/geometry3d.h"
 namespace Core
 {
-    Transform::Transform(const Core::Vector3 &pos, const EulerAngle &euler_angle, const Core::Vector3 &scale)
+    namespace
+    {
+        // source of the version stamps, shared by all transforms
+        std::atomic<uint64_t> version_counter{0};
+    }
+
+    Transform::Transform(const Core::Vec3 &pos, const EulerAngle &euler_angle, const Core::Vec3 &scale)
         : m_position(pos),
           m_scale(scale),
-          m_orientation(Quaternion::from_euler_angle(euler_angle.yaw, euler_angle.pitch, euler_angle.roll))
+          m_orientation(Quaternion::from_euler_angle(euler_angle.yaw, euler_angle.pitch, euler_angle.roll)),
+          m_version(++version_counter)
     {
     }
 
-    Transform::Transform(const Transform &transform) : m_position(transform.m_position), m_scale(transform.m_scale), m_orientation(transform.m_orientation)
+    Transform::Transform(const Transform &transform) : m_position(transform.m_position), m_scale(transform.m_scale), m_orientation(transform.m_orientation), m_version(++version_counter)
     {
     }
 
@@ -19,10 +27,11 @@ namespace Core
         m_position = transform.m_position;
         m_scale = transform.m_scale;
         m_orientation = transform.m_orientation;
+        touch();
         return *this;
     }
 
-    Transform::Transform(Transform &&transform) : m_position(transform.m_position), m_scale(transform.m_scale), m_orientation(transform.m_orientation)
+    Transform::Transform(Transform &&transform) : m_position(transform.m_position), m_scale(transform.m_scale), m_orientation(transform.m_orientation), m_version(++version_counter)
     {
     }
 
@@ -31,12 +40,14 @@ namespace Core
         m_position = transform.m_position;
         m_scale = transform.m_scale;
         m_orientation = transform.m_orientation;
+        touch();
         return *this;
     }
 
-    Transform::Transform(const Core::Vector3 &pos, const Core::Vector3 &front, const Core::Vector3 &up, const Core::Vector3 &scale)
+    Transform::Transform(const Core::Vec3 &pos, const Core::Vec3 &front, const Core::Vec3 &up, const Core::Vec3 &scale)
         : m_position(pos),
-          m_scale(scale)
+          m_scale(scale),
+          m_version(++version_counter)
     {
         set_orientation(front, up);
     }
@@ -45,172 +56,193 @@ namespace Core
     {
     }
 
-    void Transform::set_position(Vector3 position)
+    void Transform::set_position(Vec3 position)
     {
         this->m_position = position;
+        touch();
     }
 
     void Transform::set_position(float x, float y, float z)
     {
-        this->m_position = Vector3(x, y, z);
+        this->m_position = Vec3(x, y, z);
+        touch();
     }
 
     void Transform::set_orientation(Quaternion rotation)
     {
         this->m_orientation = rotation;
+        touch();
     }
 
     void Transform::set_orientation(const Core::EulerAngle &euler_angle)
     {
         this->m_orientation = Quaternion::from_euler_angle(euler_angle);
+        touch();
     }
 
-    void Transform::set_orientation(const Core::Vector3 &front, const Core::Vector3 &up)
+    void Transform::set_orientation(const Core::Vec3 &front, const Core::Vec3 &up)
     {
         // normalize and orthogonalize
-        Vector3 front_ = Geometry::normalize(front);
-        Vector3 up_ = Geometry::normalize(up);
-        Vector3 right = Vector3::cross(front_, up_);
-        up_ = Vector3::cross(right, front_);
+        Vec3 front_ = Geometry::normalize(front);
+        Vec3 up_ = Geometry::normalize(up);
+        Vec3 right = Vec3::cross(front_, up_);
+        up_ = Vec3::cross(right, front_);
         this->m_orientation = Quaternion::from_basis_vector(front_, up_, right);
+        touch();
     }
 
-    void Transform::look_at(const Core::Vector3 &front, const Core::Vector3 &up)
+    void Transform::look_at(const Core::Vec3 &front, const Core::Vec3 &up)
     {
         this->m_orientation = Geometry::quat_look_at(front, up);
+        touch();
     }
 
-    void Transform::look_at(const Core::Vector3 &target)
+    void Transform::look_at(const Core::Vec3 &target)
     {
         this->m_orientation = Geometry::quat_look_at(Geometry::normalize(target - m_position), get_up());
+        touch();
     }
 
-    void Transform::set_front(Core::Vector3 front)
+    void Transform::set_front(Core::Vec3 front)
     {
-        Vector3 front_ = Geometry::normalize(front);
-        Vector3 up_ = Geometry::normalize(get_up());
-        Vector3 right = Vector3::cross(front_, up_);
-        up_ = Vector3::cross(right, front_);
+        Vec3 front_ = Geometry::normalize(front);
+        Vec3 up_ = Geometry::normalize(get_up());
+        Vec3 right = Vec3::cross(front_, up_);
+        up_ = Vec3::cross(right, front_);
         this->m_orientation = Quaternion::from_basis_vector(front_, up_, right);
+        touch();
     }
 
     void Transform::set_front(float x, float y, float z)
     {
-        set_front(Vector3(x, y, z));
+        set_front(Vec3(x, y, z));
     }
 
-    void Transform::set_up(Core::Vector3 up)
+    void Transform::set_up(Core::Vec3 up)
     {
-        Vector3 up_ = Geometry::normalize(up);
-        Vector3 front_ = Geometry::normalize(get_front());
-        Vector3 right = Vector3::cross(front_, up_);
-        front_ = Vector3::cross(up_, right);
+        Vec3 up_ = Geometry::normalize(up);
+        Vec3 front_ = Geometry::normalize(get_front());
+        Vec3 right = Vec3::cross(front_, up_);
+        front_ = Vec3::cross(up_, right);
         this->m_orientation = Quaternion::from_basis_vector(front_, up_, right);
+        touch();
     }
 
     void Transform::set_up(float x, float y, float z)
     {
-        set_up(Vector3(x, y, z));
+        set_up(Vec3(x, y, z));
     }
 
-    void Transform::set_right(Core::Vector3 right)
+    void Transform::set_right(Core::Vec3 right)
     {
-        Vector3 right_ = Geometry::normalize(right);
-        Vector3 front_ = Geometry::normalize(get_front());
-        Vector3 up_ = Vector3::cross(right_, front_);
-        front_ = Vector3::cross(up_, right_);
+        Vec3 right_ = Geometry::normalize(right);
+        Vec3 front_ = Geometry::normalize(get_front());
+        Vec3 up_ = Vec3::cross(right_, front_);
+        front_ = Vec3::cross(up_, right_);
         this->m_orientation = Quaternion::from_basis_vector(front_, up_, right_);
+        touch();
     }
 
     void Transform::set_right(float x, float y, float z)
     {
-        set_right(Vector3(x, y, z));
+        set_right(Vec3(x, y, z));
     }
 
-    void Transform::set_scale(Vector3 scale)
+    void Transform::set_scale(Vec3 scale)
     {
         this->m_scale = scale;
+        touch();
     }
 
     void Transform::set_scale(float x, float y, float z)
     {
-        this->m_scale = Vector3(x, y, z);
+        this->m_scale = Vec3(x, y, z);
+        touch();
     }
 
     void Transform::set_scale(float scale)
     {
-        this->m_scale = Vector3(scale, scale, scale);
+        this->m_scale = Vec3(scale, scale, scale);
+        touch();
     }
 
     void Transform::move_forward(float distance)
     {
         m_position += get_front() * distance;
+        touch();
     }
 
     void Transform::move_right(float distance)
     {
         m_position += get_right() * distance;
+        touch();
     }
 
     void Transform::move_up(float distance)
     {
         m_position += get_up() * distance;
+        touch();
     }
 
-    void Transform::move(Vector3 direction, float distance)
+    void Transform::move(Vec3 direction, float distance)
     {
         m_position += direction * distance;
+        touch();
     }
 
-    void Transform::move_around_vertically(Vector3 center, float angle_degree)
+    void Transform::move_around_vertically(Vec3 center, float angle_degree)
     {
         float angle_rad = Geometry::radians(-angle_degree);
         Quaternion rot = Geometry::angle_axis(angle_rad, get_up());
-        m_position = Vector3(rot * Vector4(m_position - center, 1.0f)) + center;
+        m_position = rot * (m_position - center) + center;
         m_orientation = (rot * m_orientation).normalize();
+        touch();
     }
 
-    void Transform::move_around_horizontally(Vector3 center, float angle_degree)
+    void Transform::move_around_horizontally(Vec3 center, float angle_degree)
     {
         float angle_rad = Geometry::radians(-angle_degree);
         Quaternion rot = Geometry::angle_axis(angle_rad, get_right());
-        m_position = Vector3(rot * Vector4(m_position - center, 1.0f)) + center;
+        m_position = rot * (m_position - center) + center;
         m_orientation = (rot * m_orientation).normalize();
+        touch();
     }
 
-    Vector3 Transform::get_position()
+    Vec3 Transform::get_position() const
     {
         return m_position;
     }
 
-    Quaternion Transform::get_orientation()
+    Quaternion Transform::get_orientation() const
     {
         return m_orientation;
     }
 
-    EulerAngle Transform::get_orientation_euler_angle()
+    EulerAngle Transform::get_orientation_euler_angle() const
     {
         return m_orientation.to_euler_angle();
     }
 
-    Matrix4 Transform::get_orientation_matrix()
+    Mat4 Transform::get_orientation_matrix() const
     {
         return m_orientation.to_matrix4();
     }
 
-    Vector3 Transform::get_scale()
+    Vec3 Transform::get_scale() const
     {
         return m_scale;
     }
 
-    void Transform::translate(Vector3 translation)
+    void Transform::translate(Vec3 translation)
     {
         m_position += translation;
+        touch();
     }
 
     void Transform::translate(float x, float y, float z)
     {
-        m_position += Vector3(x, y, z);
+        m_position += Vec3(x, y, z);
+        touch();
     }
 
     void Transform::rotate_x(float angle_degree, bool local)
@@ -225,6 +257,7 @@ namespace Core
         {
             m_orientation = (m_orientation * offset).normalize();
         }
+        touch();
     }
 
     void Transform::rotate_y(float angle_degree, bool local)
@@ -239,6 +272,7 @@ namespace Core
         {
             m_orientation = (m_orientation * offset).normalize();
         }
+        touch();
     }
 
     void Transform::rotate_z(float angle_degree, bool local)
@@ -253,9 +287,10 @@ namespace Core
         {
             m_orientation = (m_orientation * offset).normalize();
         }
+        touch();
     }
 
-    void Transform::angle_axis_rotate(float angle_rad, Vector3 axis, bool local)
+    void Transform::angle_axis_rotate(float angle_rad, Vec3 axis, bool local)
     {
         Quaternion offset = Geometry::angle_axis(angle_rad, axis);
         if (local)
@@ -266,6 +301,7 @@ namespace Core
         {
             m_orientation = (m_orientation * offset).normalize();
         }
+        touch();
     }
 
     void Transform::scale(float x, float y, float z)
@@ -273,46 +309,74 @@ namespace Core
         m_scale.x() *= x;
         m_scale.y() *= y;
         m_scale.z() *= z;
+        touch();
     }
 
-    void Transform::scale(Vector3 scale)
+    void Transform::scale(Vec3 scale)
     {
         this->m_scale.x() *= scale.x();
         this->m_scale.y() *= scale.y();
         this->m_scale.z() *= scale.z();
+        touch();
     }
 
     void Transform::scale(float scale)
     {
         this->m_scale *= scale;
+        touch();
     }
 
-    Vector3 Transform::get_front()
+    Vec3 Transform::get_front() const
     {
         return Geometry::normalize(m_orientation * WORLD_FRONT);
     }
 
-    Vector3 Transform::get_right()
+    Vec3 Transform::get_right() const
     {
         return Geometry::normalize(m_orientation * WORLD_RIGHT);
     }
 
-    Vector3 Transform::get_up()
+    Vec3 Transform::get_up() const
     {
         return Geometry::normalize(m_orientation * WORLD_UP);
     }
 
-    Core::Matrix3 Transform::get_normal_matrix()
+    const Core::Mat3 &Transform::get_normal_matrix() const
+    {
+        if (m_normal_dirty)
+        {
+            // inverse transpose of the rotation-scale block: the rotation stays, the
+            // scale that get_model_matrix() puts on row i becomes 1 / scale on row i
+            auto inv = [](float s)
+            { return s != 0.f ? 1.f / s : 0.f; };
+            Core::Mat4 rotation = m_orientation.to_matrix4();
+            m_normal = Core::Mat3(Geometry::scale(rotation, inv(m_scale.x()), inv(m_scale.y()), inv(m_scale.z())));
+            m_normal_dirty = false;
+        }
+        return m_normal;
+    }
+
+    const Core::Mat4 &Transform::get_model_matrix() const
+    {
+        if (m_model_dirty)
+        {
+            Core::Mat4 model = m_orientation.to_matrix4();
+            model = Geometry::scale(model, m_scale);
+            m_model = Geometry::translate(model, m_position);
+            m_model_dirty = false;
+        }
+        return m_model;
+    }
+
+    uint64_t Transform::current_version()
     {
-        return m_orientation.to_matrix4().inverse().transpose();
+        return version_counter.load(std::memory_order_relaxed);
     }
 
-    Core::Matrix4 Transform::get_model_matrix()
+    void Transform::touch()
     {
-        Core::Matrix4 model = Core::Matrix4::identity();
-        model = model * m_orientation.to_matrix4();
-        model = Geometry::scale(model, m_scale);
-        model = Geometry::translate(model, m_position);
-        return model;
+        m_model_dirty = true;
+        m_normal_dirty = true;
+        m_version = ++version_counter;
     }
 }; // namespace Core
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "geometry/batch.h"
+#include "geometry/geometry3d.h"
+#include "math/simd.h"
+
+using namespace Core;
+using namespace Core::Math;
+
+namespace
+{
+    std::vector<float> random_values(size_t n, unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<float> dist(-10.f, 10.f);
+        std::vector<float> rslt(n);
+        for (auto &v : rslt)
+            v = dist(gen);
+        return rslt;
+    }
+
+    // p' = (x, y, z, w) * m, in double
+    void reference(const Mat4 &m, const float *p, float w, double *rslt)
+    {
+        for (size_t j = 0; j < 4; ++j)
+            rslt[j] = double(p[0]) * m(0, j) + double(p[1]) * m(1, j) + double(p[2]) * m(2, j) + double(w) * m(3, j);
+    }
+
+    Mat4 model()
+    {
+        Mat4 m = Geometry::rotate(Mat4::identity(), 0.7f, Geometry::normalize(Vec3(1.f, 2.f, -0.5f)));
+        m = Geometry::scale(m, 1.5f, 0.5f, 2.f);
+        return Geometry::translate(m, 3.f, -4.f, 5.f);
+    }
+
+    class BatchTest : public ::testing::TestWithParam<SIMD::Backend>
+    {
+    protected:
+        void SetUp() override
+        {
+            if (!SIMD::is_supported(GetParam()))
+                GTEST_SKIP() << SIMD::backend_name(GetParam()) << " is not supported on this CPU";
+            previous = SIMD::get_backend();
+            SIMD::set_backend(GetParam());
+        }
+        void TearDown() override
+        {
+            SIMD::set_backend(previous);
+            Geometry::set_batch_threads(0);
+        }
+
+        SIMD::Backend previous = SIMD::SCALAR;
+    };
+}
+
+TEST_P(BatchTest, points_and_vectors)
+{
+    const Mat4 m = model();
+    const size_t count = 37;
+    auto in = random_values(count * 3, 1);
+    std::vector<float> points(in.size()), vectors(in.size());
+    Geometry::transform_points(m, in.data(), points.data(), count);
+    Geometry::transform_vectors(m, in.data(), vectors.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        double p[4], v[4];
+        reference(m, &in[i * 3], 1.f, p);
+        reference(m, &in[i * 3], 0.f, v);
+        for (size_t j = 0; j < 3; ++j)
+        {
+            EXPECT_NEAR(points[i * 3 + j], p[j], 1e-4);
+            EXPECT_NEAR(vectors[i * 3 + j], v[j], 1e-4);
+        }
+    }
+}
+
+TEST_P(BatchTest, layouts_agree)
+{
+    const Mat4 m = model();
+    const size_t count = 301;
+    auto aos = random_values(count * 3, 2);
+    std::vector<float> x(count), y(count), z(count);
+    std::vector<float> xyzw(count * 4, 42.f);
+    std::vector<Vec3> vec3(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        x[i] = xyzw[i * 4] = vec3[i].x() = aos[i * 3];
+        y[i] = xyzw[i * 4 + 1] = vec3[i].y() = aos[i * 3 + 1];
+        z[i] = xyzw[i * 4 + 2] = vec3[i].z() = aos[i * 3 + 2];
+    }
+
+    // AoS in place, padded AoS, Vec3 arrays and SoA in place
+    Geometry::transform_points(m, aos.data(), aos.data(), count);
+    Geometry::transform_points(m, xyzw.data(), xyzw.data(), count, 4);
+    Geometry::transform_points(m, vec3.data(), vec3.data(), count);
+    Geometry::transform_points(m, Geometry::ConstPointsSoA(x.data(), y.data(), z.data()), {x.data(), y.data(), z.data()}, count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t j = 0; j < 3; ++j)
+        {
+            const float expected = aos[i * 3 + j];
+            EXPECT_EQ(xyzw[i * 4 + j], expected);
+            EXPECT_EQ(vec3[i][j], expected);
+            EXPECT_EQ((j == 0 ? x : j == 1 ? y : z)[i], expected);
+        }
+        // the padding is left alone
+        EXPECT_EQ(xyzw[i * 4 + 3], 42.f);
+    }
+}
+
+TEST_P(BatchTest, project)
+{
+    const Mat4 mvp = model() * Geometry::perspective(Geometry::radians(60.f), 1.5f, 0.1f, 100.f);
+    const size_t count = 19;
+    auto in = random_values(count * 3, 3);
+    std::vector<float> out(in.size());
+    Geometry::project_points(mvp, in.data(), out.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        double p[4];
+        reference(mvp, &in[i * 3], 1.f, p);
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_NEAR(out[i * 3 + j], p[j] / p[3], 1e-3 * std::fabs(p[j] / p[3]) + 1e-4);
+    }
+}
+
+TEST_P(BatchTest, homogeneous)
+{
+    const Mat4 m = model() * Geometry::perspective(1.f, 1.f, 0.5f, 10.f);
+    std::vector<Vec4> in = {Vec4(1.f, 2.f, 3.f, 1.f), Vec4(-1.f, 0.5f, 2.f, 0.f), Vec4(4.f, -3.f, 1.f, 2.f)};
+    std::vector<Vec4> out(in.size());
+    Geometry::transform_points(m, in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        double p[4];
+        reference(m, in[i].data(), in[i].w(), p);
+        for (size_t j = 0; j < 4; ++j)
+            EXPECT_NEAR(out[i][j], p[j], 1e-4);
+    }
+}
+
+TEST_P(BatchTest, normals)
+{
+    const Mat3 normal_matrix = Mat3(model().inverse_affine().transpose());
+    const size_t count = 21;
+    auto in = random_values(count * 3, 4);
+    in[6] = in[7] = in[8] = 0.f;
+    std::vector<float> out(in.size());
+    Geometry::transform_normals(normal_matrix, in.data(), out.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float *n = &out[i * 3];
+        if (i == 2)
+        {
+            EXPECT_EQ(n[0], 0.f);
+            EXPECT_EQ(n[1], 0.f);
+            EXPECT_EQ(n[2], 0.f);
+            continue;
+        }
+        EXPECT_NEAR(n[0] * n[0] + n[1] * n[1] + n[2] * n[2], 1.f, 1e-5);
+        double r[3] = {};
+        for (size_t j = 0; j < 3; ++j)
+            for (size_t k = 0; k < 3; ++k)
+                r[j] += double(in[i * 3 + k]) * normal_matrix(k, j);
+        const double len = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_NEAR(n[j], r[j] / len, 1e-5);
+    }
+}
+
+TEST_P(BatchTest, rotate)
+{
+    // not normalized on purpose, the batch has to agree with operator* anyway
+    const Quaternion q(0.9f, 0.3f, -0.6f, 0.2f);
+    const size_t count = 29;
+    auto in = random_values(count * 3, 5);
+    std::vector<float> out(in.size());
+    Geometry::rotate_points(q, in.data(), out.data(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Vec3 expected = q * Vec3(in[i * 3], in[i * 3 + 1], in[i * 3 + 2]);
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_NEAR(out[i * 3 + j], expected[j], 1e-4);
+    }
+}
+
+TEST_P(BatchTest, threaded)
+{
+    const Mat4 m = model();
+    const size_t count = 200003;
+    auto in = random_values(count * 3, 6);
+    std::vector<float> serial(in.size()), threaded(in.size());
+
+    Geometry::set_batch_threads(1);
+    Geometry::transform_points(m, in.data(), serial.data(), count);
+    Geometry::set_batch_threads(4);
+    Geometry::transform_points(m, in.data(), threaded.data(), count);
+    EXPECT_EQ(serial, threaded);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, BatchTest,
+                         ::testing::Values(SIMD::SCALAR, SIMD::AVX, SIMD::FMA),
+                         [](const ::testing::TestParamInfo<SIMD::Backend> &info)
+                         { return std::string(SIMD::backend_name(info.param)); });
+
+TEST(TestBatch, backends_bit_identical)
+{
+    if (!SIMD::is_supported(SIMD::AVX))
+        GTEST_SKIP() << "AVX is not supported on this CPU";
+    const SIMD::Backend previous = SIMD::get_backend();
+    const Mat4 mvp = model() * Geometry::perspective(1.f, 1.f, 0.5f, 10.f);
+    const size_t count = 1001;
+    auto in = random_values(count * 3, 7);
+    std::vector<float> scalar(in.size()), avx(in.size());
+
+    SIMD::set_backend(SIMD::SCALAR);
+    Geometry::project_points(mvp, in.data(), scalar.data(), count);
+    SIMD::set_backend(SIMD::AVX);
+    Geometry::project_points(mvp, in.data(), avx.data(), count);
+    SIMD::set_backend(previous);
+    EXPECT_EQ(scalar, avx);
+}
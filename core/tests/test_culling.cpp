@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "geometry/culling.h"
+#include "geometry/batch.h"
+#include "geometry/geometry3d.h"
+#include "math/simd.h"
+
+using namespace Core;
+using namespace Core::Math;
+
+namespace
+{
+    Mat4 camera()
+    {
+        const Mat4 view = Geometry::look_at(Vec3(0.f, 0.f, 5.f), Vec3(0.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+        return view * Geometry::perspective(1.f, 1.5f, 0.5f, 50.f);
+    }
+
+    // inside the clip volume, in double
+    bool in_clip_space(const Mat4 &m, const Vec3 &p)
+    {
+        double clip[4];
+        for (size_t j = 0; j < 4; ++j)
+            clip[j] = double(p.x()) * m(0, j) + double(p.y()) * m(1, j) + double(p.z()) * m(2, j) + m(3, j);
+        return std::fabs(clip[0]) <= clip[3] && std::fabs(clip[1]) <= clip[3] && std::fabs(clip[2]) <= clip[3];
+    }
+
+    struct Spheres
+    {
+        std::vector<float> x, y, z, radius;
+        Geometry::SpheresSoA soa() const { return {x.data(), y.data(), z.data(), radius.data()}; }
+    };
+
+    Spheres random_spheres(size_t n, unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<float> position(-40.f, 40.f);
+        std::uniform_real_distribution<float> radius(0.f, 3.f);
+        Spheres rslt;
+        for (size_t i = 0; i < n; ++i)
+        {
+            rslt.x.push_back(position(gen));
+            rslt.y.push_back(position(gen));
+            rslt.z.push_back(position(gen));
+            rslt.radius.push_back(radius(gen));
+        }
+        return rslt;
+    }
+
+    class CullingTest : public ::testing::TestWithParam<SIMD::Backend>
+    {
+    protected:
+        void SetUp() override
+        {
+            if (!SIMD::is_supported(GetParam()))
+                GTEST_SKIP() << SIMD::backend_name(GetParam()) << " is not supported on this CPU";
+            previous = SIMD::get_backend();
+            SIMD::set_backend(GetParam());
+        }
+        void TearDown() override
+        {
+            SIMD::set_backend(previous);
+            Geometry::set_batch_threads(0);
+        }
+
+        SIMD::Backend previous = SIMD::SCALAR;
+    };
+}
+
+TEST(TestCulling, frustum_planes)
+{
+    const Mat4 m = camera();
+    const Geometry::Frustum frustum = Geometry::extract_frustum(m);
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> position(-60.f, 60.f);
+    for (int i = 0; i < 2000; ++i)
+    {
+        const Vec3 p(position(gen), position(gen), position(gen));
+        EXPECT_EQ(Geometry::intersects(frustum, Geometry::BoundingSphere{p, 0.f}), in_clip_space(m, p));
+    }
+    for (const auto &plane : frustum.planes)
+        EXPECT_NEAR(plane.x() * plane.x() + plane.y() * plane.y() + plane.z() * plane.z(), 1.f, 1e-5f);
+}
+
+TEST(TestCulling, bounds)
+{
+    const float points[] = {1.f, -2.f, 3.f, -1.f, 2.f, 5.f, 0.f, 0.f, 4.f};
+    const Geometry::AABB box = Geometry::compute_aabb(points, 3);
+    EXPECT_EQ(box.min.x(), -1.f);
+    EXPECT_EQ(box.min.y(), -2.f);
+    EXPECT_EQ(box.min.z(), 3.f);
+    EXPECT_EQ(box.max.x(), 1.f);
+    EXPECT_EQ(box.max.y(), 2.f);
+    EXPECT_EQ(box.max.z(), 5.f);
+
+    const Geometry::BoundingSphere sphere = Geometry::compute_sphere(points, 3);
+    EXPECT_EQ(sphere.center.z(), 4.f);
+    EXPECT_NEAR(sphere.radius, std::sqrt(6.f), 1e-6f);
+
+    // a stride of 4 skips the fourth component
+    const float padded[] = {1.f, 1.f, 1.f, 100.f, -1.f, -1.f, -1.f, 100.f};
+    EXPECT_EQ(Geometry::compute_aabb(padded, 2, 4).max.x(), 1.f);
+    EXPECT_EQ(Geometry::compute_sphere(nullptr, 0).radius, 0.f);
+}
+
+TEST(TestCulling, transformed_bounds)
+{
+    Mat4 m = Geometry::rotate(Mat4::identity(), 0.7f, Geometry::normalize(Vec3(1.f, 2.f, -0.5f)));
+    m = Geometry::scale(m, 1.5f, 0.5f, 2.f);
+    m = Geometry::translate(m, 3.f, -4.f, 5.f);
+    const Geometry::AABB box{Vec3(-1.f, -2.f, -0.5f), Vec3(2.f, 1.f, 0.5f)};
+    const Geometry::AABB world_box = Geometry::transform_aabb(m, box);
+    const Geometry::BoundingSphere sphere{Vec3(0.5f, -0.5f, 0.f), 2.f};
+    const Geometry::BoundingSphere world_sphere = Geometry::transform_sphere(m, sphere);
+    // every transformed corner of the box stays inside both
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const Vec3 p((corner & 1) ? box.max.x() : box.min.x(), (corner & 2) ? box.max.y() : box.min.y(), (corner & 4) ? box.max.z() : box.min.z());
+        Vec3 q;
+        Geometry::transform_points(m, &p, &q, 1);
+        for (size_t c = 0; c < 3; ++c)
+        {
+            EXPECT_GE(q.values[c], world_box.min.values[c] - 1e-4f);
+            EXPECT_LE(q.values[c], world_box.max.values[c] + 1e-4f);
+        }
+        if (Geometry::distance(p, sphere.center) <= sphere.radius)
+        {
+            EXPECT_LE(Geometry::distance(q, world_sphere.center), world_sphere.radius + 1e-4f);
+        }
+    }
+    // the largest axis scale is 2
+    EXPECT_NEAR(world_sphere.radius, 4.f, 1e-5f);
+}
+
+TEST_P(CullingTest, spheres)
+{
+    const Geometry::Frustum frustum = Geometry::extract_frustum(camera());
+    const size_t count = 1003;
+    const Spheres spheres = random_spheres(count, 2);
+    std::vector<uint8_t> visible(count, 2);
+    const size_t rslt = Geometry::cull_spheres(frustum, spheres.soa(), visible.data(), count);
+
+    size_t expected = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        bool outside = false;
+        for (const auto &p : frustum.planes)
+            outside |= double(p.x()) * spheres.x[i] + double(p.y()) * spheres.y[i] + double(p.z()) * spheres.z[i] + p.w() < -1e-4 - spheres.radius[i];
+        if (!outside)
+        {
+            EXPECT_EQ(visible[i], 1) << i;
+        }
+        expected += visible[i];
+        ASSERT_LE(visible[i], 1);
+    }
+    EXPECT_EQ(rslt, expected);
+    EXPECT_GT(rslt, 0u);
+    EXPECT_LT(rslt, count);
+}
+
+TEST_P(CullingTest, boxes)
+{
+    const Geometry::Frustum frustum = Geometry::extract_frustum(camera());
+    const size_t count = 517;
+    const Spheres spheres = random_spheres(count, 3);
+    std::vector<float> min_x(count), min_y(count), min_z(count), max_x(count), max_y(count), max_z(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        min_x[i] = spheres.x[i] - spheres.radius[i];
+        min_y[i] = spheres.y[i] - spheres.radius[i];
+        min_z[i] = spheres.z[i] - spheres.radius[i];
+        max_x[i] = spheres.x[i] + spheres.radius[i];
+        max_y[i] = spheres.y[i] + spheres.radius[i];
+        max_z[i] = spheres.z[i] + spheres.radius[i];
+    }
+    std::vector<uint8_t> boxes(count), inner(count);
+    const size_t rslt = Geometry::cull_aabbs(frustum, {min_x.data(), min_y.data(), min_z.data(), max_x.data(), max_y.data(), max_z.data()}, boxes.data(), count);
+    Geometry::cull_spheres(frustum, spheres.soa(), inner.data(), count);
+    size_t expected = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        // the box holds the sphere, it is culled less often
+        EXPECT_GE(boxes[i], inner[i]) << i;
+        const Geometry::AABB box{Vec3(min_x[i], min_y[i], min_z[i]), Vec3(max_x[i], max_y[i], max_z[i])};
+        EXPECT_EQ(Geometry::intersects(frustum, box), boxes[i] == 1) << i;
+        expected += boxes[i];
+    }
+    EXPECT_EQ(rslt, expected);
+}
+
+TEST_P(CullingTest, threaded)
+{
+    const Geometry::Frustum frustum = Geometry::extract_frustum(camera());
+    const size_t count = 100003;
+    const Spheres spheres = random_spheres(count, 4);
+    std::vector<uint8_t> serial(count), threaded(count);
+
+    Geometry::set_batch_threads(1);
+    const size_t serial_count = Geometry::cull_spheres(frustum, spheres.soa(), serial.data(), count);
+    Geometry::set_batch_threads(4);
+    const size_t threaded_count = Geometry::cull_spheres(frustum, spheres.soa(), threaded.data(), count);
+    EXPECT_EQ(serial, threaded);
+    EXPECT_EQ(serial_count, threaded_count);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, CullingTest,
+                         ::testing::Values(SIMD::SCALAR, SIMD::SSE2, SIMD::AVX),
+                         [](const ::testing::TestParamInfo<SIMD::Backend> &info)
+                         { return std::string(SIMD::backend_name(info.param)); });
+
+TEST(TestCulling, backends_agree)
+{
+    const SIMD::Backend previous = SIMD::get_backend();
+    const Geometry::Frustum frustum = Geometry::extract_frustum(camera());
+    const size_t count = 4099;
+    const Spheres spheres = random_spheres(count, 5);
+    std::vector<uint8_t> scalar(count), simd(count);
+
+    SIMD::set_backend(SIMD::SCALAR);
+    Geometry::cull_spheres(frustum, spheres.soa(), scalar.data(), count);
+    for (SIMD::Backend backend : {SIMD::SSE2, SIMD::AVX})
+    {
+        if (!SIMD::is_supported(backend))
+            continue;
+        SIMD::set_backend(backend);
+        Geometry::cull_spheres(frustum, spheres.soa(), simd.data(), count);
+        EXPECT_EQ(scalar, simd) << SIMD::backend_name(backend);
+    }
+    SIMD::set_backend(previous);
+}
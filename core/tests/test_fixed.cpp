@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include "fixed_matrix.h"
+#include "quaternion.h"
+#include "geometry/geometry3d.h"
+
+TEST(TestFixed, trivially_copyable)
+{
+    using namespace Core;
+    EXPECT_TRUE(std::is_trivially_copyable_v<Vec2>);
+    EXPECT_TRUE(std::is_trivially_copyable_v<Vec3>);
+    EXPECT_TRUE(std::is_trivially_copyable_v<Vec4>);
+    EXPECT_TRUE(std::is_trivially_copyable_v<Mat3>);
+    EXPECT_TRUE(std::is_trivially_copyable_v<Mat4>);
+    EXPECT_TRUE(std::is_trivially_copyable_v<Quat>);
+    EXPECT_EQ(alignof(Vec3), 16u);
+    EXPECT_EQ(alignof(Mat4), 16u);
+    EXPECT_EQ(alignof(Quat), 16u);
+}
+
+TEST(TestFixed, vector_interop)
+{
+    using namespace Core;
+    Vector3 v(1.f, 2.f, 3.f);
+    Vec3 f = v;
+    EXPECT_FLOAT_EQ(f.x(), 1.f);
+    EXPECT_FLOAT_EQ(f.y(), 2.f);
+    EXPECT_FLOAT_EQ(f.z(), 3.f);
+    Vector3 back = f * 2.f;
+    EXPECT_TRUE(back == Vector3(2.f, 4.f, 6.f));
+
+    Vec4 f4 = Vector4(1.f, 2.f, 3.f, 4.f);
+    EXPECT_TRUE(f4 == Vec4(1.f, 2.f, 3.f, 4.f));
+    EXPECT_TRUE(f4.xyz() == Vec3(1.f, 2.f, 3.f));
+}
+
+TEST(TestFixed, vector_ops)
+{
+    using namespace Core;
+    Vec3 a(1.f, 0.f, 0.f);
+    Vec3 b(0.f, 1.f, 0.f);
+    EXPECT_TRUE(Vec3::cross(a, b) == Vec3(0.f, 0.f, 1.f));
+    EXPECT_TRUE(Vec3::cross(a, b) == Vector3::cross(Vector3(a), Vector3(b)));
+    EXPECT_FLOAT_EQ(Vec3::dot(a + b, a - b), 0.f);
+    Vec3 c(3.f, 4.f, 0.f);
+    EXPECT_FLOAT_EQ(c.length(), 5.f);
+    EXPECT_FLOAT_EQ(c.normalized().length(), 1.f);
+    EXPECT_FLOAT_EQ(c.length(), 5.f);
+    c.normalize();
+    EXPECT_TRUE(c == Vec3(0.6f, 0.8f, 0.f));
+    EXPECT_TRUE(-c * 2.f == Vec3(-1.2f, -1.6f, 0.f));
+}
+
+TEST(TestFixed, matrix_product)
+{
+    using namespace Core;
+    Matrix4 a(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+    Matrix4 b(2, 0, 1, 0, 0, 3, 0, 1, 1, 0, 4, 0, 0, 1, 0, 5);
+    Mat4 fa = a;
+    Mat4 fb = b;
+    Matrix4 expected = a * b;
+    EXPECT_TRUE(Mat4(fa * fb) == Mat4(expected));
+
+    Vector4 v(1.f, -2.f, 3.f, 1.f);
+    Vector4 expected_v = a * v;
+    EXPECT_TRUE(fa * Vec4(v) == Vec4(expected_v));
+
+    EXPECT_TRUE(fa.transpose() == Mat4(a.transpose()));
+}
+
+TEST(TestFixed, matrix_inverse)
+{
+    using namespace Core;
+    Matrix4 a(4, 0, 0, 1, 0, 2, 1, 0, 1, 0, 3, 0, 0, 1, 0, 2);
+    Mat4 fa = a;
+    EXPECT_FLOAT_EQ(fa.determinant(), a.determinant());
+    EXPECT_TRUE(fa.inverse() == Mat4(Matrix4(a.inverse())));
+    EXPECT_TRUE(fa * fa.inverse() == Mat4::identity());
+
+    Matrix3 b(2, 1, 0, 1, 3, 1, 0, 1, 4);
+    Mat3 fb = b;
+    EXPECT_FLOAT_EQ(fb.determinant(), b.determinant());
+    EXPECT_TRUE(fb * fb.inverse() == Mat3::identity());
+
+    EXPECT_THROW(Mat4::zeros().inverse(), std::runtime_error);
+}
+
+TEST(TestFixed, geometry_matches_dynamic)
+{
+    using namespace Core;
+    Matrix4 m = Matrix4::identity();
+    m.translate(Vector3(1.f, 2.f, 3.f));
+    m.scale(Vector3(2.f, 2.f, 2.f));
+    Mat4 f = Mat4::identity();
+    f.translate(Vec3(1.f, 2.f, 3.f));
+    f.scale(Vec3(2.f, 2.f, 2.f));
+    EXPECT_TRUE(f == Mat4(m));
+
+    Quat q = Geometry::angle_axis(Geometry::radians(30.f), Vec3(0.f, 1.f, 0.f));
+    Vec3 p = q * Vec3(1.f, 0.f, 0.f);
+    Vec4 p4 = q.to_matrix4().transpose() * Vec4(1.f, 0.f, 0.f, 1.f);
+    EXPECT_TRUE(p == p4.xyz());
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "math/gemm.h"
+#include "math/simd.h"
+#include "matrix.h"
+
+using namespace Core::Math;
+
+namespace
+{
+    std::vector<float> random_values(size_t n, unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        std::vector<float> rslt(n);
+        for (auto &v : rslt)
+            v = dist(gen);
+        return rslt;
+    }
+
+    // C = alpha * A * B + beta * C accumulated in double
+    std::vector<float> reference(size_t m, size_t n, size_t k, float alpha, const std::vector<float> &a,
+                                 const std::vector<float> &b, float beta, std::vector<float> c)
+    {
+        for (size_t i = 0; i < m; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                double s = 0.0;
+                for (size_t p = 0; p < k; ++p)
+                    s += double(a[i * k + p]) * b[p * n + j];
+                c[i * n + j] = static_cast<float>(alpha * s + (beta == 0.f ? 0.0 : double(beta) * c[i * n + j]));
+            }
+        }
+        return c;
+    }
+
+    float max_error(const std::vector<float> &a, const std::vector<float> &b)
+    {
+        float rslt = 0.f;
+        for (size_t i = 0; i < a.size(); ++i)
+            rslt = std::fmax(rslt, std::fabs(a[i] - b[i]));
+        return rslt;
+    }
+
+    class GEMMTest : public ::testing::TestWithParam<SIMD::Backend>
+    {
+    protected:
+        void SetUp() override
+        {
+            if (!SIMD::is_supported(GetParam()))
+                GTEST_SKIP() << SIMD::backend_name(GetParam()) << " is not supported on this CPU";
+            previous = SIMD::get_backend();
+            SIMD::set_backend(GetParam());
+        }
+        void TearDown() override
+        {
+            SIMD::set_backend(previous);
+            set_gemm_threads(0);
+        }
+
+        SIMD::Backend previous = SIMD::SCALAR;
+    };
+}
+
+TEST_P(GEMMTest, shapes)
+{
+    // edge tiles, several k slices and several row blocks
+    const size_t shapes[][3] = {{1, 1, 1}, {7, 13, 5}, {6, 16, 256}, {130, 70, 300}, {241, 33, 517}};
+    for (auto &shape : shapes)
+    {
+        const size_t m = shape[0], n = shape[1], k = shape[2];
+        auto a = random_values(m * k, 1);
+        auto b = random_values(k * n, 2);
+        std::vector<float> c(m * n, NAN);
+
+        gemm(m, n, k, 1.f, a.data(), k, b.data(), n, 0.f, c.data(), n);
+        EXPECT_LT(max_error(c, reference(m, n, k, 1.f, a, b, 0.f, c)), 1e-4f * k) << m << "x" << n << "x" << k;
+    }
+}
+
+TEST_P(GEMMTest, alpha_beta)
+{
+    const size_t m = 50, n = 40, k = 300;
+    auto a = random_values(m * k, 3);
+    auto b = random_values(k * n, 4);
+    auto c = random_values(m * n, 5);
+
+    auto expected = reference(m, n, k, -0.5f, a, b, 2.f, c);
+    gemm(m, n, k, -0.5f, a.data(), k, b.data(), n, 2.f, c.data(), n);
+    EXPECT_LT(max_error(c, expected), 1e-3f);
+
+    // k == 0 only scales C
+    auto before = c;
+    gemm(m, n, 0, 1.f, a.data(), k, b.data(), n, 0.5f, c.data(), n);
+    for (size_t i = 0; i < c.size(); ++i)
+        EXPECT_EQ(c[i], before[i] * 0.5f);
+}
+
+TEST_P(GEMMTest, strided_and_threaded)
+{
+    // operate on the inner 300 x 230 block of a 310 x 240 C, big enough for two threads
+    const size_t m = 300, n = 230, k = 256, ldc = 240;
+    auto a = random_values(m * k, 6);
+    auto b = random_values(k * n, 7);
+    std::vector<float> c(310 * ldc, 3.f);
+
+    set_gemm_threads(4);
+    gemm(m, n, k, 1.f, a.data(), k, b.data(), n, 0.f, c.data() + 5 * ldc + 5, ldc);
+
+    auto expected = reference(m, n, k, 1.f, a, b, 0.f, std::vector<float>(m * n));
+    for (size_t i = 0; i < 310; ++i)
+    {
+        for (size_t j = 0; j < ldc; ++j)
+        {
+            const float v = c[i * ldc + j];
+            if (i >= 5 && i < 5 + m && j >= 5 && j < 5 + n)
+                EXPECT_NEAR(v, expected[(i - 5) * n + j - 5], 1e-3f);
+            else
+                EXPECT_EQ(v, 3.f);
+        }
+    }
+}
+
+TEST_P(GEMMTest, matrix_product)
+{
+    const size_t m = 70, n = 90, k = 80;
+    static_assert(70 * 90 * 80 >= GEMM_THRESHOLD, "the product must take the gemm path");
+    auto a = random_values(m * k, 8);
+    auto b = random_values(k * n, 9);
+    Core::Matrix ma(a.data(), m, k, true);
+    Core::Matrix mb(b.data(), k, n, true);
+
+    Core::Matrix mc = ma * mb;
+    ASSERT_EQ(mc.rows(), m);
+    ASSERT_EQ(mc.cols(), n);
+    std::vector<float> c(mc.data(), mc.data() + mc.size());
+    EXPECT_LT(max_error(c, reference(m, n, k, 1.f, a, b, 0.f, c)), 1e-4f);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, GEMMTest,
+                         ::testing::Values(SIMD::SCALAR, SIMD::AVX, SIMD::FMA),
+                         [](const ::testing::TestParamInfo<SIMD::Backend> &info)
+                         { return std::string(SIMD::backend_name(info.param)); });
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "jobs.h"
+
+using namespace Core;
+
+namespace
+{
+    // runs every test on a pool of a known size, restores the default afterwards
+    class JobsTest : public ::testing::TestWithParam<size_t>
+    {
+    protected:
+        void SetUp() override { Jobs::init(GetParam()); }
+        void TearDown() override { Jobs::init(); }
+    };
+
+    // a pool without workers, queued jobs stay queued until someone helps
+    class JobsSerialTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override { Jobs::init(1); }
+        void TearDown() override { Jobs::init(); }
+    };
+}
+
+TEST_P(JobsTest, run_and_wait)
+{
+    EXPECT_EQ(Jobs::get_worker_count(), GetParam() - 1);
+    std::atomic<int> sum{0};
+    Jobs::Counter counter;
+    for (int i = 1; i <= 100; ++i)
+        Jobs::run([&sum, i]
+                  { sum += i; },
+                  &counter);
+    Jobs::wait(counter);
+    EXPECT_TRUE(counter.done());
+    EXPECT_EQ(sum, 5050);
+}
+
+TEST_P(JobsTest, dependencies)
+{
+    // a chain a -> b -> c plus a fan-in of many jobs into d
+    std::vector<int> order;
+    std::mutex mutex;
+    auto log = [&](int id)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(id);
+    };
+    Jobs::Counter a, b, c, fan, done;
+    Jobs::run([&]
+              { log(0); },
+              &a);
+    Jobs::run_after(a, [&]
+                    { log(1); },
+                    &b);
+    Jobs::run_after(b, [&]
+                    { log(2); },
+                    &c);
+    std::atomic<int> fanned{0};
+    for (int i = 0; i < 50; ++i)
+        Jobs::run([&]
+                  { ++fanned; },
+                  &fan);
+    int seen = -1;
+    Jobs::run_after(fan, [&]
+                    { seen = fanned; },
+                    &done);
+    Jobs::wait(c);
+    Jobs::wait(done);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(seen, 50);
+
+    // a finished dependency runs the job right away
+    Jobs::Counter after;
+    bool ran = false;
+    Jobs::run_after(a, [&]
+                    { ran = true; },
+                    &after);
+    Jobs::wait(after);
+    EXPECT_TRUE(ran);
+}
+
+TEST_P(JobsTest, parallel_for_covers_range)
+{
+    for (size_t grain : {size_t(0), size_t(1), size_t(7), size_t(1000), size_t(5000)})
+    {
+        std::vector<std::atomic<int>> hits(3001);
+        Jobs::parallel_for(5, hits.size(), grain, [&](size_t begin, size_t end)
+                           {
+            if (grain)
+            {
+                EXPECT_TRUE((begin - 5) % grain == 0);
+            }
+            for (size_t i = begin; i < end; ++i)
+                ++hits[i]; });
+        for (size_t i = 0; i < hits.size(); ++i)
+            ASSERT_EQ(hits[i], i < 5 ? 0 : 1) << "grain " << grain << ", index " << i;
+    }
+}
+
+TEST_P(JobsTest, nested_parallel_for)
+{
+    std::vector<long> sums(64, 0);
+    Jobs::parallel_for(0, sums.size(), 1, [&](size_t begin, size_t end)
+                       {
+        for (size_t i = begin; i < end; ++i)
+        {
+            std::atomic<long> sum{0};
+            Jobs::parallel_for(0, 1000, 10, [&](size_t b, size_t e)
+                               {
+                long s = 0;
+                for (size_t j = b; j < e; ++j)
+                    s += long(j);
+                sum += s; });
+            sums[i] = sum;
+        } });
+    for (auto s : sums)
+        EXPECT_EQ(s, 999 * 1000 / 2);
+}
+
+TEST_P(JobsTest, parallel_for_forwards_exceptions)
+{
+    EXPECT_THROW(Jobs::parallel_for(0, 100, 1, [](size_t begin, size_t)
+                                    {
+        if (begin == 42)
+            throw std::runtime_error("42"); }),
+                 std::runtime_error);
+}
+
+// a Counter on the stack dies right after wait(), while the job that
+// finished it may still be on its way out; meant to run under TSan
+TEST_P(JobsTest, short_lived_counters)
+{
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::atomic<int> sum{0};
+        Jobs::parallel_for(0, 64, 1, [&](size_t begin, size_t end)
+                           { sum += int(end - begin); });
+        ASSERT_EQ(sum, 64);
+    }
+    for (int i = 0; i < 2000; ++i)
+    {
+        Jobs::Counter counter;
+        Jobs::Counter after;
+        Jobs::run([] {}, &counter);
+        Jobs::run_after(counter, [] {}, &after);
+        Jobs::wait(counter);
+        Jobs::wait(after);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Threads, JobsTest, ::testing::Values(1, 2, 4),
+                         [](const ::testing::TestParamInfo<size_t> &info)
+                         { return std::to_string(info.param); });
+
+TEST_F(JobsSerialTest, help_from_outside)
+{
+    EXPECT_EQ(Jobs::get_worker_index(), Jobs::NONE);
+    bool ran = false;
+    Jobs::run([&]
+              { ran = true; });
+    EXPECT_FALSE(ran);
+    EXPECT_TRUE(Jobs::help());
+    EXPECT_TRUE(ran);
+    EXPECT_FALSE(Jobs::help());
+}
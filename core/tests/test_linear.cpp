@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "math/linear.h"
+#include "vector.h"
+
+using namespace Core;
+
+namespace
+{
+    Matrix random_matrix(size_t rows, size_t cols, unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        Matrix rslt(rows, cols);
+        for (size_t i = 0; i < rslt.size(); ++i)
+            rslt.data()[i] = dist(gen);
+        return rslt;
+    }
+
+    // symmetric positive definite: A^T * A + n * I
+    MatrixS random_spd(size_t n, unsigned seed)
+    {
+        Matrix a = random_matrix(n, n, seed);
+        MatrixS rslt = a.transpose() * a;
+        for (size_t i = 0; i < n; ++i)
+            rslt(i, i) += static_cast<float>(n);
+        return rslt;
+    }
+
+    float max_diff(const Matrix &a, const Matrix &b)
+    {
+        EXPECT_EQ(a.shape(), b.shape());
+        float rslt = 0.f;
+        for (size_t i = 0; i < a.size(); ++i)
+            rslt = std::fmax(rslt, std::fabs(a.data()[i] - b.data()[i]));
+        return rslt;
+    }
+}
+
+TEST(TestLinear, lu_factors)
+{
+    Matrix a = random_matrix(150, 150, 1);
+    Math::LU lu(a);
+    ASSERT_FALSE(lu.is_singular());
+
+    std::vector<size_t> order = lu.pivot_order();
+    Matrix pa(150, 150);
+    for (size_t i = 0; i < 150; ++i)
+    {
+        for (size_t j = 0; j < 150; ++j)
+            pa(i, j) = a(order[i], j);
+    }
+    EXPECT_LT(max_diff(lu.lower() * lu.upper(), pa), 1e-4f);
+}
+
+TEST(TestLinear, lu_solve)
+{
+    // crosses several BLOCK_SIZE panels
+    const size_t n = 200;
+    Matrix a = random_matrix(n, n, 2);
+    Vector x = random_matrix(n, 1, 3);
+    Vector b = a * x;
+
+    Vector solved = Math::solve(a, b);
+    EXPECT_LT(max_diff(a * solved, b), 1e-3f);
+
+    Matrix rhs = random_matrix(n, 5, 4);
+    EXPECT_LT(max_diff(a * Math::LU(a).solve(rhs), rhs), 1e-3f);
+}
+
+TEST(TestLinear, determinant)
+{
+    float v[9] = {2, -3, 1, 2, 0, -1, 1, 4, 5};
+    MatrixS m(v, 3, true);
+    EXPECT_NEAR(m.determinant(), 49.f, 1e-4f);
+    EXPECT_NEAR(Math::determinant(m), 49.f, 1e-4f);
+
+    // a row swap flips the sign
+    m.swap_rows(0, 2);
+    EXPECT_NEAR(m.determinant(), -49.f, 1e-4f);
+
+    EXPECT_NEAR(MatrixS::identity(300).determinant(), 1.f, 1e-6f);
+    EXPECT_FLOAT_EQ(MatrixS(4).determinant(), 0.f);
+}
+
+TEST(TestLinear, inverse)
+{
+    const size_t n = 100;
+    MatrixS a = random_matrix(n, n, 5);
+    MatrixS inv = a.inverse();
+    EXPECT_LT(max_diff(a * inv, MatrixS::identity(n)), 1e-3f);
+    EXPECT_LT(max_diff(Math::inverse(a), inv), 1e-6f);
+
+    float v[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    MatrixS singular(v, 3, true);
+    EXPECT_TRUE(Math::LU(singular).is_singular());
+    EXPECT_THROW(singular.inverse(), std::runtime_error);
+    EXPECT_THROW(Math::solve(singular, Vector::ones(3)), std::runtime_error);
+    EXPECT_THROW(Math::LU(Matrix(2, 3)), std::runtime_error);
+}
+
+TEST(TestLinear, qr)
+{
+    Matrix a = random_matrix(180, 130, 6);
+    Math::QR qr(a);
+    ASSERT_TRUE(qr.is_full_rank());
+
+    Matrix q = qr.q();
+    Matrix r = qr.r();
+    EXPECT_LT(max_diff(q * r, a), 1e-4f);
+    EXPECT_LT(max_diff(q.transpose() * q, MatrixS::identity(130)), 1e-4f);
+    for (size_t i = 0; i < r.rows(); ++i)
+    {
+        for (size_t j = 0; j < i; ++j)
+            EXPECT_EQ(r(i, j), 0.f);
+    }
+}
+
+TEST(TestLinear, qr_least_squares)
+{
+    // fit y = 2x + 1 through noisy-free samples, overdetermined
+    Matrix a(6, 2);
+    Vector y(6);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        a(i, 0) = static_cast<float>(i);
+        a(i, 1) = 1.f;
+        y[i] = 2.f * i + 1.f;
+    }
+    Vector x = Math::solve(a, y);
+    ASSERT_EQ(x.rows(), 2u);
+    EXPECT_NEAR(x[0], 2.f, 1e-5f);
+    EXPECT_NEAR(x[1], 1.f, 1e-5f);
+
+    // normal equations give the same answer on a random problem
+    Matrix b = random_matrix(120, 70, 7);
+    Vector c = random_matrix(120, 1, 8);
+    Matrix bt = b.transpose();
+    EXPECT_LT(max_diff(Math::QR(b).solve(c), Math::Cholesky(bt * b).solve(bt * c)), 1e-3f);
+
+    EXPECT_THROW(Math::QR(Matrix(2, 3)), std::runtime_error);
+    EXPECT_FALSE(Math::QR(Matrix(4, 2)).is_full_rank());
+}
+
+TEST(TestLinear, cholesky)
+{
+    const size_t n = 160;
+    MatrixS a = random_spd(n, 9);
+    Math::Cholesky chol(a);
+    ASSERT_TRUE(chol.is_positive_definite());
+
+    const Matrix &l = chol.lower();
+    EXPECT_LT(max_diff(l * l.transpose(), a), 1e-3f);
+
+    Matrix rhs = random_matrix(n, 3, 10);
+    EXPECT_LT(max_diff(a * chol.solve(rhs), rhs), 1e-3f);
+    EXPECT_LT(max_diff(chol.inverse(), a.inverse()), 1e-5f);
+
+    float v[4] = {1, 2, 2, 1};
+    EXPECT_FALSE(Math::Cholesky(MatrixS(v, 2, true)).is_positive_definite());
+}
+
+TEST(TestLinear, triangular)
+{
+    float l[9] = {2, 0, 0, 1, 3, 0, -1, 2, 4};
+    Matrix lower(l, 3, 3, true);
+    Vector b(3);
+    b[0] = 2.f;
+    b[1] = 7.f;
+    b[2] = 9.f;
+
+    Vector x = Math::solve_lower(lower, b);
+    EXPECT_LT(max_diff(lower * x, b), 1e-6f);
+
+    Matrix upper = lower.transpose();
+    x = Math::solve_upper(upper, b);
+    EXPECT_LT(max_diff(upper * x, b), 1e-6f);
+
+    // unit diagonal ignores the stored diagonal
+    x = Math::solve_lower(lower, b, true);
+    EXPECT_FLOAT_EQ(x[0], 2.f);
+    EXPECT_FLOAT_EQ(x[1], 5.f);
+    EXPECT_FLOAT_EQ(x[2], 1.f);
+
+    EXPECT_THROW(Math::solve_lower(lower, Vector(2)), std::runtime_error);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "logger.h"
+
+using namespace Core;
+
+namespace
+{
+    std::vector<Logger::Line> read_all(const Logger &logger)
+    {
+        std::vector<Logger::Line> rslt;
+        logger.read_history(0, logger.history_size(), rslt);
+        return rslt;
+    }
+
+    // the text after the "[LEVEL] [T<n>] " prefix
+    std::string message(const std::string &line)
+    {
+        const size_t at = line.find("] [T");
+        return line.substr(line.find("] ", at + 1) + 2);
+    }
+}
+
+TEST(TestLogger, format_and_order)
+{
+    Logger logger;
+    logger.log(Logger::LEVEL_INFO, "first");
+    logger.log(Logger::LEVEL_ERROR, std::string("second"));
+    logger.flush();
+    auto lines = read_all(logger);
+    ASSERT_EQ(lines.size(), 2);
+    EXPECT_EQ(lines[0].level, Logger::LEVEL_INFO);
+    EXPECT_NE(lines[0].text.find("[INFO]"), std::string::npos);
+    EXPECT_EQ(message(lines[0].text), "first");
+    EXPECT_NE(lines[1].text.find("[ERROR]"), std::string::npos);
+    EXPECT_EQ(message(lines[1].text), "second");
+
+    // long messages are cut to the entry size
+    logger.log(Logger::LEVEL_WARN, std::string(1000, 'x'));
+    logger.flush();
+    lines.clear();
+    ASSERT_EQ(logger.read_history(2, 10, lines), 1);
+    const std::string text = message(lines[0].text);
+    EXPECT_EQ(text.size(), Logger::TEXT_SIZE);
+    EXPECT_EQ(text.substr(text.size() - 3), "...");
+}
+
+TEST(TestLogger, concurrent_producers)
+{
+    Logger logger(1 << 16);
+    const int threads = 4, per_thread = 5000;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back([&, t]
+                          {
+            for (int i = 0; i < per_thread; ++i)
+                logger.log(Logger::LEVEL_DEBUG, std::to_string(t) + " " + std::to_string(i)); });
+    for (auto &thread : pool)
+        thread.join();
+    logger.flush();
+    EXPECT_EQ(logger.get_dropped(), 0);
+    const auto lines = read_all(logger);
+    ASSERT_EQ(lines.size(), size_t(threads * per_thread));
+    // every producer's messages arrive complete and in its own order
+    std::vector<int> next(threads, 0);
+    for (const auto &line : lines)
+    {
+        const std::string text = message(line.text);
+        const int t = std::stoi(text);
+        const int i = std::stoi(text.substr(text.find(' ') + 1));
+        ASSERT_EQ(i, next[t]++);
+    }
+}
+
+TEST(TestLogger, full_ring_drops)
+{
+    Logger logger(2);
+    size_t accepted = 0;
+    const size_t count = 20000;
+    for (size_t i = 0; i < count; ++i)
+        accepted += logger.log(Logger::LEVEL_INFO, "spam") ? 1 : 0;
+    logger.flush();
+    EXPECT_EQ(accepted + logger.get_dropped(), count);
+    // the ring is empty again, the drain that takes this one reports every drop before it
+    ASSERT_TRUE(logger.log(Logger::LEVEL_INFO, "end"));
+    logger.flush();
+    const auto lines = read_all(logger);
+    // the consumer reports the drops in the log itself, maybe over several lines
+    size_t spam = 0;
+    size_t reported = 0;
+    for (const auto &line : lines)
+    {
+        const std::string text = message(line.text);
+        spam += text == "spam" ? 1 : 0;
+        if (text.find("dropped") != std::string::npos)
+            reported += std::stoul(text.substr(text.find(": ") + 2));
+    }
+    EXPECT_EQ(spam, accepted);
+    EXPECT_EQ(reported, logger.get_dropped());
+}
+
+TEST(TestLogger, history_capacity)
+{
+    Logger logger(64, 10);
+    for (int i = 0; i < 25; ++i)
+    {
+        logger.log(Logger::LEVEL_INFO, std::to_string(i));
+        logger.flush();
+    }
+    auto lines = read_all(logger);
+    ASSERT_EQ(lines.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        EXPECT_EQ(message(lines[i].text), std::to_string(15 + i));
+
+    logger.set_history_capacity(4);
+    lines = read_all(logger);
+    ASSERT_EQ(lines.size(), 4);
+    EXPECT_EQ(message(lines[0].text), "21");
+    EXPECT_EQ(message(lines[3].text), "24");
+
+    logger.clear_history();
+    EXPECT_EQ(logger.history_size(), 0);
+}
+
+TEST(TestLogger, rotating_file)
+{
+    const std::string path = testing::TempDir() + "test_logger.log";
+    for (const std::string suffix : {"", ".1", ".2"})
+        std::remove((path + suffix).c_str());
+    Logger logger;
+    logger.open_file(path, 1000, 3);
+    EXPECT_TRUE(logger.has_file());
+    for (int i = 0; i < 100; ++i)
+        logger.log(Logger::LEVEL_INFO, "line " + std::to_string(i));
+    logger.close_file();
+    EXPECT_FALSE(logger.has_file());
+
+    // newest lines in the file itself, older ones shifted to .1 and .2, the rest removed
+    std::vector<std::string> kept;
+    for (const std::string suffix : {".2", ".1", ""})
+    {
+        std::ifstream file(path + suffix, std::ios::binary | std::ios::ate);
+        ASSERT_TRUE(file.is_open()) << suffix;
+        EXPECT_LE(size_t(file.tellg()), 1000) << suffix;
+        file.seekg(0);
+        std::string line;
+        while (std::getline(file, line))
+            kept.push_back(message(line));
+    }
+    ASSERT_FALSE(kept.empty());
+    EXPECT_EQ(kept.back(), "line 99");
+    const int first = std::stoi(kept.front().substr(5));
+    for (size_t i = 0; i < kept.size(); ++i)
+        EXPECT_EQ(kept[i], "line " + std::to_string(first + int(i)));
+    std::ifstream old(path + ".3");
+    EXPECT_FALSE(old.is_open());
+    for (const std::string suffix : {"", ".1", ".2"})
+        std::remove((path + suffix).c_str());
+
+    EXPECT_THROW(logger.open_file(testing::TempDir() + "missing_dir/x/test.log"), std::runtime_error);
+}
@@ -6,6 +6,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "vector.h"
 #include "geometry/geometry3d.h"
+#include "math/simd.h"
 
 namespace Core
 {
@@ -456,8 +457,24 @@ namespace Core
         EXPECT_FLOAT_EQ(v2[3], 1);
     }
 
+    // the Matrix4 cases run on the SIMD kernels, repeat them for every backend
+    class TestMatrix4Backend : public ::testing::TestWithParam<Math::SIMD::Backend>
+    {
+    protected:
+        void SetUp() override
+        {
+            if (!Math::SIMD::is_supported(GetParam()))
+                GTEST_SKIP() << Math::SIMD::backend_name(GetParam()) << " is not supported on this CPU";
+            previous = Math::SIMD::get_backend();
+            Math::SIMD::set_backend(GetParam());
+        }
+        void TearDown() override { Math::SIMD::set_backend(previous); }
+
+        Math::SIMD::Backend previous = Math::SIMD::SCALAR;
+    };
+
     // test inverse
-    TEST(TestMatrix, inverse)
+    TEST_P(TestMatrix4Backend, inverse)
     {
         Matrix4 m1 = {
             1, 2, 3, 4,
@@ -484,7 +501,7 @@ namespace Core
     }
 
     // test transpose
-    TEST(TestMatrix, transpose)
+    TEST_P(TestMatrix4Backend, transpose)
     {
         float v[16] = {
             1, 2, 3, 4,
@@ -507,7 +524,7 @@ namespace Core
         EXPECT_TRUE(Expect_Matrix_Equal(mt, glmt));
     }
 
-    TEST(TestMatrix, normal_matrix)
+    TEST_P(TestMatrix4Backend, normal_matrix)
     {
         auto m1 = Matrix4::identity();
         m1 = Core::Geometry::translate(m1, {1, 2, 3});
@@ -521,6 +538,15 @@ namespace Core
         glm_m1 = glm::rotate(glm_m1, glm::radians(45.0f), glm::vec3(1, 0, 0));
         glm_m1 = glm::scale(glm_m1, glm::vec3(1, 2, 3));
 
+        // Geometry composes with Matrix4 products, Matrix(i, j) is glm m[i][j]
+        EXPECT_TRUE(Expect_Matrix_Equal(m1, glm_m1));
+        Vec4 v = m1.transpose() * Vec4(1.0f, 2.0f, 3.0f, 1.0f);
+        glm::vec4 glm_v = glm_m1 * glm::vec4(1.0f, 2.0f, 3.0f, 1.0f);
+        EXPECT_TRUE(Math::equal(v.x(), glm_v.x));
+        EXPECT_TRUE(Math::equal(v.y(), glm_v.y));
+        EXPECT_TRUE(Math::equal(v.z(), glm_v.z));
+        EXPECT_TRUE(Math::equal(v.w(), glm_v.w));
+
         glm::mat3 glm_normal_mat = glm::transpose(glm::inverse(glm_m1));
 
         std::cout << "NORMAL: " << std::endl
@@ -529,6 +555,8 @@ namespace Core
                   << glm_normal_mat << std::endl;
 
         EXPECT_TRUE(Expect_Matrix_Equal(normal_mat, glm_normal_mat));
+        EXPECT_TRUE(Expect_Matrix_Equal(m1.inverse_affine(), glm::inverse(glm_m1)));
+        EXPECT_TRUE(Expect_Matrix_Equal(Matrix4(Mat4(m1).inverse_affine()), glm::inverse(glm_m1)));
     }
 
     TEST(TestMatrix, construction)
@@ -554,4 +582,9 @@ namespace Core
                   << m << std::endl;
     }
 
+    INSTANTIATE_TEST_SUITE_P(Backends, TestMatrix4Backend,
+                             ::testing::Values(Math::SIMD::SCALAR, Math::SIMD::SSE2, Math::SIMD::AVX, Math::SIMD::FMA),
+                             [](const ::testing::TestParamInfo<Math::SIMD::Backend> &info)
+                             { return std::string(Math::SIMD::backend_name(info.param)); });
+
 } // namespace Core
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "matrix.h"
+#include "vector.h"
+
+using namespace Core;
+
+namespace
+{
+    Matrix sequence(size_t rows, size_t cols, float start)
+    {
+        Matrix rslt(rows, cols);
+        for (size_t i = 0; i < rslt.size(); ++i)
+            rslt.data()[i] = start + static_cast<float>(i);
+        return rslt;
+    }
+}
+
+TEST(TestMatrixExpr, fused_elementwise)
+{
+    Matrix a = sequence(3, 5, 1.f);
+    Matrix b = sequence(3, 5, -4.f);
+    Matrix c = sequence(3, 5, 0.5f);
+
+    Matrix r = a * 2.f + b - c;
+    ASSERT_EQ(r.shape(), a.shape());
+    for (size_t i = 0; i < r.size(); ++i)
+        EXPECT_FLOAT_EQ(r.data()[i], a.data()[i] * 2.f + b.data()[i] - c.data()[i]);
+
+    Matrix n = -(a - b) * 0.5f;
+    for (size_t i = 0; i < n.size(); ++i)
+        EXPECT_FLOAT_EQ(n.data()[i], -(a.data()[i] - b.data()[i]) * 0.5f);
+
+    EXPECT_TRUE(2.f * a == a + a);
+    EXPECT_TRUE(a == (a * 3.f - a) * 0.5f);
+}
+
+TEST(TestMatrixExpr, assign_in_place)
+{
+    Matrix a = sequence(4, 4, 1.f);
+    Matrix b = sequence(4, 4, 2.f);
+    Matrix c = sequence(4, 4, 3.f);
+
+    // same shape: the destination buffer is reused
+    const float *buffer = c.data();
+    c = a * 2.f + b - c;
+    EXPECT_EQ(c.data(), buffer);
+    EXPECT_FLOAT_EQ(c(1, 2), (1.f + 6.f) * 2.f + (2.f + 6.f) - (3.f + 6.f));
+
+    a += b * 2.f;
+    EXPECT_FLOAT_EQ(a(0, 0), 1.f + 2.f * 2.f);
+    a -= b;
+    EXPECT_FLOAT_EQ(a(0, 0), 1.f + 2.f);
+    a *= 2.f;
+    EXPECT_FLOAT_EQ(a(0, 0), 6.f);
+
+    // a different shape reallocates
+    Matrix d = sequence(2, 2, 0.f);
+    d = a + b;
+    EXPECT_EQ(d.shape(), a.shape());
+}
+
+TEST(TestMatrixExpr, transpose)
+{
+    Matrix a = sequence(2, 3, 1.f);
+    Matrix t = a.transpose();
+    ASSERT_EQ(t.rows(), 3u);
+    ASSERT_EQ(t.cols(), 2u);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_EQ(t(j, i), a(i, j));
+    }
+
+    // reading the transposed destination must not see overwritten values
+    Matrix s = sequence(3, 3, 1.f);
+    Matrix expected = Matrix(s.transpose()) + s;
+    s = s.transpose() + s;
+    EXPECT_TRUE(s == expected);
+
+    a = a.transpose();
+    EXPECT_TRUE(a == t);
+
+    // products evaluate the expression first
+    Matrix p = a.transpose() * a;
+    EXPECT_TRUE(p == Matrix(t.transpose()) * t);
+    Matrix q = a * transpose(a);
+    EXPECT_TRUE(q == a * Matrix(t.transpose()));
+}
+
+TEST(TestMatrixExpr, subclasses)
+{
+    Vector3 x(1.f, 2.f, 3.f);
+    Vector3 y(4.f, 5.f, 6.f);
+    Vector3 z = x + y * 2.f;
+    EXPECT_TRUE(z == Vector3(9.f, 12.f, 15.f));
+    z = -z;
+    EXPECT_TRUE(z == Vector3(-9.f, -12.f, -15.f));
+    EXPECT_FLOAT_EQ(Vector::dot(x - y, x - y), 27.f);
+
+    Matrix4 m = Matrix4::identity() * 2.f;
+    EXPECT_TRUE(m == Matrix4(2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2));
+
+    // like the Matrix conversion, other shapes are zero padded
+    Matrix4 padded = Matrix3::identity() + Matrix3::identity();
+    EXPECT_FLOAT_EQ(padded(2, 2), 2.f);
+    EXPECT_FLOAT_EQ(padded(3, 3), 0.f);
+
+    std::stringstream expr_out, matrix_out;
+    expr_out << x + y;
+    matrix_out << Matrix(x + y);
+    EXPECT_EQ(expr_out.str(), matrix_out.str());
+}
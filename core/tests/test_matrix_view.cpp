@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "matrix.h"
+
+using namespace Core;
+
+namespace
+{
+    Matrix sequence(size_t rows, size_t cols, float start)
+    {
+        Matrix rslt(rows, cols);
+        for (size_t i = 0; i < rslt.size(); ++i)
+            rslt.data()[i] = start + static_cast<float>(i);
+        return rslt;
+    }
+}
+
+TEST(TestMatrixView, block_row_col)
+{
+    const Matrix m = sequence(4, 5, 0.f);
+
+    ConstMatrixView b = m.block(1, 2, 2, 3);
+    ASSERT_EQ(b.rows(), 2u);
+    ASSERT_EQ(b.cols(), 3u);
+    EXPECT_EQ(b.data(), m.data() + 7);
+    EXPECT_FALSE(b.is_contiguous());
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_EQ(b(i, j), m(1 + i, 2 + j));
+
+    ConstMatrixView r = m.row(2);
+    EXPECT_TRUE(r.is_contiguous());
+    for (size_t j = 0; j < 5; ++j)
+        EXPECT_EQ(r(0, j), m(2, j));
+
+    ConstMatrixView c = m.col(3);
+    ASSERT_EQ(c.rows(), 4u);
+    for (size_t i = 0; i < 4; ++i)
+        EXPECT_EQ(c(i, 0), m(i, 3));
+
+    // a block of a block is still a window into m
+    EXPECT_EQ(b.block(1, 1, 1, 2)(0, 1), m(2, 4));
+    EXPECT_THROW(m.block(3, 0, 2, 1), std::runtime_error);
+    EXPECT_THROW(b.col(3), std::runtime_error);
+}
+
+TEST(TestMatrixView, transpose)
+{
+    const Matrix m = sequence(2, 3, 1.f);
+    ConstMatrixView t = m.view().transpose();
+    ASSERT_EQ(t.rows(), 3u);
+    ASSERT_EQ(t.cols(), 2u);
+    EXPECT_EQ(t.data(), m.data());
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 2; ++j)
+            EXPECT_EQ(t(i, j), m(j, i));
+
+    Matrix copy = t;
+    EXPECT_TRUE(copy == m.transpose());
+}
+
+TEST(TestMatrixView, write_through)
+{
+    Matrix m(4, 4);
+    m.block(1, 1, 2, 2).fill(7.f);
+    m.col(0) = sequence(4, 1, 1.f);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(m(i, 0), i + 1.f);
+        for (size_t j = 1; j < 4; ++j)
+            EXPECT_EQ(m(i, j), (i == 1 || i == 2) && (j == 1 || j == 2) ? 7.f : 0.f);
+    }
+
+    MatrixView b = m.block(1, 0, 3, 2);
+    b.swap_rows(0, 2);
+    EXPECT_EQ(m(1, 0), 4.f);
+    EXPECT_EQ(m(3, 0), 2.f);
+    EXPECT_EQ(m(3, 1), 7.f);
+    b.scale_row(0, 0.5f);
+    EXPECT_EQ(m(1, 0), 2.f);
+    b.add_row(1, 0, 2.f);
+    EXPECT_EQ(m(2, 0), 3.f + 4.f);
+
+    // copying a view shares the elements
+    MatrixView alias = b;
+    alias(0, 1) = -1.f;
+    EXPECT_EQ(m(1, 1), -1.f);
+
+    EXPECT_THROW(m.row(0) = Matrix(2, 4), std::runtime_error);
+}
+
+TEST(TestMatrixView, arithmetic)
+{
+    Matrix a = sequence(4, 6, 0.f);
+    Matrix b = sequence(2, 3, 10.f);
+
+    Matrix sum = a.block(2, 3, 2, 3) + b * 2.f;
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_FLOAT_EQ(sum(i, j), a(2 + i, 3 + j) + 2.f * b(i, j));
+
+    a.block(0, 0, 2, 3) += b;
+    a.block(0, 0, 2, 3) -= a.block(2, 0, 2, 3);
+    a.row(3) *= 2.f;
+    EXPECT_FLOAT_EQ(a(0, 0), 0.f + 10.f - 12.f);
+    EXPECT_FLOAT_EQ(a(1, 2), 8.f + 15.f - 20.f);
+    EXPECT_FLOAT_EQ(a(3, 5), 46.f);
+
+    // products take views on either side
+    Matrix p = a.block(0, 0, 2, 3) * b.view().transpose();
+    Matrix q = Matrix(a.block(0, 0, 2, 3)) * Matrix(b.transpose());
+    EXPECT_TRUE(p == q);
+}
+
+TEST(TestMatrixView, overlapping_assignment)
+{
+    // a transpose in place and a shifted copy both overlap their destination
+    Matrix m = sequence(3, 3, 0.f);
+    Matrix expected = m.transpose();
+    m.view() = m.view().transpose();
+    EXPECT_TRUE(m == expected);
+
+    Matrix s = sequence(1, 5, 0.f);
+    s.block(0, 1, 1, 4) = s.block(0, 0, 1, 4);
+    for (size_t j = 1; j < 5; ++j)
+        EXPECT_EQ(s(0, j), j - 1.f);
+
+    Matrix r = sequence(3, 3, 0.f);
+    r = r.block(1, 1, 2, 2);
+    ASSERT_EQ(r.shape(), std::make_pair(size_t(2), size_t(2)));
+    EXPECT_EQ(r(0, 0), 4.f);
+    EXPECT_EQ(r(1, 1), 8.f);
+}
+
+TEST(TestMatrixView, foreign_storage)
+{
+    float buffer[12] = {};
+    MatrixView v(buffer, 3, 2, 4, 2);
+    v.fill(1.f);
+    for (size_t i = 0; i < 12; ++i)
+        EXPECT_EQ(buffer[i], i % 2 == 0 ? 1.f : 0.f);
+}
+
+TEST(TestMatrixView, products)
+{
+    // below and above the gemm threshold, with dense, strided and transposed views
+    for (size_t size : {5, 70})
+    {
+        const Matrix a = sequence(size + 3, size + 2, 0.f) * (1.f / (size * size));
+        const Matrix b = sequence(size + 2, size + 4, 1.f) * (1.f / (size * size));
+        const ConstMatrixView lhs = a.block(1, 0, size, size + 1);
+        const ConstMatrixView rhs = b.block(0, 2, size + 1, size);
+        const Matrix expected = Matrix(lhs) * Matrix(rhs);
+
+        EXPECT_TRUE(lhs * rhs == expected) << size;
+        EXPECT_TRUE(lhs * Matrix(rhs) == expected) << size;
+        EXPECT_TRUE(Matrix(lhs) * rhs == expected) << size;
+        const Matrix rhs_t = Matrix(rhs.transpose());
+        EXPECT_TRUE(lhs * rhs_t.view().transpose() == expected) << size;
+        EXPECT_TRUE((rhs.transpose() * lhs.transpose()).transpose() == expected) << size;
+    }
+    EXPECT_THROW(sequence(2, 3, 0.f).view() * sequence(2, 3, 0.f), std::runtime_error);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "parallel.h"
+
+using namespace Core;
+
+namespace
+{
+    // around the chunk size and well past it, including ragged last chunks
+    const size_t sizes[] = {0, 1, 2, 1000, Parallel::GRAIN, Parallel::GRAIN + 1, 5 * Parallel::GRAIN + 77};
+
+    template <typename T>
+    std::vector<T> random_values(size_t n, unsigned seed, T max)
+    {
+        std::mt19937_64 gen(seed);
+        std::vector<T> rslt(n);
+        for (auto &v : rslt)
+            v = static_cast<T>(max == std::numeric_limits<T>::max() ? gen() : gen() % (uint64_t(max) + 1));
+        return rslt;
+    }
+
+    class ParallelTest : public ::testing::TestWithParam<size_t>
+    {
+    protected:
+        void SetUp() override { Jobs::init(GetParam()); }
+        void TearDown() override { Jobs::init(); }
+    };
+}
+
+TEST_P(ParallelTest, reduce)
+{
+    for (size_t n : sizes)
+    {
+        auto values = random_values<uint64_t>(n, 1, 1000);
+        EXPECT_EQ(Parallel::reduce(values.data(), n, uint64_t(7)), std::accumulate(values.begin(), values.end(), uint64_t(7)));
+        const uint64_t max = Parallel::reduce(values.data(), n, uint64_t(0), [](uint64_t a, uint64_t b)
+                                              { return std::max(a, b); });
+        EXPECT_EQ(max, n ? *std::max_element(values.begin(), values.end()) : 0);
+    }
+}
+
+TEST_P(ParallelTest, scans)
+{
+    for (size_t n : sizes)
+    {
+        auto values = random_values<uint32_t>(n, 2, 100);
+        std::vector<uint32_t> inclusive(n), exclusive(n), expected(n);
+        Parallel::inclusive_scan(values.data(), inclusive.data(), n);
+        std::partial_sum(values.begin(), values.end(), expected.begin());
+        EXPECT_EQ(inclusive, expected);
+
+        Parallel::exclusive_scan(values.data(), exclusive.data(), n, uint32_t(5));
+        for (size_t i = 0; i < n; ++i)
+            ASSERT_EQ(exclusive[i], expected[i] - values[i] + 5) << "at " << i;
+
+        // in place
+        Parallel::exclusive_scan(values.data(), values.data(), n, uint32_t(5));
+        EXPECT_EQ(values, exclusive);
+    }
+}
+
+TEST_P(ParallelTest, partition_is_stable)
+{
+    for (size_t n : sizes)
+    {
+        std::vector<size_t> values(n);
+        std::iota(values.begin(), values.end(), 0);
+        std::shuffle(values.begin(), values.end(), std::mt19937(3));
+        auto expected = values;
+        auto odd = [](size_t v)
+        { return v % 3 == 1; };
+        const size_t count = Parallel::partition(values.data(), n, odd);
+        std::stable_partition(expected.begin(), expected.end(), odd);
+        EXPECT_EQ(count, size_t(std::count_if(expected.begin(), expected.end(), odd)));
+        EXPECT_EQ(values, expected);
+    }
+}
+
+TEST_P(ParallelTest, merge_sort_is_stable)
+{
+    for (size_t n : sizes)
+    {
+        // few distinct keys, the payload tells equal keys apart
+        auto keys = random_values<uint32_t>(n, 4, 50);
+        std::vector<std::pair<uint32_t, size_t>> values(n), expected;
+        for (size_t i = 0; i < n; ++i)
+            values[i] = {keys[i], i};
+        expected = values;
+        auto by_key = [](const std::pair<uint32_t, size_t> &a, const std::pair<uint32_t, size_t> &b)
+        { return a.first < b.first; };
+        Parallel::merge_sort(values.data(), n, by_key);
+        std::stable_sort(expected.begin(), expected.end(), by_key);
+        EXPECT_EQ(values, expected);
+    }
+
+    std::vector<std::string> words = {"pear", "apple", "fig", "kiwi", "banana"};
+    Parallel::merge_sort(words.data(), words.size());
+    EXPECT_EQ(words, (std::vector<std::string>{"apple", "banana", "fig", "kiwi", "pear"}));
+}
+
+TEST_P(ParallelTest, radix_sort)
+{
+    for (size_t n : sizes)
+    {
+        auto keys32 = random_values<uint32_t>(n, 5, 0xffffffffu);
+        auto keys64 = random_values<uint64_t>(n, 6, ~uint64_t(0));
+        // small keys skip most digits, duplicates check stability through the payload
+        auto small = random_values<uint64_t>(n, 7, 300);
+        std::vector<size_t> payload(n);
+        std::iota(payload.begin(), payload.end(), 0);
+
+        auto expected32 = keys32;
+        auto expected64 = keys64;
+        std::sort(expected32.begin(), expected32.end());
+        std::sort(expected64.begin(), expected64.end());
+        Parallel::radix_sort(keys32.data(), n);
+        Parallel::radix_sort(keys64.data(), n);
+        EXPECT_EQ(keys32, expected32);
+        EXPECT_EQ(keys64, expected64);
+
+        std::vector<std::pair<uint64_t, size_t>> expected(n);
+        for (size_t i = 0; i < n; ++i)
+            expected[i] = {small[i], i};
+        std::stable_sort(expected.begin(), expected.end(), [](auto &a, auto &b)
+                         { return a.first < b.first; });
+        Parallel::radix_sort(small.data(), payload.data(), n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            ASSERT_EQ(small[i], expected[i].first) << "at " << i;
+            ASSERT_EQ(payload[i], expected[i].second) << "at " << i;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Threads, ParallelTest, ::testing::Values(1, 3),
+                         [](const ::testing::TestParamInfo<size_t> &info)
+                         { return std::to_string(info.param); });
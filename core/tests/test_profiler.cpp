@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "profiler.h"
+
+using namespace Core;
+
+namespace
+{
+    class ProfilerTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            Profiler::set_enabled(true);
+            Profiler::set_history_size(300);
+            Profiler::stop_capture();
+            Profiler::new_frame();
+            Profiler::reset();
+        }
+        void TearDown() override
+        {
+            Profiler::stop_capture();
+            Profiler::reset();
+        }
+    };
+
+    void busy(uint64_t ns)
+    {
+        const uint64_t end = Profiler::now() + ns;
+        while (Profiler::now() < end)
+        {
+        }
+    }
+}
+
+TEST_F(ProfilerTest, nested_scopes)
+{
+    {
+        Profiler::Scope outer("outer");
+        busy(10000);
+        {
+            Profiler::Scope inner("inner");
+            busy(10000);
+        }
+        Profiler::Scope second("second");
+    }
+    Profiler::new_frame();
+    Profiler::Frame frame;
+    ASSERT_TRUE(Profiler::get_frame(0, frame));
+    ASSERT_EQ(frame.events.size(), 3);
+    // ordered by start
+    EXPECT_STREQ(frame.events[0].name, "outer");
+    EXPECT_STREQ(frame.events[1].name, "inner");
+    EXPECT_STREQ(frame.events[2].name, "second");
+    EXPECT_EQ(frame.events[0].depth, 0);
+    EXPECT_EQ(frame.events[1].depth, 1);
+    EXPECT_EQ(frame.events[2].depth, 1);
+    for (const auto &e : frame.events)
+    {
+        EXPECT_LE(frame.start, e.start);
+        EXPECT_LE(e.end, frame.end);
+        EXPECT_GE(e.start, frame.events[0].start);
+        EXPECT_LE(e.end, frame.events[0].end);
+    }
+    EXPECT_GE(frame.events[1].end - frame.events[1].start, 10000);
+    EXPECT_FALSE(Profiler::get_frame(1, frame));
+}
+
+TEST_F(ProfilerTest, open_scopes_wait_for_the_outermost)
+{
+    {
+        Profiler::Scope outer("outer");
+        {
+            Profiler::Scope inner("inner");
+        }
+        // the inner scope is still thread local
+        Profiler::new_frame();
+    }
+    Profiler::new_frame();
+    Profiler::Frame frame;
+    ASSERT_TRUE(Profiler::get_frame(1, frame));
+    EXPECT_TRUE(frame.events.empty());
+    ASSERT_TRUE(Profiler::get_frame(0, frame));
+    EXPECT_EQ(frame.events.size(), 2);
+}
+
+TEST_F(ProfilerTest, threads)
+{
+    std::vector<std::thread> pool;
+    for (int t = 0; t < 3; ++t)
+        pool.emplace_back([]
+                          {
+            Profiler::set_thread_name("worker");
+            for (int i = 0; i < 10; ++i)
+                Profiler::Scope scope("work"); });
+    for (auto &thread : pool)
+        thread.join();
+    Profiler::new_frame();
+    Profiler::Frame frame;
+    ASSERT_TRUE(Profiler::get_frame(0, frame));
+    ASSERT_EQ(frame.events.size(), 30);
+    for (size_t i = 1; i < frame.events.size(); ++i)
+    {
+        const auto &a = frame.events[i - 1], &b = frame.events[i];
+        EXPECT_TRUE(a.thread < b.thread || (a.thread == b.thread && a.start <= b.start));
+        EXPECT_NE(b.thread, frame.thread);
+    }
+    EXPECT_EQ(Profiler::get_thread_name(frame.events[0].thread), "worker");
+}
+
+TEST_F(ProfilerTest, disabled)
+{
+    Profiler::set_enabled(false);
+    {
+        Profiler::Scope scope("off");
+    }
+    Profiler::set_enabled(true);
+    Profiler::new_frame();
+    Profiler::Frame frame;
+    ASSERT_TRUE(Profiler::get_frame(0, frame));
+    EXPECT_TRUE(frame.events.empty());
+#ifndef CORE_PROFILER
+    // compiled out
+    CORE_PROFILE_SCOPE("macro");
+    Profiler::new_frame();
+    ASSERT_TRUE(Profiler::get_frame(0, frame));
+    EXPECT_TRUE(frame.events.empty());
+#endif
+}
+
+TEST_F(ProfilerTest, frame_stats)
+{
+    std::vector<double> values;
+    for (int i = 100; i >= 1; --i)
+        values.push_back(i);
+    EXPECT_EQ(Profiler::percentile(values, 50), 50);
+    EXPECT_EQ(Profiler::percentile(values, 95), 95);
+    EXPECT_EQ(Profiler::percentile(values, 99), 99);
+    EXPECT_EQ(Profiler::percentile(values, 100), 100);
+    EXPECT_EQ(Profiler::percentile(values, 0), 1);
+
+    Profiler::set_history_size(5);
+    for (int i = 0; i < 8; ++i)
+        Profiler::new_frame();
+    EXPECT_EQ(Profiler::get_frame_count(), 5);
+    EXPECT_EQ(Profiler::get_frame_times().size(), 5);
+    const auto stats = Profiler::get_frame_stats();
+    EXPECT_EQ(stats.count, 5);
+    EXPECT_LE(stats.p50, stats.p95);
+    EXPECT_LE(stats.p95, stats.p99);
+    EXPECT_LE(stats.p99, stats.max);
+    Profiler::Frame newest, oldest;
+    ASSERT_TRUE(Profiler::get_frame(0, newest));
+    ASSERT_TRUE(Profiler::get_frame(4, oldest));
+    EXPECT_EQ(newest.index, oldest.index + 4);
+}
+
+TEST_F(ProfilerTest, chrome_trace)
+{
+    Profiler::start_capture();
+    EXPECT_TRUE(Profiler::is_capturing());
+    for (int i = 0; i < 2; ++i)
+    {
+        {
+            Profiler::Scope scope("say \"hi\"");
+        }
+        Profiler::new_frame();
+    }
+    Profiler::stop_capture();
+    Profiler::new_frame();
+    EXPECT_EQ(Profiler::get_capture_frame_count(), 2);
+    const std::string trace = Profiler::chrome_trace();
+    EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0);
+    EXPECT_NE(trace.find("\"name\":\"Frame "), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"say \\\"hi\\\"\",\"ph\":\"X\",\"ts\":"), std::string::npos);
+    EXPECT_NE(trace.find("\"thread_name\""), std::string::npos);
+    size_t count = 0;
+    for (size_t at = trace.find("say"); at != std::string::npos; at = trace.find("say", at + 1))
+        ++count;
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    EXPECT_THROW(Profiler::write_chrome_trace(testing::TempDir() + "missing_dir/x/trace.json"), std::runtime_error);
+}
+
+TEST_F(ProfilerTest, submitted_tracks)
+{
+    const uint32_t gpu = Profiler::create_track("GPU");
+    EXPECT_EQ(Profiler::get_thread_name(gpu), "GPU");
+    Profiler::start_capture();
+    const uint64_t first = Profiler::get_frame_index();
+    {
+        Profiler::Scope scope("cpu");
+    }
+    const uint64_t t = Profiler::now();
+    // for the frame being recorded
+    EXPECT_TRUE(Profiler::submit(first, {{"pass", t, t + 10, gpu, 0}}));
+    Profiler::new_frame();
+    Profiler::new_frame();
+    EXPECT_EQ(Profiler::get_frame_index(), first + 2);
+    // late, like query results read back a few frames after
+    EXPECT_TRUE(Profiler::submit(first, {{"late", t + 20, t + 30, gpu, 0}, {"early", t - 5, t, gpu, 1}}));
+    EXPECT_FALSE(Profiler::submit(first + 100, {{"lost", t, t, gpu, 0}}));
+
+    Profiler::Frame frame;
+    ASSERT_TRUE(Profiler::get_frame(1, frame));
+    ASSERT_EQ(frame.index, first);
+    ASSERT_EQ(frame.events.size(), 4);
+    EXPECT_STREQ(frame.events[0].name, "cpu");
+    EXPECT_STREQ(frame.events[1].name, "early");
+    EXPECT_STREQ(frame.events[2].name, "pass");
+    EXPECT_STREQ(frame.events[3].name, "late");
+    EXPECT_NE(Profiler::chrome_trace().find("\"late\""), std::string::npos);
+    EXPECT_NE(Profiler::chrome_trace().find("{\"name\":\"GPU\"}"), std::string::npos);
+
+    Profiler::set_history_size(1);
+    EXPECT_TRUE(Profiler::submit(first, {{"capture only", t, t, gpu, 0}}));
+    Profiler::stop_capture();
+    Profiler::reset();
+    EXPECT_FALSE(Profiler::submit(first, {{"gone", t, t, gpu, 0}}));
+}
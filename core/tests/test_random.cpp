@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "math/random.h"
+#include "math/simd.h"
+
+using namespace Core;
+using namespace Core::Math;
+
+namespace
+{
+    // restores the SIMD backend and the fill threads after a test
+    class RandomTest : public ::testing::Test
+    {
+    protected:
+        void TearDown() override
+        {
+            SIMD::set_backend(previous);
+            set_random_threads(0);
+        }
+
+        SIMD::Backend previous = SIMD::get_backend();
+    };
+}
+
+TEST_F(RandomTest, philox_known_answers)
+{
+    // Random123 kat_vectors for philox4x32_10, counter (c0, c1) is the block and
+    // (c2, c3) the stream, the key is the seed
+    uint32_t out[4];
+    Philox::block(0, 0, 0, out);
+    EXPECT_EQ(out[0], 0x6627e8d5u);
+    EXPECT_EQ(out[1], 0xe169c58du);
+    EXPECT_EQ(out[2], 0xbc57ac4cu);
+    EXPECT_EQ(out[3], 0x9b00dbd8u);
+
+    Philox::block(~uint64_t(0), ~uint64_t(0), ~uint64_t(0), out);
+    EXPECT_EQ(out[0], 0x408f276du);
+    EXPECT_EQ(out[1], 0x41c83b0eu);
+    EXPECT_EQ(out[2], 0xa20bc7c6u);
+    EXPECT_EQ(out[3], 0x6d5451fdu);
+
+    Philox::block(0x299f31d0a4093822ull, 0x0370734413198a2eull, 0x85a308d3243f6a88ull, out);
+    EXPECT_EQ(out[0], 0xd16cfe09u);
+    EXPECT_EQ(out[1], 0x94fdccebu);
+    EXPECT_EQ(out[2], 0x5001e420u);
+    EXPECT_EQ(out[3], 0x24126ea1u);
+}
+
+TEST_F(RandomTest, sequential_and_seek)
+{
+    Philox gen(42, 7);
+    std::vector<uint32_t> first(11);
+    for (auto &w : first)
+        w = gen();
+    EXPECT_EQ(gen.tell(), 11u);
+
+    uint32_t block[4];
+    Philox::block(42, 7, 2, block);
+    EXPECT_EQ(first[9], block[1]);
+
+    gen.seek(5);
+    EXPECT_EQ(gen(), first[5]);
+    gen.discard(2);
+    EXPECT_EQ(gen(), first[8]);
+
+    // other streams and seeds are different sequences
+    Philox other = gen.split(8);
+    Philox reseeded(43, 7);
+    EXPECT_NE(other(), first[0]);
+    EXPECT_NE(reseeded(), first[0]);
+}
+
+TEST_F(RandomTest, fills_match_scalar_calls)
+{
+    for (SIMD::Backend backend : {SIMD::SCALAR, SIMD::AVX})
+    {
+        if (!SIMD::is_supported(backend))
+            continue;
+        SIMD::set_backend(backend);
+
+        // start off a block boundary so the head and tail paths run
+        Philox bulk(3, 1), scalar(3, 1);
+        bulk.discard(3);
+        scalar.discard(3);
+        std::vector<float> values(2051);
+        bulk.fill_uniform(values.data(), values.size(), -2.f, 5.f);
+        for (float v : values)
+            ASSERT_EQ(v, scalar.uniform(-2.f, 5.f));
+        EXPECT_EQ(bulk.tell(), scalar.tell());
+
+        // normal() drops the second value of its pair, fill_normal keeps it
+        bulk.fill_normal(values.data(), 5);
+        EXPECT_EQ(values[0], scalar.normal());
+        EXPECT_EQ(values[2], scalar.normal());
+        EXPECT_EQ(bulk.tell(), scalar.tell() + 2);
+    }
+}
+
+TEST_F(RandomTest, deterministic_across_threads)
+{
+    const size_t count = 300001;
+    std::vector<float> u1(count), u4(count), n1(count), n4(count);
+    std::vector<Vec3> s1(count / 2), s4(count / 2);
+
+    set_random_threads(1);
+    Philox a(9);
+    a.fill_uniform(u1.data(), count);
+    a.fill_normal(n1.data(), count);
+    a.fill_unit_sphere(s1.data(), s1.size());
+
+    set_random_threads(4);
+    Philox b(9);
+    b.fill_uniform(u4.data(), count);
+    b.fill_normal(n4.data(), count);
+    b.fill_unit_sphere(s4.data(), s4.size());
+
+    EXPECT_EQ(u1, u4);
+    EXPECT_EQ(n1, n4);
+    for (size_t i = 0; i < s1.size(); ++i)
+        ASSERT_TRUE(s1[i].x() == s4[i].x() && s1[i].y() == s4[i].y() && s1[i].z() == s4[i].z()) << i;
+    EXPECT_EQ(a.tell(), b.tell());
+}
+
+TEST_F(RandomTest, distributions)
+{
+    const size_t count = 100000;
+    Philox gen(1234);
+
+    std::vector<float> u(count);
+    gen.fill_uniform(u.data(), count, 1.f, 3.f);
+    double mean = 0.0;
+    for (float v : u)
+    {
+        ASSERT_GE(v, 1.f);
+        ASSERT_LT(v, 3.f);
+        mean += v;
+    }
+    EXPECT_NEAR(mean / count, 2.0, 0.01);
+
+    std::vector<float> n(count);
+    gen.fill_normal(n.data(), count, 5.f, 2.f);
+    double sum = 0.0, sum2 = 0.0;
+    for (float v : n)
+    {
+        ASSERT_TRUE(std::isfinite(v));
+        sum += v;
+        sum2 += double(v) * v;
+    }
+    const double n_mean = sum / count;
+    EXPECT_NEAR(n_mean, 5.0, 0.03);
+    EXPECT_NEAR(std::sqrt(sum2 / count - n_mean * n_mean), 2.0, 0.03);
+
+    std::vector<Vec3> dirs(count);
+    const Vec3 up(0.f, 0.f, 1.f);
+    gen.fill_hemisphere(dirs.data(), count, up);
+    Vec3 centroid;
+    for (const Vec3 &d : dirs)
+    {
+        ASSERT_NEAR(d.length(), 1.f, 1e-5f);
+        ASSERT_GE(Vec3::dot(d, up), 0.f);
+        centroid = centroid + d;
+    }
+    // a uniform hemisphere has its centroid at half the radius along the normal
+    EXPECT_NEAR(centroid.x() / count, 0.f, 0.01f);
+    EXPECT_NEAR(centroid.y() / count, 0.f, 0.01f);
+    EXPECT_NEAR(centroid.z() / count, 0.5f, 0.01f);
+}
+
+TEST_F(RandomTest, bounded_integers)
+{
+    Philox gen(5);
+    std::vector<int> histogram(7);
+    for (int i = 0; i < 70000; ++i)
+    {
+        const int v = uniform<int>(gen, -3, 4);
+        ASSERT_GE(v, -3);
+        ASSERT_LT(v, 4);
+        ++histogram[v + 3];
+    }
+    for (int h : histogram)
+        EXPECT_NEAR(h, 10000, 500);
+
+    EXPECT_EQ(uniform<int>(gen, 2, 2), 2);
+    EXPECT_EQ(uniform<unsigned>(gen, 0u, 1u), 0u);
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "scene_graph.h"
+#include "geometry/geometry3d.h"
+
+using namespace Core;
+
+namespace
+{
+    void expect_matrix_near(const Mat4 &a, const Mat4 &b, float eps = 1e-5f)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+                EXPECT_NEAR(a(i, j), b(i, j), eps) << "at (" << i << ", " << j << ")";
+        }
+    }
+}
+
+TEST(TestSceneGraph, world_matrices)
+{
+    Transform root_t(Vec3(1.f, 2.f, 3.f), EulerAngle{30.f, 0.f, 0.f});
+    Transform child_t(Vec3(0.f, 1.f, 0.f), EulerAngle{0.f, 45.f, 0.f}, Vec3(2.f, 1.f, 0.5f));
+    Transform leaf_t(Vec3(-1.f, 0.f, 2.f));
+
+    Scene_Graph graph;
+    const auto root = graph.create(&root_t);
+    const auto group = graph.create(nullptr, root);
+    const auto child = graph.create(&child_t, group);
+    const auto leaf = graph.create(&leaf_t, child);
+    EXPECT_EQ(graph.update(), 4u);
+
+    EXPECT_EQ(graph.get_depth(leaf), 3u);
+    expect_matrix_near(graph.get_world_matrix(root), root_t.get_model_matrix());
+    expect_matrix_near(graph.get_world_matrix(group), root_t.get_model_matrix());
+    const Mat4 expected = leaf_t.get_model_matrix() * child_t.get_model_matrix() * root_t.get_model_matrix();
+    expect_matrix_near(graph.get_world_matrix(leaf), expected);
+
+    // the world normal matrix is the inverse transpose of the world matrix
+    const Mat3 normal = Mat3(expected.inverse_affine().transpose());
+    const Mat3 &world_normal = graph.get_world_normal_matrix(leaf);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_NEAR(world_normal(i, j), normal(i, j), 1e-5f);
+    }
+    const Vec3 p = graph.get_world_position(leaf);
+    EXPECT_NEAR(p.x(), expected(3, 0), 1e-6f);
+    EXPECT_NEAR(p.y(), expected(3, 1), 1e-6f);
+    EXPECT_NEAR(p.z(), expected(3, 2), 1e-6f);
+}
+
+TEST(TestSceneGraph, dirty_subtrees_only)
+{
+    Transform a_t, b_t, a1_t, a2_t, b1_t;
+    Scene_Graph graph;
+    const auto a = graph.create(&a_t);
+    const auto b = graph.create(&b_t);
+    const auto a1 = graph.create(&a1_t, a);
+    const auto a2 = graph.create(&a2_t, a);
+    const auto b1 = graph.create(&b1_t, b);
+    EXPECT_EQ(graph.update(), 5u);
+    EXPECT_EQ(graph.update(), 0u);
+
+    a_t.set_position(1.f, 0.f, 0.f);
+    EXPECT_EQ(graph.update(), 3u);
+    EXPECT_TRUE(graph.is_changed(a));
+    EXPECT_TRUE(graph.is_changed(a2));
+    EXPECT_FALSE(graph.is_changed(b));
+    EXPECT_FALSE(graph.is_changed(b1));
+    EXPECT_FLOAT_EQ(graph.get_world_position(a1).x(), 1.f);
+
+    b1_t.set_position(0.f, 2.f, 0.f);
+    EXPECT_EQ(graph.update(), 1u);
+    EXPECT_TRUE(graph.is_changed(b1));
+    EXPECT_FALSE(graph.is_changed(a1));
+}
+
+TEST(TestSceneGraph, reparent)
+{
+    Transform a_t(Vec3(1.f, 0.f, 0.f)), b_t(Vec3(0.f, 5.f, 0.f)), c_t(Vec3(0.f, 0.f, 2.f));
+    Scene_Graph graph;
+    const auto a = graph.create(&a_t);
+    const auto b = graph.create(&b_t);
+    const auto c = graph.create(&c_t, a);
+    graph.update();
+    EXPECT_FLOAT_EQ(graph.get_world_position(c).x(), 1.f);
+    EXPECT_FLOAT_EQ(graph.get_world_position(c).y(), 0.f);
+
+    graph.set_parent(c, b);
+    EXPECT_THROW(graph.get_world_matrix(c), std::runtime_error);
+    graph.update();
+    EXPECT_EQ(graph.get_parent(c), b);
+    EXPECT_TRUE(graph.is_ancestor(b, c));
+    EXPECT_TRUE(graph.get_children(a).empty());
+    EXPECT_FLOAT_EQ(graph.get_world_position(c).x(), 0.f);
+    EXPECT_FLOAT_EQ(graph.get_world_position(c).y(), 5.f);
+    EXPECT_FLOAT_EQ(graph.get_world_position(c).z(), 2.f);
+
+    // b under its own child would be a cycle
+    EXPECT_THROW(graph.set_parent(b, c), std::runtime_error);
+    EXPECT_THROW(graph.set_parent(b, b), std::runtime_error);
+
+    // destroying b moves c up to the roots
+    graph.destroy(b);
+    graph.update();
+    EXPECT_FALSE(graph.contains(b));
+    EXPECT_EQ(graph.get_parent(c), Scene_Graph::NONE);
+    EXPECT_EQ(graph.get_children(Scene_Graph::NONE).size(), 2u);
+    EXPECT_FLOAT_EQ(graph.get_world_position(c).z(), 2.f);
+    EXPECT_EQ(graph.size(), 2u);
+}
+
+TEST(TestSceneGraph, threaded)
+{
+    // a wide second level so that update() splits it
+    const size_t count = 20000;
+    Transform root_t(Vec3(0.f, 1.f, 0.f), EulerAngle{10.f, 20.f, 30.f});
+    std::vector<std::unique_ptr<Transform>> transforms;
+    for (size_t i = 0; i < count; ++i)
+        transforms.emplace_back(new Transform(Vec3(float(i), 0.f, 0.f), EulerAngle{float(i % 360), 0.f, 0.f}));
+
+    Scene_Graph serial, threaded;
+    const auto serial_root = serial.create(&root_t);
+    const auto threaded_root = threaded.create(&root_t);
+    std::vector<Scene_Graph::Node> nodes;
+    for (auto &t : transforms)
+    {
+        nodes.push_back(serial.create(t.get(), serial_root));
+        threaded.create(t.get(), threaded_root);
+    }
+    set_scene_graph_threads(1);
+    EXPECT_EQ(serial.update(), count + 1);
+    set_scene_graph_threads(4);
+    EXPECT_EQ(threaded.update(), count + 1);
+    set_scene_graph_threads(0);
+
+    for (auto node : nodes)
+    {
+        const Mat4 &s = serial.get_world_matrix(node);
+        const Mat4 &t = threaded.get_world_matrix(node);
+        for (size_t i = 0; i < 16; ++i)
+            ASSERT_EQ(s.data()[i], t.data()[i]);
+    }
+}
+
+TEST(TestSceneGraph, shared_transform)
+{
+    // one transform under every node of a wide level, its cache is filled once before the threads
+    const size_t count = 20000;
+    Transform root_t;
+    Transform shared(Vec3(1.f, 2.f, 3.f), EulerAngle{10.f, 20.f, 30.f});
+    Scene_Graph graph;
+    const auto root = graph.create(&root_t);
+    std::vector<Scene_Graph::Node> nodes;
+    for (size_t i = 0; i < count; ++i)
+        nodes.push_back(graph.create(&shared, root));
+    set_scene_graph_threads(4);
+    EXPECT_EQ(graph.update(), count + 1);
+    shared.translate(Vec3(1.f, 0.f, 0.f));
+    EXPECT_EQ(graph.update(), count);
+    set_scene_graph_threads(0);
+
+    const Mat4 &expected = shared.get_model_matrix();
+    for (auto node : nodes)
+    {
+        const Mat4 &m = graph.get_world_matrix(node);
+        for (size_t i = 0; i < 16; ++i)
+            ASSERT_EQ(m.data()[i], expected.data()[i]);
+    }
+}
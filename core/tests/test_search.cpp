@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "search.h"
+#include "math/simd.h"
+
+using namespace Core;
+
+namespace
+{
+    // sorted keys with plenty of duplicates and gaps
+    std::vector<uint32_t> sorted_keys(size_t size, uint32_t seed)
+    {
+        std::mt19937 gen(seed);
+        std::vector<uint32_t> rslt(size);
+        for (auto &k : rslt)
+            k = gen() % (size * 2 + 1);
+        std::sort(rslt.begin(), rslt.end());
+        return rslt;
+    }
+
+    size_t reference(const std::vector<uint32_t> &data, uint32_t key)
+    {
+        return std::lower_bound(data.begin(), data.end(), key) - data.begin();
+    }
+}
+
+TEST(TestSearch, empty)
+{
+    const uint32_t key = 1;
+    EXPECT_EQ(Search::lower_bound<uint32_t>(nullptr, 0, key), 0);
+    EXPECT_EQ(Search::find<uint32_t>(nullptr, 0, key), Search::NOT_FOUND);
+    Search::Eytzinger<uint32_t> tree;
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.lower_bound(key), 0);
+    EXPECT_FALSE(tree.contains(key));
+    size_t out = 42;
+    tree.lower_bound(&key, 1, &out);
+    EXPECT_EQ(out, 0);
+    Search::lower_bound<uint32_t>(nullptr, 0, &key, 1, &out);
+    EXPECT_EQ(out, 0);
+}
+
+TEST(TestSearch, matches_std_lower_bound)
+{
+    for (size_t size : {1, 2, 3, 7, 8, 15, 16, 17, 31, 100, 1000, 4097})
+    {
+        const auto data = sorted_keys(size, uint32_t(size));
+        const Search::Eytzinger<uint32_t> tree(data.data(), data.size());
+        ASSERT_EQ(tree.size(), size);
+        for (uint32_t key = 0; key <= size * 2 + 2; ++key)
+        {
+            const size_t expected = reference(data, key);
+            ASSERT_EQ(Search::lower_bound(data.data(), data.size(), key), expected) << "size " << size << ", key " << key;
+            ASSERT_EQ(tree.lower_bound(key), expected) << "size " << size << ", key " << key;
+            const bool present = expected < size && data[expected] == key;
+            // duplicates: find may pick any of the equal keys, but an equal one
+            const size_t found = Search::find(data.data(), data.size(), key);
+            const size_t found_tree = tree.find(key);
+            if (present)
+            {
+                ASSERT_EQ(data[found], key);
+                ASSERT_EQ(data[found_tree], key);
+            }
+            else
+            {
+                ASSERT_EQ(found, Search::NOT_FOUND);
+                ASSERT_EQ(found_tree, Search::NOT_FOUND);
+            }
+        }
+    }
+}
+
+TEST(TestSearch, extreme_keys)
+{
+    const std::vector<uint32_t> data = {0, 1, 0x7fffffffu, 0x80000000u, 0xfffffffeu, 0xffffffffu,
+                                        0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+    for (uint32_t key : {0u, 1u, 2u, 0x7fffffffu, 0x80000000u, 0x80000001u, 0xfffffffeu, 0xffffffffu})
+    {
+        EXPECT_EQ(Search::lower_bound(data.data(), data.size(), key), reference(data, key)) << key;
+        EXPECT_EQ(Search::lower_bound_block(data.data(), data.size(), key), reference(data, key)) << key;
+    }
+}
+
+TEST(TestSearch, other_types)
+{
+    std::vector<float> floats = {-3.5f, -1.0f, -0.0f, 0.5f, 0.5f, 2.0f, 10.0f, 1e30f, 1e30f};
+    for (float key : {-4.0f, -3.5f, 0.0f, 0.5f, 0.75f, 1e30f, 2e30f})
+    {
+        const size_t expected = std::lower_bound(floats.begin(), floats.end(), key) - floats.begin();
+        EXPECT_EQ(Search::lower_bound(floats.data(), floats.size(), key), expected) << key;
+        EXPECT_EQ(Search::Eytzinger<float>(floats.data(), floats.size()).lower_bound(key), expected) << key;
+    }
+
+    // descending order through the comparator, no block search involved
+    std::vector<std::string> names = {"tex", "mesh", "light", "camera"};
+    const auto greater = std::greater<std::string>();
+    EXPECT_EQ(Search::find(names.data(), names.size(), std::string("light"), greater), 2);
+    EXPECT_EQ(Search::find(names.data(), names.size(), std::string("model"), greater), Search::NOT_FOUND);
+    const Search::Eytzinger<std::string, std::greater<std::string>> tree(names.data(), names.size());
+    EXPECT_EQ(tree.find("camera"), 3);
+    EXPECT_EQ(tree.lower_bound("model"), 1);
+    EXPECT_EQ(tree.lower_bound("a"), 4);
+}
+
+TEST(TestSearch, batched)
+{
+    const auto data = sorted_keys(100000, 7);
+    const Search::Eytzinger<uint32_t> tree(data.data(), data.size());
+    std::mt19937 gen(11);
+    // not a multiple of the group or job sizes
+    std::vector<uint32_t> keys(10007);
+    for (auto &k : keys)
+        k = gen() % (data.size() * 2 + 10);
+    std::vector<size_t> plain(keys.size()), eytzinger(keys.size());
+    Search::lower_bound(data.data(), data.size(), keys.data(), keys.size(), plain.data());
+    tree.lower_bound(keys.data(), keys.size(), eytzinger.data());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(plain[i], reference(data, keys[i])) << i;
+        ASSERT_EQ(eytzinger[i], plain[i]) << i;
+    }
+}
+
+TEST(TestSearch, block_backends)
+{
+    const auto previous = Math::SIMD::get_backend();
+    const auto data = sorted_keys(40, 3);
+    std::vector<float> floats(data.begin(), data.end());
+    for (auto backend : {Math::SIMD::SCALAR, Math::SIMD::SSE2, Math::SIMD::AVX})
+    {
+        Math::SIMD::set_backend(backend);
+        for (size_t size = 0; size <= data.size(); ++size)
+        {
+            for (uint32_t key = 0; key < 90; ++key)
+            {
+                const size_t expected = std::lower_bound(data.begin(), data.begin() + size, key) - data.begin();
+                ASSERT_EQ(Search::lower_bound_block(data.data(), size, key), expected);
+                ASSERT_EQ(Search::lower_bound_block(floats.data(), size, float(key)), expected);
+            }
+        }
+    }
+    Math::SIMD::set_backend(previous);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include "math/simd.h"
+#include "math/base.h"
+#include "fixed_matrix.h"
+#include "geometry/geometry3d.h"
+
+using namespace Core::Math;
+
+namespace
+{
+    const float A[16] = {
+        1.5f, -2.f, 3.25f, 0.f,
+        0.5f, 1.f, -2.5f, 0.f,
+        4.f, 0.125f, 1.f, 0.f,
+        -3.f, 7.5f, 2.f, 1.f};
+    const float B[16] = {
+        0.3f, 1.7f, -0.9f, 2.2f,
+        -1.1f, 0.4f, 3.3f, 0.6f,
+        2.5f, -0.7f, 0.8f, -1.4f,
+        0.9f, 1.2f, -2.6f, 1.f};
+    const float V[4] = {0.7f, -1.3f, 2.9f, 1.f};
+
+    bool all_equal(const float *a, const float *b, size_t n, bool exact)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (exact ? std::memcmp(&a[i], &b[i], sizeof(float)) != 0
+                      : std::fabs(a[i] - b[i]) > 4.f * FLT_EPSILON * std::fmax(1.f, std::fabs(a[i])))
+                return false;
+        }
+        return true;
+    }
+
+    class SIMDBackendTest : public ::testing::TestWithParam<SIMD::Backend>
+    {
+    protected:
+        void SetUp() override
+        {
+            if (!SIMD::is_supported(GetParam()))
+                GTEST_SKIP() << SIMD::backend_name(GetParam()) << " is not supported on this CPU";
+            previous = SIMD::get_backend();
+            SIMD::set_backend(GetParam());
+        }
+        void TearDown() override { SIMD::set_backend(previous); }
+
+        // every backend but FMA must match the scalar fallback bit for bit
+        bool exact() const { return GetParam() != SIMD::FMA; }
+
+        template <typename F>
+        void scalar_reference(F &&f)
+        {
+            SIMD::Backend current = SIMD::get_backend();
+            SIMD::set_backend(SIMD::SCALAR);
+            f();
+            SIMD::set_backend(current);
+        }
+
+        SIMD::Backend previous = SIMD::SCALAR;
+    };
+}
+
+TEST_P(SIMDBackendTest, mat4_mul)
+{
+    float ref[16], rslt[16];
+    scalar_reference([&]
+                     { SIMD::mat4_mul(A, B, ref); });
+    SIMD::mat4_mul(A, B, rslt);
+    EXPECT_TRUE(all_equal(ref, rslt, 16, exact()));
+
+    // in place
+    float a[16];
+    std::memcpy(a, A, sizeof(a));
+    SIMD::mat4_mul(a, B, a);
+    EXPECT_TRUE(all_equal(ref, a, 16, exact()));
+}
+
+TEST_P(SIMDBackendTest, mat4_mul_vec4)
+{
+    float ref[4], rslt[4];
+    scalar_reference([&]
+                     { SIMD::mat4_mul_vec4(B, V, ref); });
+    SIMD::mat4_mul_vec4(B, V, rslt);
+    EXPECT_TRUE(all_equal(ref, rslt, 4, exact()));
+
+    Core::Vec4 v = Core::Mat4::identity() * Core::Vec4(V[0], V[1], V[2], V[3]);
+    EXPECT_TRUE(v == Core::Vec4(V[0], V[1], V[2], V[3]));
+}
+
+TEST_P(SIMDBackendTest, mat4_transpose)
+{
+    float rslt[16];
+    SIMD::mat4_transpose(B, rslt);
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            EXPECT_EQ(rslt[j * 4 + i], B[i * 4 + j]);
+    }
+}
+
+TEST_P(SIMDBackendTest, mat4_inverse_affine)
+{
+    float ref[16], rslt[16];
+    bool ok = false;
+    scalar_reference([&]
+                     { ok = SIMD::mat4_inverse_affine(A, ref); });
+    ASSERT_TRUE(ok);
+    ASSERT_TRUE(SIMD::mat4_inverse_affine(A, rslt));
+    EXPECT_TRUE(all_equal(ref, rslt, 16, true));
+
+    Core::Mat4 m(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[8], A[9], A[10], A[11], A[12], A[13], A[14], A[15]);
+    EXPECT_TRUE(m.inverse_affine() == m.inverse());
+    EXPECT_TRUE(m * m.inverse_affine() == Core::Mat4::identity());
+
+    Core::Mat4 view = Core::Geometry::look_at(Core::Vec3(1.f, 2.f, 3.f), Core::Vec3(0.f, 0.f, 0.f), Core::Vec3(0.f, 1.f, 0.f));
+    EXPECT_TRUE(view.inverse_affine() == view.inverse());
+
+    EXPECT_FALSE(SIMD::mat4_inverse_affine(Core::Mat4::zeros().data(), rslt));
+    EXPECT_THROW(Core::Mat4::zeros().inverse_affine(), std::runtime_error);
+}
+
+TEST_P(SIMDBackendTest, inverse_affine_of_translate)
+{
+    // translate() writes the translation into column 3, Geometry::translate into row 3
+    const Core::Mat4 rotation = Core::Geometry::rotate(Core::Mat4::identity(), 0.5f, Core::Vec3(0.f, 0.f, 1.f));
+    Core::Mat4 moved = Core::Mat4::identity();
+    moved.translate(Core::Vec3(1.f, -2.f, 3.f));
+    Core::Mat4 rotated_moved = rotation.transpose();
+    rotated_moved.translate(Core::Vec3(-4.f, 5.f, 0.5f));
+    for (const Core::Mat4 &m : {moved, rotated_moved, Core::Geometry::translate(rotation, 1.f, -2.f, 3.f)})
+    {
+        EXPECT_TRUE(m.inverse_affine() == m.inverse());
+        EXPECT_TRUE(m * m.inverse_affine() == Core::Mat4::identity());
+
+        Core::Matrix4 matrix(m);
+        matrix = matrix.inverse_affine();
+        EXPECT_TRUE(Core::Mat4(matrix) == m.inverse());
+    }
+    Core::Matrix4 matrix_moved = Core::Matrix4::identity();
+    matrix_moved.translate(Core::Vector3(1.f, 2.f, 3.f));
+    EXPECT_TRUE(Core::Mat4(matrix_moved.inverse_affine()) == Core::Mat4(matrix_moved).inverse());
+
+    // a projection is neither affine layout
+    const Core::Mat4 projection = Core::Geometry::perspective(1.f, 1.f, 0.5f, 10.f);
+    EXPECT_THROW(projection.inverse_affine(), std::runtime_error);
+    EXPECT_THROW(Core::Matrix4(projection).inverse_affine(), std::runtime_error);
+}
+
+TEST_P(SIMDBackendTest, matrix4_matches_mat4)
+{
+    Core::Matrix4 a(const_cast<float *>(A), true);
+    Core::Matrix4 b(const_cast<float *>(B), true);
+    Core::Matrix generic = static_cast<const Core::Matrix &>(a) * static_cast<const Core::Matrix &>(b);
+    Core::Matrix4 fast = a * b;
+    EXPECT_TRUE(all_equal(fast.data(), generic.data(), 16, exact()));
+    Core::Mat4 fixed = Core::Mat4(a) * Core::Mat4(b);
+    EXPECT_TRUE(all_equal(fast.data(), fixed.data(), 16, true));
+    EXPECT_TRUE(a.transpose() == a.Matrix::transpose());
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, SIMDBackendTest,
+                         ::testing::Values(SIMD::SCALAR, SIMD::SSE2, SIMD::AVX, SIMD::FMA),
+                         [](const ::testing::TestParamInfo<SIMD::Backend> &info)
+                         { return std::string(SIMD::backend_name(info.param)); });
@@ -21,4 +21,18 @@ TEST(Tools, reverse_str)
     std::string r = "nmlkjihgfedcba";
    Core:: Tools::reverse_str(r);
     EXPECT_TRUE(s == r);
-}
\ No newline at end of file
+}
+TEST(Tools, binary_search)
+{
+    const int arr[] = {1, 3, 3, 5, 8, 13};
+    EXPECT_EQ(Core::Tools::binary_search(arr, 6, 5), 3);
+    EXPECT_EQ(Core::Tools::binary_search(arr, 6, 1), 0);
+    EXPECT_EQ(Core::Tools::binary_search(arr, 6, 13), 5);
+    EXPECT_EQ(arr[Core::Tools::binary_search(arr, 6, 3)], 3);
+    EXPECT_EQ(Core::Tools::binary_search(arr, 6, 4), Core::Tools::NOT_FOUND);
+    EXPECT_EQ(Core::Tools::binary_search(arr, 6, 20), Core::Tools::NOT_FOUND);
+    // used to underflow its upper index on empty arrays
+    EXPECT_EQ(Core::Tools::binary_search<int>(nullptr, 0, 4), Core::Tools::NOT_FOUND);
+    const int desc[] = {9, 7, 2};
+    EXPECT_EQ((Core::Tools::binary_search<int, std::greater<int>>(desc, 3, 7)), 1);
+}
@@ -2,6 +2,7 @@
 #include "test_utils.h"
 #include "vector.h"
 #include "transform.h"
+#include "geometry/geometry3d.h"
 
 TEST(TestTransform, construct_from_base_vectors)
 {
@@ -39,3 +40,66 @@ TEST(TestTransform, scale)
     std::cout << "scale: " << scale << std::endl;
     EXPECT_TRUE(scale == Vector3(2.0f, 4.0f, 6.0f));
 }
+
+TEST(TestTransform, cached_matrices)
+{
+    using namespace Core;
+    Transform transform(Vec3(1.0f, 2.0f, 3.0f));
+    const Mat4 &model = transform.get_model_matrix();
+    EXPECT_EQ(&model, &transform.get_model_matrix());
+    EXPECT_EQ(model(3, 0), 1.0f);
+    EXPECT_EQ(model(3, 2), 3.0f);
+
+    // setters invalidate the cache, the reference stays valid
+    transform.set_scale(2.0f, 1.0f, 0.5f);
+    transform.rotate_y(30.0f);
+    Mat4 expected = Geometry::translate(Geometry::scale(transform.get_orientation().to_matrix4(), transform.get_scale()), transform.get_position());
+    EXPECT_TRUE(transform.get_model_matrix() == expected);
+    EXPECT_TRUE(model == expected);
+}
+
+TEST(TestTransform, normal_matrix)
+{
+    using namespace Core;
+    Transform transform(Vec3(0.0f, 0.0f, 0.0f), EulerAngle{0.3f, 0.5f, 0.1f}, Vec3(3.0f, 1.0f, 0.5f));
+    Mat3 model(transform.get_model_matrix());
+    const Mat3 &normal_matrix = transform.get_normal_matrix();
+
+    // a tangent and the normal of the same surface stay perpendicular, rows are
+    // transformed as row vectors like the shaders do with the uploaded matrices
+    auto apply = [](const Vec3 &v, const Mat3 &m)
+    {
+        return Vec3(v.x() * m(0, 0) + v.y() * m(1, 0) + v.z() * m(2, 0),
+                    v.x() * m(0, 1) + v.y() * m(1, 1) + v.z() * m(2, 1),
+                    v.x() * m(0, 2) + v.y() * m(1, 2) + v.z() * m(2, 2));
+    };
+    const Vec3 tangent(1.0f, -1.0f, 0.0f);
+    const Vec3 normal(1.0f, 1.0f, 1.0f);
+    EXPECT_NEAR(Vec3::dot(apply(tangent, model), apply(normal, normal_matrix)), 0.0f, 1e-5f);
+
+    transform.set_scale(1.0f);
+    Mat3 rotation(transform.get_orientation().to_matrix4());
+    EXPECT_TRUE(transform.get_normal_matrix() == rotation);
+}
+
+TEST(TestTransform, version)
+{
+    using namespace Core;
+    Transform transform;
+    const uint64_t frame = Transform::current_version();
+    EXPECT_FALSE(transform.changed_since(frame));
+
+    transform.get_model_matrix();
+    EXPECT_FALSE(transform.changed_since(frame));
+
+    transform.move_forward(1.0f);
+    EXPECT_TRUE(transform.changed_since(frame));
+    const uint64_t seen = transform.get_version();
+    EXPECT_FALSE(transform.changed_since(seen));
+
+    // a transform created after the frame started counts as changed
+    Transform other;
+    EXPECT_TRUE(other.changed_since(frame));
+    other = transform;
+    EXPECT_GT(other.get_version(), seen);
+}
@@ -0,0 +1,79 @@
+// Millions of points per second through the Geometry batch transforms (AoS and
+// SoA) against a per-point loop over Mat4 * Vec4 and Quaternion * Vec3.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "geometry/batch.h"
+#include "geometry/geometry3d.h"
+
+namespace
+{
+    template <typename F>
+    double seconds(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const char *name, size_t count, double t)
+    {
+        printf("%-28s %10.1f Mpoints/s\n", name, count / t * 1e-6);
+    }
+}
+
+// usage: bench_batch_transform [points] [threads]
+int main(int argc, char **argv)
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    if (argc > 2)
+        Core::Geometry::set_batch_threads(std::strtoul(argv[2], nullptr, 10));
+    printf("points: %zu, threads: %zu\n", count, Core::Geometry::get_batch_threads());
+
+    Core::Mat4 m = Core::Geometry::rotate(Core::Mat4::identity(), 0.5f, Core::Vec3(0.f, 1.f, 0.f));
+    m = Core::Geometry::translate(m, 1.f, 2.f, 3.f);
+    const Core::Mat4 mt = m.transpose();
+    const Core::Quaternion q = Core::Geometry::angle_axis(0.5f, 0.f, 1.f, 0.f);
+
+    std::vector<float> aos(count * 3), out(count * 3);
+    std::vector<float> x(count), y(count), z(count);
+    for (size_t i = 0; i < count * 3; ++i)
+        aos[i] = static_cast<float>(std::rand()) / RAND_MAX;
+    for (size_t i = 0; i < count; ++i)
+    {
+        x[i] = aos[i * 3];
+        y[i] = aos[i * 3 + 1];
+        z[i] = aos[i * 3 + 2];
+    }
+    std::vector<float> ox(count), oy(count), oz(count);
+
+    report("per point Mat4 * Vec4", count, seconds([&]
+                                                    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Core::Vec4 p = mt * Core::Vec4(aos[i * 3], aos[i * 3 + 1], aos[i * 3 + 2], 1.f);
+            out[i * 3] = p.x();
+            out[i * 3 + 1] = p.y();
+            out[i * 3 + 2] = p.z();
+        } }));
+    report("transform_points AoS", count, seconds([&]
+                                                   { Core::Geometry::transform_points(m, aos.data(), out.data(), count); }));
+    report("transform_points SoA", count, seconds([&]
+                                                   { Core::Geometry::transform_points(m, {x.data(), y.data(), z.data()}, {ox.data(), oy.data(), oz.data()}, count); }));
+
+    report("per point Quaternion * Vec3", count, seconds([&]
+                                                          {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Core::Vec3 p = q * Core::Vec3(aos[i * 3], aos[i * 3 + 1], aos[i * 3 + 2]);
+            out[i * 3] = p.x();
+            out[i * 3 + 1] = p.y();
+            out[i * 3 + 2] = p.z();
+        } }));
+    report("rotate_points AoS", count, seconds([&]
+                                                { Core::Geometry::rotate_points(q, aos.data(), out.data(), count); }));
+    report("rotate_points SoA", count, seconds([&]
+                                                { Core::Geometry::rotate_points(q, {x.data(), y.data(), z.data()}, {ox.data(), oy.data(), oz.data()}, count); }));
+    return 0;
+}
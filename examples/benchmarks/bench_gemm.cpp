@@ -0,0 +1,81 @@
+// GFLOP/s of Matrix::operator* (packed, threaded Math::gemm above the size
+// threshold) against the naive i-j-k loop it replaced.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "matrix.h"
+#include "math/gemm.h"
+
+namespace
+{
+    Core::Matrix random_matrix(size_t rows, size_t cols)
+    {
+        Core::Matrix rslt(rows, cols);
+        for (size_t i = 0; i < rslt.size(); ++i)
+            rslt.data()[i] = static_cast<float>(std::rand()) / RAND_MAX - 0.5f;
+        return rslt;
+    }
+
+    // the loop Matrix::operator* used before
+    Core::Matrix naive(const Core::Matrix &a, const Core::Matrix &b)
+    {
+        Core::Matrix rslt(a.rows(), b.cols());
+        for (size_t i = 0; i < a.rows(); ++i)
+        {
+            for (size_t j = 0; j < b.cols(); ++j)
+            {
+                for (size_t k = 0; k < a.cols(); ++k)
+                    rslt(i, j) += a(i, k) * b(k, j);
+            }
+        }
+        return rslt;
+    }
+
+    template <typename F>
+    double seconds(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+// usage: bench_gemm [max size] [threads]
+int main(int argc, char **argv)
+{
+    const size_t max_size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2048;
+    if (argc > 2)
+        Core::Math::set_gemm_threads(std::strtoul(argv[2], nullptr, 10));
+    printf("threads: %zu\n", Core::Math::get_gemm_threads());
+    printf("%6s %14s %14s %10s\n", "n", "naive GFLOP/s", "gemm GFLOP/s", "max diff");
+
+    for (size_t n = 128; n <= max_size; n *= 2)
+    {
+        Core::Matrix a = random_matrix(n, n);
+        Core::Matrix b = random_matrix(n, n);
+        const double flops = 2.0 * n * n * n;
+
+        Core::Matrix fast;
+        double t_fast = seconds([&]
+                                { fast = a * b; });
+
+        // the naive loop takes minutes above 1024, only time it where it is bearable
+        if (n <= 1024)
+        {
+            Core::Matrix slow;
+            double t_slow = seconds([&]
+                                    { slow = naive(a, b); });
+            float diff = 0.f;
+            for (size_t i = 0; i < slow.size(); ++i)
+                diff = std::fmax(diff, std::fabs(slow.data()[i] - fast.data()[i]));
+            printf("%6zu %14.2f %14.2f %10.2e\n", n, flops / t_slow * 1e-9, flops / t_fast * 1e-9, diff);
+        }
+        else
+        {
+            printf("%6zu %14s %14.2f %10s\n", n, "-", flops / t_fast * 1e-9, "-");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Scheduling overhead of Core::Jobs (empty jobs, tiny parallel_for chunks) and the
+// scaling of a compute bound parallel_for from 1 to N threads.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "jobs.h"
+
+namespace
+{
+    template <typename F>
+    double seconds(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // enough arithmetic per element that memory bandwidth does not decide the scaling
+    float work(size_t i)
+    {
+        float x = static_cast<float>(i);
+        for (int k = 0; k < 32; ++k)
+            x = std::sqrt(x + 1.f);
+        return x;
+    }
+}
+
+// usage: bench_jobs [max threads] [elements]
+int main(int argc, char **argv)
+{
+    const size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    const size_t count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4000000;
+
+    Core::Jobs::init(max_threads);
+    printf("threads: %zu (%zu workers)\n", max_threads, Core::Jobs::get_worker_count());
+    const size_t jobs = 200000;
+    {
+        Core::Jobs::Counter counter;
+        const double t = seconds([&]
+                                 {
+            for (size_t i = 0; i < jobs; ++i)
+                Core::Jobs::run([] {}, &counter);
+            Core::Jobs::wait(counter); });
+        printf("%-28s %10.1f ns/job\n", "run + wait, empty jobs", t / jobs * 1e9);
+    }
+    {
+        std::vector<float> out(jobs);
+        const double t = seconds([&]
+                                 { Core::Jobs::parallel_for(0, jobs, 1, [&](size_t begin, size_t)
+                                                            { out[begin] = 1.f; }); });
+        printf("%-28s %10.1f ns/chunk\n", "parallel_for, grain 1", t / jobs * 1e9);
+    }
+
+    std::vector<float> out(count);
+    double base = 0.0;
+    for (size_t threads = 1; threads <= max_threads; ++threads)
+    {
+        Core::Jobs::init(threads);
+        const double t = seconds([&]
+                                 { Core::Jobs::parallel_for(0, count, 0, [&](size_t begin, size_t end)
+                                                            {
+            for (size_t i = begin; i < end; ++i)
+                out[i] = work(i); }); });
+        if (threads == 1)
+            base = t;
+        printf("parallel_for %2zu threads     %10.1f Melements/s  speedup %.2f\n", threads, count / t * 1e-6, base / t);
+    }
+    return 0;
+}
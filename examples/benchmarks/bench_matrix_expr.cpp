@@ -0,0 +1,94 @@
+// Allocation count and run time of `r = a * 2 + b - c` with the lazy
+// expression templates against the eager evaluation the operators used to do
+// (one new[] per operator).
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "matrix.h"
+
+namespace
+{
+    size_t allocations = 0;
+
+    Core::Matrix random_matrix(size_t rows, size_t cols)
+    {
+        Core::Matrix rslt(rows, cols);
+        for (size_t i = 0; i < rslt.size(); ++i)
+            rslt.data()[i] = static_cast<float>(std::rand()) / RAND_MAX;
+        return rslt;
+    }
+
+    // what `a * 2.f + b - c` cost before the expression templates
+    Core::Matrix eager(const Core::Matrix &a, const Core::Matrix &b, const Core::Matrix &c)
+    {
+        Core::Matrix scaled(a.rows(), a.cols());
+        for (size_t i = 0; i < a.size(); ++i)
+            scaled.data()[i] = a.data()[i] * 2.f;
+        Core::Matrix sum(a.rows(), a.cols());
+        for (size_t i = 0; i < a.size(); ++i)
+            sum.data()[i] = scaled.data()[i] + b.data()[i];
+        Core::Matrix rslt(a.rows(), a.cols());
+        for (size_t i = 0; i < a.size(); ++i)
+            rslt.data()[i] = sum.data()[i] - c.data()[i];
+        return rslt;
+    }
+
+    template <typename F>
+    void run(const char *name, size_t iterations, F &&f)
+    {
+        size_t before = allocations;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+            f();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        printf("%-28s %10.3f ms %8.2f allocations/iteration\n", name, ms,
+               static_cast<double>(allocations - before) / iterations);
+    }
+}
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+int main()
+{
+    const size_t sizes[] = {4, 64, 512};
+    for (size_t n : sizes)
+    {
+        Core::Matrix a = random_matrix(n, n);
+        Core::Matrix b = random_matrix(n, n);
+        Core::Matrix c = random_matrix(n, n);
+        Core::Matrix r(n, n);
+        const size_t iterations = n <= 4 ? 1000000 : (n <= 64 ? 20000 : 200);
+
+        printf("%zux%zu, %zu iterations\n", n, n, iterations);
+        run("eager temporaries", iterations, [&]
+            { r = eager(a, b, c); });
+        run("expression, new matrix", iterations, [&]
+            { Core::Matrix t = a * 2.f + b - c; r = std::move(t); });
+        run("expression, into r", iterations, [&]
+            { r = a * 2.f + b - c; });
+        run("expression, compound", iterations, [&]
+            { r += a * 2.f - c; });
+    }
+    return 0;
+}
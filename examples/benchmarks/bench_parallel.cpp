@@ -0,0 +1,102 @@
+// Core::Parallel against the serial standard algorithms, from 1K to 100M
+// elements: reduce, inclusive_scan, partition, merge_sort and radix_sort on
+// 32 bit keys with 32 bit payloads and on 64 bit keys.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "parallel.h"
+
+namespace
+{
+    template <typename F>
+    double seconds(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const char *name, size_t count, double serial, double parallel)
+    {
+        printf("  %-22s %10.1f  %10.1f Melements/s  x%.2f\n", name, count / serial * 1e-6, count / parallel * 1e-6, serial / parallel);
+    }
+}
+
+// usage: bench_parallel [max elements] [threads]
+int main(int argc, char **argv)
+{
+    const size_t max_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000000;
+    Core::Jobs::init(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0);
+    printf("threads: %zu, columns: std, Core::Parallel\n", Core::Jobs::get_worker_count() + 1);
+
+    std::mt19937_64 gen(1);
+    for (size_t count = 1000; count <= max_count; count *= 10)
+    {
+        printf("%zu elements\n", count);
+        std::vector<uint32_t> keys(count), payload(count), work(count), work_payload(count), out(count);
+        for (auto &k : keys)
+            k = static_cast<uint32_t>(gen());
+        std::iota(payload.begin(), payload.end(), 0);
+
+        volatile uint64_t sink = 0;
+        std::vector<uint64_t> wide(keys.begin(), keys.end());
+        const double reduce_std = seconds([&]
+                                          { sink = std::accumulate(wide.begin(), wide.end(), uint64_t(0)); });
+        const double reduce_par = seconds([&]
+                                          { sink = Core::Parallel::reduce(wide.data(), count); });
+        report("reduce", count, reduce_std, reduce_par);
+
+        const double scan_std = seconds([&]
+                                        { std::partial_sum(keys.begin(), keys.end(), out.begin()); });
+        const double scan_par = seconds([&]
+                                        { Core::Parallel::inclusive_scan(keys.data(), out.data(), count); });
+        report("inclusive_scan", count, scan_std, scan_par);
+
+        auto even = [](uint32_t k)
+        { return (k & 1) == 0; };
+        work = keys;
+        const double partition_std = seconds([&]
+                                             { std::stable_partition(work.begin(), work.end(), even); });
+        work = keys;
+        const double partition_par = seconds([&]
+                                             { Core::Parallel::partition(work.data(), count, even); });
+        report("partition (stable)", count, partition_std, partition_par);
+
+        work = keys;
+        const double sort_std = seconds([&]
+                                        { std::stable_sort(work.begin(), work.end()); });
+        work = keys;
+        const double sort_par = seconds([&]
+                                        { Core::Parallel::merge_sort(work.data(), count); });
+        report("merge_sort", count, sort_std, sort_par);
+
+        // draw key style: sort indices by key
+        std::vector<std::pair<uint32_t, uint32_t>> pairs(count);
+        for (size_t i = 0; i < count; ++i)
+            pairs[i] = {keys[i], payload[i]};
+        const double pairs_std = seconds([&]
+                                         { std::sort(pairs.begin(), pairs.end()); });
+        work = keys;
+        work_payload = payload;
+        const double radix32 = seconds([&]
+                                       { Core::Parallel::radix_sort(work.data(), work_payload.data(), count); });
+        report("radix_sort 32 + payload", count, pairs_std, radix32);
+
+        std::vector<uint64_t> keys64(count);
+        for (auto &k : keys64)
+            k = gen();
+        auto work64 = keys64;
+        const double sort64_std = seconds([&]
+                                          { std::sort(work64.begin(), work64.end()); });
+        work64 = keys64;
+        const double radix64 = seconds([&]
+                                       { Core::Parallel::radix_sort(work64.data(), count); });
+        report("radix_sort 64", count, sort64_std, radix64);
+    }
+    return 0;
+}
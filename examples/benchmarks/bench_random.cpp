@@ -0,0 +1,61 @@
+// Millions of floats per second from the old per-call generator (function-local
+// std::mt19937 plus a distribution per call) against the Philox bulk fills.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "math/random.h"
+
+namespace
+{
+    template <typename F>
+    double seconds(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // what Math::random<float>() used to do
+    float old_random(float min, float max)
+    {
+        static std::mt19937 gen(0);
+        std::uniform_real_distribution<float> dis(min, max);
+        return dis(gen);
+    }
+
+    void report(const char *name, size_t count, double t)
+    {
+        printf("%-26s %10.1f M/s\n", name, count / t * 1e-6);
+    }
+}
+
+// usage: bench_random [count] [threads]
+int main(int argc, char **argv)
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16000000;
+    if (argc > 2)
+        Core::Math::set_random_threads(std::strtoul(argv[2], nullptr, 10));
+    printf("count: %zu, threads: %zu\n", count, Core::Math::get_random_threads());
+
+    std::vector<float> out(count);
+    std::vector<Core::Vec3> dirs(count / 4);
+    Core::Math::Philox gen(1);
+
+    report("mt19937 per call", count, seconds([&]
+                                               {
+        for (auto &v : out)
+            v = old_random(0.f, 1.f); }));
+    report("Philox per call", count, seconds([&]
+                                              {
+        for (auto &v : out)
+            v = gen.uniform(); }));
+    report("fill_uniform", count, seconds([&]
+                                           { gen.fill_uniform(out.data(), count); }));
+    report("fill_normal", count, seconds([&]
+                                          { gen.fill_normal(out.data(), count); }));
+    report("fill_unit_sphere", dirs.size(), seconds([&]
+                                                     { gen.fill_unit_sphere(dirs.data(), dirs.size()); }));
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Lookups into a sorted uint32_t table from 1K to 16M keys: std::lower_bound
+// against Core::Search::lower_bound, the Eytzinger layout and the batched
+// overloads of both. Reports million lookups per second.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "search.h"
+
+namespace
+{
+    template <typename F>
+    double seconds(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const char *name, size_t lookups, double time, double baseline)
+    {
+        printf("  %-22s %10.1f Mlookups/s  x%.2f\n", name, lookups / time * 1e-6, baseline / time);
+    }
+}
+
+// usage: bench_search [max table size] [lookups] [threads]
+int main(int argc, char **argv)
+{
+    const size_t max_size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (size_t(1) << 24);
+    const size_t lookups = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4000000;
+    Core::Jobs::init(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0);
+    printf("threads: %zu, %zu lookups per table\n", Core::Jobs::get_worker_count() + 1, lookups);
+
+    std::mt19937 gen(1);
+    std::vector<uint32_t> keys(lookups);
+    std::vector<size_t> out(lookups);
+    for (size_t size = 1024; size <= max_size; size *= 4)
+    {
+        printf("%zu keys\n", size);
+        std::vector<uint32_t> data(size);
+        for (auto &k : data)
+            k = gen();
+        std::sort(data.begin(), data.end());
+        for (auto &k : keys)
+            k = gen();
+        const Core::Search::Eytzinger<uint32_t> tree(data.data(), size);
+
+        // every lookup feeds a checksum that is printed on a mismatch, so none of them can be dropped
+        size_t sum = 0;
+        const double std_time = seconds([&]
+                                        { for (auto k : keys) sum += std::lower_bound(data.begin(), data.end(), k) - data.begin(); });
+        report("std::lower_bound", lookups, std_time, std_time);
+
+        const size_t expected = sum;
+        auto check = [&]
+        {
+            if (sum != expected)
+                printf("  mismatch: %zu != %zu\n", sum, expected);
+        };
+        sum = 0;
+        const double branchless = seconds([&]
+                                          { for (auto k : keys) sum += Core::Search::lower_bound(data.data(), size, k); });
+        report("Search::lower_bound", lookups, branchless, std_time);
+        check();
+
+        sum = 0;
+        const double eytzinger = seconds([&]
+                                         { for (auto k : keys) sum += tree.lower_bound(k); });
+        report("Eytzinger", lookups, eytzinger, std_time);
+        check();
+
+        const double batched = seconds([&]
+                                       { Core::Search::lower_bound(data.data(), size, keys.data(), lookups, out.data()); });
+        report("batched lower_bound", lookups, batched, std_time);
+
+        const double batched_tree = seconds([&]
+                                            { tree.lower_bound(keys.data(), lookups, out.data()); });
+        report("batched Eytzinger", lookups, batched_tree, std_time);
+
+        sum = 0;
+        for (auto i : out)
+            sum += i;
+        check();
+    }
+    return 0;
+}
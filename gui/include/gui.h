@@ -8,5 +8,7 @@
 #include "../src/shader.h"
 #include "../src/texture.h"
 #include "../src/camera.h"
+#include "../src/render_queue.h"
+#include "../src/mesh_buffer.h"
 
 #endif // !GUI_H
\ No newline at end of file
@@ -20,6 +20,17 @@ namespace GUI
     void Application::init()
     {
         this->settings.load_from_file(settings.path);
+        if (!this->settings.log_file.empty())
+        {
+            try
+            {
+                Log::get().logger.open_file(this->settings.log_file);
+            }
+            catch (const std::exception &e)
+            {
+                Log::get().error(e.what());
+            }
+        }
         this->load_layout(this->settings.ini_file);
         Rendering::shader_program_factory.add_shader_from_file("./shaders/blinn-phong.vert", GL_VERTEX_SHADER, "blinn-phong_vertex");
         Rendering::shader_program_factory.add_shader_from_file("./shaders/blinn-phong.frag", GL_FRAGMENT_SHADER, "blinn-phong_fragment");
@@ -73,6 +84,8 @@ namespace GUI
         auto w = std::unique_ptr<Sample_OGL_Widget>(new Sample_OGL_Widget("OpenGL Window", 0, 0, 800, 600, true));
         this->ogl_widget_test = std::move(w);
         this->log_widget = std::unique_ptr<Log_Widget>(new Log_Widget("Log", 0, 0, 800, 600, true));
+        this->profiler_widget = std::unique_ptr<Profiler_Widget>(new Profiler_Widget("Profiler", 0, 0, 800, 600, true));
+        this->gl_stats_widget = std::unique_ptr<GL_Stats_Widget>(new GL_Stats_Widget("GL Stats", 0, 0, 400, 600, true));
         this->settings_widget = std::unique_ptr<UI_Settings_Widget>(new UI_Settings_Widget("Settings", 0, 0, 800, 600, true));
 
         // this->text_widget = std::unique_ptr<Text_Widget>(new Text_Widget("Text", 0, 0, 800, 600, true));
@@ -90,7 +103,7 @@ namespace GUI
 
     void Application::run(bool maximized)
     {
-
+        CORE_PROFILE_SCOPE("Application::run");
         // ImGui::ShowDemoWindow();
         settings_widget->show();
         if (settings.show_OpenGL_window)
@@ -108,6 +121,16 @@ namespace GUI
         {
             log_widget->show();
         }
+
+        if (settings.show_Profiler_window)
+        {
+            profiler_widget->show();
+        }
+
+        if (settings.show_GL_Stats_window)
+        {
+            gl_stats_widget->show();
+        }
     }
 
     void Application::destroy()
@@ -21,6 +21,8 @@ namespace GUI
         UI_Settings settings;
         Sample_OGL_Widget_Ptr ogl_widget_test;
         Log_Widget_Ptr log_widget;
+        Profiler_Widget_Ptr profiler_widget;
+        GL_Stats_Widget_Ptr gl_stats_widget;
         UI_Settings_Widget_Ptr settings_widget;
         // IMGWidget_Ptr text_widget;
         Properties_Widget_Ptr properties_Widget;
@@ -12,7 +12,7 @@ namespace Rendering
         init();
     }
 
-    Camera::Camera(const Core::Vector3 &position)
+    Camera::Camera(const Core::Vec3 &position)
         : Configurable("Camera"),
           transform(Core::Transform_Ptr(new Core::Transform(position))),
           properties(Properties())
@@ -54,28 +54,28 @@ namespace Rendering
         }
     }
 
-    void Camera::move(Core::Vector3 direction, float distance)
+    void Camera::move(Core::Vec3 direction, float distance)
     {
         transform->translate(direction * distance);
     }
 
-    Core::Matrix4 Camera::get_view_matrix()
+    Core::Mat4 Camera::get_view_matrix()
     {
-        Core::Vector3 pos = transform->get_position();
-        Core::Vector3 front = transform->get_front();
-        Core::Vector3 up = transform->get_up();
-        Core::Vector3 center = pos + front * properties.focus_distance;
+        Core::Vec3 pos = transform->get_position();
+        Core::Vec3 front = transform->get_front();
+        Core::Vec3 up = transform->get_up();
+        Core::Vec3 center = pos + front * properties.focus_distance;
         return Core::Geometry::look_at(pos, center, up);
     }
 
-    Core::Vector3 Camera::get_position() const
+    Core::Vec3 Camera::get_position() const
     {
         return transform->get_position();
     }
 
-    void Camera::focus_on(Core::Vector3 target, Core::Vector3 up)
+    void Camera::focus_on(Core::Vec3 target, Core::Vec3 up)
     {
-        Core::Vector3 front = Core::Geometry::normalize(target - transform->get_position());
+        Core::Vec3 front = Core::Geometry::normalize(target - transform->get_position());
         up = Core::Geometry::normalize(up);
         transform->look_at(-front, up);
         properties.focus_distance = Core::Geometry::distance(target, transform->get_position());
@@ -48,7 +48,7 @@ namespace Rendering
         // constructors and destructor
     public:
         Camera();
-        Camera(const Core::Vector3 &position);
+        Camera(const Core::Vec3 &position);
         Camera(const Camera &camera) : Configurable(camera.name),
                                        transform(Core::Transform_Ptr(new Core::Transform(*camera.transform))), properties(Properties())
         {
@@ -74,14 +74,14 @@ namespace Rendering
         // methods
     public:
         void move(CameraMovement direction, float distance);
-        void move(Core::Vector3 direction, float distance);
-        Core::Matrix4 get_view_matrix();
-        Core::Vector3 get_position() const;
-        Core::Vector3 get_up() const { return transform->get_up(); }
-        Core::Vector3 get_front() const { return transform->get_front(); }
-        Core::Vector3 get_right() const { return transform->get_right(); }
-        Core::Vector3 get_focus() const { return transform->get_position() + transform->get_front() * properties.focus_distance; }
-        void focus_on(Core::Vector3 position, Core::Vector3 up = Core::Vector3(0.0f, 1.0f, 0.0f));
+        void move(Core::Vec3 direction, float distance);
+        Core::Mat4 get_view_matrix();
+        Core::Vec3 get_position() const;
+        Core::Vec3 get_up() const { return transform->get_up(); }
+        Core::Vec3 get_front() const { return transform->get_front(); }
+        Core::Vec3 get_right() const { return transform->get_right(); }
+        Core::Vec3 get_focus() const { return transform->get_position() + transform->get_front() * properties.focus_distance; }
+        void focus_on(Core::Vec3 position, Core::Vec3 up = Core::Vec3(0.0f, 1.0f, 0.0f));
 
         void init();
     };
@@ -1,24 +1,26 @@
 #include "fbo.h"
 #include <iostream>
 #include "math/base.h"
+#include "gl_state.h"
 namespace Rendering
 {
     void FBO::destroy()
     {
         if (this->id)
         {
+            GL_State::instance().forget_framebuffer(this->id);
             glDeleteFramebuffers(1, &this->id);
         }
     }
 
     void FBO::bind()
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, this->id);
+        GL_State::instance().bind_framebuffer(GL_FRAMEBUFFER, this->id);
     }
 
     void FBO::unbind()
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GL_State::instance().bind_framebuffer(GL_FRAMEBUFFER, 0);
     }
 
     void FBO::resize(unsigned int width, unsigned int height)
@@ -132,7 +134,7 @@ namespace Rendering
     void FBO::clear()
     {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-        glViewport(0, 0, this->width, this->height);
+        GL_State::instance().viewport_rect(0, 0, this->width, this->height);
     }
 
     Texture *FBO::get_color_attachment(unsigned int index)
@@ -0,0 +1,70 @@
+#include "gl_extensions.h"
+#include <cstring>
+
+#ifndef GL_VERSION_4_2
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC glad_glDrawElementsInstancedBaseVertexBaseInstance = nullptr;
+#endif
+#ifndef GL_VERSION_4_3
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect = nullptr;
+#endif
+
+namespace Rendering
+{
+    namespace
+    {
+        bool has_extension(const char *name)
+        {
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            for (GLint i = 0; i < count; ++i)
+            {
+                const char *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+                if (extension && std::strcmp(extension, name) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool base_instance = false;
+        bool multi_draw_indirect = false;
+    }
+
+    namespace GL_Extensions
+    {
+        void load(GLADloadproc loader)
+        {
+            GLint major = 0, minor = 0;
+            glGetIntegerv(GL_MAJOR_VERSION, &major);
+            glGetIntegerv(GL_MINOR_VERSION, &minor);
+            const int version = major * 10 + minor;
+
+            glad_glDrawElementsInstancedBaseVertexBaseInstance = nullptr;
+            glad_glMultiDrawElementsIndirect = nullptr;
+            if (version >= 42 || has_extension("GL_ARB_base_instance"))
+            {
+                glad_glDrawElementsInstancedBaseVertexBaseInstance =
+                    reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC>(loader("glDrawElementsInstancedBaseVertexBaseInstance"));
+            }
+            base_instance = glad_glDrawElementsInstancedBaseVertexBaseInstance != nullptr;
+            // the commands carry a base instance, without it the extension reads it as 0
+            if (base_instance && (version >= 43 || has_extension("GL_ARB_multi_draw_indirect")))
+            {
+                glad_glMultiDrawElementsIndirect =
+                    reinterpret_cast<PFNGLMULTIDRAWELEMENTSINDIRECTPROC>(loader("glMultiDrawElementsIndirect"));
+            }
+            multi_draw_indirect = glad_glMultiDrawElementsIndirect != nullptr;
+        }
+
+        bool has_base_instance()
+        {
+            return base_instance;
+        }
+
+        bool has_multi_draw_indirect()
+        {
+            return multi_draw_indirect;
+        }
+    }
+} // namespace Rendering
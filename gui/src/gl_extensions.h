@@ -0,0 +1,38 @@
+#pragma once
+#ifndef RENDERING_GL_EXTENSIONS_H
+#define RENDERING_GL_EXTENSIONS_H
+
+#include <glad/glad.h>
+
+// Entry points past the GL 3.3 core that glad is generated for. They are
+// declared the way glad declares its own, so call sites and GL_Stats treat
+// them alike, and stay null until GL_Extensions::load finds them.
+#ifndef GL_VERSION_4_2
+typedef void(APIENTRYP PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex, GLuint baseinstance);
+extern PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC glad_glDrawElementsInstancedBaseVertexBaseInstance;
+#define glDrawElementsInstancedBaseVertexBaseInstance glad_glDrawElementsInstancedBaseVertexBaseInstance
+#endif
+
+#ifndef GL_VERSION_4_3
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+typedef void(APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride);
+extern PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect glad_glMultiDrawElementsIndirect
+#endif
+
+namespace Rendering
+{
+    // What the context offers beyond GL 3.3, found from its version and
+    // extension strings. load() runs once after gladLoadGLLoader, with the
+    // same loader (glfwGetProcAddress).
+    namespace GL_Extensions
+    {
+        void load(GLADloadproc loader);
+        // GL 4.2 or ARB_base_instance: draws offset instanced attributes by baseinstance
+        bool has_base_instance();
+        // GL 4.3 or ARB_multi_draw_indirect (with base instance): one call for many draws
+        bool has_multi_draw_indirect();
+    }
+} // namespace Rendering
+
+#endif // RENDERING_GL_EXTENSIONS_H
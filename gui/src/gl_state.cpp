@@ -0,0 +1,584 @@
+#include "gl_state.h"
+#include <string>
+#include "ui_log.h"
+
+namespace Rendering
+{
+    GL_State::GL_State()
+    {
+        invalidate();
+    }
+
+    void GL_State::use_program(GLuint program)
+    {
+        if (debug)
+        {
+            check_program();
+        }
+        if (same(this->program, program))
+        {
+            return;
+        }
+        glUseProgram(program);
+        this->program = program;
+    }
+
+    void GL_State::bind_vertex_array(GLuint vao)
+    {
+        if (debug)
+        {
+            check_vertex_array();
+        }
+        if (same(this->vao, vao))
+        {
+            return;
+        }
+        glBindVertexArray(vao);
+        this->vao = vao;
+    }
+
+    void GL_State::bind_framebuffer(GLenum target, GLuint framebuffer)
+    {
+        if (debug)
+        {
+            check_framebuffers();
+        }
+        if (target == GL_FRAMEBUFFER)
+        {
+            if (same(draw_framebuffer == read_framebuffer ? draw_framebuffer : UNKNOWN, framebuffer))
+            {
+                return;
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            draw_framebuffer = read_framebuffer = framebuffer;
+            return;
+        }
+        GLuint &cached = target == GL_READ_FRAMEBUFFER ? read_framebuffer : draw_framebuffer;
+        if (same(cached, framebuffer))
+        {
+            return;
+        }
+        glBindFramebuffer(target, framebuffer);
+        cached = framebuffer;
+    }
+
+    void GL_State::active_texture(GLuint unit)
+    {
+        if (debug)
+        {
+            check_active_texture();
+        }
+        if (same(active_unit, unit))
+        {
+            return;
+        }
+        glActiveTexture(GL_TEXTURE0 + unit);
+        active_unit = unit;
+    }
+
+    void GL_State::bind_texture(GLenum target, GLuint texture)
+    {
+        const int index = target_index(target);
+        if (index < 0 || active_unit >= MAX_TEXTURE_UNITS)
+        {
+            ++issued;
+            glBindTexture(target, texture);
+            return;
+        }
+        if (debug)
+        {
+            check_texture(active_unit, index);
+        }
+        GLuint &cached = units[active_unit].textures[index];
+        if (same(cached, texture))
+        {
+            return;
+        }
+        glBindTexture(target, texture);
+        cached = texture;
+    }
+
+    void GL_State::bind_texture(GLuint unit, GLenum target, GLuint texture)
+    {
+        const int index = target_index(target);
+        if (index >= 0 && unit < MAX_TEXTURE_UNITS)
+        {
+            if (debug)
+            {
+                check_texture(unit, index);
+            }
+            if (units[unit].textures[index] == texture)
+            {
+                ++skipped;
+                return;
+            }
+        }
+        active_texture(unit);
+        bind_texture(target, texture);
+    }
+
+    void GL_State::bind_sampler(GLuint unit, GLuint sampler)
+    {
+        if (unit >= MAX_TEXTURE_UNITS)
+        {
+            ++issued;
+            glBindSampler(unit, sampler);
+            return;
+        }
+        if (debug)
+        {
+            check_sampler(unit);
+        }
+        if (same(units[unit].sampler, sampler))
+        {
+            return;
+        }
+        glBindSampler(unit, sampler);
+        units[unit].sampler = sampler;
+    }
+
+    void GL_State::bind_uniform_buffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size)
+    {
+        if (binding < MAX_UNIFORM_BINDINGS)
+        {
+            if (debug)
+            {
+                check_uniform_buffer(binding);
+            }
+            Buffer_Range &cached = uniform_buffers[binding];
+            if (cached.buffer == buffer && cached.offset == offset && cached.size == size)
+            {
+                ++skipped;
+                return;
+            }
+            cached = {buffer, offset, size};
+        }
+        ++issued;
+        if (size == 0)
+        {
+            glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+        }
+        else
+        {
+            glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size);
+        }
+    }
+
+    void GL_State::viewport_rect(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (debug)
+        {
+            check_viewport();
+        }
+        if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+        {
+            ++skipped;
+            return;
+        }
+        ++issued;
+        glViewport(x, y, width, height);
+        viewport[0] = x;
+        viewport[1] = y;
+        viewport[2] = width;
+        viewport[3] = height;
+    }
+
+    void GL_State::set_capability(GLenum capability, bool enabled)
+    {
+        if (debug)
+        {
+            check_capability(capability);
+        }
+        auto it = capabilities.find(capability);
+        if (it != capabilities.end() && it->second == enabled)
+        {
+            ++skipped;
+            return;
+        }
+        ++issued;
+        if (enabled)
+        {
+            glEnable(capability);
+        }
+        else
+        {
+            glDisable(capability);
+        }
+        capabilities[capability] = enabled;
+    }
+
+    void GL_State::cull_face(GLenum mode)
+    {
+        if (debug)
+        {
+            check_cull_face();
+        }
+        if (same(cull_face_mode, mode))
+        {
+            return;
+        }
+        glCullFace(mode);
+        cull_face_mode = mode;
+    }
+
+    void GL_State::depth_func(GLenum func)
+    {
+        if (debug)
+        {
+            check_depth_func();
+        }
+        if (same(depth_func_mode, func))
+        {
+            return;
+        }
+        glDepthFunc(func);
+        depth_func_mode = func;
+    }
+
+    void GL_State::blend_func(GLenum source, GLenum destination)
+    {
+        if (debug)
+        {
+            check_blend_func();
+        }
+        if (blend_source == source && blend_destination == destination)
+        {
+            ++skipped;
+            return;
+        }
+        ++issued;
+        glBlendFunc(source, destination);
+        blend_source = source;
+        blend_destination = destination;
+    }
+
+    void GL_State::forget_program(GLuint program)
+    {
+        if (this->program == program)
+        {
+            this->program = 0;
+        }
+    }
+
+    void GL_State::forget_vertex_array(GLuint vao)
+    {
+        if (this->vao == vao)
+        {
+            this->vao = 0;
+        }
+    }
+
+    void GL_State::forget_framebuffer(GLuint framebuffer)
+    {
+        if (draw_framebuffer == framebuffer)
+        {
+            draw_framebuffer = 0;
+        }
+        if (read_framebuffer == framebuffer)
+        {
+            read_framebuffer = 0;
+        }
+    }
+
+    void GL_State::forget_texture(GLuint texture)
+    {
+        for (auto &unit : units)
+        {
+            for (auto &bound : unit.textures)
+            {
+                if (bound == texture)
+                {
+                    bound = 0;
+                }
+            }
+        }
+    }
+
+    void GL_State::forget_sampler(GLuint sampler)
+    {
+        for (auto &unit : units)
+        {
+            if (unit.sampler == sampler)
+            {
+                unit.sampler = 0;
+            }
+        }
+    }
+
+    void GL_State::forget_buffer(GLuint buffer)
+    {
+        for (auto &bound : uniform_buffers)
+        {
+            if (bound.buffer == buffer)
+            {
+                bound = {0, 0, 0};
+            }
+        }
+    }
+
+    void GL_State::invalidate()
+    {
+        program = vao = UNKNOWN;
+        draw_framebuffer = read_framebuffer = UNKNOWN;
+        active_unit = UNKNOWN;
+        for (auto &unit : units)
+        {
+            for (auto &bound : unit.textures)
+            {
+                bound = UNKNOWN;
+            }
+            unit.sampler = UNKNOWN;
+        }
+        for (auto &bound : uniform_buffers)
+        {
+            bound = {UNKNOWN, 0, 0};
+        }
+        viewport[0] = viewport[1] = viewport[3] = 0;
+        viewport[2] = -1;
+        cull_face_mode = depth_func_mode = UNKNOWN;
+        blend_source = blend_destination = UNKNOWN;
+        capabilities.clear();
+    }
+
+    bool GL_State::validate()
+    {
+        bool rslt = check_program();
+        rslt &= check_vertex_array();
+        rslt &= check_framebuffers();
+        rslt &= check_active_texture();
+        for (GLuint unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+        {
+            for (int index = 0; index < TARGET_COUNT; ++index)
+            {
+                if (units[unit].textures[index] != UNKNOWN)
+                {
+                    rslt &= check_texture(unit, index);
+                }
+            }
+            if (units[unit].sampler != UNKNOWN)
+            {
+                rslt &= check_sampler(unit);
+            }
+        }
+        for (GLuint binding = 0; binding < MAX_UNIFORM_BINDINGS; ++binding)
+        {
+            rslt &= check_uniform_buffer(binding);
+        }
+        rslt &= check_viewport();
+        for (const auto &capability : capabilities)
+        {
+            rslt &= check_capability(capability.first);
+        }
+        rslt &= check_cull_face();
+        rslt &= check_depth_func();
+        rslt &= check_blend_func();
+        return rslt;
+    }
+
+    GL_State &GL_State::instance()
+    {
+        static GL_State state;
+        return state;
+    }
+
+    int GL_State::target_index(GLenum target)
+    {
+        switch (target)
+        {
+        case GL_TEXTURE_1D:
+            return TEXTURE_1D;
+        case GL_TEXTURE_2D:
+            return TEXTURE_2D;
+        case GL_TEXTURE_3D:
+            return TEXTURE_3D;
+        case GL_TEXTURE_CUBE_MAP:
+            return TEXTURE_CUBE_MAP;
+        case GL_TEXTURE_2D_ARRAY:
+            return TEXTURE_2D_ARRAY;
+        case GL_TEXTURE_2D_MULTISAMPLE:
+            return TEXTURE_2D_MULTISAMPLE;
+        default:
+            return -1;
+        }
+    }
+
+    GLenum GL_State::target_binding(int index)
+    {
+        static const GLenum bindings[TARGET_COUNT] = {
+            GL_TEXTURE_BINDING_1D,
+            GL_TEXTURE_BINDING_2D,
+            GL_TEXTURE_BINDING_3D,
+            GL_TEXTURE_BINDING_CUBE_MAP,
+            GL_TEXTURE_BINDING_2D_ARRAY,
+            GL_TEXTURE_BINDING_2D_MULTISAMPLE,
+        };
+        return bindings[index];
+    }
+
+    bool GL_State::same(GLuint cached, GLuint value)
+    {
+        if (cached == value)
+        {
+            ++skipped;
+            return true;
+        }
+        ++issued;
+        return false;
+    }
+
+    bool GL_State::check(const char *what, GLuint &cached, GLint actual)
+    {
+        if (cached == UNKNOWN || cached == static_cast<GLuint>(actual))
+        {
+            return true;
+        }
+        GUI::Log::get().warn(std::string("GL_State: ") + what + " is " + std::to_string(actual) + ", the cache had " + std::to_string(cached));
+        cached = static_cast<GLuint>(actual);
+        return false;
+    }
+
+    bool GL_State::check_program()
+    {
+        GLint actual = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &actual);
+        return check("program", program, actual);
+    }
+
+    bool GL_State::check_vertex_array()
+    {
+        GLint actual = 0;
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &actual);
+        return check("vertex array", vao, actual);
+    }
+
+    bool GL_State::check_framebuffers()
+    {
+        GLint draw = 0, read = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw);
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read);
+        const bool draw_ok = check("draw framebuffer", draw_framebuffer, draw);
+        return check("read framebuffer", read_framebuffer, read) && draw_ok;
+    }
+
+    bool GL_State::check_active_texture()
+    {
+        GLint actual = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &actual);
+        return check("active texture unit", active_unit, actual - GL_TEXTURE0);
+    }
+
+    bool GL_State::check_texture(GLuint unit, int target)
+    {
+        const std::string what = "texture " + std::to_string(target) + " of unit " + std::to_string(unit);
+        return check(what.c_str(), units[unit].textures[target], query_unit(unit, target_binding(target)));
+    }
+
+    bool GL_State::check_sampler(GLuint unit)
+    {
+        const std::string what = "sampler of unit " + std::to_string(unit);
+        return check(what.c_str(), units[unit].sampler, query_unit(unit, GL_SAMPLER_BINDING));
+    }
+
+    bool GL_State::check_uniform_buffer(GLuint binding)
+    {
+        Buffer_Range &cached = uniform_buffers[binding];
+        if (cached.buffer == UNKNOWN)
+        {
+            return true;
+        }
+        GLint buffer = 0;
+        GLint64 offset = 0, size = 0;
+        glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, binding, &buffer);
+        glGetInteger64i_v(GL_UNIFORM_BUFFER_START, binding, &offset);
+        glGetInteger64i_v(GL_UNIFORM_BUFFER_SIZE, binding, &size);
+        if (cached.buffer == static_cast<GLuint>(buffer) && cached.offset == offset && cached.size == size)
+        {
+            return true;
+        }
+        GUI::Log::get().warn("GL_State: uniform binding " + std::to_string(binding) + " is buffer " + std::to_string(buffer) + " at " + std::to_string(offset) +
+                             ", the cache had buffer " + std::to_string(cached.buffer) + " at " + std::to_string(cached.offset));
+        cached = {static_cast<GLuint>(buffer), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size)};
+        return false;
+    }
+
+    bool GL_State::check_viewport()
+    {
+        if (viewport[2] < 0)
+        {
+            return true;
+        }
+        GLint actual[4] = {0, 0, 0, 0};
+        glGetIntegerv(GL_VIEWPORT, actual);
+        if (actual[0] == viewport[0] && actual[1] == viewport[1] && actual[2] == viewport[2] && actual[3] == viewport[3])
+        {
+            return true;
+        }
+        GUI::Log::get().warn("GL_State: viewport is " + std::to_string(actual[2]) + "x" + std::to_string(actual[3]) +
+                             ", the cache had " + std::to_string(viewport[2]) + "x" + std::to_string(viewport[3]));
+        for (int i = 0; i < 4; ++i)
+        {
+            viewport[i] = actual[i];
+        }
+        return false;
+    }
+
+    bool GL_State::check_capability(GLenum capability)
+    {
+        auto it = capabilities.find(capability);
+        if (it == capabilities.end())
+        {
+            return true;
+        }
+        const bool actual = glIsEnabled(capability) == GL_TRUE;
+        if (actual == it->second)
+        {
+            return true;
+        }
+        GUI::Log::get().warn("GL_State: capability " + std::to_string(capability) + (actual ? " is enabled" : " is disabled") + ", the cache had it the other way");
+        it->second = actual;
+        return false;
+    }
+
+    bool GL_State::check_cull_face()
+    {
+        GLint actual = 0;
+        glGetIntegerv(GL_CULL_FACE_MODE, &actual);
+        return check("cull face", cull_face_mode, actual);
+    }
+
+    bool GL_State::check_depth_func()
+    {
+        GLint actual = 0;
+        glGetIntegerv(GL_DEPTH_FUNC, &actual);
+        return check("depth func", depth_func_mode, actual);
+    }
+
+    bool GL_State::check_blend_func()
+    {
+        GLint source = 0, destination = 0, source_alpha = 0, destination_alpha = 0;
+        glGetIntegerv(GL_BLEND_SRC_RGB, &source);
+        glGetIntegerv(GL_BLEND_DST_RGB, &destination);
+        glGetIntegerv(GL_BLEND_SRC_ALPHA, &source_alpha);
+        glGetIntegerv(GL_BLEND_DST_ALPHA, &destination_alpha);
+        // glBlendFunc sets both, separate functions can not be cached as one
+        if (blend_source != UNKNOWN && (source != source_alpha || destination != destination_alpha))
+        {
+            GUI::Log::get().warn("GL_State: blend functions are separate, the cache had them equal");
+            blend_source = blend_destination = UNKNOWN;
+            return false;
+        }
+        const bool source_ok = check("blend source", blend_source, source);
+        return check("blend destination", blend_destination, destination) && source_ok;
+    }
+
+    GLint GL_State::query_unit(GLuint unit, GLenum binding)
+    {
+        GLint active = GL_TEXTURE0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &active);
+        glActiveTexture(GL_TEXTURE0 + unit);
+        GLint rslt = 0;
+        glGetIntegerv(binding, &rslt);
+        glActiveTexture(static_cast<GLenum>(active));
+        return rslt;
+    }
+} // namespace Rendering
@@ -0,0 +1,156 @@
+#pragma once
+#ifndef RENDERING_GL_STATE_H
+#define RENDERING_GL_STATE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Rendering
+{
+    // Shadow of the GL state the renderer touches. Every setter compares with
+    // what it last set and only calls GL when the value changes, so the
+    // bind/unbind pairs around each draw collapse into the binds that matter.
+    // Unbinding programs, vertex arrays, textures and samplers is left to the
+    // next bind; framebuffers are really rebound since 0 is the window.
+    // Values start unknown (the first set always reaches GL) and go unknown
+    // again on invalidate(), which is needed after code that changes state
+    // behind the cache's back without restoring it. Objects must be
+    // forgotten when deleted, GL may hand their names out again. With debug
+    // on, each setter first checks the cache against glGet* and logs and
+    // repairs a mismatch. One context, main thread only.
+    class GL_State
+    {
+        // structures
+    public:
+        static constexpr GLuint UNKNOWN = 0xFFFFFFFFu;
+        // units past this are not cached, their binds always reach GL
+        static constexpr GLuint MAX_TEXTURE_UNITS = 32;
+        // uniform buffer bindings past this are not cached either
+        static constexpr GLuint MAX_UNIFORM_BINDINGS = 16;
+
+    private:
+        enum Texture_Target
+        {
+            TEXTURE_1D,
+            TEXTURE_2D,
+            TEXTURE_3D,
+            TEXTURE_CUBE_MAP,
+            TEXTURE_2D_ARRAY,
+            TEXTURE_2D_MULTISAMPLE,
+            TARGET_COUNT
+        };
+
+        struct Unit
+        {
+            GLuint textures[TARGET_COUNT];
+            GLuint sampler;
+        };
+
+        // a size of 0 is the whole buffer
+        struct Buffer_Range
+        {
+            GLuint buffer;
+            GLintptr offset;
+            GLsizeiptr size;
+        };
+
+        // attributes
+    private:
+        GLuint program = UNKNOWN;
+        GLuint vao = UNKNOWN;
+        GLuint draw_framebuffer = UNKNOWN;
+        GLuint read_framebuffer = UNKNOWN;
+        // index of the active unit, not GL_TEXTUREi
+        GLuint active_unit = UNKNOWN;
+        Unit units[MAX_TEXTURE_UNITS];
+        Buffer_Range uniform_buffers[MAX_UNIFORM_BINDINGS];
+        // x, y, width, height; a width of -1 is unknown
+        GLint viewport[4];
+        GLenum cull_face_mode = UNKNOWN;
+        GLenum depth_func_mode = UNKNOWN;
+        GLenum blend_source = UNKNOWN;
+        GLenum blend_destination = UNKNOWN;
+        // capability -> enabled, missing if unknown
+        std::unordered_map<GLenum, bool> capabilities;
+        bool debug = false;
+        uint64_t issued = 0;
+        uint64_t skipped = 0;
+
+        // constructors and deconstructor
+    public:
+        GL_State();
+        ~GL_State() = default;
+        GL_State(const GL_State &) = delete;
+        GL_State &operator=(const GL_State &) = delete;
+
+        // methods
+    public:
+        void use_program(GLuint program);
+        void bind_vertex_array(GLuint vao);
+        // GL_FRAMEBUFFER sets both the draw and the read binding
+        void bind_framebuffer(GLenum target, GLuint framebuffer);
+        // unit is an index, as passed to Texture::bind
+        void active_texture(GLuint unit);
+        // on the active unit
+        void bind_texture(GLenum target, GLuint texture);
+        // only switches the active unit if the binding changes
+        void bind_texture(GLuint unit, GLenum target, GLuint texture);
+        void bind_sampler(GLuint unit, GLuint sampler);
+        // glBindBufferRange, or glBindBufferBase for a size of 0; also binds GL_UNIFORM_BUFFER
+        void bind_uniform_buffer(GLuint binding, GLuint buffer, GLintptr offset = 0, GLsizeiptr size = 0);
+        void viewport_rect(GLint x, GLint y, GLsizei width, GLsizei height);
+        void enable(GLenum capability) { set_capability(capability, true); }
+        void disable(GLenum capability) { set_capability(capability, false); }
+        void set_capability(GLenum capability, bool enabled);
+        void cull_face(GLenum mode);
+        void depth_func(GLenum func);
+        void blend_func(GLenum source, GLenum destination);
+
+        // call right before the glDelete* of the object
+        void forget_program(GLuint program);
+        void forget_vertex_array(GLuint vao);
+        void forget_framebuffer(GLuint framebuffer);
+        void forget_texture(GLuint texture);
+        void forget_sampler(GLuint sampler);
+        void forget_buffer(GLuint buffer);
+
+        // everything unknown, the next set of each value reaches GL
+        void invalidate();
+        // compares every known value with glGet*, logs and repairs mismatches; false if there were any
+        bool validate();
+        void set_debug(bool debug) { this->debug = debug; }
+        bool is_debug() const { return debug; }
+        // calls that reached GL and calls the cache saved
+        uint64_t get_issued() const { return issued; }
+        uint64_t get_skipped() const { return skipped; }
+        void reset_counters() { issued = skipped = 0; }
+
+        static GL_State &instance();
+
+    private:
+        static int target_index(GLenum target);
+        static GLenum target_binding(int index);
+        // true if the cached value can be kept; counts either way
+        bool same(GLuint cached, GLuint value);
+        // the cached value against the one GL reports, repaired and logged if they differ
+        bool check(const char *what, GLuint &cached, GLint actual);
+        // one check per cached value; true if it matched or is unknown
+        bool check_program();
+        bool check_vertex_array();
+        bool check_framebuffers();
+        bool check_active_texture();
+        bool check_texture(GLuint unit, int target);
+        bool check_sampler(GLuint unit);
+        bool check_uniform_buffer(GLuint binding);
+        bool check_viewport();
+        bool check_capability(GLenum capability);
+        bool check_cull_face();
+        bool check_depth_func();
+        bool check_blend_func();
+        // the binding of a texture unit, with the active unit switched just for the query
+        GLint query_unit(GLuint unit, GLenum binding);
+    };
+} // namespace Rendering
+
+#endif // RENDERING_GL_STATE_H
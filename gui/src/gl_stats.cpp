@@ -0,0 +1,665 @@
+#include "gl_stats.h"
+#include "gl_extensions.h"
+#include <fstream>
+#include <stdexcept>
+#include "profiler.h"
+
+namespace Rendering
+{
+    namespace
+    {
+        // what a shadow entry tracks; the slot tells apart targets, units and capabilities
+        enum Kind : uint32_t
+        {
+            PROGRAM = 1,
+            VAO,
+            ACTIVE_TEXTURE,
+            TEXTURE, // slot: unit << 32 | target
+            BUFFER,
+            FRAMEBUFFER,
+            CAPABILITY,
+            CULL_FACE,
+            DEPTH_FUNC,
+            BLEND_FUNC,
+            VIEWPORT
+        };
+
+        // bytes of one pixel of a client side image
+        uint64_t pixel_size(GLenum format, GLenum type)
+        {
+            switch (type)
+            {
+            case GL_UNSIGNED_BYTE_3_3_2:
+            case GL_UNSIGNED_BYTE_2_3_3_REV:
+                return 1;
+            case GL_UNSIGNED_SHORT_5_6_5:
+            case GL_UNSIGNED_SHORT_5_6_5_REV:
+            case GL_UNSIGNED_SHORT_4_4_4_4:
+            case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+            case GL_UNSIGNED_SHORT_5_5_5_1:
+            case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+                return 2;
+            case GL_UNSIGNED_INT_8_8_8_8:
+            case GL_UNSIGNED_INT_8_8_8_8_REV:
+            case GL_UNSIGNED_INT_10_10_10_2:
+            case GL_UNSIGNED_INT_2_10_10_10_REV:
+            case GL_UNSIGNED_INT_24_8:
+            case GL_UNSIGNED_INT_10F_11F_11F_REV:
+            case GL_UNSIGNED_INT_5_9_9_9_REV:
+                return 4;
+            case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+                return 8;
+            default:
+                break;
+            }
+            uint64_t components = 4;
+            switch (format)
+            {
+            case GL_RED:
+            case GL_RED_INTEGER:
+            case GL_DEPTH_COMPONENT:
+            case GL_STENCIL_INDEX:
+                components = 1;
+                break;
+            case GL_RG:
+            case GL_RG_INTEGER:
+                components = 2;
+                break;
+            case GL_RGB:
+            case GL_BGR:
+            case GL_RGB_INTEGER:
+            case GL_BGR_INTEGER:
+                components = 3;
+                break;
+            default:
+                break;
+            }
+            switch (type)
+            {
+            case GL_UNSIGNED_BYTE:
+            case GL_BYTE:
+                return components;
+            case GL_UNSIGNED_SHORT:
+            case GL_SHORT:
+            case GL_HALF_FLOAT:
+                return components * 2;
+            default:
+                return components * 4;
+            }
+        }
+
+        uint64_t pack(uint32_t high, uint32_t low)
+        {
+            return (static_cast<uint64_t>(high) << 32) | low;
+        }
+    }
+
+#define GL_STATS_HOOKS(X)                                                                     \
+    X(DrawArrays)                                                                             \
+    X(DrawElements)                                                                           \
+    X(DrawArraysInstanced)                                                                    \
+    X(DrawElementsInstanced)                                                                  \
+    X(DrawElementsBaseVertex)                                                                 \
+    X(DrawElementsInstancedBaseVertex)                                                        \
+    X(DrawElementsInstancedBaseVertexBaseInstance)                                            \
+    X(MultiDrawElementsIndirect)                                                              \
+    X(UseProgram)                                                                             \
+    X(BindVertexArray)                                                                        \
+    X(ActiveTexture)                                                                          \
+    X(BindTexture)                                                                            \
+    X(BindBuffer)                                                                             \
+    X(BindBufferBase)                                                                         \
+    X(BindBufferRange)                                                                        \
+    X(BindFramebuffer)                                                                        \
+    X(Enable)                                                                                 \
+    X(Disable)                                                                                \
+    X(CullFace)                                                                               \
+    X(DepthFunc)                                                                              \
+    X(BlendFunc)                                                                              \
+    X(Viewport)                                                                               \
+    X(GetUniformLocation)                                                                     \
+    X(Uniform1i)                                                                              \
+    X(Uniform1f)                                                                              \
+    X(Uniform2f)                                                                              \
+    X(Uniform3f)                                                                              \
+    X(Uniform4f)                                                                              \
+    X(Uniform1iv)                                                                             \
+    X(Uniform1fv)                                                                             \
+    X(Uniform2fv)                                                                             \
+    X(Uniform3fv)                                                                             \
+    X(Uniform4fv)                                                                             \
+    X(UniformMatrix2fv)                                                                       \
+    X(UniformMatrix3fv)                                                                       \
+    X(UniformMatrix4fv)                                                                       \
+    X(BufferData)                                                                             \
+    X(BufferSubData)                                                                          \
+    X(MapBufferRange)                                                                         \
+    X(TexImage2D)                                                                             \
+    X(TexSubImage2D)                                                                          \
+    X(Clear)                                                                                  \
+    X(DeleteTextures)                                                                         \
+    X(DeleteBuffers)                                                                          \
+    X(DeleteVertexArrays)                                                                     \
+    X(DeleteFramebuffers)
+
+    // the wrappers installed into glad, each counts and forwards to the original
+    struct GL_Hooks
+    {
+        struct Originals
+        {
+#define GL_STATS_ORIGINAL(name) decltype(glad_gl##name) name = nullptr;
+            GL_STATS_HOOKS(GL_STATS_ORIGINAL)
+#undef GL_STATS_ORIGINAL
+        };
+        static Originals original;
+
+        static GL_Frame_Stats &counts() { return GL_Stats::instance().current; }
+        static bool update(uint32_t kind, uint64_t slot, uint64_t value) { return GL_Stats::instance().update(kind, slot, value); }
+
+        static void count_state(uint32_t kind, uint64_t slot, uint64_t value)
+        {
+            ++counts().state_sets;
+            counts().redundant_state_sets += update(kind, slot, value);
+        }
+
+        static void count_uniform(uint64_t bytes)
+        {
+            ++counts().uniform_uploads;
+            counts().uniform_bytes += bytes;
+        }
+
+        static void count_draw(uint64_t vertices)
+        {
+            ++counts().draw_calls;
+            counts().vertices += vertices;
+        }
+
+        static void APIENTRY hook_DrawArrays(GLenum mode, GLint first, GLsizei count)
+        {
+            count_draw(count);
+            original.DrawArrays(mode, first, count);
+        }
+
+        static void APIENTRY hook_DrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+        {
+            count_draw(count);
+            original.DrawElements(mode, count, type, indices);
+        }
+
+        static void APIENTRY hook_DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+        {
+            count_draw(static_cast<uint64_t>(count) * instances);
+            original.DrawArraysInstanced(mode, first, count, instances);
+        }
+
+        static void APIENTRY hook_DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instances)
+        {
+            count_draw(static_cast<uint64_t>(count) * instances);
+            original.DrawElementsInstanced(mode, count, type, indices, instances);
+        }
+
+        static void APIENTRY hook_DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLint base_vertex)
+        {
+            count_draw(count);
+            original.DrawElementsBaseVertex(mode, count, type, indices, base_vertex);
+        }
+
+        static void APIENTRY hook_DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instances, GLint base_vertex)
+        {
+            count_draw(static_cast<uint64_t>(count) * instances);
+            original.DrawElementsInstancedBaseVertex(mode, count, type, indices, instances, base_vertex);
+        }
+
+        static void APIENTRY hook_DrawElementsInstancedBaseVertexBaseInstance(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instances, GLint base_vertex, GLuint base_instance)
+        {
+            count_draw(static_cast<uint64_t>(count) * instances);
+            original.DrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, instances, base_vertex, base_instance);
+        }
+
+        static void APIENTRY hook_MultiDrawElementsIndirect(GLenum mode, GLenum type, const void *indirect, GLsizei draws, GLsizei stride)
+        {
+            // one call; count and instances are read back from the bound indirect
+            // buffer, which stalls, but only while counting
+            ++counts().draw_calls;
+            const GLsizei step = stride != 0 ? stride : static_cast<GLsizei>(5 * sizeof(GLuint));
+            GLuint command[2] = {0, 0};
+            for (GLsizei i = 0; i < draws; ++i)
+            {
+                const GLintptr offset = reinterpret_cast<GLintptr>(indirect) + static_cast<GLintptr>(i) * step;
+                glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, offset, sizeof(command), command);
+                counts().vertices += static_cast<uint64_t>(command[0]) * command[1];
+            }
+            original.MultiDrawElementsIndirect(mode, type, indirect, draws, stride);
+        }
+
+        static void APIENTRY hook_UseProgram(GLuint program)
+        {
+            ++counts().program_binds;
+            counts().redundant_program_binds += update(PROGRAM, 0, program);
+            original.UseProgram(program);
+        }
+
+        static void APIENTRY hook_BindVertexArray(GLuint vao)
+        {
+            ++counts().vao_binds;
+            if (update(VAO, 0, vao))
+            {
+                ++counts().redundant_vao_binds;
+            }
+            else
+            {
+                // the element buffer binding belongs to the vertex array
+                GL_Stats::instance().shadow.erase((static_cast<uint64_t>(BUFFER) << 56) | GL_ELEMENT_ARRAY_BUFFER);
+            }
+            original.BindVertexArray(vao);
+        }
+
+        static void APIENTRY hook_ActiveTexture(GLenum unit)
+        {
+            ++counts().active_texture_sets;
+            counts().redundant_active_texture_sets += update(ACTIVE_TEXTURE, 0, unit);
+            original.ActiveTexture(unit);
+        }
+
+        static void APIENTRY hook_BindTexture(GLenum target, GLuint texture)
+        {
+            ++counts().texture_binds;
+            const auto &shadow = GL_Stats::instance().shadow;
+            auto unit = shadow.find(static_cast<uint64_t>(ACTIVE_TEXTURE) << 56);
+            // without a known unit the binding can not be attributed
+            if (unit != shadow.end())
+            {
+                counts().redundant_texture_binds += update(TEXTURE, pack(static_cast<uint32_t>(unit->second - GL_TEXTURE0), target), texture);
+            }
+            original.BindTexture(target, texture);
+        }
+
+        static void APIENTRY hook_BindBuffer(GLenum target, GLuint buffer)
+        {
+            ++counts().buffer_binds;
+            counts().redundant_buffer_binds += update(BUFFER, target, buffer);
+            original.BindBuffer(target, buffer);
+        }
+
+        static void APIENTRY hook_BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+        {
+            ++counts().buffer_binds;
+            counts().redundant_buffer_binds += GL_Stats::instance().update_range(target, index, {buffer, 0, 0});
+            // the generic binding point changes too
+            update(BUFFER, target, buffer);
+            original.BindBufferBase(target, index, buffer);
+        }
+
+        static void APIENTRY hook_BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+        {
+            ++counts().buffer_binds;
+            counts().redundant_buffer_binds += GL_Stats::instance().update_range(target, index, {buffer, offset, size});
+            update(BUFFER, target, buffer);
+            original.BindBufferRange(target, index, buffer, offset, size);
+        }
+
+        static void APIENTRY hook_BindFramebuffer(GLenum target, GLuint framebuffer)
+        {
+            ++counts().framebuffer_binds;
+            bool redundant;
+            if (target == GL_FRAMEBUFFER)
+            {
+                // binds both, both have to be current already
+                const bool draw = update(FRAMEBUFFER, GL_DRAW_FRAMEBUFFER, framebuffer);
+                const bool read = update(FRAMEBUFFER, GL_READ_FRAMEBUFFER, framebuffer);
+                redundant = draw && read;
+            }
+            else
+            {
+                redundant = update(FRAMEBUFFER, target, framebuffer);
+            }
+            counts().redundant_framebuffer_binds += redundant;
+            original.BindFramebuffer(target, framebuffer);
+        }
+
+        static void APIENTRY hook_Enable(GLenum capability)
+        {
+            count_state(CAPABILITY, capability, 1);
+            original.Enable(capability);
+        }
+
+        static void APIENTRY hook_Disable(GLenum capability)
+        {
+            count_state(CAPABILITY, capability, 0);
+            original.Disable(capability);
+        }
+
+        static void APIENTRY hook_CullFace(GLenum mode)
+        {
+            count_state(CULL_FACE, 0, mode);
+            original.CullFace(mode);
+        }
+
+        static void APIENTRY hook_DepthFunc(GLenum func)
+        {
+            count_state(DEPTH_FUNC, 0, func);
+            original.DepthFunc(func);
+        }
+
+        static void APIENTRY hook_BlendFunc(GLenum source, GLenum destination)
+        {
+            count_state(BLEND_FUNC, 0, pack(source, destination));
+            original.BlendFunc(source, destination);
+        }
+
+        static void APIENTRY hook_Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+        {
+            ++counts().state_sets;
+            const bool origin = update(VIEWPORT, 0, pack(x, y));
+            const bool size = update(VIEWPORT, 1, pack(width, height));
+            counts().redundant_state_sets += origin && size;
+            original.Viewport(x, y, width, height);
+        }
+
+        static GLint APIENTRY hook_GetUniformLocation(GLuint program, const GLchar *name)
+        {
+            ++counts().uniform_lookups;
+            return original.GetUniformLocation(program, name);
+        }
+
+#define GL_STATS_UNIFORM(name, params, args, bytes) \
+    static void APIENTRY hook_##name params         \
+    {                                               \
+        count_uniform(bytes);                       \
+        original.name args;                         \
+    }
+        GL_STATS_UNIFORM(Uniform1i, (GLint l, GLint x), (l, x), 4)
+        GL_STATS_UNIFORM(Uniform1f, (GLint l, GLfloat x), (l, x), 4)
+        GL_STATS_UNIFORM(Uniform2f, (GLint l, GLfloat x, GLfloat y), (l, x, y), 8)
+        GL_STATS_UNIFORM(Uniform3f, (GLint l, GLfloat x, GLfloat y, GLfloat z), (l, x, y, z), 12)
+        GL_STATS_UNIFORM(Uniform4f, (GLint l, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (l, x, y, z, w), 16)
+        GL_STATS_UNIFORM(Uniform1iv, (GLint l, GLsizei n, const GLint *v), (l, n, v), 4ull * n)
+        GL_STATS_UNIFORM(Uniform1fv, (GLint l, GLsizei n, const GLfloat *v), (l, n, v), 4ull * n)
+        GL_STATS_UNIFORM(Uniform2fv, (GLint l, GLsizei n, const GLfloat *v), (l, n, v), 8ull * n)
+        GL_STATS_UNIFORM(Uniform3fv, (GLint l, GLsizei n, const GLfloat *v), (l, n, v), 12ull * n)
+        GL_STATS_UNIFORM(Uniform4fv, (GLint l, GLsizei n, const GLfloat *v), (l, n, v), 16ull * n)
+        GL_STATS_UNIFORM(UniformMatrix2fv, (GLint l, GLsizei n, GLboolean t, const GLfloat *v), (l, n, t, v), 16ull * n)
+        GL_STATS_UNIFORM(UniformMatrix3fv, (GLint l, GLsizei n, GLboolean t, const GLfloat *v), (l, n, t, v), 36ull * n)
+        GL_STATS_UNIFORM(UniformMatrix4fv, (GLint l, GLsizei n, GLboolean t, const GLfloat *v), (l, n, t, v), 64ull * n)
+#undef GL_STATS_UNIFORM
+
+        static void APIENTRY hook_BufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+        {
+            if (data)
+            {
+                ++counts().buffer_uploads;
+                counts().buffer_bytes += size;
+            }
+            original.BufferData(target, size, data, usage);
+        }
+
+        static void APIENTRY hook_BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+        {
+            ++counts().buffer_uploads;
+            counts().buffer_bytes += size;
+            original.BufferSubData(target, offset, size, data);
+        }
+
+        static void *APIENTRY hook_MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+        {
+            // the bytes written through the mapping, assuming all of the range is
+            if (access & GL_MAP_WRITE_BIT)
+            {
+                ++counts().buffer_uploads;
+                counts().buffer_bytes += length;
+            }
+            return original.MapBufferRange(target, offset, length, access);
+        }
+
+        static void APIENTRY hook_TexImage2D(GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels)
+        {
+            // without pixels it only allocates
+            if (pixels)
+            {
+                ++counts().texture_uploads;
+                counts().texture_bytes += static_cast<uint64_t>(width) * height * pixel_size(format, type);
+            }
+            original.TexImage2D(target, level, internal_format, width, height, border, format, type, pixels);
+        }
+
+        static void APIENTRY hook_TexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+        {
+            ++counts().texture_uploads;
+            counts().texture_bytes += static_cast<uint64_t>(width) * height * pixel_size(format, type);
+            original.TexSubImage2D(target, level, x, y, width, height, format, type, pixels);
+        }
+
+        static void APIENTRY hook_Clear(GLbitfield mask)
+        {
+            ++counts().clears;
+            original.Clear(mask);
+        }
+
+        static void APIENTRY hook_DeleteTextures(GLsizei count, const GLuint *ids)
+        {
+            GL_Stats::instance().forget(TEXTURE, count, ids);
+            original.DeleteTextures(count, ids);
+        }
+
+        static void APIENTRY hook_DeleteBuffers(GLsizei count, const GLuint *ids)
+        {
+            GL_Stats::instance().forget(BUFFER, count, ids);
+            original.DeleteBuffers(count, ids);
+        }
+
+        static void APIENTRY hook_DeleteVertexArrays(GLsizei count, const GLuint *ids)
+        {
+            GL_Stats::instance().forget(VAO, count, ids);
+            original.DeleteVertexArrays(count, ids);
+        }
+
+        static void APIENTRY hook_DeleteFramebuffers(GLsizei count, const GLuint *ids)
+        {
+            GL_Stats::instance().forget(FRAMEBUFFER, count, ids);
+            original.DeleteFramebuffers(count, ids);
+        }
+    };
+
+    GL_Hooks::Originals GL_Hooks::original;
+
+    const std::vector<GL_Frame_Stats::Field> &GL_Frame_Stats::fields()
+    {
+#define GL_STATS_FIELD(name) {#name, &GL_Frame_Stats::name}
+        static const std::vector<Field> rslt = {
+            GL_STATS_FIELD(frame_index),
+            GL_STATS_FIELD(draw_calls),
+            GL_STATS_FIELD(vertices),
+            GL_STATS_FIELD(program_binds),
+            GL_STATS_FIELD(redundant_program_binds),
+            GL_STATS_FIELD(vao_binds),
+            GL_STATS_FIELD(redundant_vao_binds),
+            GL_STATS_FIELD(texture_binds),
+            GL_STATS_FIELD(redundant_texture_binds),
+            GL_STATS_FIELD(active_texture_sets),
+            GL_STATS_FIELD(redundant_active_texture_sets),
+            GL_STATS_FIELD(buffer_binds),
+            GL_STATS_FIELD(redundant_buffer_binds),
+            GL_STATS_FIELD(framebuffer_binds),
+            GL_STATS_FIELD(redundant_framebuffer_binds),
+            GL_STATS_FIELD(state_sets),
+            GL_STATS_FIELD(redundant_state_sets),
+            GL_STATS_FIELD(uniform_lookups),
+            GL_STATS_FIELD(uniform_uploads),
+            GL_STATS_FIELD(uniform_bytes),
+            GL_STATS_FIELD(buffer_uploads),
+            GL_STATS_FIELD(buffer_bytes),
+            GL_STATS_FIELD(texture_uploads),
+            GL_STATS_FIELD(texture_bytes),
+            GL_STATS_FIELD(clears),
+        };
+#undef GL_STATS_FIELD
+        return rslt;
+    }
+
+    void GL_Stats::set_enabled(bool enabled)
+    {
+        if (enabled == installed)
+        {
+            return;
+        }
+        auto &original = GL_Hooks::original;
+        if (enabled)
+        {
+#define GL_STATS_INSTALL(name)                           \
+    original.name = glad_gl##name;                       \
+    if (original.name)                                   \
+    {                                                    \
+        glad_gl##name = &GL_Hooks::hook_##name;          \
+    }
+            GL_STATS_HOOKS(GL_STATS_INSTALL)
+#undef GL_STATS_INSTALL
+            // the cheap part of the current state, everything else starts unknown
+            shadow.clear();
+            range_shadow.clear();
+            GLint value = 0;
+            glGetIntegerv(GL_CURRENT_PROGRAM, &value);
+            update(PROGRAM, 0, static_cast<GLuint>(value));
+            glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &value);
+            update(VAO, 0, static_cast<GLuint>(value));
+            glGetIntegerv(GL_ACTIVE_TEXTURE, &value);
+            update(ACTIVE_TEXTURE, 0, static_cast<GLuint>(value));
+            current = GL_Frame_Stats();
+            current.frame_index = Core::Profiler::get_frame_index();
+        }
+        else
+        {
+#define GL_STATS_UNINSTALL(name)        \
+    if (original.name)                  \
+    {                                   \
+        glad_gl##name = original.name;  \
+    }
+            GL_STATS_HOOKS(GL_STATS_UNINSTALL)
+#undef GL_STATS_UNINSTALL
+            original = GL_Hooks::Originals();
+        }
+        installed = enabled;
+    }
+
+    void GL_Stats::begin_frame()
+    {
+        if (!installed)
+        {
+            return;
+        }
+        history.push_back(current);
+        while (history.size() > history_size)
+        {
+            history.pop_front();
+        }
+        current = GL_Frame_Stats();
+        current.frame_index = Core::Profiler::get_frame_index();
+    }
+
+    bool GL_Stats::get_last_frame(GL_Frame_Stats &stats) const
+    {
+        if (history.empty())
+        {
+            return false;
+        }
+        stats = history.back();
+        return true;
+    }
+
+    void GL_Stats::set_history_size(size_t frames)
+    {
+        history_size = frames > 0 ? frames : 1;
+        while (history.size() > history_size)
+        {
+            history.pop_front();
+        }
+    }
+
+    void GL_Stats::clear()
+    {
+        history.clear();
+    }
+
+    void GL_Stats::write_csv(const std::string &path) const
+    {
+        std::ofstream file(path, std::ios::out);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("GL_Stats::write_csv: can not open " + path);
+        }
+        const auto &fields = GL_Frame_Stats::fields();
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            file << (i ? "," : "") << fields[i].name;
+        }
+        file << "\n";
+        for (const auto &frame : history)
+        {
+            for (size_t i = 0; i < fields.size(); ++i)
+            {
+                file << (i ? "," : "") << frame.*fields[i].value;
+            }
+            file << "\n";
+        }
+    }
+
+    GL_Stats &GL_Stats::instance()
+    {
+        static GL_Stats stats;
+        return stats;
+    }
+
+    bool GL_Stats::update(uint32_t kind, uint64_t slot, uint64_t value)
+    {
+        const uint64_t key = (static_cast<uint64_t>(kind) << 56) | slot;
+        auto it = shadow.find(key);
+        if (it != shadow.end() && it->second == value)
+        {
+            return true;
+        }
+        shadow[key] = value;
+        return false;
+    }
+
+    bool GL_Stats::update_range(GLenum target, GLuint index, const Buffer_Range &range)
+    {
+        const uint64_t key = pack(target, index);
+        auto it = range_shadow.find(key);
+        if (it != range_shadow.end() && it->second == range)
+        {
+            return true;
+        }
+        range_shadow[key] = range;
+        return false;
+    }
+
+    void GL_Stats::forget(uint32_t kind, GLsizei count, const GLuint *ids)
+    {
+        if (kind == BUFFER)
+        {
+            for (auto &entry : range_shadow)
+            {
+                for (GLsizei i = 0; i < count; ++i)
+                {
+                    if (entry.second.buffer == ids[i])
+                    {
+                        entry.second = Buffer_Range();
+                    }
+                }
+            }
+        }
+        for (auto &entry : shadow)
+        {
+            if ((entry.first >> 56) != kind)
+            {
+                continue;
+            }
+            for (GLsizei i = 0; i < count; ++i)
+            {
+                if (entry.second == ids[i])
+                {
+                    entry.second = 0;
+                }
+            }
+        }
+    }
+} // namespace Rendering
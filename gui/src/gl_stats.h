@@ -0,0 +1,120 @@
+#pragma once
+#ifndef RENDERING_GL_STATS_H
+#define RENDERING_GL_STATS_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Rendering
+{
+    // per frame counts of the GL traffic that goes through glad
+    struct GL_Frame_Stats
+    {
+        uint64_t frame_index = 0;
+        uint64_t draw_calls = 0;
+        uint64_t vertices = 0; // index or vertex count times instances
+        uint64_t program_binds = 0;
+        uint64_t redundant_program_binds = 0;
+        uint64_t vao_binds = 0;
+        uint64_t redundant_vao_binds = 0;
+        uint64_t texture_binds = 0;
+        uint64_t redundant_texture_binds = 0;
+        uint64_t active_texture_sets = 0;
+        uint64_t redundant_active_texture_sets = 0;
+        uint64_t buffer_binds = 0;
+        uint64_t redundant_buffer_binds = 0;
+        uint64_t framebuffer_binds = 0;
+        uint64_t redundant_framebuffer_binds = 0;
+        uint64_t state_sets = 0; // enable/disable, cull face, depth and blend functions, viewport
+        uint64_t redundant_state_sets = 0;
+        uint64_t uniform_lookups = 0;
+        uint64_t uniform_uploads = 0;
+        uint64_t uniform_bytes = 0;
+        uint64_t buffer_uploads = 0;
+        uint64_t buffer_bytes = 0;
+        uint64_t texture_uploads = 0;
+        uint64_t texture_bytes = 0;
+        uint64_t clears = 0;
+
+        struct Field
+        {
+            const char *name;
+            uint64_t GL_Frame_Stats::*value;
+        };
+        // every counter, in declaration order; names double as CSV columns
+        static const std::vector<Field> &fields();
+    };
+
+    // Opt-in interceptor: enabling it swaps the glad function pointers of the
+    // calls below for wrappers that count and then forward, disabling it puts
+    // the originals back. A shadow of the bindings and fixed-function state set
+    // through those calls flags redundant sets, i.e. ones that set what is
+    // already current. State set before enabling, or by code with its own GL
+    // loader (the ImGui backend), is not seen, so the first set of a binding
+    // after enabling never counts as redundant. Main thread only.
+    class GL_Stats
+    {
+        // structures
+    private:
+        // an indexed buffer binding; size 0 is the whole buffer, as glBindBufferBase binds it
+        struct Buffer_Range
+        {
+            GLuint buffer = 0;
+            GLintptr offset = 0;
+            GLsizeiptr size = 0;
+
+            bool operator==(const Buffer_Range &other) const { return buffer == other.buffer && offset == other.offset && size == other.size; }
+        };
+
+        // attributes
+    private:
+        bool installed = false;
+        GL_Frame_Stats current;
+        std::deque<GL_Frame_Stats> history;
+        size_t history_size = 600;
+        // (kind, slot) -> last value set, missing if unknown
+        std::unordered_map<uint64_t, uint64_t> shadow;
+        // target << 32 | index -> last range bound, missing if unknown; too wide for `shadow`
+        std::unordered_map<uint64_t, Buffer_Range> range_shadow;
+
+        // constructors and deconstructor
+    public:
+        GL_Stats() = default;
+        ~GL_Stats() = default;
+        GL_Stats(const GL_Stats &) = delete;
+        GL_Stats &operator=(const GL_Stats &) = delete;
+
+        // methods
+    public:
+        // needs a loaded glad; pointers glad could not load stay untouched
+        void set_enabled(bool enabled);
+        bool is_enabled() const { return installed; }
+        // once per frame: closes the current counts into the history
+        void begin_frame();
+        // false until a frame has been counted
+        bool get_last_frame(GL_Frame_Stats &stats) const;
+        const std::deque<GL_Frame_Stats> &get_history() const { return history; }
+        void set_history_size(size_t frames);
+        size_t get_history_size() const { return history_size; }
+        void clear();
+        // one row per kept frame, oldest first
+        void write_csv(const std::string &path) const;
+
+        static GL_Stats &instance();
+
+    private:
+        friend struct GL_Hooks;
+        // records `value` for (kind, slot) and returns true if it was already set
+        bool update(uint32_t kind, uint64_t slot, uint64_t value);
+        // the same for an indexed buffer binding
+        bool update_range(GLenum target, GLuint index, const Buffer_Range &range);
+        // deleted objects read as bound to 0 wherever they were bound
+        void forget(uint32_t kind, GLsizei count, const GLuint *ids);
+    };
+} // namespace Rendering
+
+#endif // RENDERING_GL_STATS_H
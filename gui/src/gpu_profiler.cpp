@@ -0,0 +1,202 @@
+#include "gpu_profiler.h"
+#include <algorithm>
+#include "ui_log.h"
+
+namespace Rendering
+{
+    namespace
+    {
+        constexpr size_t NONE = static_cast<size_t>(-1);
+        // queries generated at once when the pool runs dry
+        constexpr GLsizei QUERY_BATCH = 32;
+    }
+
+    void GPU_Profiler::init()
+    {
+        initialized = true;
+        supported = false;
+        if (!glQueryCounter || !glGetQueryObjectui64v || !glGetQueryObjectiv || !glGetInteger64v || !glGetQueryiv)
+        {
+            GUI::Log::get().warn("GPU_Profiler: timer queries are not available, GPU timings are off");
+            return;
+        }
+        while (glGetError() != GL_NO_ERROR)
+        {
+        }
+        GLint bits = 0;
+        glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+        if (glGetError() != GL_NO_ERROR || bits == 0)
+        {
+            GUI::Log::get().warn("GPU_Profiler: the driver has no timestamp counter, GPU timings are off");
+            return;
+        }
+        supported = true;
+        track = Core::Profiler::create_track("GPU");
+        frames[current].frame_index = Core::Profiler::get_frame_index();
+        calibrate();
+    }
+
+    void GPU_Profiler::destroy()
+    {
+        if (!all_queries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(all_queries.size()), all_queries.data());
+        }
+        all_queries.clear();
+        free_queries.clear();
+        for (auto &frame : frames)
+        {
+            frame.scopes.clear();
+            frame.pending = false;
+        }
+        open.clear();
+        initialized = false;
+        supported = false;
+    }
+
+    void GPU_Profiler::begin_frame()
+    {
+        if (!initialized)
+        {
+            init();
+        }
+        if (!supported)
+        {
+            return;
+        }
+        // scopes left open by the last frame end here, their frame could not resolve otherwise
+        while (!open.empty())
+        {
+            end();
+        }
+        // oldest first, a frame is never ready before the ones issued earlier
+        for (size_t i = 1; i <= FRAME_LATENCY; ++i)
+        {
+            auto &frame = frames[(current + i) % FRAME_LATENCY];
+            if (!frame.pending)
+            {
+                continue;
+            }
+            if (!resolve(frame))
+            {
+                break;
+            }
+            recycle(frame);
+        }
+        current = (current + 1) % FRAME_LATENCY;
+        auto &frame = frames[current];
+        if (frame.pending)
+        {
+            // still not back after FRAME_LATENCY frames, reading it now would stall
+            ++dropped_frames;
+            recycle(frame);
+        }
+        if (frame_count++ % CALIBRATION_INTERVAL == 0)
+        {
+            calibrate();
+        }
+        frame.frame_index = Core::Profiler::get_frame_index();
+    }
+
+    void GPU_Profiler::begin(const char *name)
+    {
+        if (!initialized)
+        {
+            init();
+        }
+        if (!supported)
+        {
+            return;
+        }
+        if (!enabled || !Core::Profiler::is_enabled())
+        {
+            open.push_back(NONE);
+            return;
+        }
+        auto &frame = frames[current];
+        Query_Scope scope{name, acquire_query(), acquire_query(), static_cast<uint32_t>(open.size())};
+        glQueryCounter(scope.begin, GL_TIMESTAMP);
+        open.push_back(frame.scopes.size());
+        frame.scopes.push_back(scope);
+        frame.pending = true;
+    }
+
+    void GPU_Profiler::end()
+    {
+        if (!supported || open.empty())
+        {
+            return;
+        }
+        const size_t index = open.back();
+        open.pop_back();
+        if (index != NONE)
+        {
+            glQueryCounter(frames[current].scopes[index].end, GL_TIMESTAMP);
+        }
+    }
+
+    GPU_Profiler &GPU_Profiler::instance()
+    {
+        static GPU_Profiler profiler;
+        return profiler;
+    }
+
+    GLuint GPU_Profiler::acquire_query()
+    {
+        if (free_queries.empty())
+        {
+            GLuint ids[QUERY_BATCH];
+            glGenQueries(QUERY_BATCH, ids);
+            free_queries.insert(free_queries.end(), ids, ids + QUERY_BATCH);
+            all_queries.insert(all_queries.end(), ids, ids + QUERY_BATCH);
+        }
+        GLuint rslt = free_queries.back();
+        free_queries.pop_back();
+        return rslt;
+    }
+
+    void GPU_Profiler::calibrate()
+    {
+        GLint64 gpu = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpu);
+        offset = static_cast<int64_t>(Core::Profiler::now()) - gpu;
+    }
+
+    bool GPU_Profiler::resolve(Frame_Queries &frame)
+    {
+        for (const auto &scope : frame.scopes)
+        {
+            GLint begin_ready = 0, end_ready = 0;
+            glGetQueryObjectiv(scope.begin, GL_QUERY_RESULT_AVAILABLE, &begin_ready);
+            glGetQueryObjectiv(scope.end, GL_QUERY_RESULT_AVAILABLE, &end_ready);
+            if (!begin_ready || !end_ready)
+            {
+                return false;
+            }
+        }
+        resolved.clear();
+        for (const auto &scope : frame.scopes)
+        {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(scope.begin, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(scope.end, GL_QUERY_RESULT, &end);
+            resolved.push_back({scope.name,
+                                static_cast<uint64_t>(static_cast<int64_t>(begin) + offset),
+                                static_cast<uint64_t>(static_cast<int64_t>(std::max(begin, end)) + offset),
+                                track, scope.depth});
+        }
+        Core::Profiler::submit(frame.frame_index, resolved);
+        return true;
+    }
+
+    void GPU_Profiler::recycle(Frame_Queries &frame)
+    {
+        for (const auto &scope : frame.scopes)
+        {
+            free_queries.push_back(scope.begin);
+            free_queries.push_back(scope.end);
+        }
+        frame.scopes.clear();
+        frame.pending = false;
+    }
+} // namespace Rendering
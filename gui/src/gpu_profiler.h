@@ -0,0 +1,116 @@
+#pragma once
+#ifndef RENDERING_GPU_PROFILER_H
+#define RENDERING_GPU_PROFILER_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include "profiler.h"
+
+namespace Rendering
+{
+    // GPU time of render passes from GL_TIMESTAMP queries. Each scope writes a
+    // timestamp when the GPU reaches its start and its end, so scopes can nest
+    // (GL_TIME_ELAPSED queries can not). The queries of a frame are only read
+    // once they are available, FRAME_LATENCY - 1 frames later at the latest, so
+    // reading never stalls the pipeline; frames whose results are still missing
+    // by then are dropped. Results are converted to the Core::Profiler clock and
+    // submitted to the frame that issued them on a "GPU" track, so they show up
+    // in the Profiler widget and the Chrome trace next to the CPU scopes.
+    // Without timer queries (no context, or GL_QUERY_COUNTER_BITS of 0 as on
+    // some software rasterizers) every call is a no-op.
+    class GPU_Profiler
+    {
+        // structures
+    public:
+        static constexpr size_t FRAME_LATENCY = 4;
+        // re-measure the GPU to CPU clock offset every this many frames
+        static constexpr uint64_t CALIBRATION_INTERVAL = 120;
+
+    private:
+        struct Query_Scope
+        {
+            const char *name;
+            GLuint begin;
+            GLuint end;
+            uint32_t depth;
+        };
+
+        struct Frame_Queries
+        {
+            uint64_t frame_index = 0;
+            std::vector<Query_Scope> scopes;
+            bool pending = false;
+        };
+
+        // attributes
+    private:
+        bool initialized = false;
+        bool supported = false;
+        bool enabled = true;
+        uint32_t track = 0;
+        Frame_Queries frames[FRAME_LATENCY];
+        size_t current = 0;
+        uint64_t frame_count = 0;
+        // open scopes of the current frame, indices into its scopes
+        std::vector<size_t> open;
+        std::vector<GLuint> free_queries;
+        std::vector<GLuint> all_queries;
+        // cpu = gpu + offset, in ns
+        int64_t offset = 0;
+        size_t dropped_frames = 0;
+        std::vector<Core::Profiler::Event> resolved;
+
+        // constructors and deconstructor
+    public:
+        GPU_Profiler() = default;
+        ~GPU_Profiler() = default;
+        GPU_Profiler(const GPU_Profiler &) = delete;
+        GPU_Profiler &operator=(const GPU_Profiler &) = delete;
+
+        // methods
+    public:
+        // needs the GL context; called by the first begin_frame otherwise
+        void init();
+        // deletes the queries, call before the context goes away
+        void destroy();
+        // once per frame, before any scope: reads back finished frames and recycles their queries
+        void begin_frame();
+        void begin(const char *name);
+        void end();
+
+        bool is_supported() const { return supported; }
+        void set_enabled(bool enabled) { this->enabled = enabled; }
+        bool is_enabled() const { return enabled; }
+        size_t get_dropped_frames() const { return dropped_frames; }
+
+        static GPU_Profiler &instance();
+
+    private:
+        GLuint acquire_query();
+        void calibrate();
+        // false if the results are not there yet
+        bool resolve(Frame_Queries &frame);
+        void recycle(Frame_Queries &frame);
+        bool active() const { return supported && enabled; }
+    };
+
+    class GPU_Scope
+    {
+    public:
+        explicit GPU_Scope(const char *name) { GPU_Profiler::instance().begin(name); }
+        ~GPU_Scope() { GPU_Profiler::instance().end(); }
+        GPU_Scope(const GPU_Scope &) = delete;
+        GPU_Scope &operator=(const GPU_Scope &) = delete;
+    };
+} // namespace Rendering
+
+#ifdef CORE_PROFILER
+#define GPU_PROFILE_SCOPE(name) ::Rendering::GPU_Scope CORE_PROFILE_CONCAT(gpu_profile_scope_, __COUNTER__)(name)
+#define GPU_PROFILE_FRAME() ::Rendering::GPU_Profiler::instance().begin_frame()
+#else
+#define GPU_PROFILE_SCOPE(name) ((void)0)
+#define GPU_PROFILE_FRAME() ((void)0)
+#endif
+
+#endif // RENDERING_GPU_PROFILER_H
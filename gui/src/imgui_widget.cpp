@@ -264,7 +264,7 @@ namespace GUI
                 ImGui::ResetMouseDragDelta(ImGuiMouseButton_Right);
 
                 mouse_delta = ImGui::GetMouseDragDelta(ImGuiMouseButton_Left);
-                Core::Vector3 camera_focus = scene->cameras[scene->active_camera_index].value->get_focus();
+                Core::Vec3 camera_focus = scene->cameras[scene->active_camera_index].value->get_focus();
 
                 if (!Core::Math::equal(mouse_delta.x, 0.0f))
                 {
@@ -315,16 +315,309 @@ namespace GUI
         ImGui::Begin(name.c_str());
         {
             update();
+            auto &logger = Log::get().logger;
+            if (ImGui::Button("Clear"))
+            {
+                Log::get().clear();
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("Auto-scroll", &auto_scroll);
+            ImGui::Separator();
             ImGui::BeginChild("scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
-            for (auto msg : Log::get().messages)
+            // only the visible rows are copied and submitted, whatever the history length
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(logger.history_size()));
+            while (clipper.Step())
+            {
+                visible_lines.clear();
+                logger.read_history(clipper.DisplayStart, clipper.DisplayEnd - clipper.DisplayStart, visible_lines);
+                for (const auto &line : visible_lines)
+                {
+                    if (line.level >= Core::Logger::LEVEL_WARN)
+                    {
+                        const ImVec4 color = line.level == Core::Logger::LEVEL_ERROR ? ImVec4(1.0f, 0.4f, 0.4f, 1.0f) : ImVec4(1.0f, 0.8f, 0.4f, 1.0f);
+                        ImGui::PushStyleColor(ImGuiCol_Text, color);
+                        ImGui::TextUnformatted(line.text.c_str(), line.text.c_str() + line.text.size());
+                        ImGui::PopStyleColor();
+                    }
+                    else
+                    {
+                        ImGui::TextUnformatted(line.text.c_str(), line.text.c_str() + line.text.size());
+                    }
+                }
+            }
+            clipper.End();
+            if (auto_scroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
             {
-                ImGui::Text("%s", msg.c_str());
+                ImGui::SetScrollHereY(1.0f);
             }
             ImGui::EndChild();
             ImGui::End();
         }
     }
 
+    void Profiler_Widget::show()
+    {
+        ImGui::Begin(name.c_str());
+        {
+            update();
+            if (!paused)
+            {
+                frame_times = Core::Profiler::get_frame_times();
+                if (!Core::Profiler::get_frame(frame_age, frame))
+                {
+                    Core::Profiler::get_frame(0, frame);
+                }
+            }
+            auto stats = Core::Profiler::get_frame_stats();
+            ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+            ImGui::Text("Frame time over %d frames (ms): mean %.2f  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f",
+                        static_cast<int>(stats.count), stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+            float max_time = 0.0f;
+            for (auto t : frame_times)
+            {
+                max_time = std::max(max_time, t);
+            }
+            ImGui::PlotLines("##frame_times", frame_times.data(), static_cast<int>(frame_times.size()), 0, "frame time (ms)", 0.0f, max_time * 1.1f, ImVec2(-1, 80));
+
+            bool enabled = Core::Profiler::is_enabled();
+            if (ImGui::Checkbox("Record", &enabled))
+            {
+                Core::Profiler::set_enabled(enabled);
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("Pause", &paused);
+            ImGui::SameLine();
+            if (Core::Profiler::is_capturing())
+            {
+                if (ImGui::Button("Stop Capture"))
+                {
+                    Core::Profiler::stop_capture();
+                }
+                ImGui::SameLine();
+                ImGui::Text("%d frames", static_cast<int>(Core::Profiler::get_capture_frame_count()));
+            }
+            else if (ImGui::Button("Start Capture"))
+            {
+                Core::Profiler::start_capture();
+            }
+            ImGui::InputText("##trace_path", trace_path, sizeof(trace_path));
+            ImGui::SameLine();
+            if (ImGui::Button("Export Trace"))
+            {
+                try
+                {
+                    Core::Profiler::write_chrome_trace(trace_path);
+                    Log::get().info(std::string("Profiler trace written to ") + trace_path);
+                }
+                catch (const std::exception &e)
+                {
+                    Log::get().error(e.what());
+                }
+            }
+            ImGui::Separator();
+            ImGui::SliderInt("Frames Ago", &frame_age, 0, static_cast<int>(Core::Profiler::get_history_size()) - 1);
+            if (Rendering::GPU_Profiler::instance().is_supported())
+            {
+                ImGui::SameLine();
+                ImGui::Text("GPU frames dropped: %d", static_cast<int>(Rendering::GPU_Profiler::instance().get_dropped_frames()));
+            }
+            ImGui::Text("Frame %d: %.3f ms", static_cast<int>(frame.index), frame.duration_ms());
+            show_timeline();
+        }
+        ImGui::End();
+    }
+
+    void GL_Stats_Widget::show()
+    {
+        ImGui::Begin(name.c_str());
+        {
+            update();
+            auto &stats = Rendering::GL_Stats::instance();
+            bool enabled = stats.is_enabled();
+            if (ImGui::Checkbox("Intercept GL calls", &enabled))
+            {
+                stats.set_enabled(enabled);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Clear"))
+            {
+                stats.clear();
+            }
+            auto &state = Rendering::GL_State::instance();
+            bool debug = state.is_debug();
+            if (ImGui::Checkbox("Verify state cache", &debug))
+            {
+                state.set_debug(debug);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Validate"))
+            {
+                if (state.validate())
+                {
+                    Log::get().info("GL_State: the cache matches GL");
+                }
+            }
+            ImGui::Text("State cache: %llu calls issued, %llu skipped", static_cast<unsigned long long>(state.get_issued()),
+                        static_cast<unsigned long long>(state.get_skipped()));
+            auto &meshes = Rendering::Mesh_Cache::instance();
+            if (ImGui::CollapsingHeader("Mesh cache"))
+            {
+                ImGui::Text("%.1f KB, %llu hits, %llu misses", meshes.get_bytes() / 1024.0, static_cast<unsigned long long>(meshes.get_hits()),
+                            static_cast<unsigned long long>(meshes.get_misses()));
+                if (ImGui::BeginTable("##mesh_cache", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+                {
+                    ImGui::TableSetupColumn("Mesh");
+                    ImGui::TableSetupColumn("KB");
+                    ImGui::TableSetupColumn("Users");
+                    ImGui::TableHeadersRow();
+                    for (const auto &entry : meshes.get_entries())
+                    {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(entry.name.c_str());
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.1f", entry.bytes / 1024.0);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%ld", entry.users);
+                    }
+                    ImGui::EndTable();
+                }
+                for (const auto &buffer : Rendering::Mesh_Buffer::get_buffers())
+                {
+                    ImGui::Text("Shared buffer %u: %zu / %zu vertices, %zu / %zu indices", buffer->get_vao(), buffer->get_used_vertices(),
+                                buffer->get_vertex_capacity(), buffer->get_used_indices(), buffer->get_index_capacity());
+                }
+            }
+            Rendering::GL_Frame_Stats last;
+            if (!stats.get_last_frame(last))
+            {
+                ImGui::TextUnformatted("No frame counted yet");
+                ImGui::End();
+                return;
+            }
+            draw_calls.clear();
+            for (const auto &frame : stats.get_history())
+            {
+                draw_calls.push_back(static_cast<float>(frame.draw_calls));
+            }
+            ImGui::PlotLines("##draw_calls", draw_calls.data(), static_cast<int>(draw_calls.size()), 0, "draw calls", 0.0f, FLT_MAX, ImVec2(-1, 60));
+
+            // a counter and, where there is one, its redundant share on the same row
+            ImGui::Text("Frame %d", static_cast<int>(last.frame_index));
+            if (ImGui::BeginTable("##gl_stats", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+            {
+                ImGui::TableSetupColumn("Counter");
+                ImGui::TableSetupColumn("Count");
+                ImGui::TableSetupColumn("Redundant");
+                ImGui::TableHeadersRow();
+                const auto &fields = Rendering::GL_Frame_Stats::fields();
+                for (size_t i = 1; i < fields.size(); ++i)
+                {
+                    const bool has_redundant = i + 1 < fields.size() && std::string(fields[i + 1].name).rfind("redundant_", 0) == 0;
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(fields[i].name);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(last.*fields[i].value));
+                    ImGui::TableNextColumn();
+                    if (has_redundant)
+                    {
+                        const auto redundant = last.*fields[i + 1].value;
+                        if (redundant > 0)
+                        {
+                            ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "%llu", static_cast<unsigned long long>(redundant));
+                        }
+                        else
+                        {
+                            ImGui::TextUnformatted("0");
+                        }
+                        ++i;
+                    }
+                }
+                ImGui::EndTable();
+            }
+            ImGui::InputText("##csv_path", csv_path, sizeof(csv_path));
+            ImGui::SameLine();
+            if (ImGui::Button("Dump CSV"))
+            {
+                try
+                {
+                    stats.write_csv(csv_path);
+                    Log::get().info(std::string("GL stats written to ") + csv_path);
+                }
+                catch (const std::exception &e)
+                {
+                    Log::get().error(e.what());
+                }
+            }
+        }
+        ImGui::End();
+    }
+
+    void Profiler_Widget::show_timeline()
+    {
+        const float lane_height = ImGui::GetTextLineHeight() + 4.0f;
+        const float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+        // GPU work of the frame usually finishes after its CPU side, the view covers both
+        uint64_t view_end = frame.end;
+        for (const auto &e : frame.events)
+        {
+            view_end = std::max(view_end, e.end);
+        }
+        const double duration = static_cast<double>(std::max<uint64_t>(1, view_end - frame.start));
+        ImGui::BeginChild("timeline", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+        size_t i = 0;
+        while (i < frame.events.size())
+        {
+            // events are grouped by thread, lanes by depth
+            const uint32_t thread = frame.events[i].thread;
+            uint32_t depth = 0;
+            size_t end = i;
+            while (end < frame.events.size() && frame.events[end].thread == thread)
+            {
+                depth = std::max(depth, frame.events[end].depth);
+                ++end;
+            }
+            ImGui::TextUnformatted(Core::Profiler::get_thread_name(thread).c_str());
+            const ImVec2 origin = ImGui::GetCursorScreenPos();
+            ImGui::Dummy(ImVec2(width, lane_height * (depth + 1)));
+            auto draw_list = ImGui::GetWindowDrawList();
+            for (; i < end; ++i)
+            {
+                const auto &e = frame.events[i];
+                // scopes opened before the frame began are cut at its start
+                const uint64_t start = std::max(e.start, frame.start);
+                const uint64_t stop = std::max(e.end, start);
+                const float x0 = origin.x + static_cast<float>((start - frame.start) / duration) * width;
+                const float x1 = std::max(x0 + 1.0f, origin.x + static_cast<float>((stop - frame.start) / duration) * width);
+                const float y0 = origin.y + lane_height * e.depth;
+                const ImVec2 min(x0, y0), max(x1, y0 + lane_height - 1.0f);
+                // the colour follows the name, so a scope keeps it across frames
+                unsigned int hash = 2166136261u;
+                for (const char *c = e.name; *c; ++c)
+                {
+                    hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+                }
+                const float hue = static_cast<float>(hash % 360) / 360.0f;
+                draw_list->AddRectFilled(min, max, ImColor::HSV(hue, 0.5f, 0.7f));
+                const ImVec2 text_size = ImGui::CalcTextSize(e.name);
+                if (text_size.x + 4.0f < x1 - x0)
+                {
+                    draw_list->AddText(ImVec2(x0 + 2.0f, y0 + 2.0f), IM_COL32_WHITE, e.name);
+                }
+                if (ImGui::IsMouseHoveringRect(min, max))
+                {
+                    ImGui::SetTooltip("%s\n%.3f ms", e.name, (e.end - e.start) * 1e-6);
+                }
+            }
+            // where the CPU side of the frame ended
+            const float frame_end = origin.x + static_cast<float>((frame.end - frame.start) / duration) * width;
+            draw_list->AddLine(ImVec2(frame_end, origin.y), ImVec2(frame_end, origin.y + lane_height * (depth + 1)), IM_COL32(255, 255, 255, 128));
+        }
+        ImGui::EndChild();
+    }
+
     UI_Settings_Widget::UI_Settings_Widget(const std::string &name, float x, float y, float width, float height, bool active) : IMG_Widget(name, x, y, width, height, active)
     {
         init();
@@ -351,6 +644,12 @@ namespace GUI
         file << "show_OpenGL_window " << show_OpenGL_window << std::endl;
         file << "show_Log_window " << show_Log_window << std::endl;
         file << "show_Properties_window " << show_Properties_window << std::endl;
+        file << "show_Profiler_window " << show_Profiler_window << std::endl;
+        file << "show_GL_Stats_window " << show_GL_Stats_window << std::endl;
+        if (!log_file.empty())
+        {
+            file << "log_file " << log_file << std::endl;
+        }
         // close file
         file.close();
     }
@@ -394,6 +693,18 @@ namespace GUI
             {
                 ss >> show_Properties_window;
             }
+            else if (key == "show_Profiler_window")
+            {
+                ss >> show_Profiler_window;
+            }
+            else if (key == "show_GL_Stats_window")
+            {
+                ss >> show_GL_Stats_window;
+            }
+            else if (key == "log_file")
+            {
+                ss >> log_file;
+            }
         }
     }
 
@@ -406,6 +717,8 @@ namespace GUI
                 ImGui::Checkbox("Show OpenGL Window", &this->settings->show_OpenGL_window);
                 ImGui::Checkbox("Show Log Window", &this->settings->show_Log_window);
                 ImGui::Checkbox("Show Properties Window", &this->settings->show_Properties_window);
+                ImGui::Checkbox("Show Profiler Window", &this->settings->show_Profiler_window);
+                ImGui::Checkbox("Show GL Stats Window", &this->settings->show_GL_Stats_window);
                 static bool show_save_dialog = false;
                 if (ImGui::Button("Save Layout"))
                 {
@@ -511,6 +824,7 @@ namespace GUI
         {
             ImGui::Text("Model");
             ImGui::Separator();
+            show_node_property(model->scene_graph, model->node);
             show_transform_property(model->transform.get());
         }
 
@@ -542,6 +856,7 @@ namespace GUI
             ImGui::ColorEdit3("##color", light->color.data());
             ImGui::Text("Intensity");
             ImGui::SliderFloat("##intensity", &light->intensity, 0.0f, 1.0f, "%.3f");
+            show_node_property(light->scene_graph, light->node);
             show_transform_property(light->transform.get());
         }
     }
@@ -893,6 +1208,110 @@ namespace GUI
         }
     }
 
+    void Properties_Widget::show_node_property(Core::Scene_Graph *graph, Core::Scene_Graph::Node node)
+    {
+        using Node = Core::Scene_Graph::Node;
+        if (graph == nullptr || !graph->contains(node))
+        {
+            return;
+        }
+        ImGui::Text("Parent");
+        const Node parent = graph->get_parent(node);
+        Node selected = parent;
+        const std::string preview = parent == Core::Scene_Graph::NONE ? "None" : scene_node_name(*graph, parent);
+        if (ImGui::BeginCombo("##parent", preview.c_str()))
+        {
+            if (ImGui::Selectable("None", parent == Core::Scene_Graph::NONE))
+            {
+                selected = Core::Scene_Graph::NONE;
+            }
+            // every node except the node itself and its subtree
+            std::vector<Node> stack(graph->get_children(Core::Scene_Graph::NONE).rbegin(), graph->get_children(Core::Scene_Graph::NONE).rend());
+            while (!stack.empty())
+            {
+                const Node candidate = stack.back();
+                stack.pop_back();
+                if (candidate == node)
+                {
+                    continue;
+                }
+                const std::string label = std::string(graph->get_depth(candidate) * 2, ' ') + scene_node_name(*graph, candidate) + "##parent" + std::to_string(candidate);
+                if (ImGui::Selectable(label.c_str(), candidate == parent))
+                {
+                    selected = candidate;
+                }
+                const auto &children = graph->get_children(candidate);
+                stack.insert(stack.end(), children.rbegin(), children.rend());
+            }
+            ImGui::EndCombo();
+        }
+        // applied after the combo, the children lists change
+        if (selected != parent)
+        {
+            graph->set_parent(node, selected);
+        }
+    }
+
+    std::string scene_node_name(const Core::Scene_Graph &graph, Core::Scene_Graph::Node node)
+    {
+        auto object = graph.get_object(node);
+        return object ? object->name : "Group " + std::to_string(node);
+    }
+
+    void scene_node_drag_source(const Core::Scene_Graph &graph, Core::Scene_Graph::Node node)
+    {
+        if (ImGui::BeginDragDropSource())
+        {
+            ImGui::SetDragDropPayload("SCENE_NODE", &node, sizeof(node));
+            ImGui::Text("%s", scene_node_name(graph, node).c_str());
+            ImGui::EndDragDropSource();
+        }
+    }
+
+    void Scene_Widget::accept_scene_node(Core::Scene_Graph::Node parent)
+    {
+        if (ImGui::BeginDragDropTarget())
+        {
+            if (const ImGuiPayload *payload = ImGui::AcceptDragDropPayload("SCENE_NODE"))
+            {
+                dropped_node = *static_cast<const Core::Scene_Graph::Node *>(payload->Data);
+                drop_parent = parent;
+            }
+            ImGui::EndDragDropTarget();
+        }
+    }
+
+    void Scene_Widget::show_scene_node(Core::Scene_Graph &graph, Core::Scene_Graph::Node node)
+    {
+        const auto &children = graph.get_children(node);
+        auto object = graph.get_object(node);
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
+        if (children.empty())
+        {
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        }
+        if (object && object == selected_object)
+        {
+            flags |= ImGuiTreeNodeFlags_Selected;
+        }
+        const std::string label = scene_node_name(graph, node) + "##node" + std::to_string(node);
+        const bool open = ImGui::TreeNodeEx(label.c_str(), flags);
+        if (object && ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+        {
+            selected_object = object;
+        }
+        scene_node_drag_source(graph, node);
+        accept_scene_node(node);
+        if (open)
+        {
+            for (auto child : children)
+            {
+                show_scene_node(graph, child);
+            }
+            ImGui::TreePop();
+        }
+    }
+
     void Scene_Widget::show()
     {
 
@@ -909,6 +1328,11 @@ namespace GUI
             // list all configurable objects in the scene and get the selected object
             // if none was selected then select the scene
             auto ogl_scene = dynamic_cast<Rendering::OGL_Scene *>(scene);
+            if (auto scene_3d = dynamic_cast<Rendering::OGL_Scene_3D *>(scene))
+            {
+                const auto &cull_stats = scene_3d->get_cull_stats();
+                ImGui::Text("%zu models visible, %zu culled", cull_stats.visible, cull_stats.culled);
+            }
             ImGui::SetNextItemOpen(true, ImGuiCond_Once);
             if (ImGui::TreeNode("Scene"))
             {
@@ -927,9 +1351,34 @@ namespace GUI
                             {
                                 selected_object = model.get();
                             }
+                            scene_node_drag_source(ogl_scene->scene_graph, model->node);
                         }
                         ImGui::TreePop();
                     }
+
+                    // parent/child view of the models and lights, drag a node onto
+                    // another one to reparent it or onto the header to make it a root
+                    auto &graph = ogl_scene->scene_graph;
+                    ImGui::SetNextItemOpen(true, ImGuiCond_Once);
+                    const bool hierarchy_open = ImGui::TreeNode("Hierarchy");
+                    accept_scene_node(Core::Scene_Graph::NONE);
+                    if (hierarchy_open)
+                    {
+                        for (auto root : graph.get_children(Core::Scene_Graph::NONE))
+                        {
+                            show_scene_node(graph, root);
+                        }
+                        ImGui::TreePop();
+                    }
+                    // applied after the tree is drawn, the children lists change
+                    if (dropped_node != Core::Scene_Graph::NONE)
+                    {
+                        if (graph.contains(dropped_node) && dropped_node != drop_parent && !graph.is_ancestor(dropped_node, drop_parent))
+                        {
+                            graph.set_parent(dropped_node, drop_parent);
+                        }
+                        dropped_node = Core::Scene_Graph::NONE;
+                    }
                 }
                 auto ogl_scene_3d = dynamic_cast<Rendering::OGL_Scene_3D *>(scene);
                 if (ogl_scene_3d)
@@ -947,6 +1396,10 @@ namespace GUI
                             {
                                 selected_object = light.value.get();
                             }
+                            if (light.value->scene_graph)
+                            {
+                                scene_node_drag_source(*light.value->scene_graph, light.value->node);
+                            }
                         }
                         ImGui::TreePop();
                     }
@@ -10,6 +10,12 @@
 #include <fstream>
 #include <sstream>
 #include "ui_log.h"
+#include "profiler.h"
+#include "gpu_profiler.h"
+#include "gl_stats.h"
+#include "gl_state.h"
+#include "mesh_cache.h"
+#include "mesh_buffer.h"
 #include <map>
 #include "shader.h"
 #include "text_render.h"
@@ -123,6 +129,11 @@ namespace GUI
     {
         // attributes
     public:
+        bool auto_scroll = true;
+
+    private:
+        // the lines on screen this frame, copied out of the log history
+        std::vector<Core::Logger::Line> visible_lines;
         // constructors and deconstructor
     public:
         Log_Widget(const std::string &name = "Log_Widget", float x = 0, float y = 0, float width = 0, float height = 0, bool active = true);
@@ -135,6 +146,60 @@ namespace GUI
         // void update();
     };
 
+    class Profiler_Widget;
+    using Profiler_Widget_U_Ptr = std::unique_ptr<Profiler_Widget>;
+    using Profiler_Widget_S_Ptr = std::shared_ptr<Profiler_Widget>;
+    using Profiler_Widget_W_Ptr = std::weak_ptr<Profiler_Widget>;
+    using Profiler_Widget_Ptr = Profiler_Widget_U_Ptr;
+    class Profiler_Widget : public IMG_Widget
+    {
+        // attributes
+    public:
+        bool paused = false;
+        // GPU timings are read back up to FRAME_LATENCY frames after their frame ended
+        int frame_age = static_cast<int>(Rendering::GPU_Profiler::FRAME_LATENCY);
+        char trace_path[256] = "trace.json";
+
+    private:
+        Core::Profiler::Frame frame;
+        std::vector<float> frame_times;
+        // constructors and deconstructor
+    public:
+        Profiler_Widget(const std::string &name = "Profiler_Widget", float x = 0, float y = 0, float width = 0, float height = 0, bool active = true)
+            : IMG_Widget(name, x, y, width, height, active){};
+        ~Profiler_Widget(){};
+        // methods
+    public:
+        void show();
+
+    private:
+        // the scopes of the shown frame, one lane per thread and nesting depth
+        void show_timeline();
+    };
+
+    class GL_Stats_Widget;
+    using GL_Stats_Widget_U_Ptr = std::unique_ptr<GL_Stats_Widget>;
+    using GL_Stats_Widget_S_Ptr = std::shared_ptr<GL_Stats_Widget>;
+    using GL_Stats_Widget_W_Ptr = std::weak_ptr<GL_Stats_Widget>;
+    using GL_Stats_Widget_Ptr = GL_Stats_Widget_U_Ptr;
+    class GL_Stats_Widget : public IMG_Widget
+    {
+        // attributes
+    public:
+        char csv_path[256] = "gl_stats.csv";
+
+    private:
+        std::vector<float> draw_calls;
+        // constructors and deconstructor
+    public:
+        GL_Stats_Widget(const std::string &name = "GL_Stats_Widget", float x = 0, float y = 0, float width = 0, float height = 0, bool active = true)
+            : IMG_Widget(name, x, y, width, height, active){};
+        ~GL_Stats_Widget(){};
+        // methods
+    public:
+        void show();
+    };
+
     class Properties_Widget;
     using Properties_Widget_U_Ptr = std::unique_ptr<Properties_Widget>;
     using Properties_Widget_S_Ptr = std::shared_ptr<Properties_Widget>;
@@ -165,6 +230,7 @@ namespace GUI
     protected:
         void show_material_property(Rendering::Material_PBR *material);
         void show_transform_property(Core::Transform *transform);
+        void show_node_property(Core::Scene_Graph *graph, Core::Scene_Graph::Node node);
     };
 
     struct UI_Settings
@@ -175,6 +241,10 @@ namespace GUI
         bool show_OpenGL_window = false;
         bool show_Log_window = false;
         bool show_Properties_window = false;
+        bool show_Profiler_window = false;
+        bool show_GL_Stats_window = false;
+        // rotating log file, none if empty
+        std::string log_file;
 
         void save_to_file(const std::string &directory, const std::string &filename);
 
@@ -222,6 +292,11 @@ namespace GUI
     public:
         Rendering::Scene *scene;
         Core::Configurable *selected_object;
+
+    private:
+        // a node dropped on another one this frame, applied after the tree is drawn
+        Core::Scene_Graph::Node dropped_node = Core::Scene_Graph::NONE;
+        Core::Scene_Graph::Node drop_parent = Core::Scene_Graph::NONE;
         // constructors and deconstructor
     public:
         Scene_Widget(const std::string &name = "Scene_Widget", float x = 0, float y = 0, float width = 0, float height = 0, bool active = true)
@@ -232,6 +307,10 @@ namespace GUI
         // methods
     public:
         void bind_scene(Rendering::Scene *scene) { this->scene = scene; }
+
+    private:
+        void show_scene_node(Core::Scene_Graph &graph, Core::Scene_Graph::Node node);
+        void accept_scene_node(Core::Scene_Graph::Node parent);
     };
 
     // class Cubemap_Dialog : public IMG_Widget
@@ -304,5 +383,9 @@ namespace GUI
 
     void load_map_button(const std::string &name, std::string &path);
     void update_material(Rendering::Material_PBR *material);
+    // name of the object behind a scene graph node, "Group <n>" for plain group nodes
+    std::string scene_node_name(const Core::Scene_Graph &graph, Core::Scene_Graph::Node node);
+    // makes the last item draggable onto scene graph nodes
+    void scene_node_drag_source(const Core::Scene_Graph &graph, Core::Scene_Graph::Node node);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "instance_buffer.h"
+#include <stdexcept>
+
+namespace Rendering
+{
+    void Instance_Buffer::commit()
+    {
+        if (staging.empty())
+        {
+            return;
+        }
+        if (buffer == 0)
+        {
+            glGenBuffers(1, &buffer);
+        }
+        if (capacity < staging.size())
+        {
+            capacity = capacity == 0 ? 1024 : capacity;
+            while (capacity < staging.size())
+            {
+                capacity *= 2;
+            }
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        // orphaned, last frame's draws keep their storage
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Instance_Data), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, staging.size() * sizeof(Instance_Data), staging.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void Instance_Buffer::bind_attributes(size_t first) const
+    {
+        if (buffer == 0)
+        {
+            throw std::runtime_error("Instance_Buffer::bind_attributes: nothing was committed");
+        }
+        const GLsizei stride = sizeof(Instance_Data);
+        const size_t base = first * sizeof(Instance_Data);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        for (GLuint i = 0; i < 4; ++i)
+        {
+            glVertexAttribPointer(INSTANCE_ATTRIBUTE::MODEL + i, 4, GL_FLOAT, GL_FALSE, stride, (void *)(base + offsetof(Instance_Data, model) + i * 4 * sizeof(float)));
+        }
+        for (GLuint i = 0; i < 3; ++i)
+        {
+            glVertexAttribPointer(INSTANCE_ATTRIBUTE::NORMAL_MATRIX + i, 3, GL_FLOAT, GL_FALSE, stride, (void *)(base + offsetof(Instance_Data, normal_matrix) + i * 3 * sizeof(float)));
+        }
+        glVertexAttribPointer(INSTANCE_ATTRIBUTE::ALBEDO, 3, GL_FLOAT, GL_FALSE, stride, (void *)(base + offsetof(Instance_Data, albedo)));
+        glVertexAttribPointer(INSTANCE_ATTRIBUTE::MATERIAL, 3, GL_FLOAT, GL_FALSE, stride, (void *)(base + offsetof(Instance_Data, metallic)));
+        for (GLuint i = INSTANCE_ATTRIBUTE::MODEL; i < INSTANCE_ATTRIBUTE::END; ++i)
+        {
+            glEnableVertexAttribArray(i);
+            glVertexAttribDivisor(i, 1);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void Instance_Buffer::destroy()
+    {
+        if (buffer != 0)
+        {
+            glDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
+        capacity = 0;
+        staging.clear();
+    }
+} // namespace Rendering
@@ -0,0 +1,72 @@
+#pragma once
+#ifndef RENDERING_INSTANCE_BUFFER_H
+#define RENDERING_INSTANCE_BUFFER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+    // vertex attribute locations of the per-instance data, after the mesh's own 0-3
+    struct INSTANCE_ATTRIBUTE
+    {
+        static const GLuint MODEL = 4;         // mat4, 4-7
+        static const GLuint NORMAL_MATRIX = 8; // mat3, 8-10
+        static const GLuint ALBEDO = 11;       // vec3
+        static const GLuint MATERIAL = 12;     // vec3: metallic, roughness, ao
+        static const GLuint END = 13;
+    };
+
+    // one instance as pbr.vert reads it; matrices as uploaded with glUniformMatrix*
+    struct Instance_Data
+    {
+        float model[16];
+        float normal_matrix[9];
+        float albedo[3];
+        float metallic;
+        float roughness;
+        float ao;
+        float pad_0;
+    };
+    static_assert(sizeof(Instance_Data) == 128, "Instance_Data is expected to be 128 bytes");
+
+    // Instances of a frame: push() stages them, commit() orphans the buffer and
+    // uploads all of them at once, bind_attributes() points the instance
+    // attributes of the bound vertex array at them. Draws pick their run with
+    // a base instance, so the attributes are pointed once per vertex array.
+    class Instance_Buffer
+    {
+        // attributes
+    private:
+        GLuint buffer = 0;
+        // in instances
+        size_t capacity = 0;
+        std::vector<Instance_Data> staging;
+
+        // constructors and deconstructor
+    public:
+        Instance_Buffer() = default;
+        ~Instance_Buffer() { destroy(); }
+        Instance_Buffer(const Instance_Buffer &) = delete;
+        Instance_Buffer &operator=(const Instance_Buffer &) = delete;
+
+        // methods
+    public:
+        void reset() { staging.clear(); }
+        // the slot to write, valid until the next push
+        Instance_Data &push()
+        {
+            staging.emplace_back();
+            return staging.back();
+        }
+        size_t size() const { return staging.size(); }
+        void commit();
+        // on the bound vertex array, starting at instance `first`
+        void bind_attributes(size_t first) const;
+        void destroy();
+    };
+} // namespace Rendering
+
+#endif // RENDERING_INSTANCE_BUFFER_H
@@ -1,31 +1,83 @@
 #include "light.h"
+#include <cstring>
+#include "gl_state.h"
 
 void Rendering::Light::visualize(Shader_Program *shader)
 {
     if (mesh)
     {
-        Core::Matrix4 model = transform->get_model_matrix();
-        Core::Matrix3 normal_matrix = transform->get_normal_matrix();
         shader->activate();
-        shader->set_vec3("u_color", color.data());
-        shader->set_mat4("u_model", model.data());
-        shader->set_mat3("u_normal_matrix", normal_matrix.data());
         mesh->bind_buffer();
         // enable face culling
-        glEnable(GL_CULL_FACE);
-        glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, 0);
-        glDisable(GL_CULL_FACE);
+        GL_State::instance().enable(GL_CULL_FACE);
+        glDrawElementsBaseVertex(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, mesh->index_offset(), mesh->base_vertex());
+        GL_State::instance().disable(GL_CULL_FACE);
         mesh->unbind_buffer();
     }
 }
 
+Core::Vec3 Rendering::Light::get_position() const
+{
+    if (scene_graph)
+    {
+        return scene_graph->get_world_position(node);
+    }
+    return transform->get_position();
+}
+
+Core::Vec3 Rendering::Light::get_direction() const
+{
+    auto front = transform->get_front();
+    if (scene_graph == nullptr || scene_graph->get_parent(node) == Core::Scene_Graph::NONE)
+    {
+        return front;
+    }
+    // rotate the local front by the parent, row vector times matrix
+    const Core::Mat3 parent = Core::Mat3(scene_graph->get_world_matrix(scene_graph->get_parent(node)));
+    return Core::Geometry::normalize(parent.transpose() * front);
+}
+
+void Rendering::Light::Uniforms::resolve(const Shader_Program *shader, const std::string &name)
+{
+    position = shader->get_uniform<Uniform_Type::VEC3>(name + ".position");
+    direction = shader->get_uniform<Uniform_Type::VEC3>(name + ".direction");
+    color = shader->get_uniform<Uniform_Type::VEC3>(name + ".color");
+    type = shader->get_uniform<Uniform_Type::INT>(name + ".type");
+    intensity = shader->get_uniform<Uniform_Type::FLOAT>(name + ".intensity");
+}
+
 void Rendering::Light::write_to_shader(const std::string &name_, Shader_Program *shader)
 {
-    shader->set_vec3(name_ + ".position", get_position().data());
-    shader->set_vec3(name_ + ".direction", get_direction().data());
-    shader->set_vec3(name_ + ".color", color.data());
-    shader->set_int(name_ + ".type", type);
-    shader->set_float(name_ + ".intensity", intensity);
+    Uniforms uniforms;
+    uniforms.resolve(shader, name_);
+    write_to_shader(uniforms, shader);
+}
+
+void Rendering::Light::write_to_shader(const Uniforms &uniforms, Shader_Program *shader)
+{
+    shader->set(uniforms.position, get_position().data());
+    shader->set(uniforms.direction, get_direction().data());
+    shader->set(uniforms.color, color.data());
+    shader->set(uniforms.type, static_cast<int>(type));
+    shader->set(uniforms.intensity, intensity);
+}
+
+void Rendering::Light::write_light_data(Light_Data &data) const
+{
+    std::memcpy(data.position, get_position().data(), sizeof(data.position));
+    std::memcpy(data.direction, get_direction().data(), sizeof(data.direction));
+    std::memcpy(data.color, color.data(), sizeof(data.color));
+    data.type = static_cast<int32_t>(type);
+    data.intensity = intensity;
+}
+
+void Rendering::Light::write_draw_data(Draw_Data &data) const
+{
+    const Core::Mat4 &model = scene_graph ? scene_graph->get_world_matrix(node) : transform->get_model_matrix();
+    const Core::Mat3 &normal_matrix = scene_graph ? scene_graph->get_world_normal_matrix(node) : transform->get_normal_matrix();
+    std::memcpy(data.model, model.data(), sizeof(data.model));
+    data.set_normal_matrix(normal_matrix.data());
+    std::memcpy(data.color, color.data(), sizeof(data.color));
 }
 
 void Rendering::Light::write_to_shader(const std::string &name_, int index, Shader_Program *shader)
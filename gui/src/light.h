@@ -4,8 +4,11 @@
 
 #include <memory>
 #include "models.h"
+#include "mesh_cache.h"
 #include "configurable.h"
 #include "transform.h"
+#include "scene_graph.h"
+#include "uniform_buffer.h"
 
 namespace Rendering
 {
@@ -18,6 +21,18 @@ namespace Rendering
     class Light : virtual public Core::Configurable
     {
     public:
+        // the members of one shader Light, resolved once per program
+        struct Uniforms
+        {
+            Uniform_Vec3 position;
+            Uniform_Vec3 direction;
+            Uniform_Vec3 color;
+            Uniform_Int type;
+            Uniform_Float intensity;
+
+            void resolve(const Shader_Program *shader, const std::string &name);
+        };
+
         enum Light_Type
         {
             PARALLEL_LIGHT = 0,
@@ -27,36 +42,46 @@ namespace Rendering
         // attributes
     public:
         Light_Type type = POINT_LIGHT;
-        Core::Vector3 color = Core::Vector3{1.0, 1.0, 1.0};
+        Core::Vec3 color = Core::Vec3{1.0, 1.0, 1.0};
         float intensity = 1.0;
         Core::Transform_Ptr transform;
-        OGL_Mesh *mesh = nullptr;
+        // the marker drawn by visualize, shared by all lights
+        OGL_Mesh_S_Ptr mesh;
+        // set when the light is added to a scene, the transform is then relative to the parent node
+        Core::Scene_Graph *scene_graph = nullptr;
+        Core::Scene_Graph::Node node = Core::Scene_Graph::NONE;
         // constructors and deconstructor
     public:
-        Light(Light_Type light_type = POINT_LIGHT, Core::Vector3 color = Core::Vector3{1.0, 1.0, 1.0}, float intensity = 1.0)
+        Light(Light_Type light_type = POINT_LIGHT, Core::Vec3 color = Core::Vec3{1.0, 1.0, 1.0}, float intensity = 1.0)
             : Configurable("Light"),
               type(light_type), color(color), intensity(intensity), transform(std::move(Core::Transform_Ptr(new Core::Transform())))
         {
-            mesh = OGL_Mesh::sphere_mesh().release();
+            mesh = Mesh_Cache::instance().sphere();
             transform->set_scale(0.05);
         }
-        Light(Core::Transform *transform, Light_Type light_type = POINT_LIGHT, Core::Vector3 color = Core::Vector3{1.0, 1.0, 1.0}, float intensity = 1.0)
+        Light(Core::Transform *transform, Light_Type light_type = POINT_LIGHT, Core::Vec3 color = Core::Vec3{1.0, 1.0, 1.0}, float intensity = 1.0)
             : Configurable("Light"),
               type(light_type), color(color), intensity(intensity), transform(Core::Transform_Ptr(transform))
         {
-            mesh = OGL_Mesh::sphere_mesh().release();
+            mesh = Mesh_Cache::instance().sphere();
             transform->set_scale(0.05);
         }
         virtual ~Light() {}
         // methods
     public:
-        Core::Vector3 get_position() const { return transform->get_position(); }
-        Core::Vector3 get_direction() const { return transform->get_front(); }
-        void set_position(Core::Vector3 position) { transform->set_position(position); }
-        void set_direction(Core::Vector3 direction) { transform->set_front(direction); }
-        void spot_on(Core::Vector3 target) { transform->look_at(target); }
+        // in world space
+        Core::Vec3 get_position() const;
+        Core::Vec3 get_direction() const;
+        void set_position(Core::Vec3 position) { transform->set_position(position); }
+        void set_direction(Core::Vec3 direction) { transform->set_front(direction); }
+        void spot_on(Core::Vec3 target) { transform->look_at(target); }
         void write_to_shader(const std::string &name, Shader_Program *shader);
         void write_to_shader(const std::string &name, int index, Shader_Program *shader);
+        void write_to_shader(const Uniforms &uniforms, Shader_Program *shader);
+        // the light as seen by the shading pass, and its marker mesh
+        void write_light_data(Light_Data &data) const;
+        void write_draw_data(Draw_Data &data) const;
+        // the draw data of the light must be bound to UNIFORM_BINDING::DRAW
         void visualize(Shader_Program *shader);
     };
 
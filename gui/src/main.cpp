@@ -1,4 +1,9 @@
 #include "application.h"
+#include "profiler.h"
+#include "gpu_profiler.h"
+#include "gl_stats.h"
+#include "gl_state.h"
+#include "gl_extensions.h"
 #include <iostream>
 #include <fstream>
 #include <ctime>
@@ -50,22 +55,25 @@ void init_glad()
     {
         std::cout << "Failed to initialize GLAD" << std::endl;
     }
+    // draw entry points past GL 3.3, where the context has them
+    Rendering::GL_Extensions::load((GLADloadproc)glfwGetProcAddress);
 }
 
 void init_opengl()
 {
+    auto &state = Rendering::GL_State::instance();
     // enable depth testing
-    glEnable(GL_DEPTH_TEST);
+    state.enable(GL_DEPTH_TEST);
     // enable multisampling
-    glEnable(GL_MULTISAMPLE);
+    state.enable(GL_MULTISAMPLE);
     // enable face culling
-    glEnable(GL_CULL_FACE);
+    state.enable(GL_CULL_FACE);
     // enable blending
-    glEnable(GL_BLEND);
+    state.enable(GL_BLEND);
     // set blending function
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     // enable seamless cubemap sampling
-    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+    state.enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 }
 
 GLFWwindow *init_glfw(int width, int height, int x_pos, int y_pos)
@@ -124,8 +132,12 @@ void glfw_error_callback(int error, const char *description)
 
 void loop(GLFWwindow *glfw_window, GUI::Application *app)
 {
+    Core::Profiler::set_thread_name("Main");
     while (!glfwWindowShouldClose(glfw_window))
     {
+        CORE_PROFILE_FRAME();
+        GPU_PROFILE_FRAME();
+        Rendering::GL_Stats::instance().begin_frame();
         glfwPollEvents();
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -135,8 +147,11 @@ void loop(GLFWwindow *glfw_window, GUI::Application *app)
         ImGui::DockSpaceOverViewport(viewport);
 
         app->run();
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            CORE_PROFILE_SCOPE("ImGui::Render");
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
         if (ImGui::GetIO().ConfigFlags)
         {
             GLFWwindow *backup_current_context = glfwGetCurrentContext();
@@ -144,12 +159,17 @@ void loop(GLFWwindow *glfw_window, GUI::Application *app)
             ImGui::RenderPlatformWindowsDefault();
             glfwMakeContextCurrent(backup_current_context);
         }
-        glfwSwapBuffers(glfw_window);
+        {
+            CORE_PROFILE_SCOPE("glfwSwapBuffers");
+            glfwSwapBuffers(glfw_window);
+        }
     }
 }
 
 void destroy(GLFWwindow *glfw_window)
 {
+    Rendering::GPU_Profiler::instance().destroy();
+    Rendering::GL_Stats::instance().set_enabled(false);
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
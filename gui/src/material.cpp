@@ -1,5 +1,6 @@
 #include "material.h"
 #include "scene.h"
+#include "gl_state.h"
 namespace Rendering
 {
     Material_PBR::Material_PBR(Core::Vector3 color, float metallic, float roughness, float ao, Core::Vector3 emissive_color, float emissive_intensity, float height_scale)
@@ -41,7 +42,7 @@ namespace Rendering
 
     void Material_PBR::unbind() const
     {
-        glActiveTexture(GL_TEXTURE0);
+        GL_State::instance().active_texture(0);
     }
 
     void Material_PBR::set_map(Texture *tex, const std::string &path, Map_Type type)
@@ -81,111 +82,106 @@ namespace Rendering
         }
     }
 
-    void Material_PBR::write_to_shader(const std::string &m_name, Shader_Program *shader)
+    namespace
     {
-        auto place_holder_map = Texture_Manager::instance().get_default_2d();
-        shader->set_float(m_name + ".metallic", get_metallic());
-        shader->set_float(m_name + ".roughness", get_roughness());
-        shader->set_float(m_name + ".ao", get_ao());
-        shader->set_float(m_name + ".height_scale", get_height_scale());
-        shader->set_vec3(m_name + ".albedo", get_albedo().data());
-        shader->set_vec3(m_name + ".emissive", get_emissive().data());
-        auto albedo_map = get_albedo_map();
-        if (albedo_map)
-        {
-            shader->set_float(m_name + ".albedo_texture_factor", 1.f);
-            albedo_map->bind(PBR_TEXTURE_UNIT::ALBEDO);
-            shader->set_int(m_name + ".albedo_map", PBR_TEXTURE_UNIT::ALBEDO);
-        }
-        else
-        {
-            place_holder_map->bind(PBR_TEXTURE_UNIT::ALBEDO);
-            shader->set_int(m_name + ".albedo_map", PBR_TEXTURE_UNIT::ALBEDO);
-            shader->set_float(m_name + ".albedo_texture_factor", 0.f);
-        }
-        auto normal_map = get_normal_map();
-        if (normal_map)
-        {
-            shader->set_float(m_name + ".normal_texture_factor", 1.f);
-            normal_map->bind(PBR_TEXTURE_UNIT::NORMAL);
-            shader->set_int(m_name + ".normal_map", PBR_TEXTURE_UNIT::NORMAL);
-        }
-        else
-        {
-            place_holder_map->bind(PBR_TEXTURE_UNIT::NORMAL);
-            shader->set_int(m_name + ".normal_map", PBR_TEXTURE_UNIT::NORMAL);
-            shader->set_float(m_name + ".normal_texture_factor", 0.f);
-        }
-        auto height_map = get_height_map();
-        if (height_map)
-        {
-            shader->set_float(m_name + ".height_texture_factor", 1.f);
-            height_map->bind(PBR_TEXTURE_UNIT::HEIGHT);
-            shader->set_int(m_name + ".height_map", PBR_TEXTURE_UNIT::HEIGHT);
-        }
-        else
-        {
-            place_holder_map->bind(PBR_TEXTURE_UNIT::HEIGHT);
-            shader->set_int(m_name + ".height_map", PBR_TEXTURE_UNIT::HEIGHT);
-            shader->set_float(m_name + ".height_texture_factor", 0.f);
-        }
-        auto metallic_map = get_metallic_map();
-        if (metallic_map)
-        {
-            shader->set_float(m_name + ".metallic_texture_factor", 1.f);
-            metallic_map->bind(PBR_TEXTURE_UNIT::METALLIC);
-            shader->set_int(m_name + ".metallic_map", PBR_TEXTURE_UNIT::METALLIC);
-        }
-        else
-        {
-            place_holder_map->bind(PBR_TEXTURE_UNIT::METALLIC);
-            shader->set_int(m_name + ".metallic_map", PBR_TEXTURE_UNIT::METALLIC);
-            shader->set_float(m_name + ".metallic_texture_factor", 0.f);
-        }
-        auto roughness_map = get_roughness_map();
-        if (roughness_map)
-        {
-            shader->set_float(m_name + ".roughness_texture_factor", 1.f);
-            roughness_map->bind(PBR_TEXTURE_UNIT::ROUGHNESS);
-            shader->set_int(m_name + ".roughness_map", PBR_TEXTURE_UNIT::ROUGHNESS);
-        }
-        else
+        Material_PBR::Map_Uniforms resolve_map(const Shader_Program *shader, const std::string &name, const std::string &map)
         {
-            place_holder_map->bind(PBR_TEXTURE_UNIT::ROUGHNESS);
-            shader->set_int(m_name + ".roughness_map", PBR_TEXTURE_UNIT::ROUGHNESS);
-            shader->set_float(m_name + ".roughness_texture_factor", 0.f);
+            Material_PBR::Map_Uniforms rslt;
+            rslt.map = shader->get_uniform<Uniform_Type::INT>(name + "." + map + "_map");
+            rslt.factor = shader->get_uniform<Uniform_Type::FLOAT>(name + "." + map + "_texture_factor");
+            return rslt;
         }
-        auto ao_map = get_ao_map();
-        if (ao_map)
-        {
-            shader->set_float(m_name + ".ao_texture_factor", 1.f);
-            ao_map->bind(PBR_TEXTURE_UNIT::AO);
-            shader->set_int(m_name + ".ao_map", PBR_TEXTURE_UNIT::AO);
-        }
-        else
-        {
-            place_holder_map->bind(PBR_TEXTURE_UNIT::AO);
-            shader->set_int(m_name + ".ao_map", PBR_TEXTURE_UNIT::AO);
-            shader->set_float(m_name + ".ao_texture_factor", 0.f);
-        }
-        shader->set_float(m_name + ".emissive_intensity", emissive_intensity);
 
-        shader->set_vec3(m_name + ".emissive", emissive_color.data());
-        auto emissive_map = get_emissive_map();
-        if (emissive_map)
-        {
-            shader->set_float(m_name + ".emissive_texture_factor", 1.0f);
-            emissive_map->bind(PBR_TEXTURE_UNIT::EMISSIVE);
-            shader->set_int(m_name + ".emissive_map", PBR_TEXTURE_UNIT::EMISSIVE);
-        }
-        else
-        {
-            place_holder_map->bind(PBR_TEXTURE_UNIT::EMISSIVE);
-            shader->set_int(m_name + ".emissive_map", PBR_TEXTURE_UNIT::EMISSIVE);
-            shader->set_float(m_name + ".emissive_texture_factor", 0.f);
+        // a missing map samples the place holder with a factor of 0
+        void write_map(Texture *map, int unit, const Material_PBR::Map_Uniforms &uniforms, Shader_Program *shader)
+        {
+            if (map)
+            {
+                map->bind(unit);
+            }
+            else
+            {
+                Texture_Manager::instance().get_default_2d()->bind(unit);
+            }
+            shader->set(uniforms.map, unit);
+            shader->set(uniforms.factor, map ? 1.f : 0.f);
         }
     }
 
+    void Material_PBR::Uniforms::resolve(const Shader_Program *shader, const std::string &name)
+    {
+        albedo = shader->get_uniform<Uniform_Type::VEC3>(name + ".albedo");
+        emissive = shader->get_uniform<Uniform_Type::VEC3>(name + ".emissive");
+        metallic = shader->get_uniform<Uniform_Type::FLOAT>(name + ".metallic");
+        roughness = shader->get_uniform<Uniform_Type::FLOAT>(name + ".roughness");
+        ao = shader->get_uniform<Uniform_Type::FLOAT>(name + ".ao");
+        height_scale = shader->get_uniform<Uniform_Type::FLOAT>(name + ".height_scale");
+        emissive_intensity = shader->get_uniform<Uniform_Type::FLOAT>(name + ".emissive_intensity");
+        albedo_map = resolve_map(shader, name, "albedo");
+        normal_map = resolve_map(shader, name, "normal");
+        height_map = resolve_map(shader, name, "height");
+        metallic_map = resolve_map(shader, name, "metallic");
+        roughness_map = resolve_map(shader, name, "roughness");
+        ao_map = resolve_map(shader, name, "ao");
+        emissive_map = resolve_map(shader, name, "emissive");
+    }
+
+    void Material_PBR::write_to_shader(const std::string &m_name, Shader_Program *shader)
+    {
+        Uniforms uniforms;
+        uniforms.resolve(shader, m_name);
+        write_to_shader(uniforms, shader);
+    }
+
+    void Material_PBR::write_to_shader(const Uniforms &uniforms, Shader_Program *shader)
+    {
+        shader->set(uniforms.metallic, get_metallic());
+        shader->set(uniforms.roughness, get_roughness());
+        shader->set(uniforms.ao, get_ao());
+        shader->set(uniforms.height_scale, get_height_scale());
+        shader->set(uniforms.albedo, get_albedo().data());
+        shader->set(uniforms.emissive, emissive_color.data());
+        shader->set(uniforms.emissive_intensity, emissive_intensity);
+        write_map(get_albedo_map(), PBR_TEXTURE_UNIT::ALBEDO, uniforms.albedo_map, shader);
+        write_map(get_normal_map(), PBR_TEXTURE_UNIT::NORMAL, uniforms.normal_map, shader);
+        write_map(get_height_map(), PBR_TEXTURE_UNIT::HEIGHT, uniforms.height_map, shader);
+        write_map(get_metallic_map(), PBR_TEXTURE_UNIT::METALLIC, uniforms.metallic_map, shader);
+        write_map(get_roughness_map(), PBR_TEXTURE_UNIT::ROUGHNESS, uniforms.roughness_map, shader);
+        write_map(get_ao_map(), PBR_TEXTURE_UNIT::AO, uniforms.ao_map, shader);
+        write_map(get_emissive_map(), PBR_TEXTURE_UNIT::EMISSIVE, uniforms.emissive_map, shader);
+    }
+
+    void Material_PBR::write_instance_data(Instance_Data &data) const
+    {
+        data.albedo[0] = color.x();
+        data.albedo[1] = color.y();
+        data.albedo[2] = color.z();
+        data.metallic = metallic;
+        data.roughness = roughness;
+        data.ao = ao;
+    }
+
+    uint64_t Material_PBR::get_batch_hash() const
+    {
+        // FNV-1a over the maps and the shared scalars
+        uint64_t rslt = 14695981039346656037ull;
+        auto mix = [&rslt](const void *data, size_t size)
+        {
+            const auto *bytes = static_cast<const unsigned char *>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                rslt = (rslt ^ bytes[i]) * 1099511628211ull;
+            }
+        };
+        const Texture *maps[] = {albedo_map, normal_map, height_map, metallic_map, roughness_map, ao_map, emissive_map};
+        mix(maps, sizeof(maps));
+        const float emissive[] = {emissive_color.x(), emissive_color.y(), emissive_color.z()};
+        mix(emissive, sizeof(emissive));
+        mix(&emissive_intensity, sizeof(emissive_intensity));
+        mix(&height_scale, sizeof(height_scale));
+        return rslt;
+    }
+
     Material_PHONG::Material_PHONG(Core::Vector3 ambient, Core::Vector3 diffuse, Core::Vector3 specular, float shininess)
         : ambient(ambient), diffuse(diffuse), specular(specular), shininess(shininess)
     {
@@ -200,28 +196,23 @@ namespace Rendering
     {
         if (ambient_map)
         {
-            glActiveTexture(GL_TEXTURE0 + start_index + 0);
-            ambient_map->bind();
+            ambient_map->bind(start_index + 0);
         }
         if (diffuse_map)
         {
-            glActiveTexture(GL_TEXTURE0 + start_index + 1);
-            diffuse_map->bind();
+            diffuse_map->bind(start_index + 1);
         }
         if (specular_map)
         {
-            glActiveTexture(GL_TEXTURE0 + start_index + 2);
-            specular_map->bind();
+            specular_map->bind(start_index + 2);
         }
         if (normal_map)
         {
-            glActiveTexture(GL_TEXTURE0 + start_index + 3);
-            normal_map->bind();
+            normal_map->bind(start_index + 3);
         }
         if (height_map)
         {
-            glActiveTexture(GL_TEXTURE0 + start_index + 4);
-            height_map->bind();
+            height_map->bind(start_index + 4);
         }
     }
 
@@ -5,6 +5,7 @@
 #include "shader.h"
 #include "configurable.h"
 #include "vector.h"
+#include "instance_buffer.h"
 
 namespace Rendering
 {
@@ -54,6 +55,31 @@ namespace Rendering
             NORMAL_MAP,
             HEIGHT_MAP
         };
+        struct Map_Uniforms
+        {
+            Uniform_Int map;
+            Uniform_Float factor;
+        };
+        // the members of the shader Material, resolved once per program
+        struct Uniforms
+        {
+            Uniform_Vec3 albedo;
+            Uniform_Vec3 emissive;
+            Uniform_Float metallic;
+            Uniform_Float roughness;
+            Uniform_Float ao;
+            Uniform_Float height_scale;
+            Uniform_Float emissive_intensity;
+            Map_Uniforms albedo_map;
+            Map_Uniforms normal_map;
+            Map_Uniforms height_map;
+            Map_Uniforms metallic_map;
+            Map_Uniforms roughness_map;
+            Map_Uniforms ao_map;
+            Map_Uniforms emissive_map;
+
+            void resolve(const Shader_Program *shader, const std::string &name);
+        };
         // attributes
     public:
         Core::Vector3 color;
@@ -115,6 +141,11 @@ namespace Rendering
         Texture *get_height_map() const { return height_map; }
 
         void write_to_shader(const std::string &m_name, Shader_Program *shader);
+        void write_to_shader(const Uniforms &uniforms, Shader_Program *shader);
+        // the scalars the pbr shader reads per instance: albedo, metallic, roughness, ao
+        void write_instance_data(Instance_Data &data) const;
+        // hash of everything else write_to_shader sets, materials with equal hashes can share a draw
+        uint64_t get_batch_hash() const;
     };
 
     class Material_PHONG;
@@ -1,8 +1,12 @@
 #include "mesh.h"
+#include "profiler.h"
+#include "gl_state.h"
+#include "mesh_buffer.h"
 #include <cstdarg>
 #include <vector>
 #include <cstring>
 #include <cmath>
+#include <limits>
 
 namespace Rendering
 {
@@ -23,21 +27,18 @@ namespace Rendering
 
     void OGL_Mesh::bind_buffer()
     {
-        glBindVertexArray(vao);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        // the element buffer is part of the vertex array, the vertex buffer is only needed for uploads
+        GL_State::instance().bind_vertex_array(vao);
     }
 
     void OGL_Mesh::unbind_buffer()
     {
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        // the vertex array stays bound until the next bind_buffer replaces it
     }
 
     void OGL_Mesh::map_buffers()
     {
-        glBindVertexArray(vao);
+        GL_State::instance().bind_vertex_array(vao);
         glBindBuffer(GL_ARRAY_BUFFER, vbo);
         glBufferData(GL_ARRAY_BUFFER, vertices.size(), vertices.data(), GL_STATIC_DRAW);
 
@@ -53,22 +54,30 @@ namespace Rendering
             offset += segment.size();
         }
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
     }
 
     void OGL_Mesh::setup_buffers()
     {
-        create_vao();
-        create_vbo();
-        create_ebo();
-        bind_buffer();
-        map_buffers();
-        unbind_buffer();
+        CORE_PROFILE_SCOPE("OGL_Mesh::setup_buffers");
+        compute_bounds();
+        shared_buffer = &Mesh_Buffer::of(layout);
+        region = shared_buffer->allocate(vertex_count(), index_count());
+        shared_buffer->upload(region, *this);
+        vao = shared_buffer->get_vao();
     }
 
     void OGL_Mesh::destroy()
     {
-        unbind_buffer();
+        if (shared_buffer != nullptr)
+        {
+            // the vertex array belongs to the shared buffer
+            shared_buffer->release(region);
+            shared_buffer = nullptr;
+            region = Buffer_Region();
+            vao = 0;
+            return;
+        }
+        GL_State::instance().forget_vertex_array(vao);
         glDeleteVertexArrays(1, &vao);
         glDeleteBuffers(1, &vbo);
         glDeleteBuffers(1, &ebo);
@@ -76,19 +85,33 @@ namespace Rendering
 
     void OGL_Mesh::update()
     {
+        compute_bounds();
+        if (shared_buffer != nullptr)
+        {
+            // same vertex and index counts as when it was placed
+            shared_buffer->upload(region, *this);
+            return;
+        }
         bind_buffer();
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
         glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size(), vertices.data());
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(unsigned int), indices.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
         unbind_buffer();
     }
 
     void OGL_Mesh::render(Shader_Program *shader)
     {
         bind_buffer();
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        glDrawElementsBaseVertex(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, index_offset(), base_vertex());
         unbind_buffer();
     }
 
+    Draw_Elements_Command OGL_Mesh::draw_command(GLuint instance_count, GLuint base_instance) const
+    {
+        return {static_cast<GLuint>(indices.size()), instance_count, static_cast<GLuint>(region.first_index), base_vertex(), base_instance};
+    }
+
     OGL_Mesh_Ptr OGL_Mesh::cube_mesh(float width, float height, float depth)
     {
         Rendering::Mesh::Layout layout;
@@ -495,6 +518,21 @@ namespace Rendering
         indices.clear();
     }
 
+    void Mesh::compute_bounds()
+    {
+        const size_t stride = layout.size();
+        if (layout.count() == 0 || layout[0].element_type != GL_FLOAT || layout[0].count < 3 || stride % sizeof(float) != 0)
+        {
+            bounds = Core::Geometry::AABB();
+            bounding_sphere = Core::Geometry::BoundingSphere();
+            bounding_sphere.radius = std::numeric_limits<float>::infinity();
+            return;
+        }
+        const float *positions = reinterpret_cast<const float *>(vertices.data());
+        bounds = Core::Geometry::compute_aabb(positions, vertex_count(), stride / sizeof(float));
+        bounding_sphere = Core::Geometry::compute_sphere(positions, vertex_count(), stride / sizeof(float));
+    }
+
     size_t Mesh::Layout::size() const
     {
         size_t rslt = 0;
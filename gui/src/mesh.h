@@ -6,6 +6,7 @@
 #include <vector>
 #include <memory>
 #include "shader.h"
+#include "geometry/culling.h"
 #include <typeinfo>
 #include <iostream>
 #include <cstring>
@@ -62,6 +63,9 @@ namespace Rendering
         std::vector<char> vertices;
         std::vector<unsigned int> indices;
         Layout layout;
+        // of the positions, the first attribute; kept up to date by compute_bounds
+        Core::Geometry::AABB bounds;
+        Core::Geometry::BoundingSphere bounding_sphere;
 
     private:
         // constructors and deconstructor
@@ -102,12 +106,35 @@ namespace Rendering
         void append_index(unsigned int *data, size_t count) { indices.insert(indices.end(), data, data + count); }
 
         void clear();
+        // a mesh without float positions gets an infinite sphere, it is never culled
+        void compute_bounds();
 
         size_t vertex_count() const { return vertices.size() / layout.size(); }
         size_t index_count() const { return indices.size(); }
         // static methods
     };
 
+    class Mesh_Buffer;
+    // where a mesh lives in a shared Mesh_Buffer, in vertices and indices
+    struct Buffer_Region
+    {
+        size_t first_vertex = 0;
+        size_t vertex_count = 0;
+        size_t first_index = 0;
+        size_t index_count = 0;
+    };
+
+    // one draw as glMultiDrawElementsIndirect reads it
+    struct Draw_Elements_Command
+    {
+        GLuint count;
+        GLuint instance_count;
+        GLuint first_index;
+        GLint base_vertex;
+        GLuint base_instance;
+    };
+    static_assert(sizeof(Draw_Elements_Command) == 20, "Draw_Elements_Command is expected to be 20 bytes");
+
     class OGL_Mesh;
     using OGL_Mesh_U_Ptr = std::unique_ptr<OGL_Mesh>;
     using OGL_Mesh_S_Ptr = std::shared_ptr<OGL_Mesh>;
@@ -118,8 +145,11 @@ namespace Rendering
         // attributes
     public:
         GLuint vao;
+        // only set for a mesh with its own buffers, a shared one lives in `shared_buffer`
         GLuint vbo;
         GLuint ebo;
+        Mesh_Buffer *shared_buffer = nullptr;
+        Buffer_Region region;
         // constructors and deconstructor
     public:
         OGL_Mesh(Layout layout) : Mesh(layout), vao(0), vbo(0), ebo(0) {}
@@ -134,10 +164,15 @@ namespace Rendering
         void bind_buffer();
         void unbind_buffer();
         void map_buffers();
+        // places the mesh in the shared buffer of its layout
         void setup_buffers();
         void destroy();
         void update();
         void render(Shader_Program *shader);
+        // for glDraw*BaseVertex on the bound vertex array
+        GLint base_vertex() const { return static_cast<GLint>(region.first_vertex); }
+        const void *index_offset() const { return reinterpret_cast<const void *>(region.first_index * sizeof(unsigned int)); }
+        Draw_Elements_Command draw_command(GLuint instance_count = 1, GLuint base_instance = 0) const;
         // static methods
     public:
         static OGL_Mesh_Ptr cube_mesh(float width = 1.0f, float height = 1.0f, float depth = 1.0f);
@@ -0,0 +1,304 @@
+#include "mesh_buffer.h"
+#include <algorithm>
+#include <stdexcept>
+#include "gl_extensions.h"
+#include "gl_state.h"
+#include "profiler.h"
+
+namespace Rendering
+{
+    namespace
+    {
+        const size_t INITIAL_VERTICES = 1 << 16;
+        const size_t INITIAL_INDICES = 1 << 18;
+
+        bool same_layout(const Mesh::Layout &a, const Mesh::Layout &b)
+        {
+            if (a.count() != b.count())
+            {
+                return false;
+            }
+            for (unsigned int i = 0; i < a.count(); ++i)
+            {
+                if (a[i].element_type != b[i].element_type || a[i].element_size != b[i].element_size || a[i].count != b[i].count)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        size_t grown_capacity(size_t capacity, size_t required, size_t initial)
+        {
+            size_t rslt = std::max(capacity, initial);
+            while (rslt < required)
+            {
+                rslt *= 2;
+            }
+            return rslt;
+        }
+
+        // a larger copy of `buffer`, the old one is deleted
+        void grow_buffer(GLuint &buffer, size_t old_bytes, size_t new_bytes)
+        {
+            GLuint rslt = 0;
+            glGenBuffers(1, &rslt);
+            // the copy targets, binding the element buffer would change the bound vertex array
+            glBindBuffer(GL_COPY_WRITE_BUFFER, rslt);
+            glBufferData(GL_COPY_WRITE_BUFFER, new_bytes, nullptr, GL_STATIC_DRAW);
+            if (buffer != 0)
+            {
+                glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, old_bytes);
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                GL_State::instance().forget_buffer(buffer);
+                glDeleteBuffers(1, &buffer);
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            buffer = rslt;
+        }
+    }
+
+    size_t Range_Allocator::allocate(size_t count)
+    {
+        for (auto it = free_ranges.begin(); it != free_ranges.end(); ++it)
+        {
+            if (it->second >= count)
+            {
+                const size_t rslt = it->first;
+                const size_t left = it->second - count;
+                free_ranges.erase(it);
+                if (left > 0)
+                {
+                    free_ranges[rslt + count] = left;
+                }
+                return rslt;
+            }
+        }
+        return NONE;
+    }
+
+    void Range_Allocator::release(size_t first, size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        auto next = free_ranges.lower_bound(first);
+        if (next != free_ranges.end() && first + count == next->first)
+        {
+            count += next->second;
+            next = free_ranges.erase(next);
+        }
+        if (next != free_ranges.begin())
+        {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == first)
+            {
+                prev->second += count;
+                return;
+            }
+        }
+        free_ranges[first] = count;
+    }
+
+    void Range_Allocator::grow(size_t new_capacity)
+    {
+        if (new_capacity > capacity)
+        {
+            const size_t old_capacity = capacity;
+            capacity = new_capacity;
+            release(old_capacity, new_capacity - old_capacity);
+        }
+    }
+
+    size_t Range_Allocator::get_free() const
+    {
+        size_t rslt = 0;
+        for (const auto &range : free_ranges)
+        {
+            rslt += range.second;
+        }
+        return rslt;
+    }
+
+    Mesh_Buffer::Mesh_Buffer(const Mesh::Layout &layout) : layout(layout)
+    {
+        glGenVertexArrays(1, &vao);
+    }
+
+    Mesh_Buffer::~Mesh_Buffer()
+    {
+        GL_State::instance().forget_vertex_array(vao);
+        glDeleteVertexArrays(1, &vao);
+        GL_State::instance().forget_buffer(vbo);
+        glDeleteBuffers(1, &vbo);
+        GL_State::instance().forget_buffer(ebo);
+        glDeleteBuffers(1, &ebo);
+    }
+
+    Buffer_Region Mesh_Buffer::allocate(size_t vertex_count, size_t index_count)
+    {
+        Buffer_Region rslt;
+        rslt.vertex_count = vertex_count;
+        rslt.index_count = index_count;
+        if (vertex_count > 0)
+        {
+            rslt.first_vertex = vertex_ranges.allocate(vertex_count);
+            if (rslt.first_vertex == Range_Allocator::NONE)
+            {
+                grow_vertices(vertex_ranges.get_capacity() + vertex_count);
+                rslt.first_vertex = vertex_ranges.allocate(vertex_count);
+            }
+        }
+        if (index_count > 0)
+        {
+            rslt.first_index = index_ranges.allocate(index_count);
+            if (rslt.first_index == Range_Allocator::NONE)
+            {
+                grow_indices(index_ranges.get_capacity() + index_count);
+                rslt.first_index = index_ranges.allocate(index_count);
+            }
+        }
+        return rslt;
+    }
+
+    void Mesh_Buffer::release(const Buffer_Region &region)
+    {
+        vertex_ranges.release(region.first_vertex, region.vertex_count);
+        index_ranges.release(region.first_index, region.index_count);
+    }
+
+    void Mesh_Buffer::upload(const Buffer_Region &region, const Mesh &mesh)
+    {
+        const size_t stride = layout.size();
+        if (mesh.vertices.size() > region.vertex_count * stride || mesh.indices.size() > region.index_count)
+        {
+            throw std::runtime_error("Mesh_Buffer::upload: the mesh does not fit its region");
+        }
+        if (!mesh.vertices.empty())
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, region.first_vertex * stride, mesh.vertices.size(), mesh.vertices.data());
+        }
+        if (!mesh.indices.empty())
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, region.first_index * sizeof(unsigned int), mesh.indices.size() * sizeof(unsigned int), mesh.indices.data());
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    Mesh_Buffer &Mesh_Buffer::of(const Mesh::Layout &layout)
+    {
+        auto &all = buffers();
+        for (auto &buffer : all)
+        {
+            if (same_layout(buffer->layout, layout))
+            {
+                return *buffer;
+            }
+        }
+        all.emplace_back(new Mesh_Buffer(layout));
+        return *all.back();
+    }
+
+    const std::vector<std::unique_ptr<Mesh_Buffer>> &Mesh_Buffer::get_buffers()
+    {
+        return buffers();
+    }
+
+    void Mesh_Buffer::grow_vertices(size_t vertex_count)
+    {
+        CORE_PROFILE_SCOPE("Mesh_Buffer::grow_vertices");
+        const size_t stride = layout.size();
+        const size_t old_capacity = vertex_ranges.get_capacity();
+        const size_t new_capacity = grown_capacity(old_capacity, vertex_count, INITIAL_VERTICES);
+        grow_buffer(vbo, old_capacity * stride, new_capacity * stride);
+        vertex_ranges.grow(new_capacity);
+        map_attributes();
+    }
+
+    void Mesh_Buffer::grow_indices(size_t index_count)
+    {
+        CORE_PROFILE_SCOPE("Mesh_Buffer::grow_indices");
+        const size_t old_capacity = index_ranges.get_capacity();
+        const size_t new_capacity = grown_capacity(old_capacity, index_count, INITIAL_INDICES);
+        grow_buffer(ebo, old_capacity * sizeof(unsigned int), new_capacity * sizeof(unsigned int));
+        index_ranges.grow(new_capacity);
+        map_attributes();
+    }
+
+    void Mesh_Buffer::map_attributes()
+    {
+        GL_State::instance().bind_vertex_array(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        if (vbo != 0)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            size_t offset = 0;
+            for (unsigned int i = 0; i < layout.count(); ++i)
+            {
+                glVertexAttribPointer(i, layout[i].count, layout[i].element_type, GL_FALSE, layout.size(), reinterpret_cast<const void *>(offset));
+                glEnableVertexAttribArray(i);
+                offset += layout[i].size();
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+    }
+
+    std::vector<std::unique_ptr<Mesh_Buffer>> &Mesh_Buffer::buffers()
+    {
+        // never destroyed, meshes may still release regions during static destruction
+        static auto *rslt = new std::vector<std::unique_ptr<Mesh_Buffer>>();
+        return *rslt;
+    }
+
+    void Indirect_Draws::submit(const Instance_Buffer &instances)
+    {
+        if (commands.empty())
+        {
+            return;
+        }
+        if (!GL_Extensions::has_base_instance())
+        {
+            throw std::runtime_error("Indirect_Draws::submit: needs GL 4.2 or ARB_base_instance");
+        }
+        instances.bind_attributes(0);
+        if (GL_Extensions::has_multi_draw_indirect())
+        {
+            if (buffer == 0)
+            {
+                glGenBuffers(1, &buffer);
+            }
+            if (capacity < commands.size())
+            {
+                capacity = std::max(commands.size(), capacity * 2);
+            }
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+            // orphaned like the instance buffer
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, capacity * sizeof(Draw_Elements_Command), nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(Draw_Elements_Command), commands.data());
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands.size()), 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            return;
+        }
+        for (const auto &command : commands)
+        {
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.count, GL_UNSIGNED_INT,
+                                                          reinterpret_cast<const void *>(command.first_index * sizeof(unsigned int)),
+                                                          command.instance_count, command.base_vertex, command.base_instance);
+        }
+    }
+
+    void Indirect_Draws::destroy()
+    {
+        if (buffer != 0)
+        {
+            glDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
+        capacity = 0;
+        commands.clear();
+    }
+} // namespace Rendering
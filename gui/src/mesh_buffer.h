@@ -0,0 +1,122 @@
+#pragma once
+#ifndef RENDERING_MESH_BUFFER_H
+#define RENDERING_MESH_BUFFER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <vector>
+#include "mesh.h"
+#include "instance_buffer.h"
+
+namespace Rendering
+{
+    // [first, first + count) ranges handed out first fit, neighbours are
+    // merged on release. Only bookkeeping, the storage is the caller's.
+    class Range_Allocator
+    {
+        // attributes
+    private:
+        std::map<size_t, size_t> free_ranges;
+        size_t capacity = 0;
+
+        // methods
+    public:
+        static constexpr size_t NONE = ~size_t(0);
+        // NONE if no free range is large enough
+        size_t allocate(size_t count);
+        void release(size_t first, size_t count);
+        // the new space is free
+        void grow(size_t new_capacity);
+        size_t get_capacity() const { return capacity; }
+        size_t get_free() const;
+        // in first order
+        const std::map<size_t, size_t> &get_free_ranges() const { return free_ranges; }
+    };
+
+    // Vertex and index storage shared by every mesh of one layout: a single
+    // vertex array, vertex buffer and element buffer, handed out in regions
+    // from a first-fit free list. Indices stay relative to their mesh, draws
+    // add the region's base vertex. Growing copies the buffers on the GPU and
+    // re-points the vertex array, so a mesh's vertex array never changes.
+    // Main thread only, like the GL calls it makes.
+    class Mesh_Buffer
+    {
+        // attributes
+    private:
+        Mesh::Layout layout;
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        Range_Allocator vertex_ranges;
+        Range_Allocator index_ranges;
+
+        // constructors and deconstructor
+    public:
+        Mesh_Buffer(const Mesh::Layout &layout);
+        ~Mesh_Buffer();
+        Mesh_Buffer(const Mesh_Buffer &) = delete;
+        Mesh_Buffer &operator=(const Mesh_Buffer &) = delete;
+
+        // methods
+    public:
+        Buffer_Region allocate(size_t vertex_count, size_t index_count);
+        void release(const Buffer_Region &region);
+        // the mesh must fit in the region
+        void upload(const Buffer_Region &region, const Mesh &mesh);
+
+        GLuint get_vao() const { return vao; }
+        const Mesh::Layout &get_layout() const { return layout; }
+        size_t get_vertex_capacity() const { return vertex_ranges.get_capacity(); }
+        size_t get_used_vertices() const { return vertex_ranges.get_capacity() - vertex_ranges.get_free(); }
+        size_t get_index_capacity() const { return index_ranges.get_capacity(); }
+        size_t get_used_indices() const { return index_ranges.get_capacity() - index_ranges.get_free(); }
+
+        // the buffer of this layout, created on first use
+        static Mesh_Buffer &of(const Mesh::Layout &layout);
+        static const std::vector<std::unique_ptr<Mesh_Buffer>> &get_buffers();
+
+    private:
+        void grow_vertices(size_t vertex_count);
+        void grow_indices(size_t index_count);
+        void map_attributes();
+        static std::vector<std::unique_ptr<Mesh_Buffer>> &buffers();
+    };
+
+    // Draw commands on one vertex array, collected over a frame and issued
+    // together: uploaded into an indirect buffer for one
+    // glMultiDrawElementsIndirect where the context has it (GL 4.3 or
+    // ARB_multi_draw_indirect), a loop of
+    // glDrawElementsInstancedBaseVertexBaseInstance otherwise. Either way the
+    // instance attributes are pointed once and each command's base instance
+    // selects its run. See GL_Extensions.
+    class Indirect_Draws
+    {
+        // attributes
+    private:
+        std::vector<Draw_Elements_Command> commands;
+        GLuint buffer = 0;
+        // in commands
+        size_t capacity = 0;
+
+        // constructors and deconstructor
+    public:
+        Indirect_Draws() = default;
+        ~Indirect_Draws() { destroy(); }
+        Indirect_Draws(const Indirect_Draws &) = delete;
+        Indirect_Draws &operator=(const Indirect_Draws &) = delete;
+
+        // methods
+    public:
+        void clear() { commands.clear(); }
+        void push(const Draw_Elements_Command &command) { commands.push_back(command); }
+        size_t size() const { return commands.size(); }
+        bool empty() const { return commands.empty(); }
+        // on the bound vertex array, base_instance indexes `instances`
+        void submit(const Instance_Buffer &instances);
+        void destroy();
+    };
+} // namespace Rendering
+
+#endif // RENDERING_MESH_BUFFER_H
@@ -0,0 +1,165 @@
+#include "mesh_cache.h"
+#include <cstring>
+#include <sstream>
+
+namespace Rendering
+{
+    namespace
+    {
+        struct Primitive_Info
+        {
+            const char *name;
+            int param_count;
+        };
+
+        const Primitive_Info primitive_infos[Mesh_Cache::PRIMITIVE_COUNT] = {
+            {"cube", 3},
+            {"plane", 2},
+            {"grid", 4},
+            {"circle", 2},
+            {"sphere", 3},
+            {"quad", 2},
+        };
+    }
+
+    bool Mesh_Cache::Key::operator==(const Key &other) const
+    {
+        return primitive == other.primitive && std::memcmp(params, other.params, sizeof(params)) == 0;
+    }
+
+    size_t Mesh_Cache::Key_Hash::operator()(const Key &key) const
+    {
+        // FNV-1a over the primitive and the parameter bits
+        uint64_t rslt = 14695981039346656037ull;
+        auto mix = [&rslt](const void *data, size_t size)
+        {
+            const auto *bytes = static_cast<const unsigned char *>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                rslt = (rslt ^ bytes[i]) * 1099511628211ull;
+            }
+        };
+        mix(&key.primitive, sizeof(key.primitive));
+        mix(key.params, sizeof(key.params));
+        return static_cast<size_t>(rslt);
+    }
+
+    OGL_Mesh_S_Ptr Mesh_Cache::cube(float width, float height, float depth)
+    {
+        return get({CUBE, {width, height, depth, 0.f}}, [&]
+                   { return OGL_Mesh::cube_mesh(width, height, depth); });
+    }
+
+    OGL_Mesh_S_Ptr Mesh_Cache::plane(float width, float height)
+    {
+        return get({PLANE, {width, height, 0.f, 0.f}}, [&]
+                   { return OGL_Mesh::plane_mesh(width, height); });
+    }
+
+    OGL_Mesh_S_Ptr Mesh_Cache::grid(float width, float height, unsigned int width_segments, unsigned int height_segments)
+    {
+        return get({GRID, {width, height, float(width_segments), float(height_segments)}}, [&]
+                   { return OGL_Mesh::grid_mesh(width, height, width_segments, height_segments); });
+    }
+
+    OGL_Mesh_S_Ptr Mesh_Cache::circle(float radius, unsigned int segments)
+    {
+        return get({CIRCLE, {radius, float(segments), 0.f, 0.f}}, [&]
+                   { return OGL_Mesh::circle_mesh(radius, segments); });
+    }
+
+    OGL_Mesh_S_Ptr Mesh_Cache::sphere(float radius, unsigned int slices, unsigned int stacks)
+    {
+        return get({SPHERE, {radius, float(slices), float(stacks), 0.f}}, [&]
+                   { return OGL_Mesh::sphere_mesh(radius, slices, stacks); });
+    }
+
+    OGL_Mesh_S_Ptr Mesh_Cache::quad(float width, float height)
+    {
+        return get({QUAD, {width, height, 0.f, 0.f}}, [&]
+                   { return OGL_Mesh::quad_mesh(width, height); });
+    }
+
+    size_t Mesh_Cache::sweep()
+    {
+        size_t rslt = 0;
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it->second.mesh.expired())
+            {
+                it = entries.erase(it);
+                ++rslt;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        return rslt;
+    }
+
+    std::vector<Mesh_Cache::Entry_Info> Mesh_Cache::get_entries() const
+    {
+        std::vector<Entry_Info> rslt;
+        for (const auto &entry : entries)
+        {
+            const long users = entry.second.mesh.use_count();
+            if (users > 0)
+            {
+                rslt.push_back({key_name(entry.first), entry.second.bytes, users});
+            }
+        }
+        return rslt;
+    }
+
+    size_t Mesh_Cache::get_bytes() const
+    {
+        size_t rslt = 0;
+        for (const auto &entry : entries)
+        {
+            if (!entry.second.mesh.expired())
+            {
+                rslt += entry.second.bytes;
+            }
+        }
+        return rslt;
+    }
+
+    Mesh_Cache &Mesh_Cache::instance()
+    {
+        static Mesh_Cache cache;
+        return cache;
+    }
+
+    OGL_Mesh_S_Ptr Mesh_Cache::get(const Key &key, const std::function<OGL_Mesh_Ptr()> &generate)
+    {
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            if (auto rslt = it->second.mesh.lock())
+            {
+                ++hits;
+                return rslt;
+            }
+        }
+        ++misses;
+        sweep();
+        OGL_Mesh_S_Ptr rslt = generate();
+        const size_t bytes = rslt->vertices.size() + rslt->indices.size() * sizeof(unsigned int);
+        entries[key] = {rslt, bytes};
+        return rslt;
+    }
+
+    std::string Mesh_Cache::key_name(const Key &key)
+    {
+        const Primitive_Info &info = primitive_infos[key.primitive];
+        std::ostringstream rslt;
+        rslt << info.name << "(";
+        for (int i = 0; i < info.param_count; ++i)
+        {
+            rslt << (i ? ", " : "") << key.params[i];
+        }
+        rslt << ")";
+        return rslt.str();
+    }
+} // namespace Rendering
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef RENDERING_MESH_CACHE_H
+#define RENDERING_MESH_CACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mesh.h"
+
+namespace Rendering
+{
+    // Generated primitives, one GPU mesh per generator and parameters. The
+    // cache hands out shared pointers and only keeps weak ones, so a mesh is
+    // freed with its last user and its entry is dropped on the next lookup or
+    // sweep. Callers must not change the vertices of a cached mesh, every
+    // other user sees it. Main thread only, like the GL calls it makes.
+    class Mesh_Cache
+    {
+        // structures
+    public:
+        enum Primitive : uint32_t
+        {
+            CUBE,
+            PLANE,
+            GRID,
+            CIRCLE,
+            SPHERE,
+            QUAD,
+            PRIMITIVE_COUNT
+        };
+
+        struct Entry_Info
+        {
+            std::string name;
+            // vertex and index bytes, as uploaded
+            size_t bytes;
+            long users;
+        };
+
+    private:
+        // counts are stored as floats, exact up to 2^24
+        struct Key
+        {
+            Primitive primitive;
+            float params[4];
+            bool operator==(const Key &other) const;
+        };
+        struct Key_Hash
+        {
+            size_t operator()(const Key &key) const;
+        };
+        struct Entry
+        {
+            std::weak_ptr<OGL_Mesh> mesh;
+            size_t bytes;
+        };
+
+        // attributes
+    private:
+        std::unordered_map<Key, Entry, Key_Hash> entries;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        // constructors and deconstructor
+    public:
+        Mesh_Cache() = default;
+        ~Mesh_Cache() = default;
+        Mesh_Cache(const Mesh_Cache &) = delete;
+        Mesh_Cache &operator=(const Mesh_Cache &) = delete;
+
+        // methods
+    public:
+        // same parameters and defaults as the OGL_Mesh generators
+        OGL_Mesh_S_Ptr cube(float width = 1.0f, float height = 1.0f, float depth = 1.0f);
+        OGL_Mesh_S_Ptr plane(float width = 1.0f, float height = 1.0f);
+        OGL_Mesh_S_Ptr grid(float width = 1.0f, float height = 1.0f, unsigned int width_segments = 1, unsigned int height_segments = 1);
+        OGL_Mesh_S_Ptr circle(float radius = 1.0f, unsigned int segments = 32);
+        OGL_Mesh_S_Ptr sphere(float radius = 1.0f, unsigned int slices = 32, unsigned int stacks = 32);
+        OGL_Mesh_S_Ptr quad(float width = 1.0f, float height = 1.0f);
+
+        // drops the entries whose mesh is gone, returns how many
+        size_t sweep();
+        // live entries only
+        std::vector<Entry_Info> get_entries() const;
+        size_t get_bytes() const;
+        uint64_t get_hits() const { return hits; }
+        uint64_t get_misses() const { return misses; }
+
+        static Mesh_Cache &instance();
+
+    private:
+        OGL_Mesh_S_Ptr get(const Key &key, const std::function<OGL_Mesh_Ptr()> &generate);
+        static std::string key_name(const Key &key);
+    };
+} // namespace Rendering
+
+#endif // RENDERING_MESH_CACHE_H
@@ -3,42 +3,32 @@
 
 namespace Rendering
 {
-    Core::Matrix4 OGL_Model::get_model_matrix() const
+    const Core::Mat4 &OGL_Model::get_model_matrix() const
     {
-        Core::Matrix4 model = Core::Matrix4::identity();
-        if (transform == nullptr)
+        static const Core::Mat4 identity = Core::Mat4::identity();
+        if (scene_graph != nullptr)
         {
-            return model;
-        }
-        else
-        {
-            model = transform->get_model_matrix();
-            return model;
+            return scene_graph->get_world_matrix(node);
         }
+        return transform ? transform->get_model_matrix() : identity;
     }
-    void OGL_Model::draw(Shader_Program *shader)
+
+    const Core::Mat3 &OGL_Model::get_normal_matrix() const
     {
-        glEnable(GL_CULL_FACE);
-        for (int i = 0; i < mesh_list.size(); ++i)
+        static const Core::Mat3 identity = Core::Mat3::identity();
+        if (scene_graph != nullptr)
         {
-            auto mesh_ = get_mesh(i);
-            if (mesh_ == nullptr || shader == nullptr)
-            {
-                return;
-            }
-            Core::Matrix4 model = get_model_matrix();
-            Core::Matrix3 normal_matrix = transform->get_normal_matrix();
-            shader->activate();
-            // material->bind();
-            // material->write_to_shader("u_material", shader);
-            shader->set_mat4("u_model", model.data());
-            shader->set_mat3("u_normal_matrix", normal_matrix.data());
-            mesh_->bind_buffer();
-            // enable face culling
-            glDrawElements(GL_TRIANGLES, mesh_->indices.size(), GL_UNSIGNED_INT, 0);
-            mesh_->unbind_buffer();
+            return scene_graph->get_world_normal_matrix(node);
         }
-        glDisable(GL_CULL_FACE);
+        return transform ? transform->get_normal_matrix() : identity;
+    }
+
+    void OGL_Model::write_instance_data(Instance_Data &data) const
+    {
+        // both are cached (by the scene graph or the transform), only rebuilt after something moved
+        std::memcpy(data.model, get_model_matrix().data(), sizeof(data.model));
+        std::memcpy(data.normal_matrix, get_normal_matrix().data(), sizeof(data.normal_matrix));
+        material->write_instance_data(data);
     }
 
     void OGL_Model::update()
@@ -49,7 +39,8 @@ namespace Rendering
     void OGL_Model::init()
     {
         auto mesh_ = get_mesh();
-        if (mesh_ != nullptr)
+        // generated meshes come with their buffers, a shared one is only set up once
+        if (mesh_ != nullptr && mesh_->vao == 0)
         {
             mesh_->setup_buffers();
         }
@@ -8,6 +8,8 @@
 #include "shader.h"
 #include "material.h"
 #include "transform.h"
+#include "scene_graph.h"
+#include "instance_buffer.h"
 
 namespace Rendering
 {
@@ -22,12 +24,16 @@ namespace Rendering
         // attributes
     public:
         Core::Transform_Ptr transform;
+        // set when the model is added to a scene, the transform is then relative to the parent node
+        Core::Scene_Graph *scene_graph = nullptr;
+        Core::Scene_Graph::Node node = Core::Scene_Graph::NONE;
 
     protected:
-        std::vector<Mesh_Ptr> mesh_list;
+        // shared, models built from the same mesh can be drawn instanced
+        std::vector<Mesh_S_Ptr> mesh_list;
         // constructors and deconstructor
     public:
-        Model(const std::string &name = "Model", Mesh_Ptr mesh = nullptr, Core::Transform_Ptr transform = Core::Transform_Ptr(new Core::Transform()))
+        Model(const std::string &name = "Model", Mesh_S_Ptr mesh = nullptr, Core::Transform_Ptr transform = Core::Transform_Ptr(new Core::Transform()))
             : Configurable(name),
               transform(std::move(transform))
         {
@@ -40,6 +46,7 @@ namespace Rendering
         virtual void update() = 0;
         virtual void destroy() = 0;
         virtual Mesh *get_mesh(size_t index = 0) const { return mesh_list.size() ? mesh_list[index].get() : nullptr; }
+        size_t get_mesh_count() const { return mesh_list.size(); }
     };
 
     class OGL_Model;
@@ -56,18 +63,21 @@ namespace Rendering
 
         // constructors and deconstructor
     public:
-        OGL_Model(const std::string &name = "OGL_Model", OGL_Mesh_Ptr mesh = nullptr, Core::Transform_Ptr transform = Core::Transform_Ptr(new Core::Transform()), Material_PBR_Ptr material = Material_PBR_Ptr(new Material_PBR()))
+        OGL_Model(const std::string &name = "OGL_Model", OGL_Mesh_S_Ptr mesh = nullptr, Core::Transform_Ptr transform = Core::Transform_Ptr(new Core::Transform()), Material_PBR_Ptr material = Material_PBR_Ptr(new Material_PBR()))
             : Configurable(name),
-              Model(name, Mesh_Ptr(std::move(mesh)), std::move(transform)),
+              Model(name, std::move(mesh), std::move(transform)),
               material(material) { init(); }
         virtual ~OGL_Model() { destroy(); }
         // methods
     public:
-        virtual void draw(Shader_Program *shader);
         virtual void update();
         virtual void init();
         virtual void destroy() {}
-        Core::Matrix4 get_model_matrix() const;
+        // world matrices, the local ones if the model is not in a scene graph
+        const Core::Mat4 &get_model_matrix() const;
+        const Core::Mat3 &get_normal_matrix() const;
+        // transform and material scalars of one instance
+        void write_instance_data(Instance_Data &data) const;
         virtual OGL_Mesh *get_mesh(size_t index = 0) const { return dynamic_cast<OGL_Mesh *>(Model::get_mesh(index)); }
     };
 
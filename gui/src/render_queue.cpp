@@ -0,0 +1,116 @@
+#include "render_queue.h"
+#include "parallel.h"
+
+namespace Rendering
+{
+    namespace
+    {
+        constexpr uint64_t field(uint64_t value, int bits)
+        {
+            return value & ((uint64_t(1) << bits) - 1);
+        }
+    }
+
+    void Render_Queue::clear()
+    {
+        keys.clear();
+        items.clear();
+        states.clear();
+        program_ids.clear();
+        material_ids.clear();
+        mesh_ids.clear();
+    }
+
+    uint64_t Render_Queue::make_key(Pass pass, const void *program, uint64_t material, const void *mesh, float depth)
+    {
+        const uint64_t program_id = field(compact_id(program_ids, reinterpret_cast<uintptr_t>(program)), PROGRAM_BITS);
+        const uint64_t material_id = field(compact_id(material_ids, material), MATERIAL_BITS);
+        const uint64_t mesh_id = field(compact_id(mesh_ids, reinterpret_cast<uintptr_t>(mesh)), MESH_BITS);
+        uint64_t rslt = field(pass, PASS_BITS) << (64 - PASS_BITS);
+        if (pass == TRANSLUCENT_PASS)
+        {
+            // back to front first, state after
+            const uint64_t far_first = field(~quantize_depth(depth), DEPTH_BITS);
+            rslt |= far_first << (64 - PASS_BITS - DEPTH_BITS);
+            rslt |= program_id << (MATERIAL_BITS + MESH_BITS);
+            rslt |= material_id << MESH_BITS;
+            rslt |= mesh_id;
+        }
+        else
+        {
+            rslt |= program_id << (MATERIAL_BITS + MESH_BITS + DEPTH_BITS);
+            rslt |= material_id << (MESH_BITS + DEPTH_BITS);
+            rslt |= mesh_id << DEPTH_BITS;
+            rslt |= quantize_depth(depth);
+        }
+        return rslt;
+    }
+
+    void Render_Queue::push(uint64_t key, uint32_t item, const State &state)
+    {
+        keys.push_back(key);
+        items.push_back(item);
+        states.push_back(state);
+    }
+
+    void Render_Queue::sort()
+    {
+        // a 4 byte payload moves faster than the states, they follow the order afterwards
+        const size_t size = keys.size();
+        order.resize(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        Core::Parallel::radix_sort(keys.data(), order.data(), size);
+        sorted_items.resize(size);
+        sorted_states.resize(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            sorted_items[i] = items[order[i]];
+            sorted_states[i] = states[order[i]];
+        }
+        items.swap(sorted_items);
+        states.swap(sorted_states);
+    }
+
+    uint64_t Render_Queue::quantize_depth(float depth)
+    {
+        const uint64_t max = (uint64_t(1) << DEPTH_BITS) - 1;
+        // also catches NaN
+        if (!(depth > 0.f))
+        {
+            return 0;
+        }
+        if (depth >= 1.f)
+        {
+            return max;
+        }
+        return static_cast<uint64_t>(depth * static_cast<float>(max));
+    }
+
+    uint64_t Render_Queue::state_of(uint64_t key)
+    {
+        const uint64_t depth_mask = (uint64_t(1) << DEPTH_BITS) - 1;
+        if ((key >> (64 - PASS_BITS)) == TRANSLUCENT_PASS)
+        {
+            return key & ~(depth_mask << (64 - PASS_BITS - DEPTH_BITS));
+        }
+        return key & ~depth_mask;
+    }
+
+    uint64_t Render_Queue::material_state_of(uint64_t key)
+    {
+        const uint64_t mesh_mask = (uint64_t(1) << MESH_BITS) - 1;
+        if ((key >> (64 - PASS_BITS)) == TRANSLUCENT_PASS)
+        {
+            return state_of(key) & ~mesh_mask;
+        }
+        return state_of(key) & ~(mesh_mask << DEPTH_BITS);
+    }
+
+    uint32_t Render_Queue::compact_id(std::unordered_map<uint64_t, uint32_t> &ids, uint64_t object)
+    {
+        return ids.emplace(object, static_cast<uint32_t>(ids.size())).first->second;
+    }
+} // namespace Rendering
@@ -0,0 +1,103 @@
+#pragma once
+#ifndef RENDERING_RENDER_QUEUE_H
+#define RENDERING_RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Rendering
+{
+    // Draw packets of one frame, ordered by a 64 bit key and radix sorted
+    // before submission. From the most significant bit:
+    //     pass 2 | program 10 | material 16 | mesh 16 | depth 20
+    // so opaque packets are grouped by the state they bind and drawn front to
+    // back inside a group, which feeds early-Z. Translucent packets move the
+    // depth, inverted, right behind the pass: back to front matters more for
+    // blending than the binds it saves.
+    // Programs, materials and meshes get small ids on first sight, handed out
+    // again after clear(); an id past the width of its field wraps, which
+    // only costs sort quality. Keys therefore only order packets, whether two
+    // packets bind the same state is told by the State kept next to each key.
+    // A material is any 64 bit value that tells apart the state it binds, a
+    // pointer or a hash. A packet carries an index chosen by the caller.
+    class Render_Queue
+    {
+        // structures
+    public:
+        enum Pass : uint32_t
+        {
+            OPAQUE_PASS = 0,
+            TRANSLUCENT_PASS = 1
+        };
+        static constexpr int PASS_BITS = 2;
+        static constexpr int PROGRAM_BITS = 10;
+        static constexpr int MATERIAL_BITS = 16;
+        static constexpr int MESH_BITS = 16;
+        static constexpr int DEPTH_BITS = 20;
+
+        // what a packet binds, unlike the key never truncated
+        struct State
+        {
+            const void *program = nullptr;
+            uint64_t material = 0;
+            const void *mesh = nullptr;
+
+            bool operator==(const State &other) const { return program == other.program && material == other.material && mesh == other.mesh; }
+            bool operator!=(const State &other) const { return !(*this == other); }
+            // the same program and material, the mesh may differ
+            bool same_material(const State &other) const { return program == other.program && material == other.material; }
+        };
+
+        // attributes
+    private:
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> items;
+        std::vector<State> states;
+        // push order of the packets while sorting
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> sorted_items;
+        std::vector<State> sorted_states;
+        std::unordered_map<uint64_t, uint32_t> program_ids;
+        std::unordered_map<uint64_t, uint32_t> material_ids;
+        std::unordered_map<uint64_t, uint32_t> mesh_ids;
+
+        // constructors and deconstructor
+    public:
+        Render_Queue() = default;
+        ~Render_Queue() = default;
+
+        // methods
+    public:
+        // also forgets the ids, so they stay within their fields for any scene that fits a frame
+        void clear();
+        // depth is normalized, 0 at the near plane and 1 at the far plane, and clamped
+        uint64_t make_key(Pass pass, const void *program, uint64_t material, const void *mesh, float depth);
+        void push(uint64_t key, uint32_t item, const State &state);
+        void push(Pass pass, const void *program, uint64_t material, const void *mesh, float depth, uint32_t item)
+        {
+            push(make_key(pass, program, material, mesh, depth), item, {program, material, mesh});
+        }
+        // stable, equal keys keep their push order
+        void sort();
+
+        size_t size() const { return items.size(); }
+        bool empty() const { return items.empty(); }
+        // the packets' items, in key order after sort()
+        const std::vector<uint32_t> &get_items() const { return items; }
+        const std::vector<uint64_t> &get_keys() const { return keys; }
+        const std::vector<State> &get_states() const { return states; }
+
+        static uint64_t quantize_depth(float depth);
+        // the key without its depth; ids may wrap, compare States to tell draw state apart
+        static uint64_t state_of(uint64_t key);
+        // the key without its mesh and depth
+        static uint64_t material_state_of(uint64_t key);
+
+    private:
+        static uint32_t compact_id(std::unordered_map<uint64_t, uint32_t> &ids, uint64_t object);
+    };
+} // namespace Rendering
+
+#endif // RENDERING_RENDER_QUEUE_H
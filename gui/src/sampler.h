@@ -5,6 +5,7 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include "gl_state.h"
 
 namespace Rendering
 {
@@ -54,6 +55,7 @@ namespace Rendering
         {
             if (sampler_id)
             {
+                GL_State::instance().forget_sampler(sampler_id);
                 glDeleteSamplers(1, &sampler_id);
                 sampler_id = 0;
             }
@@ -62,11 +64,11 @@ namespace Rendering
     public:
         void bind(GLuint unit = 0) const
         {
-            glBindSampler(unit, sampler_id);
+            GL_State::instance().bind_sampler(unit, sampler_id);
         }
         void unbind() const
         {
-            glBindSampler(0, 0);
+            // the sampler stays bound until another one takes its unit
         }
     };
 
@@ -1,8 +1,23 @@
 #include "scene.h"
+#include <cstring>
+#include "profiler.h"
+#include "gpu_profiler.h"
+#include "gl_state.h"
+#include "mesh_cache.h"
 #include "geometry/general.h"
 #include "math/random.h"
 namespace Rendering
 {
+    namespace
+    {
+        // distance in front of the camera of the model's origin; both matrices as uploaded to GL
+        float view_depth(const float *view, const Core::Mat4 &model)
+        {
+            const float *position = model.data() + 12;
+            return -(view[2] * position[0] + view[6] * position[1] + view[10] * position[2] + view[14]);
+        }
+    }
+
     void OGL_Scene::init()
     {
         init_final_fbo();
@@ -22,6 +37,14 @@ namespace Rendering
         final_fbo->unbind();
     }
 
+    OGL_Model *OGL_Scene::add_model(OGL_Model_Ptr model, Core::Scene_Graph::Node parent)
+    {
+        model->node = scene_graph.create(model->transform.get(), parent, model.get());
+        model->scene_graph = &scene_graph;
+        models.push_back(std::move(model));
+        return models.back().get();
+    }
+
     OGL_Scene_3D::OGL_Scene_3D(float width, float height)
         : OGL_Scene(width, height),
           lights(),
@@ -50,16 +73,16 @@ namespace Rendering
 
         auto plane = Rendering::OGL_Model_Ptr(new Rendering::OGL_Model(
             "Plane",
-            Rendering::OGL_Mesh::plane_mesh(10.0f, 10.0f)));
+            Mesh_Cache::instance().plane(10.0f, 10.0f)));
             // Rendering::OGL_Mesh::plane_mesh(10.0f, 10.0f, 10, 10)));
-        plane->transform->set_position(Core::Vector3(0.0f, -1.0f, 0.0f));
-        plane->transform->angle_axis_rotate(Core::Geometry::radians(-90.0f), Core::Vector3(1.0f, 0.0f, 0.0f));
+        plane->transform->set_position(Core::Vec3(0.0f, -1.0f, 0.0f));
+        plane->transform->angle_axis_rotate(Core::Geometry::radians(-90.0f), Core::Vec3(1.0f, 0.0f, 0.0f));
         plane->material->color = Core::Vector3(Math::random(0.2, 1.0), Math::random(0.2, 1.0), Math::random(0.2, 1.0));
         plane->transform->scale(0.5);
         plane->material->metallic = Math::random(0.2, 1.0);
         plane->material->roughness = Math::random(0.2, 1.0);
         plane->material->ao = Math::random(0.1, 0.5);
-        models.push_back(std::move(plane));
+        add_model(std::move(plane));
         // add 5x5x5 cubes
         const int row = 3;
         int index = 0;
@@ -72,7 +95,7 @@ namespace Rendering
         //         for (int k = 0; k < row; ++k)
         //         {
         //             float y = -float(row) + k * float(row) / 2.f;
-        //             Core::Vector3 pos = Core::Vector3(x, y, z);
+        //             Core::Vec3 pos = Core::Vec3(x, y, z);
         //             // auto cube_model = Rendering::OGL_Model_Ptr(new Rendering::OGL_Model(
         //             //     "Cube " + std::to_string(index++),
         //             //     Rendering::OGL_Mesh::cube_mesh(1.0f, 1.0f, 1.0f)));
@@ -93,6 +116,8 @@ namespace Rendering
         float off_set = float(row) / 4.f;
         // float off_set = 0.f;
         index = 0;
+        // one mesh for all of them, so they are drawn instanced
+        OGL_Mesh_S_Ptr sphere_mesh = Mesh_Cache::instance().sphere(1.0, 32, 32);
         for (int i = 0; i < row; ++i)
         {
             float y = -float(row) + i * float(row) / 2.f + off_set;
@@ -102,17 +127,17 @@ namespace Rendering
                 for (int k = 0; k < row; ++k)
                 {
                     float x = -float(row) + k * float(row) / 2.f + off_set;
-                    Core::Vector3 pos = Core::Vector3(x, y, z);
+                    Core::Vec3 pos = Core::Vec3(x, y, z);
                     auto sphere_model = Rendering::OGL_Model_Ptr(new Rendering::OGL_Model(
                         "Sphere " + std::to_string(index++),
-                        Rendering::OGL_Mesh::sphere_mesh(1.0, 32, 32)));
+                        sphere_mesh));
                     sphere_model->transform->set_position(pos);
                     sphere_model->material->color = Core::Vector3(Math::random(0.2, 1.0), Math::random(0.2, 1.0), Math::random(0.2, 1.0));
                     sphere_model->material->metallic = Math::random(0.2, 1.0);
                     sphere_model->material->roughness = Math::random(0.2, 1.0);
                     sphere_model->material->ao = Math::random(0.1, 0.5);
                     sphere_model->transform->scale(0.5);
-                    models.push_back(std::move(sphere_model));
+                    add_model(std::move(sphere_model));
                 }
             }
         }
@@ -121,35 +146,35 @@ namespace Rendering
         // set directional light
         auto light = Rendering::Light_Ptr(new Rendering::Light());
         light->name = "light 0";
-        light->set_position(Core::Vector3(2.0f, 2.0f, 2.0f));
-        light->spot_on(Core::Vector3(0.0f, 0.0f, 0.0f));
-        light->color = Core::Vector3(1.0f, 1.0f, 1.0f);
+        light->set_position(Core::Vec3(2.0f, 2.0f, 2.0f));
+        light->spot_on(Core::Vec3(0.0f, 0.0f, 0.0f));
+        light->color = Core::Vec3(1.0f, 1.0f, 1.0f);
         light->intensity = 1.0f;
         light->type = Rendering::Light::PARALLEL_LIGHT;
-        lights.push_back({std::move(light), true});
+        add_light(std::move(light));
 
         // set point lights
         for (int i = 1; i <= 9; i++)
         {
             auto light = Rendering::Light_Ptr(new Rendering::Light());
             light->name = "light " + std::to_string(i);
-            light->set_position(Core::Vector3(Math::random(-2.5, 2.5), Math::random(-2.5, 2.5), Math::random(-2.5, 2.5)));
-            light->spot_on(Core::Vector3(0.0f, 0.0f, 0.0f));
-            Core::Vector3 color = Core::Vector3(Math::random(0.2, 1.0), Math::random(0.2, 1.0), Math::random(0.2, 1.0));
+            light->set_position(Core::Vec3(Math::random(-2.5, 2.5), Math::random(-2.5, 2.5), Math::random(-2.5, 2.5)));
+            light->spot_on(Core::Vec3(0.0f, 0.0f, 0.0f));
+            Core::Vec3 color = Core::Vec3(Math::random(0.2, 1.0), Math::random(0.2, 1.0), Math::random(0.2, 1.0));
             light->color = color;
             light->intensity = Math::random(0.2, 1.0);
             light->type = Rendering::Light::POINT_LIGHT;
-            lights.push_back({std::move(light), true});
+            add_light(std::move(light));
         }
 
-        auto camera = Rendering::Camera_Ptr(new Rendering::Camera(Core::Vector3(0.0f, 0.0f, 4.0f)));
+        auto camera = Rendering::Camera_Ptr(new Rendering::Camera(Core::Vec3(0.0f, 0.0f, 4.0f)));
         camera->name = "camera 1";
-        camera->focus_on(Core::Vector3(0.f, 0.0f, 0.0f), Core::Vector3(0.0f, 1.0f, 0.0f));
+        camera->focus_on(Core::Vec3(0.f, 0.0f, 0.0f), Core::Vec3(0.0f, 1.0f, 0.0f));
         cameras.push_back({std::move(camera), true});
         active_camera_index = 0;
 
-        auto camera_2 = Rendering::Camera_Ptr(new Rendering::Camera(Core::Vector3(3.0f, 0.0f, 0.0f)));
-        camera_2->focus_on(Core::Vector3(0.f, 0.0f, 0.0f), Core::Vector3(0.0f, 1.0f, 0.0f));
+        auto camera_2 = Rendering::Camera_Ptr(new Rendering::Camera(Core::Vec3(3.0f, 0.0f, 0.0f)));
+        camera_2->focus_on(Core::Vec3(0.f, 0.0f, 0.0f), Core::Vec3(0.0f, 1.0f, 0.0f));
         camera_2->name = "camera 2";
         cameras.push_back({std::move(camera_2), false});
 
@@ -161,7 +186,17 @@ namespace Rendering
     }
     void OGL_Scene_3D::update()
     {
-        // TODO: update scene
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::update");
+        // world matrices of whatever moved since the last frame
+        scene_graph.update();
+    }
+
+    Light *OGL_Scene_3D::add_light(Light_Ptr light, bool is_active, Core::Scene_Graph::Node parent)
+    {
+        light->node = scene_graph.create(light->transform.get(), parent, light.get());
+        light->scene_graph = &scene_graph;
+        lights.push_back({std::move(light), is_active});
+        return lights.back().value.get();
     }
     void OGL_Scene_3D::destroy()
     {
@@ -169,9 +204,11 @@ namespace Rendering
     }
     void OGL_Scene_3D::render()
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::render");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::render");
         using namespace Core;
-        Matrix4 projection = Core::Geometry::perspective(Core::Geometry::radians(this->fov), this->aspect, this->near, this->far);
-        Matrix4 view = Core::Matrix4::identity();
+        Mat4 projection = Core::Geometry::perspective(Core::Geometry::radians(this->fov), this->aspect, this->near, this->far);
+        Mat4 view = Core::Mat4::identity();
         if (active_camera_index >= 0)
         {
             auto &active_camera = cameras[active_camera_index].value;
@@ -182,53 +219,91 @@ namespace Rendering
             float color[4] = {bg_color.x(), bg_color.y(), bg_color.z(), 1.0f};
             skybox_texture->update_pixels(color, 0, 0, 1, 1);
         }
+        upload_uniforms(view, projection);
+        view_frustum = Core::Geometry::extract_frustum(view * projection);
         pbr_fbo->bind();
         pbr_fbo->clear();
-        render_pbr(view, projection);
+        render_pbr();
 
-        render_lights(view, projection);
-        render_skybox(view, projection);
+        render_lights();
+        render_skybox();
         pbr_fbo->unbind();
         finalize_output();
     }
-    void OGL_Scene_3D::render_skybox(const Core::Matrix4 &view, const Core::Matrix4 &projection)
+    void OGL_Scene_3D::upload_uniforms(const Core::Mat4 &view, const Core::Mat4 &projection)
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::upload_uniforms");
+        std::memcpy(frame_data.view, view.data(), sizeof(frame_data.view));
+        std::memcpy(frame_data.projection, projection.data(), sizeof(frame_data.projection));
+        frame_data.exposure = exposure;
+        frame_data.gamma = gamma;
+        int light_num = 0;
+        for (auto &light : lights)
+        {
+            if (light.is_active && light_num < Frame_Data::MAX_LIGHTS)
+            {
+                light.value->write_light_data(frame_data.lights[light_num++]);
+            }
+        }
+        frame_data.light_num = light_num;
+        frame_uniforms.update(&frame_data, sizeof(Frame_Data));
+        frame_uniforms.bind(UNIFORM_BINDING::FRAME);
+
+        draw_uniforms.reset();
+        Draw_Data draw_data{};
+        light_draw_offsets.resize(lights.size());
+        for (size_t i = 0; i < lights.size(); ++i)
+        {
+            if (lights[i].is_active)
+            {
+                lights[i].value->write_draw_data(draw_data);
+                light_draw_offsets[i] = draw_uniforms.push(&draw_data, sizeof(Draw_Data));
+            }
+        }
+        draw_uniforms.commit();
+    }
+
+    void OGL_Scene_3D::render_skybox()
+    {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::render_skybox");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::render_skybox");
         auto skybox_shader = Rendering::shader_program_factory.find_shader_program("skybox_shader");
         skybox_shader->activate();
-        skybox_shader->set_mat4("u_view", view.data());
-        skybox_shader->set_mat4("u_projection", projection.data());
         skybox_texture->bind(PBR_TEXTURE_UNIT::SKYBOX);
         skybox_shader->set_int("u_skybox", PBR_TEXTURE_UNIT::SKYBOX);
-        glDepthFunc(GL_LEQUAL);
-        glCullFace(GL_FRONT);
+        GL_State::instance().depth_func(GL_LEQUAL);
+        GL_State::instance().cull_face(GL_FRONT);
         Rendering::OGL_Mesh::instanced_cube_mesh()->render(skybox_shader);
-        glCullFace(GL_BACK);
-        glDepthFunc(GL_LESS);
+        GL_State::instance().cull_face(GL_BACK);
+        GL_State::instance().depth_func(GL_LESS);
         skybox_texture->unbind();
         skybox_shader->deactivate();
     }
 
-    void OGL_Scene_3D::render_lights(const Core::Matrix4 &view, const Core::Matrix4 &projection)
+    void OGL_Scene_3D::render_lights()
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::render_lights");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::render_lights");
         auto light_shader = Rendering::shader_program_factory.find_shader_program("light_shader");
         if (light_shader)
         {
             light_shader->activate();
-            light_shader->set_mat4("u_view", view.data());
-            light_shader->set_mat4("u_projection", projection.data());
-            for (auto &light : lights)
+            for (size_t i = 0; i < lights.size(); ++i)
             {
-                if (light.is_active)
+                if (lights[i].is_active)
                 {
-                    light.value->visualize(light_shader);
+                    draw_uniforms.bind(UNIFORM_BINDING::DRAW, light_draw_offsets[i], sizeof(Draw_Data));
+                    lights[i].value->visualize(light_shader);
                 }
             }
             light_shader->deactivate();
         }
     }
 
-    void OGL_Scene_3D::render_pbr(const Core::Matrix4 &view, const Core::Matrix4 &projection)
+    void OGL_Scene_3D::render_pbr()
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::render_pbr");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::render_pbr");
         Shader_Program *shader = nullptr;
 
         // set environment map
@@ -238,53 +313,172 @@ namespace Rendering
 
         shader = Rendering::shader_program_factory.find_shader_program("pbr_shader");
         shader->activate();
+        auto &uniforms = pbr_uniforms;
+        if (uniforms.shader != shader || uniforms.generation != shader->get_generation())
+        {
+            uniforms.resolve(shader);
+        }
 
         irradiance_map->bind(PBR_TEXTURE_UNIT::IRRADIANCE);
-        shader->set_int("u_irradiance_map", PBR_TEXTURE_UNIT::IRRADIANCE);
+        shader->set(uniforms.irradiance_map, PBR_TEXTURE_UNIT::IRRADIANCE);
 
         prefilter_map->bind(PBR_TEXTURE_UNIT::PREFILTER);
-        shader->set_int("u_prefilter_map", PBR_TEXTURE_UNIT::PREFILTER);
+        shader->set(uniforms.prefilter_map, PBR_TEXTURE_UNIT::PREFILTER);
 
         brdf_lut->bind(PBR_TEXTURE_UNIT::BRDF);
-        shader->set_int("u_brdf_lut", PBR_TEXTURE_UNIT::BRDF);
+        shader->set(uniforms.brdf_lut, PBR_TEXTURE_UNIT::BRDF);
 
-        shader->set_mat4("u_view", view.data());
-        shader->set_mat4("u_projection", projection.data());
+        // a model is drawn if any of its meshes is in the view frustum
+        pbr_volumes.clear();
+        // models without a mesh push no volume and are neither visible nor culled
+        size_t tested = 0;
+        for (size_t i = 0; i < models.size(); ++i)
+        {
+            if (models[i]->active)
+            {
+                const size_t pushed = pbr_volumes.models.size();
+                const Core::Mat4 &model_matrix = models[i]->get_model_matrix();
+                for (size_t m = 0; m < models[i]->get_mesh_count(); ++m)
+                {
+                    if (const Mesh *mesh = models[i]->get_mesh(m))
+                    {
+                        pbr_volumes.push(Core::Geometry::transform_sphere(model_matrix, mesh->bounding_sphere), static_cast<uint32_t>(i));
+                    }
+                }
+                if (pbr_volumes.models.size() != pushed)
+                {
+                    ++tested;
+                }
+            }
+        }
+        pbr_volumes.cull(view_frustum);
 
-        int active_light_num = 0;
-        for (auto &light : lights)
+        pbr_queue.clear();
+        uint32_t last = UINT32_MAX;
+        for (size_t v = 0; v < pbr_volumes.models.size(); ++v)
+        {
+            const uint32_t i = pbr_volumes.models[v];
+            if (!pbr_volumes.visible[v] || i == last)
+            {
+                continue;
+            }
+            last = i;
+            auto &model = models[i];
+            const float depth = (view_depth(frame_data.view, model->get_model_matrix()) - near) / (far - near);
+            // a model of several meshes is never batched with another
+            const void *geometry = model->get_mesh_count() == 1 ? static_cast<const void *>(model->get_mesh()) : model.get();
+            pbr_queue.push(Render_Queue::OPAQUE_PASS, shader, model->material->get_batch_hash(), geometry, depth, i);
+        }
+        cull_stats.visible = pbr_queue.size();
+        cull_stats.culled = tested - cull_stats.visible;
+        pbr_queue.sort();
+
+        // neighbours with the same state share one instanced draw, all instances go up in one upload
+        pbr_instances.reset();
+        pbr_batches.clear();
+        const auto &items = pbr_queue.get_items();
+        const auto &states = pbr_queue.get_states();
+        for (size_t i = 0; i < items.size(); ++i)
         {
-            if (light.is_active)
+            if (i == 0 || states[i] != states[i - 1])
             {
-                light.value->write_to_shader("u_lights", active_light_num++, shader);
+                pbr_batches.push_back({pbr_instances.size(), 0, items[i], states[i]});
             }
+            models[items[i]]->write_instance_data(pbr_instances.push());
+            ++pbr_batches.back().count;
         }
-        shader->set_int("u_light_num", active_light_num);
-        for (auto &model : models)
+        pbr_instances.commit();
+
+        // meshes of one layout share a vertex array, so the batches of a material become one submission
+        GLuint draw_vao = 0;
+        Render_Queue::State draw_state;
+        auto flush = [&]()
         {
-            if (model->active)
+            if (!pbr_draws.empty())
             {
-                model->material->write_to_shader("u_material", shader);
-                model->draw(shader);
+                GL_State::instance().bind_vertex_array(draw_vao);
+                pbr_draws.submit(pbr_instances);
+                pbr_draws.clear();
+            }
+        };
+        GL_State::instance().enable(GL_CULL_FACE);
+        for (const auto &batch : pbr_batches)
+        {
+            auto &model = models[batch.item];
+            for (size_t m = 0; m < model->get_mesh_count(); ++m)
+            {
+                OGL_Mesh *mesh = model->get_mesh(m);
+                if (mesh == nullptr)
+                {
+                    continue;
+                }
+                if (!pbr_draws.empty() && (mesh->vao != draw_vao || !batch.state.same_material(draw_state)))
+                {
+                    flush();
+                }
+                if (pbr_draws.empty())
+                {
+                    model->material->write_to_shader(uniforms.material, shader);
+                    draw_vao = mesh->vao;
+                    draw_state = batch.state;
+                }
+                pbr_draws.push(mesh->draw_command(batch.count, static_cast<GLuint>(batch.first)));
             }
         }
+        flush();
+        GL_State::instance().disable(GL_CULL_FACE);
         shader->deactivate();
     }
 
+    void OGL_Scene_3D::PBR_Uniforms::resolve(const Shader_Program *shader)
+    {
+        this->shader = shader;
+        generation = shader->get_generation();
+        irradiance_map = shader->get_uniform<Uniform_Type::INT>("u_irradiance_map");
+        prefilter_map = shader->get_uniform<Uniform_Type::INT>("u_prefilter_map");
+        brdf_lut = shader->get_uniform<Uniform_Type::INT>("u_brdf_lut");
+        material.resolve(shader, "u_material");
+    }
+
+    void OGL_Scene_3D::Cull_Volumes::clear()
+    {
+        x.clear();
+        y.clear();
+        z.clear();
+        radius.clear();
+        models.clear();
+    }
+
+    void OGL_Scene_3D::Cull_Volumes::push(const Core::Geometry::BoundingSphere &sphere, uint32_t model)
+    {
+        x.push_back(sphere.center.x());
+        y.push_back(sphere.center.y());
+        z.push_back(sphere.center.z());
+        radius.push_back(sphere.radius);
+        models.push_back(model);
+    }
+
+    void OGL_Scene_3D::Cull_Volumes::cull(const Core::Geometry::Frustum &frustum)
+    {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::cull");
+        visible.resize(models.size());
+        Core::Geometry::cull_spheres(frustum, {x.data(), y.data(), z.data(), radius.data()}, visible.data(), models.size());
+    }
+
     void OGL_Scene_3D::tone_mapping(Texture *texture)
     {
-        glDisable(GL_DEPTH_TEST);
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::tone_mapping");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::tone_mapping");
+        GL_State::instance().disable(GL_DEPTH_TEST);
         // set background color
         auto tone_mapping_shader = Rendering::shader_program_factory.find_shader_program("tone_mapping_shader");
         tone_mapping_shader->activate();
-        tone_mapping_shader->set_float("u_gamma", this->gamma);
-        tone_mapping_shader->set_float("u_exposure", this->exposure);
         texture->bind(PBR_TEXTURE_UNIT::FINAL);
         tone_mapping_shader->set_int("u_image", PBR_TEXTURE_UNIT::FINAL);
         Rendering::OGL_Mesh::instanced_quad_mesh()->render(tone_mapping_shader);
         texture->unbind();
         tone_mapping_shader->deactivate();
-        glEnable(GL_DEPTH_TEST);
+        GL_State::instance().enable(GL_DEPTH_TEST);
     }
 
     void OGL_Scene_3D::init_pbr_fbo()
@@ -395,14 +589,17 @@ namespace Rendering
 
     void OGL_Scene_3D::finalize_output()
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::finalize_output");
         final_fbo->bind();
         final_fbo->clear();
         tone_mapping(pbr_fbo->get_color_attachment(0));
         final_fbo->unbind();
     }
 
-    void OGL_Scene_3D::equi_to_cubemap(const Core::Matrix4 &projection)
+    void OGL_Scene_3D::equi_to_cubemap(const Core::Mat4 &projection)
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::equi_to_cubemap");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::equi_to_cubemap");
         auto equi_texture = Texture_Manager::instance().get_texture(this->skybox_path);
         if (!equi_texture)
         {
@@ -412,11 +609,11 @@ namespace Rendering
         equi_to_cube_shader->activate();
         equi_to_cube_shader->set_mat4("u_projection", projection.data());
         cubemap_fbo->bind();
-        glViewport(0, 0, 1024, 1024);
+        GL_State::instance().viewport_rect(0, 0, 1024, 1024);
         equi_texture->bind(PBR_TEXTURE_UNIT::EQUIRECTANGULAR);
         equi_to_cube_shader->set_int("u_equirectangular_map", PBR_TEXTURE_UNIT::EQUIRECTANGULAR);
         auto cubemap_texture = cubemap_fbo->get_color_attachment(0);
-        glCullFace(GL_FRONT);
+        GL_State::instance().cull_face(GL_FRONT);
 
         for (int i = 0; i < 6; i++)
         {
@@ -426,7 +623,7 @@ namespace Rendering
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
             Rendering::OGL_Mesh::instanced_cube_mesh()->render(equi_to_cube_shader);
         }
-        glCullFace(GL_BACK);
+        GL_State::instance().cull_face(GL_BACK);
         equi_texture->unbind();
         equi_to_cube_shader->deactivate();
         cubemap_texture->generate_mipmap();
@@ -443,6 +640,8 @@ namespace Rendering
 
     void OGL_Scene_3D::compute_env_irradiance(Texture *env_cubemap)
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::compute_env_irradiance");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::compute_env_irradiance");
         if (!env_cubemap)
         {
             return;
@@ -456,6 +655,7 @@ namespace Rendering
         env_cubemap->bind(PBR_TEXTURE_UNIT::SKYBOX);
         irradiance_shader->set_int("u_environment_map", PBR_TEXTURE_UNIT::SKYBOX);
         irradiance_shader->set_mat4("u_projection", cube_projection.data());
+        GL_State::instance().cull_face(GL_FRONT);
 
         for (int i = 0; i < 6; i++)
         {
@@ -463,10 +663,9 @@ namespace Rendering
             // set the render target to be the cube face
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, irradiance_map->texture_id, 0);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            glCullFace(GL_FRONT);
             Rendering::OGL_Mesh::instanced_cube_mesh()->render(irradiance_shader);
-            glCullFace(GL_BACK);
         }
+        GL_State::instance().cull_face(GL_BACK);
         env_cubemap->unbind();
         irradiance_map->unbind();
         irradiance_shader->deactivate();
@@ -475,6 +674,8 @@ namespace Rendering
 
     void OGL_Scene_3D::compute_env_prefilter(Texture *env_cubemap)
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::compute_env_prefilter");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::compute_env_prefilter");
         if (!env_cubemap)
         {
             return;
@@ -489,6 +690,7 @@ namespace Rendering
         prefilter_shader->set_int("u_environment_map", PBR_TEXTURE_UNIT::SKYBOX);
         prefilter_shader->set_mat4("u_projection", cube_projection.data());
 
+        GL_State::instance().cull_face(GL_FRONT);
         const int max_mip_levels = 5;
         for (int mip = 0; mip < max_mip_levels; ++mip)
         {
@@ -498,7 +700,7 @@ namespace Rendering
             auto render_buffer = prefilter_fbo->rbo.get();
             render_buffer->bind();
             render_buffer->resize(mip_width, mip_height);
-            glViewport(0, 0, mip_width, mip_height);
+            GL_State::instance().viewport_rect(0, 0, mip_width, mip_height);
             float roughness = (float)mip / (float)(max_mip_levels - 1);
             prefilter_shader->set_float("u_roughness", roughness);
 
@@ -507,11 +709,10 @@ namespace Rendering
                 prefilter_shader->set_mat4("u_view", cube_views[i].data());
                 glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, prefilter_map->texture_id, mip);
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-                glCullFace(GL_FRONT);
                 Rendering::OGL_Mesh::instanced_cube_mesh()->render(prefilter_shader);
-                glCullFace(GL_BACK);
             }
         }
+        GL_State::instance().cull_face(GL_BACK);
         env_cubemap->unbind();
         prefilter_shader->deactivate();
         prefilter_fbo->unbind();
@@ -519,7 +720,8 @@ namespace Rendering
 
     void OGL_Scene_3D::compute_brdf_lut()
     {
-
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::compute_brdf_lut");
+        GPU_PROFILE_SCOPE("OGL_Scene_3D::compute_brdf_lut");
         auto brdf_shader = Rendering::shader_program_factory.find_shader_program("env_brdf_shader");
         brdf_shader->activate();
         brdf_fbo->bind();
@@ -531,6 +733,7 @@ namespace Rendering
 
     void OGL_Scene_3D::update_skybox()
     {
+        CORE_PROFILE_SCOPE("OGL_Scene_3D::update_skybox");
         equi_to_cubemap();
         skybox_texture = cubemap_fbo->get_color_attachment(0);
         if (!skybox_texture)
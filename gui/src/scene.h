@@ -10,7 +10,11 @@
 #include "camera.h"
 #include "light.h"
 #include "fbo.h"
+#include "uniform_buffer.h"
+#include "render_queue.h"
+#include "mesh_buffer.h"
 #include "geometry/geometry3d.h"
+#include "geometry/culling.h"
 #include "math/base.h"
 
 
@@ -80,6 +84,8 @@ namespace Rendering
         Core::Vector4 bg_color = Core::Vector4(1.f, 1.f, 1.f, 1.0f);
         // GLuint fbo = 0, fb_tex = 0, rbo = 0;
         FBO_Ptr final_fbo = nullptr;
+        // hierarchy of the models and lights, declared first so it outlives them
+        Core::Scene_Graph scene_graph;
         std::vector<OGL_Model_Ptr> models;
         // constructors and deconstructor
     public:
@@ -117,6 +123,8 @@ namespace Rendering
             return final_fbo->get_color_attachment();
         }
         virtual void init_final_fbo();
+        // takes the model and puts its transform under `parent` in the scene graph
+        OGL_Model *add_model(OGL_Model_Ptr model, Core::Scene_Graph::Node parent = Core::Scene_Graph::NONE);
     };
 
     class OGL_Scene_3D;
@@ -168,6 +176,12 @@ namespace Rendering
             Light_Ptr value = nullptr;
             bool is_active = true;
         };
+        // active models with meshes of the last pbr pass inside and outside the view frustum
+        struct Cull_Stats
+        {
+            size_t visible = 0;
+            size_t culled = 0;
+        };
         // attributes
     public:
         float gamma = 2.2f;
@@ -199,6 +213,7 @@ namespace Rendering
         virtual void update();
         virtual void destroy();
         virtual void render();
+        Light *add_light(Light_Ptr light, bool is_active = true, Core::Scene_Graph::Node parent = Core::Scene_Graph::NONE);
         virtual void resize(float width, float height) override
         {
             if (Core::Math::equal(this->width, width) && Core::Math::equal(this->height, height))
@@ -216,20 +231,72 @@ namespace Rendering
             return final_fbo->get_color_attachment();
         }
         virtual void finalize_output() override;
-        void equi_to_cubemap(const Core::Matrix4 &projection = Core::Geometry::perspective(Core::Geometry::radians(90.0f), 1.0f, 0.1f, 10.0f));
+        void equi_to_cubemap(const Core::Mat4 &projection = Core::Geometry::perspective(Core::Geometry::radians(90.0f), 1.0f, 0.1f, 10.0f));
         void precompute_envrionment();
         void compute_env_irradiance(Texture *env_cubemap);
         void compute_env_prefilter(Texture *env_cubemap);
         void compute_brdf_lut();
         void update_skybox();
+        const Cull_Stats &get_cull_stats() const { return cull_stats; }
 
     protected:
-        void render_skybox(const Core::Matrix4 &view, const Core::Matrix4 &projection);
-        void render_lights(const Core::Matrix4 &view, const Core::Matrix4 &projection);
-        void render_pbr(const Core::Matrix4 &view, const Core::Matrix4 &projection);
+        // fills the frame block and stages the draw data of every active light, one upload each
+        void upload_uniforms(const Core::Mat4 &view, const Core::Mat4 &projection);
+        void render_skybox();
+        void render_lights();
+        void render_pbr();
         void tone_mapping(Texture *texture);
 
     private:
+        // handles into the pbr shader, resolved again after it is relinked
+        struct PBR_Uniforms
+        {
+            const Shader_Program *shader = nullptr;
+            uint32_t generation = 0;
+            Uniform_Int irradiance_map;
+            Uniform_Int prefilter_map;
+            Uniform_Int brdf_lut;
+            Material_PBR::Uniforms material;
+
+            void resolve(const Shader_Program *shader);
+        };
+        PBR_Uniforms pbr_uniforms;
+        // camera, lights and tone mapping, bound to UNIFORM_BINDING::FRAME
+        Frame_Data frame_data;
+        Uniform_Buffer frame_uniforms;
+        // one Draw_Data per light, offsets into the ring (parallel to lights)
+        Uniform_Ring draw_uniforms;
+        std::vector<size_t> light_draw_offsets;
+        // of the projection and view of the frame, for culling
+        Core::Geometry::Frustum view_frustum;
+        Cull_Stats cull_stats;
+        // world bounding spheres of the active models' meshes, SoA for Geometry::cull_spheres
+        struct Cull_Volumes
+        {
+            std::vector<float> x, y, z, radius;
+            std::vector<uint32_t> models;
+            std::vector<uint8_t> visible;
+
+            void clear();
+            void push(const Core::Geometry::BoundingSphere &sphere, uint32_t model);
+            void cull(const Core::Geometry::Frustum &frustum);
+        };
+        Cull_Volumes pbr_volumes;
+        // the visible models of the pbr pass, items are indices into models
+        Render_Queue pbr_queue;
+        // a run of instances drawn with the mesh and material of the model `item`
+        struct Instance_Batch
+        {
+            size_t first;
+            GLsizei count;
+            uint32_t item;
+            Render_Queue::State state;
+        };
+        Instance_Buffer pbr_instances;
+        std::vector<Instance_Batch> pbr_batches;
+        // the batches of one vertex array and material, issued together
+        Indirect_Draws pbr_draws;
+
         void init_pbr_fbo();
         void init_cubemap_fbo();
         void init_irradiance_fbo();
@@ -237,14 +304,14 @@ namespace Rendering
         void init_brdf_fbo();
     };
 
-    static const Core::Matrix4 cube_projection = Core::Geometry::perspective(Core::Geometry::radians(90.0f), 1.0f, 0.1f, 10.0f);
-    static const Core::Matrix4 cube_views[6] = {
-        Core::Geometry::look_at(Core::Vector3(0.0f, 0.0f, 0.0f), Core::Vector3(1.0f, 0.0f, 0.0f), Core::Vector3(0.0f, -1.0f, 0.0f)),
-        Core::Geometry::look_at(Core::Vector3(0.0f, 0.0f, 0.0f), Core::Vector3(-1.0f, 0.0f, 0.0f), Core::Vector3(0.0f, -1.0f, 0.0f)),
-        Core::Geometry::look_at(Core::Vector3(0.0f, 0.0f, 0.0f), Core::Vector3(0.0f, 1.0f, 0.0f), Core::Vector3(0.0f, 0.0f, 1.0f)),
-        Core::Geometry::look_at(Core::Vector3(0.0f, 0.0f, 0.0f), Core::Vector3(0.0f, -1.0f, 0.0f), Core::Vector3(0.0f, 0.0f, -1.0f)),
-        Core::Geometry::look_at(Core::Vector3(0.0f, 0.0f, 0.0f), Core::Vector3(0.0f, 0.0f, 1.0f), Core::Vector3(0.0f, -1.0f, 0.0f)),
-        Core::Geometry::look_at(Core::Vector3(0.0f, 0.0f, 0.0f), Core::Vector3(0.0f, 0.0f, -1.0f), Core::Vector3(0.0f, -1.0f, 0.0f))};
+    static const Core::Mat4 cube_projection = Core::Geometry::perspective(Core::Geometry::radians(90.0f), 1.0f, 0.1f, 10.0f);
+    static const Core::Mat4 cube_views[6] = {
+        Core::Geometry::look_at(Core::Vec3(0.0f, 0.0f, 0.0f), Core::Vec3(1.0f, 0.0f, 0.0f), Core::Vec3(0.0f, -1.0f, 0.0f)),
+        Core::Geometry::look_at(Core::Vec3(0.0f, 0.0f, 0.0f), Core::Vec3(-1.0f, 0.0f, 0.0f), Core::Vec3(0.0f, -1.0f, 0.0f)),
+        Core::Geometry::look_at(Core::Vec3(0.0f, 0.0f, 0.0f), Core::Vec3(0.0f, 1.0f, 0.0f), Core::Vec3(0.0f, 0.0f, 1.0f)),
+        Core::Geometry::look_at(Core::Vec3(0.0f, 0.0f, 0.0f), Core::Vec3(0.0f, -1.0f, 0.0f), Core::Vec3(0.0f, 0.0f, -1.0f)),
+        Core::Geometry::look_at(Core::Vec3(0.0f, 0.0f, 0.0f), Core::Vec3(0.0f, 0.0f, 1.0f), Core::Vec3(0.0f, -1.0f, 0.0f)),
+        Core::Geometry::look_at(Core::Vec3(0.0f, 0.0f, 0.0f), Core::Vec3(0.0f, 0.0f, -1.0f), Core::Vec3(0.0f, -1.0f, 0.0f))};
 
 } // namespace scene
 
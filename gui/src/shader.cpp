@@ -2,9 +2,83 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstring>
 
 namespace Rendering
 {
+    namespace
+    {
+        // FNV-1a
+        uint64_t uniform_hash(const std::string &name)
+        {
+            uint64_t rslt = 14695981039346656037ull;
+            for (char c : name)
+            {
+                rslt = (rslt ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+            }
+            return rslt;
+        }
+
+        Uniform_Type uniform_type(GLenum type)
+        {
+            switch (type)
+            {
+            case GL_INT:
+            case GL_BOOL:
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_SAMPLER_CUBE_SHADOW:
+            case GL_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+                return Uniform_Type::INT;
+            case GL_FLOAT:
+                return Uniform_Type::FLOAT;
+            case GL_FLOAT_VEC2:
+                return Uniform_Type::VEC2;
+            case GL_FLOAT_VEC3:
+                return Uniform_Type::VEC3;
+            case GL_FLOAT_VEC4:
+                return Uniform_Type::VEC4;
+            case GL_FLOAT_MAT2:
+                return Uniform_Type::MAT2;
+            case GL_FLOAT_MAT3:
+                return Uniform_Type::MAT3;
+            case GL_FLOAT_MAT4:
+                return Uniform_Type::MAT4;
+            default:
+                return Uniform_Type::NONE;
+            }
+        }
+
+        size_t uniform_words(Uniform_Type type)
+        {
+            switch (type)
+            {
+            case Uniform_Type::INT:
+            case Uniform_Type::FLOAT:
+                return 1;
+            case Uniform_Type::VEC2:
+                return 2;
+            case Uniform_Type::VEC3:
+                return 3;
+            case Uniform_Type::VEC4:
+            case Uniform_Type::MAT2:
+                return 4;
+            case Uniform_Type::MAT3:
+                return 9;
+            case Uniform_Type::MAT4:
+                return 16;
+            default:
+                return 0;
+            }
+        }
+    }
+
     Shader_Program_Factory shader_program_factory;
     std::string read_file(const std::string &path)
     {
@@ -84,6 +158,8 @@ namespace Rendering
             return -1;
         }
         is_linked = true;
+        ++generation;
+        reflect_uniforms();
         glDetachShader(program_id, vertex_shader->id);
         glDetachShader(program_id, fragment_shader->id);
         if (geometry_shader != nullptr)
@@ -95,72 +171,236 @@ namespace Rendering
 
     void Shader_Program::activate()
     {
-        glUseProgram(program_id);
+        GL_State::instance().use_program(program_id);
     }
 
     void Shader_Program::deactivate()
     {
-        glUseProgram(0);
+        // the program stays bound until the next activate replaces it
     }
 
     void Shader_Program::set_bool(const std::string &name, bool value) const
     {
-        glUniform1i(glGetUniformLocation(program_id, name.c_str()), (int)value);
+        const int i = value ? 1 : 0;
+        write(find_uniform(name), Uniform_Type::INT, &i);
     }
 
     void Shader_Program::set_int(const std::string &name, int value) const
     {
-        glUniform1i(glGetUniformLocation(program_id, name.c_str()), value);
+        write(find_uniform(name), Uniform_Type::INT, &value);
     }
 
     void Shader_Program::set_float(const std::string &name, float value) const
     {
-        glUniform1f(glGetUniformLocation(program_id, name.c_str()), value);
+        write(find_uniform(name), Uniform_Type::FLOAT, &value);
     }
 
     void Shader_Program::set_vec2(const std::string &name, float x, float y) const
     {
-        glUniform2f(glGetUniformLocation(program_id, name.c_str()), x, y);
+        const float vec[2] = {x, y};
+        write(find_uniform(name), Uniform_Type::VEC2, vec);
     }
 
     void Shader_Program::set_vec2(const std::string &name, const float *vec) const
     {
-        glUniform2fv(glGetUniformLocation(program_id, name.c_str()), 1, vec);
+        write(find_uniform(name), Uniform_Type::VEC2, vec);
     }
 
     void Shader_Program::set_vec3(const std::string &name, float x, float y, float z) const
     {
-        glUniform3f(glGetUniformLocation(program_id, name.c_str()), x, y, z);
+        const float vec[3] = {x, y, z};
+        write(find_uniform(name), Uniform_Type::VEC3, vec);
     }
 
     void Shader_Program::set_vec3(const std::string &name, const float *vec) const
     {
-        glUniform3fv(glGetUniformLocation(program_id, name.c_str()), 1, vec);
+        write(find_uniform(name), Uniform_Type::VEC3, vec);
     }
 
     void Shader_Program::set_vec4(const std::string &name, float x, float y, float z, float w) const
     {
-        glUniform4f(glGetUniformLocation(program_id, name.c_str()), x, y, z, w);
+        const float vec[4] = {x, y, z, w};
+        write(find_uniform(name), Uniform_Type::VEC4, vec);
     }
 
     void Shader_Program::set_vec4(const std::string &name, const float *vec) const
     {
-        glUniform4fv(glGetUniformLocation(program_id, name.c_str()), 1, vec);
+        write(find_uniform(name), Uniform_Type::VEC4, vec);
     }
 
     void Shader_Program::set_mat2(const std::string &name, const float *mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(program_id, name.c_str()), 1, GL_FALSE, mat);
+        write(find_uniform(name), Uniform_Type::MAT2, mat);
     }
 
     void Shader_Program::set_mat3(const std::string &name, const float *mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(program_id, name.c_str()), 1, GL_FALSE, mat);
+        write(find_uniform(name), Uniform_Type::MAT3, mat);
     }
 
     void Shader_Program::set_mat4(const std::string &name, const float *mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(program_id, name.c_str()), 1, GL_FALSE, mat);
+        write(find_uniform(name), Uniform_Type::MAT4, mat);
+    }
+
+    int32_t Shader_Program::find_uniform(const std::string &name) const
+    {
+        if (table.empty())
+        {
+            return -1;
+        }
+        const uint64_t hash = uniform_hash(name);
+        const size_t mask = table.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+        {
+            const int32_t index = table[slot].index;
+            if (index < 0)
+            {
+                return -1;
+            }
+            if (table[slot].hash != hash)
+            {
+                continue;
+            }
+            const std::string &found = uniforms[index].name;
+            if (found == name || (found.size() == name.size() + 3 && found.compare(0, name.size(), name) == 0 &&
+                                  found.compare(name.size(), 3, "[0]") == 0))
+            {
+                return index;
+            }
+        }
+    }
+
+    void Shader_Program::reflect_uniforms()
+    {
+        uniforms.clear();
+        values.clear();
+        known.clear();
+        GLint count = 0, max_length = 0;
+        glGetProgramiv(program_id, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+        std::vector<std::pair<std::string, int32_t>> aliases;
+        std::vector<char> buffer(max_length > 0 ? max_length : 1);
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLsizei length = 0;
+            GLint array_size = 0;
+            GLenum gl_type = 0;
+            glGetActiveUniform(program_id, i, max_length, &length, &array_size, &gl_type, buffer.data());
+            std::string name(buffer.data(), length);
+            const Uniform_Type type = uniform_type(gl_type);
+            const size_t bracket = name.size() > 3 ? name.size() - 3 : std::string::npos;
+            if (bracket == std::string::npos || name.compare(bracket, 3, "[0]") != 0)
+            {
+                const GLint location = glGetUniformLocation(program_id, name.c_str());
+                // members of uniform blocks have no location
+                if (location >= 0)
+                {
+                    add_uniform(name, location, type);
+                }
+                continue;
+            }
+            // arrays of plain types are reported once, every element gets its own entry
+            const std::string base = name.substr(0, bracket);
+            for (GLint element = 0; element < array_size; ++element)
+            {
+                const std::string element_name = base + "[" + std::to_string(element) + "]";
+                const GLint location = glGetUniformLocation(program_id, element_name.c_str());
+                if (location < 0)
+                {
+                    continue;
+                }
+                if (element == 0)
+                {
+                    aliases.emplace_back(base, static_cast<int32_t>(uniforms.size()));
+                }
+                add_uniform(element_name, location, type);
+            }
+        }
+        // at most half full keeps the probes short
+        size_t size = 16;
+        while (size < 2 * (uniforms.size() + aliases.size()))
+        {
+            size <<= 1;
+        }
+        table.assign(size, Slot{0, -1});
+        for (size_t i = 0; i < uniforms.size(); ++i)
+        {
+            insert_uniform(uniforms[i].hash, static_cast<int32_t>(i));
+        }
+        for (const auto &alias : aliases)
+        {
+            insert_uniform(uniform_hash(alias.first), alias.second);
+        }
+    }
+
+    void Shader_Program::add_uniform(const std::string &name, GLint location, Uniform_Type type)
+    {
+        const uint32_t offset = static_cast<uint32_t>(values.size());
+        values.resize(values.size() + uniform_words(type));
+        known.push_back(false);
+        uniforms.push_back({uniform_hash(name), name, location, type, offset});
+    }
+
+    void Shader_Program::insert_uniform(uint64_t hash, int32_t index)
+    {
+        const size_t mask = table.size() - 1;
+        size_t slot = hash & mask;
+        while (table[slot].index >= 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = Slot{hash, index};
+    }
+
+    void Shader_Program::write(int32_t index, Uniform_Type type, const void *data) const
+    {
+        // unknown names are ignored like GL ignores location -1, a type mismatch would be a GL error
+        if (index < 0 || uniforms[index].type != type)
+        {
+            return;
+        }
+        const Uniform &uniform = uniforms[index];
+        const size_t bytes = uniform_words(type) * sizeof(uint32_t);
+        uint32_t *shadow = values.data() + uniform.offset;
+        if (known[index] && std::memcmp(shadow, data, bytes) == 0)
+        {
+            return;
+        }
+        std::memcpy(shadow, data, bytes);
+        known[index] = true;
+        GL_State::instance().use_program(program_id);
+        const GLint location = uniform.location;
+        const float *f = static_cast<const float *>(data);
+        switch (type)
+        {
+        case Uniform_Type::INT:
+            glUniform1i(location, *static_cast<const int *>(data));
+            break;
+        case Uniform_Type::FLOAT:
+            glUniform1f(location, f[0]);
+            break;
+        case Uniform_Type::VEC2:
+            glUniform2fv(location, 1, f);
+            break;
+        case Uniform_Type::VEC3:
+            glUniform3fv(location, 1, f);
+            break;
+        case Uniform_Type::VEC4:
+            glUniform4fv(location, 1, f);
+            break;
+        case Uniform_Type::MAT2:
+            glUniformMatrix2fv(location, 1, GL_FALSE, f);
+            break;
+        case Uniform_Type::MAT3:
+            glUniformMatrix3fv(location, 1, GL_FALSE, f);
+            break;
+        case Uniform_Type::MAT4:
+            glUniformMatrix4fv(location, 1, GL_FALSE, f);
+            break;
+        default:
+            break;
+        }
     }
 
     Shader *Shader_Program_Factory::find_shader(const std::string &name)
@@ -6,6 +6,9 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
+#include <cstdint>
+#include "gl_state.h"
 
 namespace Rendering
 {
@@ -37,17 +40,76 @@ namespace Rendering
 
     int compile_shader(Shader &shader);
 
+    enum class Uniform_Type : uint8_t
+    {
+        NONE, // not settable through handles
+        INT,  // int, bool and samplers
+        FLOAT,
+        VEC2,
+        VEC3,
+        VEC4,
+        MAT2,
+        MAT3,
+        MAT4
+    };
+
+    // a resolved uniform of a program, only valid for the program (and link) it came from
+    template <Uniform_Type TYPE>
+    struct Uniform_Handle
+    {
+        int32_t index = -1;
+        bool is_valid() const { return index >= 0; }
+    };
+    using Uniform_Int = Uniform_Handle<Uniform_Type::INT>;
+    using Uniform_Float = Uniform_Handle<Uniform_Type::FLOAT>;
+    using Uniform_Vec2 = Uniform_Handle<Uniform_Type::VEC2>;
+    using Uniform_Vec3 = Uniform_Handle<Uniform_Type::VEC3>;
+    using Uniform_Vec4 = Uniform_Handle<Uniform_Type::VEC4>;
+    using Uniform_Mat2 = Uniform_Handle<Uniform_Type::MAT2>;
+    using Uniform_Mat3 = Uniform_Handle<Uniform_Type::MAT3>;
+    using Uniform_Mat4 = Uniform_Handle<Uniform_Type::MAT4>;
+
     class Shader_Program;
     using Shader_Program_S_Ptr = std::shared_ptr<Shader_Program>;
     using Shader_Program_U_Ptr = std::unique_ptr<Shader_Program>;
     using Shader_Program_W_Ptr = std::weak_ptr<Shader_Program>;
     using Shader_Program_Ptr = Shader_Program_U_Ptr;
 
+    // The active uniforms are reflected once per link into a flat table keyed by
+    // name (array elements and struct members get one entry each, "a" and
+    // "a[0]" name the same uniform). Handles resolve a name once; the string
+    // setters look it up in the table instead of asking GL. Every setter goes
+    // through a shadow copy of the values and only reaches GL when a value
+    // changes, activating the program through GL_State if needed.
     class Shader_Program
     {
+        // structures
+    private:
+        struct Uniform
+        {
+            uint64_t hash;
+            std::string name;
+            GLint location;
+            Uniform_Type type;
+            // into values, in 4 byte words
+            uint32_t offset;
+        };
+
         // attributes
     private:
         GLuint program_id;
+        std::vector<Uniform> uniforms;
+        struct Slot
+        {
+            uint64_t hash;
+            // into uniforms, -1 if empty; an alias "a" points at "a[0]"
+            int32_t index;
+        };
+        // open addressing, linear probing
+        std::vector<Slot> table;
+        mutable std::vector<uint32_t> values;
+        mutable std::vector<bool> known;
+        uint32_t generation = 0;
 
     public:
         std::string name;
@@ -61,6 +123,7 @@ namespace Rendering
         {
             if (program_id != 0)
             {
+                GL_State::instance().forget_program(program_id);
                 glDeleteProgram(program_id);
                 is_linked = false;
             }
@@ -82,8 +145,32 @@ namespace Rendering
         void set_mat2(const std::string &name, const float *mat) const;
         void set_mat3(const std::string &name, const float *mat) const;
         void set_mat4(const std::string &name, const float *mat) const;
+
+        // an invalid handle if the program has no such uniform, or it has another type
+        template <Uniform_Type TYPE>
+        Uniform_Handle<TYPE> get_uniform(const std::string &name) const;
+        void set(Uniform_Int uniform, int value) const { write(uniform.index, Uniform_Type::INT, &value); }
+        void set(Uniform_Float uniform, float value) const { write(uniform.index, Uniform_Type::FLOAT, &value); }
+        void set(Uniform_Vec2 uniform, const float *vec) const { write(uniform.index, Uniform_Type::VEC2, vec); }
+        void set(Uniform_Vec3 uniform, const float *vec) const { write(uniform.index, Uniform_Type::VEC3, vec); }
+        void set(Uniform_Vec4 uniform, const float *vec) const { write(uniform.index, Uniform_Type::VEC4, vec); }
+        void set(Uniform_Mat2 uniform, const float *mat) const { write(uniform.index, Uniform_Type::MAT2, mat); }
+        void set(Uniform_Mat3 uniform, const float *mat) const { write(uniform.index, Uniform_Type::MAT3, mat); }
+        void set(Uniform_Mat4 uniform, const float *mat) const { write(uniform.index, Uniform_Type::MAT4, mat); }
+        // -1 if there is none
+        int32_t find_uniform(const std::string &name) const;
+        size_t get_uniform_count() const { return uniforms.size(); }
+        // changes on every successful link, handles from an older one are stale
+        uint32_t get_generation() const { return generation; }
+
+    private:
+        void reflect_uniforms();
+        void add_uniform(const std::string &name, GLint location, Uniform_Type type);
+        void insert_uniform(uint64_t hash, int32_t index);
+        void write(int32_t index, Uniform_Type type, const void *data) const;
     };
 
+
     class Shader_Program_Factory
     {
         // attributes
@@ -117,6 +204,20 @@ namespace Rendering
     };
 
     extern Shader_Program_Factory shader_program_factory;
+
+    /*---Implementation---*/
+    template <Uniform_Type TYPE>
+    Uniform_Handle<TYPE> Shader_Program::get_uniform(const std::string &name) const
+    {
+        Uniform_Handle<TYPE> rslt;
+        const int32_t index = find_uniform(name);
+        if (index >= 0 && uniforms[index].type == TYPE)
+        {
+            rslt.index = index;
+        }
+        return rslt;
+    }
+
 }; // namespace GUI
 
 #endif // GUI_SHADER_H
\ No newline at end of file
@@ -1,17 +1,17 @@
 /*
 fragment shader for pbr shading
-in: mat3 tbn, vec3 frag_position, vec2 frag_texcoord
+in: mat3 tbn, vec3 frag_position, vec2 frag_texcoord, vec3 instance_albedo,
+vec3 instance_material (metallic, roughness, ao)
 out: vec4 fragColor, vec4 brightColor
-uniform: Material u_material, Light u_lights[MAX_LIGHTS], int u_light_num,
-mat4 u_view, bool u_ibl_enable, vec3 u_env_color, samplerCube
+uniform: Material u_material, Frame_Data (lights, view), bool u_ibl_enable, vec3 u_env_color, samplerCube
 u_irradiance_map, samplerCube u_prefilter_map, sampler2D u_brdf_lut
 */
 #version 420 core
 #define PI 3.14159265359
-#define MAX_LIGHTS 33
 #define LIGHT_TYPE_PARALLEL 0
 #define LIGHT_TYPE_POINT 1
 #define LIGHT_TYPE_SPOT 2
+#define MAX_LIGHTS 33
 
 layout(location = 0) out vec4 frag_color;
 layout(location = 1) out vec4 bright_color;
@@ -19,6 +19,8 @@ layout(location = 1) out vec4 bright_color;
 in mat3 tbn;
 in vec3 frag_position;
 in vec2 frag_texcoord;
+flat in vec3 instance_albedo;
+flat in vec3 instance_material;
 
 struct Light {
   vec3 position;
@@ -28,12 +30,9 @@ struct Light {
   float intensity;
 };
 
+// albedo, metallic, roughness and ao come per instance
 struct Material {
-  vec3 albedo;
   vec3 emissive;
-  float metallic;
-  float roughness;
-  float ao;
   float height_scale;
 
   sampler2D albedo_map;
@@ -55,9 +54,15 @@ struct Material {
 };
 
 uniform Material u_material;
-uniform Light u_lights[MAX_LIGHTS];
-uniform int u_light_num;
-uniform mat4 u_view;
+// per frame, shared by the scene shaders; std140 mirror in uniform_buffer.h
+layout(std140, binding = 0) uniform Frame_Data {
+  mat4 u_view;
+  mat4 u_projection;
+  float u_exposure;
+  float u_gamma;
+  int u_light_num;
+  Light u_lights[MAX_LIGHTS];
+};
 
 uniform samplerCube u_irradiance_map;
 uniform samplerCube u_prefilter_map;
@@ -132,18 +137,18 @@ void main() {
 
   vec3 tex_albedo = sgrb_to_linear(texture(u_material.albedo_map, uv).rgb);
   vec3 albedo =
-      mix(u_material.albedo, tex_albedo, u_material.albedo_texture_factor);
+      mix(instance_albedo, tex_albedo, u_material.albedo_texture_factor);
 
   float tex_metallic = texture(u_material.metallic_map, uv).r;
-  float metallic = mix(u_material.metallic, tex_metallic,
+  float metallic = mix(instance_material.x, tex_metallic,
                        u_material.metallic_texture_factor);
 
   float tex_roughness = texture(u_material.roughness_map, uv).r;
-  float roughness = mix(u_material.roughness, tex_roughness,
+  float roughness = mix(instance_material.y, tex_roughness,
                         u_material.roughness_texture_factor);
 
   float tex_ao = texture(u_material.ao_map, uv).r;
-  float ao = mix(u_material.ao, tex_ao, u_material.ao_texture_factor);
+  float ao = mix(instance_material.z, tex_ao, u_material.ao_texture_factor);
 
   vec3 tex_emissive = texture(u_material.emissive_map, uv).rgb;
   vec3 emissive =
@@ -1,33 +1,58 @@
 /*
 vertex shader for pbr shading
-in: vec3 position, vec3 normal, vec3 tangent, vec2 texCoord
-out: mat3 tbn, vec3 fragPos, vec2 texCoord
-uniform: mat4 model, mat4 view, mat4 projection, mat3 normalMatrix
+in: vec3 position, vec3 normal, vec3 tangent, vec2 texCoord, per instance: mat4 model,
+mat3 normal matrix, vec3 albedo, vec3 material (metallic, roughness, ao)
+out: mat3 tbn, vec3 fragPos, vec2 texCoord, the instance's albedo and material
+uniform: Frame_Data (view, projection)
 */
 
 #version 420 core
 out mat3 tbn;
 out vec3 frag_position;
 out vec2 frag_texcoord;
+flat out vec3 instance_albedo;
+flat out vec3 instance_material;
 
 layout(location = 0) in vec3 v_position;
 layout(location = 1) in vec3 v_normal;
 layout(location = 2) in vec3 v_tangent;
 layout(location = 3) in vec2 v_texcoord;
+// per instance, see instance_buffer.h
+layout(location = 4) in mat4 i_model;
+layout(location = 8) in mat3 i_normal_matrix;
+layout(location = 11) in vec3 i_albedo;
+layout(location = 12) in vec3 i_material;
 
-uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
-uniform mat3 u_normal_matrix;
+#define MAX_LIGHTS 33
+
+struct Light {
+  vec3 position;
+  vec3 direction;
+  vec3 color;
+  int type;
+  float intensity;
+};
+
+// per frame, shared by the scene shaders; std140 mirror in uniform_buffer.h
+layout(std140, binding = 0) uniform Frame_Data {
+  mat4 u_view;
+  mat4 u_projection;
+  float u_exposure;
+  float u_gamma;
+  int u_light_num;
+  Light u_lights[MAX_LIGHTS];
+};
 
 
 void main() {
   frag_texcoord = v_texcoord;
+  instance_albedo = i_albedo;
+  instance_material = i_material;
   vec3 pos = v_position;
-  vec4 pos_view = u_view * u_model * vec4(pos, 1.0);
+  vec4 pos_view = u_view * i_model * vec4(pos, 1.0);
   frag_position = pos_view.xyz;
   gl_Position = u_projection * pos_view;
-  vec3 t = normalize(u_normal_matrix * v_tangent);
-  vec3 n = normalize(u_normal_matrix * v_normal);
+  vec3 t = normalize(i_normal_matrix * v_tangent);
+  vec3 n = normalize(i_normal_matrix * v_normal);
   tbn = mat3(t, cross(t, n), n);
 }
\ No newline at end of file
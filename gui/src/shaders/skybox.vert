@@ -6,8 +6,25 @@ layout (location = 0) in vec3 v_position;
 // layout (location = 2) in vec3 v_tangent;
 // layout (location = 3) in vec2 v_texcoord;
 
-uniform mat4 u_projection;
-uniform mat4 u_view;
+#define MAX_LIGHTS 33
+
+struct Light {
+  vec3 position;
+  vec3 direction;
+  vec3 color;
+  int type;
+  float intensity;
+};
+
+// per frame, shared by the scene shaders; std140 mirror in uniform_buffer.h
+layout(std140, binding = 0) uniform Frame_Data {
+  mat4 u_view;
+  mat4 u_projection;
+  float u_exposure;
+  float u_gamma;
+  int u_light_num;
+  Light u_lights[MAX_LIGHTS];
+};
 
 void main()
 {
@@ -2,7 +2,7 @@
 fragment shader for tone mapping
 in: vec2 texcoord
 uniform sampler2D u_image
-uniform float u_exposure
+Frame_Data (exposure, gamma)
 out: vec4 frag_color
 */
 
@@ -12,8 +12,25 @@ out vec4 frag_color;
 in vec2 texcoord;
 
 uniform sampler2D u_image;
-uniform float u_exposure;
-uniform float u_gamma = 2.2;
+#define MAX_LIGHTS 33
+
+struct Light {
+  vec3 position;
+  vec3 direction;
+  vec3 color;
+  int type;
+  float intensity;
+};
+
+// per frame, shared by the scene shaders; std140 mirror in uniform_buffer.h
+layout(std140, binding = 0) uniform Frame_Data {
+  mat4 u_view;
+  mat4 u_projection;
+  float u_exposure;
+  float u_gamma;
+  int u_light_num;
+  Light u_lights[MAX_LIGHTS];
+};
 
 vec3 aces_tone_mapping(vec3 x)
 {
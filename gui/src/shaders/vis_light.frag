@@ -10,8 +10,33 @@ layout (location = 1) out vec4 other_color;
 in vec2 texcoord;
 in vec3 frag_position;
 in vec3 frag_normal;
-uniform mat4 u_view;
-uniform vec3 u_color;
+
+#define MAX_LIGHTS 33
+
+struct Light {
+  vec3 position;
+  vec3 direction;
+  vec3 color;
+  int type;
+  float intensity;
+};
+
+// per frame, shared by the scene shaders; std140 mirror in uniform_buffer.h
+layout(std140, binding = 0) uniform Frame_Data {
+  mat4 u_view;
+  mat4 u_projection;
+  float u_exposure;
+  float u_gamma;
+  int u_light_num;
+  Light u_lights[MAX_LIGHTS];
+};
+
+// per draw, a range of the ring buffer
+layout(std140, binding = 1) uniform Draw_Data {
+  mat4 u_model;
+  mat3 u_normal_matrix;
+  vec3 u_color;
+};
 
 
 void main()
@@ -8,10 +8,32 @@ layout (location = 1) in vec3 v_normal;
 layout (location = 2) in vec3 v_tangent;
 layout (location = 3) in vec2 v_texcoord;
 
-uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
-uniform mat3 u_normal_matrix;
+#define MAX_LIGHTS 33
+
+struct Light {
+  vec3 position;
+  vec3 direction;
+  vec3 color;
+  int type;
+  float intensity;
+};
+
+// per frame, shared by the scene shaders; std140 mirror in uniform_buffer.h
+layout(std140, binding = 0) uniform Frame_Data {
+  mat4 u_view;
+  mat4 u_projection;
+  float u_exposure;
+  float u_gamma;
+  int u_light_num;
+  Light u_lights[MAX_LIGHTS];
+};
+
+// per draw, a range of the ring buffer
+layout(std140, binding = 1) uniform Draw_Data {
+  mat4 u_model;
+  mat3 u_normal_matrix;
+  vec3 u_color;
+};
 
 void main()
 {
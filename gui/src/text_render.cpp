@@ -2,6 +2,7 @@
 #include "ui_log.h"
 #include <iostream>
 #include "math/base.h"
+#include "gl_state.h"
 namespace Rendering
 {
     void Text_Render::init()
@@ -15,7 +16,7 @@ namespace Rendering
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
 
-        glBindVertexArray(VAO);
+        GL_State::instance().bind_vertex_array(VAO);
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
@@ -25,16 +26,13 @@ namespace Rendering
         glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-        glBindVertexArray(0);
-        
     }
 
     void Text_Render::render_text(const std::string &content, float x, float y, float scale, Core::Vector3 color)
     {
         shader->activate();
-        glActiveTexture(GL_TEXTURE0);
-        glBindVertexArray(VAO);
+        auto &state = GL_State::instance();
+        state.bind_vertex_array(VAO);
 
         for (auto c : content)
         {
@@ -55,7 +53,7 @@ namespace Rendering
                 {xpos + w, ypos, 1.0f, 1.0f},
                 {xpos + w, ypos + h, 1.0f, 0.0f}};
 
-            glBindTexture(GL_TEXTURE_2D, ch.textureID);
+            state.bind_texture(0, GL_TEXTURE_2D, ch.textureID);
 
             glBindBuffer(GL_ARRAY_BUFFER, VBO);
             glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
@@ -67,8 +65,6 @@ namespace Rendering
             x += (ch.advance >> 6) * scale;
         }
 
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
         shader->deactivate();
     }
 
@@ -94,6 +90,7 @@ namespace Rendering
     {
         if (VAO != 0)
         {
+            GL_State::instance().forget_vertex_array(VAO);
             glDeleteVertexArrays(1, &VAO);
             glDeleteBuffers(1, &VBO);
         }
@@ -127,7 +124,7 @@ namespace Rendering
 
             GLuint font_texture;
             glGenTextures(1, &font_texture);
-            glBindTexture(GL_TEXTURE_2D, font_texture);
+            GL_State::instance().bind_texture(GL_TEXTURE_2D, font_texture);
             glTexImage2D(
                 GL_TEXTURE_2D,
                 0,
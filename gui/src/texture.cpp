@@ -1,4 +1,5 @@
 #include "texture.h"
+#include "profiler.h"
 #include "ui_log.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -7,6 +8,7 @@
 #include <iostream>
 #include "file.h"
 #include "tools.h"
+#include "gl_state.h"
 
 namespace Rendering
 {
@@ -20,23 +22,23 @@ namespace Rendering
 
     Texture::~Texture()
     {
+        GL_State::instance().forget_texture(texture_id);
         glDeleteTextures(1, &texture_id);
     }
 
     void Texture::bind() const
     {
-        glBindTexture(format.target, texture_id);
+        GL_State::instance().bind_texture(format.target, texture_id);
     }
 
     void Texture::bind(int index) const
     {
-        glActiveTexture(GL_TEXTURE0 + index);
-        glBindTexture(format.target, texture_id);
+        GL_State::instance().bind_texture(index, format.target, texture_id);
     }
 
     void Texture::unbind() const
     {
-        glBindTexture(format.target, 0);
+        // the texture stays bound until another one takes its unit
     }
 
     void Texture::set_data(const void *data, size_t width, size_t height)
@@ -107,6 +109,7 @@ namespace Rendering
 
     Img_Data image_data(const std::string &path, bool flip)
     {
+        CORE_PROFILE_SCOPE("image_data");
         Img_Data rslt;
         auto ext = Core::file_extension(path);
         if (ext == ".jpg" || ext == ".jpeg")
@@ -351,6 +354,7 @@ namespace Rendering
     // load texture from file with FreeImage Library
     Texture *load_texture(const std::string &path)
     {
+        CORE_PROFILE_SCOPE("load_texture");
         Texture::Format format;
         format.target = GL_TEXTURE_2D;
         auto img = image_data(path, true);
@@ -372,6 +376,7 @@ namespace Rendering
 
     Texture *load_cube_texture(const std::string &path)
     {
+        CORE_PROFILE_SCOPE("load_cube_texture");
         Texture::Format format;
         format.target = GL_TEXTURE_CUBE_MAP;
 
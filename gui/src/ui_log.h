@@ -3,41 +3,38 @@
 #define UI_LOG_H
 
 #include <string>
-#include <vector>
+#include "logger.h"
 
 namespace GUI
 {
+    // application log, safe to call from any thread; see Core::Logger
     struct Log
     {
-        std::vector<std::string> messages;
-        int max_lines = 1000;
-        void log(const std::string &msg)
+        Core::Logger logger;
+
+        void log(const std::string &msg, Core::Logger::Level level = Core::Logger::LEVEL_INFO)
         {
-            messages.push_back(msg);
-            if (messages.size() > max_lines)
-            {
-                messages.erase(messages.begin());
-            }
+            logger.log(level, msg);
         }
 
         void warn(const std::string &msg)
         {
-            log("[WARN] " + msg);
+            log(msg, Core::Logger::LEVEL_WARN);
         }
 
         void error(const std::string &msg)
         {
-            log("[ERROR] " + msg);
+            log(msg, Core::Logger::LEVEL_ERROR);
         }
 
         void info(const std::string &msg)
         {
-            log("[INFO] " + msg);
+            log(msg, Core::Logger::LEVEL_INFO);
         }
-        
+
         void clear()
         {
-            messages.clear();
+            logger.clear_history();
         }
 
         static Log &get()
@@ -48,4 +45,4 @@ namespace GUI
     };
 };
 
-#endif
\ No newline at end of file
+#endif
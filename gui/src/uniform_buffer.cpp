@@ -0,0 +1,133 @@
+#include "uniform_buffer.h"
+#include <cstring>
+#include <stdexcept>
+#include "gl_state.h"
+
+namespace Rendering
+{
+    void Draw_Data::set_normal_matrix(const float *mat3)
+    {
+        for (int column = 0; column < 3; ++column)
+        {
+            std::memcpy(normal_matrix + column * 4, mat3 + column * 3, 3 * sizeof(float));
+            normal_matrix[column * 4 + 3] = 0.f;
+        }
+    }
+
+    void Uniform_Buffer::update(const void *data, size_t size)
+    {
+        if (buffer == 0)
+        {
+            glGenBuffers(1, &buffer);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        // same size: the driver hands out fresh storage instead of waiting for the last frame
+        glBufferData(GL_UNIFORM_BUFFER, size, data, GL_STREAM_DRAW);
+        this->size = size;
+    }
+
+    void Uniform_Buffer::bind(GLuint binding)
+    {
+        if (buffer == 0)
+        {
+            throw std::runtime_error("Uniform_Buffer::bind: the buffer was never updated");
+        }
+        GL_State::instance().bind_uniform_buffer(binding, buffer);
+    }
+
+    void Uniform_Buffer::destroy()
+    {
+        if (buffer != 0)
+        {
+            GL_State::instance().forget_buffer(buffer);
+            glDeleteBuffers(1, &buffer);
+            buffer = 0;
+            size = 0;
+        }
+    }
+
+    Uniform_Ring::Uniform_Ring(size_t capacity)
+        : capacity(capacity)
+    {
+    }
+
+    size_t Uniform_Ring::push(const void *data, size_t size)
+    {
+        if (alignment == 0)
+        {
+            GLint value = 0;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+            alignment = value > 0 ? static_cast<size_t>(value) : 256;
+        }
+        const size_t rslt = align(staging.size());
+        staging.resize(rslt + size);
+        std::memcpy(staging.data() + rslt, data, size);
+        return rslt;
+    }
+
+    void Uniform_Ring::commit()
+    {
+        if (staging.empty())
+        {
+            return;
+        }
+        const size_t size = staging.size();
+        if (buffer == 0 || size > capacity)
+        {
+            size_t grown = capacity;
+            while (grown < size)
+            {
+                grown *= 2;
+            }
+            allocate(grown);
+        }
+        else if (head + size > capacity)
+        {
+            // wrapped: orphan the storage the GPU may still be reading and start over
+            allocate(capacity);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        void *mapped = glMapBufferRange(GL_UNIFORM_BUFFER, head, size,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapped != nullptr)
+        {
+            std::memcpy(mapped, staging.data(), size);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+        }
+        else
+        {
+            glBufferSubData(GL_UNIFORM_BUFFER, head, size, staging.data());
+        }
+        base = head;
+        head = align(head + size);
+    }
+
+    void Uniform_Ring::bind(GLuint binding, size_t offset, size_t size)
+    {
+        GL_State::instance().bind_uniform_buffer(binding, buffer, base + offset, size);
+    }
+
+    void Uniform_Ring::destroy()
+    {
+        if (buffer != 0)
+        {
+            GL_State::instance().forget_buffer(buffer);
+            glDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
+        head = base = 0;
+        staging.clear();
+    }
+
+    void Uniform_Ring::allocate(size_t capacity)
+    {
+        if (buffer == 0)
+        {
+            glGenBuffers(1, &buffer);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferData(GL_UNIFORM_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        this->capacity = capacity;
+        head = 0;
+    }
+} // namespace Rendering
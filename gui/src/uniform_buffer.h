@@ -0,0 +1,124 @@
+#pragma once
+#ifndef RENDERING_UNIFORM_BUFFER_H
+#define RENDERING_UNIFORM_BUFFER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+    // binding points of the uniform blocks, fixed in the shaders with layout(binding = ...)
+    struct UNIFORM_BINDING
+    {
+        static const GLuint FRAME = 0;
+        static const GLuint DRAW = 1;
+    };
+
+    // std140 layouts, kept in sync with the Frame_Data and Draw_Data blocks of the shaders
+    struct Light_Data
+    {
+        float position[3];
+        float pad_0;
+        float direction[3];
+        float pad_1;
+        float color[3];
+        int32_t type;
+        float intensity;
+        float pad_2[3];
+    };
+    static_assert(sizeof(Light_Data) == 64, "Light_Data does not match std140");
+
+    struct Frame_Data
+    {
+        static const int MAX_LIGHTS = 33;
+        float view[16];
+        float projection[16];
+        float exposure;
+        float gamma;
+        int32_t light_num;
+        float pad_0;
+        Light_Data lights[MAX_LIGHTS];
+    };
+    static_assert(offsetof(Frame_Data, lights) == 144, "Frame_Data does not match std140");
+
+    struct Draw_Data
+    {
+        float model[16];
+        // a mat3 is three vec4 columns in std140
+        float normal_matrix[12];
+        float color[3];
+        float pad_0;
+
+        void set_normal_matrix(const float *mat3);
+    };
+    static_assert(sizeof(Draw_Data) == 128, "Draw_Data does not match std140");
+
+    // a uniform buffer written whole, once per frame
+    class Uniform_Buffer
+    {
+        // attributes
+    private:
+        GLuint buffer = 0;
+        size_t size = 0;
+
+        // constructors and deconstructor
+    public:
+        Uniform_Buffer() = default;
+        ~Uniform_Buffer() { destroy(); }
+        Uniform_Buffer(const Uniform_Buffer &) = delete;
+        Uniform_Buffer &operator=(const Uniform_Buffer &) = delete;
+
+        // methods
+    public:
+        // orphans the old storage, the draws still reading it keep their copy
+        void update(const void *data, size_t size);
+        void bind(GLuint binding);
+        void destroy();
+    };
+
+    // Per-draw records of a frame: push() stages them on the CPU, commit()
+    // writes all of them with a single unsynchronized map at the head of the
+    // ring and bind() points a binding at one record with glBindBufferRange.
+    // When the ring is full the storage is orphaned and writing restarts at
+    // the front, so nothing the GPU may still read is ever overwritten and no
+    // fences are needed.
+    class Uniform_Ring
+    {
+        // attributes
+    private:
+        GLuint buffer = 0;
+        size_t capacity;
+        size_t head = 0;
+        // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, read with the first commit
+        size_t alignment = 0;
+        std::vector<uint8_t> staging;
+        // buffer offset of the committed records, staging offsets are relative to it
+        size_t base = 0;
+
+        // constructors and deconstructor
+    public:
+        explicit Uniform_Ring(size_t capacity = 1 << 18);
+        ~Uniform_Ring() { destroy(); }
+        Uniform_Ring(const Uniform_Ring &) = delete;
+        Uniform_Ring &operator=(const Uniform_Ring &) = delete;
+
+        // methods
+    public:
+        // drops the staged records, the committed ones stay valid until the next commit
+        void reset() { staging.clear(); }
+        // returns the record's offset to pass to bind after the commit
+        size_t push(const void *data, size_t size);
+        void commit();
+        void bind(GLuint binding, size_t offset, size_t size);
+        void destroy();
+        size_t get_capacity() const { return capacity; }
+
+    private:
+        size_t align(size_t value) const { return (value + alignment - 1) / alignment * alignment; }
+        void allocate(size_t capacity);
+    };
+} // namespace Rendering
+
+#endif // RENDERING_UNIFORM_BUFFER_H
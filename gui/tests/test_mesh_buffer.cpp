@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <gui.h>
+#include <map>
+
+using Rendering::Range_Allocator;
+
+namespace
+{
+    std::map<size_t, size_t> ranges(std::initializer_list<std::pair<const size_t, size_t>> list)
+    {
+        return std::map<size_t, size_t>(list);
+    }
+}
+
+TEST(TestRangeAllocator, split)
+{
+    Range_Allocator allocator;
+    allocator.grow(100);
+    EXPECT_EQ(allocator.allocate(30), 0u);
+    EXPECT_EQ(allocator.allocate(20), 30u);
+    // the rest of the range stays free
+    EXPECT_EQ(allocator.get_free_ranges(), ranges({{50, 50}}));
+    EXPECT_EQ(allocator.get_free(), 50u);
+    EXPECT_EQ(allocator.allocate(51), Range_Allocator::NONE);
+    EXPECT_EQ(allocator.allocate(50), 50u);
+    EXPECT_TRUE(allocator.get_free_ranges().empty());
+    EXPECT_EQ(allocator.allocate(1), Range_Allocator::NONE);
+}
+
+TEST(TestRangeAllocator, first_fit)
+{
+    Range_Allocator allocator;
+    allocator.grow(100);
+    const size_t a = allocator.allocate(10);
+    allocator.allocate(10);
+    const size_t c = allocator.allocate(30);
+    allocator.allocate(10);
+    allocator.release(a, 10);
+    allocator.release(c, 30);
+    // the first hole is too small, the second one is split
+    EXPECT_EQ(allocator.allocate(20), c);
+    EXPECT_EQ(allocator.allocate(10), a);
+}
+
+TEST(TestRangeAllocator, merge_with_prev)
+{
+    Range_Allocator allocator;
+    allocator.grow(30);
+    const size_t a = allocator.allocate(10);
+    const size_t b = allocator.allocate(10);
+    allocator.allocate(10);
+    allocator.release(a, 10);
+    allocator.release(b, 10);
+    EXPECT_EQ(allocator.get_free_ranges(), ranges({{0, 20}}));
+}
+
+TEST(TestRangeAllocator, merge_with_next)
+{
+    Range_Allocator allocator;
+    allocator.grow(30);
+    allocator.allocate(10);
+    const size_t b = allocator.allocate(10);
+    const size_t c = allocator.allocate(10);
+    allocator.release(c, 10);
+    allocator.release(b, 10);
+    EXPECT_EQ(allocator.get_free_ranges(), ranges({{10, 20}}));
+}
+
+TEST(TestRangeAllocator, merge_both)
+{
+    Range_Allocator allocator;
+    allocator.grow(40);
+    const size_t a = allocator.allocate(10);
+    const size_t b = allocator.allocate(10);
+    const size_t c = allocator.allocate(10);
+    allocator.allocate(10);
+    allocator.release(a, 10);
+    allocator.release(c, 10);
+    EXPECT_EQ(allocator.get_free_ranges(), ranges({{0, 10}, {20, 10}}));
+    allocator.release(b, 10);
+    EXPECT_EQ(allocator.get_free_ranges(), ranges({{0, 30}}));
+    EXPECT_EQ(allocator.allocate(30), 0u);
+}
+
+TEST(TestRangeAllocator, grow_then_allocate)
+{
+    Range_Allocator allocator;
+    EXPECT_EQ(allocator.allocate(1), Range_Allocator::NONE);
+    allocator.grow(16);
+    const size_t a = allocator.allocate(10);
+    EXPECT_EQ(allocator.allocate(10), Range_Allocator::NONE);
+    // the new space merges with the free tail, so the request fits now
+    allocator.grow(32);
+    EXPECT_EQ(allocator.get_capacity(), 32u);
+    EXPECT_EQ(allocator.get_free_ranges(), ranges({{10, 22}}));
+    EXPECT_EQ(allocator.allocate(20), 10u);
+    EXPECT_EQ(allocator.get_free(), 2u);
+    // shrinking is ignored
+    allocator.grow(8);
+    EXPECT_EQ(allocator.get_capacity(), 32u);
+    allocator.release(a, 10);
+    EXPECT_EQ(allocator.get_free(), 12u);
+}
+
+TEST(TestRangeAllocator, empty_release)
+{
+    Range_Allocator allocator;
+    allocator.grow(10);
+    allocator.allocate(10);
+    allocator.release(5, 0);
+    EXPECT_TRUE(allocator.get_free_ranges().empty());
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <gui.h>
+#include <cmath>
+#include <limits>
+
+using Rendering::Render_Queue;
+
+namespace
+{
+    // distinct addresses standing in for programs and meshes
+    int programs[2];
+    int meshes[3];
+
+    uint64_t bits(uint64_t key, int shift, int count)
+    {
+        return (key >> shift) & ((uint64_t(1) << count) - 1);
+    }
+}
+
+TEST(TestRenderQueue, opaque_layout)
+{
+    Render_Queue queue;
+    queue.make_key(Render_Queue::OPAQUE_PASS, &programs[0], 7, &meshes[0], 0.f);
+    const uint64_t key = queue.make_key(Render_Queue::OPAQUE_PASS, &programs[1], 8, &meshes[1], 0.5f);
+    // pass | program | material | mesh | depth
+    EXPECT_EQ(bits(key, 62, 2), Render_Queue::OPAQUE_PASS);
+    EXPECT_EQ(bits(key, 52, 10), 1u);
+    EXPECT_EQ(bits(key, 36, 16), 1u);
+    EXPECT_EQ(bits(key, 20, 16), 1u);
+    EXPECT_EQ(bits(key, 0, 20), Render_Queue::quantize_depth(0.5f));
+}
+
+TEST(TestRenderQueue, translucent_layout)
+{
+    Render_Queue queue;
+    queue.make_key(Render_Queue::TRANSLUCENT_PASS, &programs[0], 7, &meshes[0], 0.f);
+    const uint64_t key = queue.make_key(Render_Queue::TRANSLUCENT_PASS, &programs[1], 8, &meshes[1], 0.25f);
+    // pass | inverted depth | program | material | mesh
+    const uint64_t depth_mask = (uint64_t(1) << Render_Queue::DEPTH_BITS) - 1;
+    EXPECT_EQ(bits(key, 62, 2), Render_Queue::TRANSLUCENT_PASS);
+    EXPECT_EQ(bits(key, 42, 20), ~Render_Queue::quantize_depth(0.25f) & depth_mask);
+    EXPECT_EQ(bits(key, 32, 10), 1u);
+    EXPECT_EQ(bits(key, 16, 16), 1u);
+    EXPECT_EQ(bits(key, 0, 16), 1u);
+}
+
+TEST(TestRenderQueue, ids_restart_after_clear)
+{
+    Render_Queue queue;
+    const uint64_t first = queue.make_key(Render_Queue::OPAQUE_PASS, &programs[0], 7, &meshes[0], 0.5f);
+    queue.make_key(Render_Queue::OPAQUE_PASS, &programs[1], 8, &meshes[1], 0.5f);
+    queue.clear();
+    EXPECT_EQ(queue.make_key(Render_Queue::OPAQUE_PASS, &programs[1], 8, &meshes[1], 0.5f), first);
+}
+
+TEST(TestRenderQueue, depth_order)
+{
+    Render_Queue queue;
+    const float depths[] = {0.7f, 0.2f, 0.5f, 0.9f};
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        queue.push(Render_Queue::TRANSLUCENT_PASS, &programs[0], 1, &meshes[0], depths[i], 10 + i);
+        queue.push(Render_Queue::OPAQUE_PASS, &programs[0], 1, &meshes[0], depths[i], i);
+    }
+    queue.sort();
+    const auto &items = queue.get_items();
+    ASSERT_EQ(items.size(), 8u);
+    // opaque front to back, then translucent back to front
+    const uint32_t expected[] = {1, 2, 0, 3, 13, 10, 12, 11};
+    for (size_t i = 0; i < 8; ++i)
+        EXPECT_EQ(items[i], expected[i]) << i;
+    for (size_t i = 1; i < 8; ++i)
+        EXPECT_LE(queue.get_keys()[i - 1], queue.get_keys()[i]) << i;
+}
+
+TEST(TestRenderQueue, state_before_depth)
+{
+    Render_Queue queue;
+    queue.push(Render_Queue::OPAQUE_PASS, &programs[1], 1, &meshes[0], 0.1f, 0);
+    queue.push(Render_Queue::OPAQUE_PASS, &programs[0], 1, &meshes[0], 0.9f, 1);
+    queue.push(Render_Queue::OPAQUE_PASS, &programs[1], 1, &meshes[0], 0.05f, 2);
+    queue.sort();
+    // the packets of one program stay together, the states follow their items
+    const auto &items = queue.get_items();
+    const auto &states = queue.get_states();
+    EXPECT_EQ(items[0], 2u);
+    EXPECT_EQ(items[1], 0u);
+    EXPECT_EQ(items[2], 1u);
+    EXPECT_EQ(states[0], states[1]);
+    EXPECT_NE(states[1], states[2]);
+    EXPECT_EQ(states[2].program, &programs[0]);
+}
+
+TEST(TestRenderQueue, stable_sort)
+{
+    Render_Queue queue;
+    const uint32_t count = 1000;
+    for (uint32_t i = 0; i < count; ++i)
+        queue.push(Render_Queue::OPAQUE_PASS, &programs[i % 2], 3, &meshes[0], 0.5f, i);
+    queue.sort();
+    const auto &items = queue.get_items();
+    ASSERT_EQ(items.size(), count);
+    // the even items first, each half in push order
+    for (uint32_t i = 0; i < count; ++i)
+        EXPECT_EQ(items[i], i < count / 2 ? 2 * i : 2 * (i - count / 2) + 1) << i;
+}
+
+TEST(TestRenderQueue, quantize_depth)
+{
+    const uint64_t max = (uint64_t(1) << Render_Queue::DEPTH_BITS) - 1;
+    EXPECT_EQ(Render_Queue::quantize_depth(0.f), 0u);
+    EXPECT_EQ(Render_Queue::quantize_depth(-2.f), 0u);
+    EXPECT_EQ(Render_Queue::quantize_depth(std::nanf("")), 0u);
+    EXPECT_EQ(Render_Queue::quantize_depth(-std::numeric_limits<float>::infinity()), 0u);
+    EXPECT_EQ(Render_Queue::quantize_depth(1.f), max);
+    EXPECT_EQ(Render_Queue::quantize_depth(3.f), max);
+    EXPECT_EQ(Render_Queue::quantize_depth(std::numeric_limits<float>::infinity()), max);
+    EXPECT_LT(Render_Queue::quantize_depth(0.25f), Render_Queue::quantize_depth(0.5f));
+    EXPECT_NEAR(double(Render_Queue::quantize_depth(0.5f)), max / 2.0, 1.0);
+}
+
+TEST(TestRenderQueue, state_masks)
+{
+    for (Render_Queue::Pass pass : {Render_Queue::OPAQUE_PASS, Render_Queue::TRANSLUCENT_PASS})
+    {
+        Render_Queue queue;
+        const uint64_t near_key = queue.make_key(pass, &programs[0], 1, &meshes[0], 0.1f);
+        const uint64_t far_key = queue.make_key(pass, &programs[0], 1, &meshes[0], 0.8f);
+        const uint64_t other_mesh = queue.make_key(pass, &programs[0], 1, &meshes[1], 0.1f);
+        const uint64_t other_material = queue.make_key(pass, &programs[0], 2, &meshes[0], 0.1f);
+        const uint64_t other_program = queue.make_key(pass, &programs[1], 1, &meshes[0], 0.1f);
+
+        EXPECT_NE(near_key, far_key) << pass;
+        EXPECT_EQ(Render_Queue::state_of(near_key), Render_Queue::state_of(far_key)) << pass;
+        EXPECT_NE(Render_Queue::state_of(near_key), Render_Queue::state_of(other_mesh)) << pass;
+        // the pass survives both masks
+        EXPECT_EQ(Render_Queue::state_of(near_key) >> 62, pass) << pass;
+        EXPECT_EQ(Render_Queue::material_state_of(near_key) >> 62, pass) << pass;
+
+        EXPECT_EQ(Render_Queue::material_state_of(near_key), Render_Queue::material_state_of(far_key)) << pass;
+        EXPECT_EQ(Render_Queue::material_state_of(near_key), Render_Queue::material_state_of(other_mesh)) << pass;
+        EXPECT_NE(Render_Queue::material_state_of(near_key), Render_Queue::material_state_of(other_material)) << pass;
+        EXPECT_NE(Render_Queue::material_state_of(near_key), Render_Queue::material_state_of(other_program)) << pass;
+    }
+}
+
+TEST(TestRenderQueue, state_compare)
+{
+    const Render_Queue::State state{&programs[0], 1, &meshes[0]};
+    EXPECT_EQ(state, (Render_Queue::State{&programs[0], 1, &meshes[0]}));
+    EXPECT_NE(state, (Render_Queue::State{&programs[0], 1, &meshes[1]}));
+    EXPECT_TRUE(state.same_material({&programs[0], 1, &meshes[1]}));
+    EXPECT_FALSE(state.same_material({&programs[0], 2, &meshes[0]}));
+    EXPECT_FALSE(state.same_material({&programs[1], 1, &meshes[0]}));
+}